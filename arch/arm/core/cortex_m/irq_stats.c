@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Per-IRQ latency and duration histograms
+ *
+ * The interrupt wrapper reads the DWT cycle counter on entry, then calls the
+ * ISR through _irq_stats_isr(), which records the entry latency and the
+ * duration of the ISR for the active interrupt line.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <arch/cpu.h>
+#include <arch/arm/cortex_m/cmsis.h>
+#include <debug/irq_stats.h>
+#include <string.h>
+
+static struct irq_stats irq_stats[CONFIG_NUM_IRQS];
+
+/*
+ * Cycles spent in the ISRs so far, from the wrapper on. An ISR is not
+ * charged with the ISRs nested in it, which added to this sum meanwhile.
+ */
+static u32_t irq_stats_isr_cycles;
+
+static inline void irq_stats_record(u32_t *histogram, u32_t cycles)
+{
+	u32_t value = cycles >> CONFIG_IRQ_STATS_BUCKET_SHIFT;
+	u32_t bucket = 0U;
+
+	if (value != 0U) {
+		bucket = min(32 - __builtin_clz(value),
+			     CONFIG_IRQ_STATS_BUCKETS - 1);
+	}
+
+	histogram[bucket]++;
+}
+
+void _irq_stats_isr(void *arg, void (*isr)(void *), u32_t entry)
+{
+	struct irq_stats *stats = &irq_stats[__get_IPSR() - 16];
+	unsigned int key;
+	u32_t start;
+	u32_t nested;
+	u32_t latency;
+	u32_t duration;
+
+	key = irq_lock();
+	start = DWT->CYCCNT;
+	nested = irq_stats_isr_cycles;
+	irq_unlock(key);
+
+	isr(arg);
+
+	key = irq_lock();
+	latency = start - entry;
+	duration = DWT->CYCCNT - start - (irq_stats_isr_cycles - nested);
+	irq_stats_isr_cycles += latency + duration;
+
+	stats->count++;
+	if (latency > stats->latency_max) {
+		stats->latency_max = latency;
+	}
+	if (duration > stats->duration_max) {
+		stats->duration_max = duration;
+	}
+	irq_stats_record(stats->latency, latency);
+	irq_stats_record(stats->duration, duration);
+	irq_unlock(key);
+}
+
+int irq_stats_get(unsigned int irq, struct irq_stats *stats)
+{
+	unsigned int key;
+
+	if (irq >= CONFIG_NUM_IRQS) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	*stats = irq_stats[irq];
+	irq_unlock(key);
+
+	return 0;
+}
+
+void irq_stats_reset(void)
+{
+	unsigned int key;
+	unsigned int irq;
+
+	/* One line at a time, not to add to the latency measured */
+	for (irq = 0; irq < CONFIG_NUM_IRQS; irq++) {
+		key = irq_lock();
+		(void)memset(&irq_stats[irq], 0, sizeof(irq_stats[irq]));
+		irq_unlock(key);
+	}
+}
+
+u32_t irq_stats_cycles_per_sec(void)
+{
+	return SystemCoreClock;
+}
+
+static int irq_stats_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#ifdef CONFIG_CPU_CORTEX_M7
+	/* Unlock the DWT registers */
+	DWT->LAR = 0xC5ACCE55;
+#endif
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	return 0;
+}
+
+SYS_INIT(irq_stats_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <adc.h>
+#include <device.h>
+#include <kernel.h>
+#include <soc.h>
+#include <clock_control/stm32_clock_control.h>
+#include <clock_control.h>
+
+#define LOG_LEVEL CONFIG_ADC_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_REGISTER(adc_stm32);
+
+#define ADC_CONTEXT_USES_KERNEL_TIMER
+#include "adc_context.h"
+
+#if defined(CONFIG_SOC_SERIES_STM32L0X)
+
+#define ADC_STM32_CHANNEL_VREFINT	17
+#define ADC_STM32_CHANNEL_TEMPSENSOR	18
+#define ADC_STM32_CHANNEL_MAX		18
+
+/* Sampling times, in ADC clock cycles minus one half */
+static const u16_t acq_time_tbl[] = {
+	1, 3, 7, 12, 19, 39, 79, 160
+};
+
+static const u32_t acq_time_ll[] = {
+	LL_ADC_SAMPLINGTIME_1CYCLE_5,
+	LL_ADC_SAMPLINGTIME_3CYCLES_5,
+	LL_ADC_SAMPLINGTIME_7CYCLES_5,
+	LL_ADC_SAMPLINGTIME_12CYCLES_5,
+	LL_ADC_SAMPLINGTIME_19CYCLES_5,
+	LL_ADC_SAMPLINGTIME_39CYCLES_5,
+	LL_ADC_SAMPLINGTIME_79CYCLES_5,
+	LL_ADC_SAMPLINGTIME_160CYCLES_5,
+};
+
+/* Long enough for the internal channels at any ADC clock */
+#define ADC_STM32_ACQ_TIME_DEFAULT	7
+
+#elif defined(CONFIG_SOC_SERIES_STM32L4X)
+
+#define ADC_STM32_CHANNEL_VREFINT	0
+#define ADC_STM32_CHANNEL_TEMPSENSOR	17
+#define ADC_STM32_CHANNEL_VBAT		18
+#define ADC_STM32_CHANNEL_MAX		18
+
+static const u16_t acq_time_tbl[] = {
+	2, 6, 12, 24, 47, 92, 247, 640
+};
+
+static const u32_t acq_time_ll[] = {
+	LL_ADC_SAMPLINGTIME_2CYCLES_5,
+	LL_ADC_SAMPLINGTIME_6CYCLES_5,
+	LL_ADC_SAMPLINGTIME_12CYCLES_5,
+	LL_ADC_SAMPLINGTIME_24CYCLES_5,
+	LL_ADC_SAMPLINGTIME_47CYCLES_5,
+	LL_ADC_SAMPLINGTIME_92CYCLES_5,
+	LL_ADC_SAMPLINGTIME_247CYCLES_5,
+	LL_ADC_SAMPLINGTIME_640CYCLES_5,
+};
+
+#define ADC_STM32_ACQ_TIME_DEFAULT	6
+
+static const u32_t rank_tbl[] = {
+	LL_ADC_REG_RANK_1,  LL_ADC_REG_RANK_2,  LL_ADC_REG_RANK_3,
+	LL_ADC_REG_RANK_4,  LL_ADC_REG_RANK_5,  LL_ADC_REG_RANK_6,
+	LL_ADC_REG_RANK_7,  LL_ADC_REG_RANK_8,  LL_ADC_REG_RANK_9,
+	LL_ADC_REG_RANK_10, LL_ADC_REG_RANK_11, LL_ADC_REG_RANK_12,
+	LL_ADC_REG_RANK_13, LL_ADC_REG_RANK_14, LL_ADC_REG_RANK_15,
+	LL_ADC_REG_RANK_16,
+};
+
+#endif
+
+/* The largest oversampling ratio of the hardware is 256 */
+#define ADC_STM32_OVERSAMPLING_MAX	8
+
+#ifdef CONFIG_ADC_STM32_DMA
+/* DMA1 channel 1 is wired to the ADC with request 0 on both series */
+#define ADC_STM32_DMA_CHANNEL		LL_DMA_CHANNEL_1
+#define ADC_STM32_DMA_IRQ		DMA1_Channel1_IRQn
+#endif
+
+struct adc_stm32_cfg {
+	ADC_TypeDef *base;
+	struct stm32_pclken pclken;
+	void (*irq_cfg_func)(void);
+};
+
+struct adc_stm32_data {
+	struct adc_context ctx;
+	struct device *dev;
+	u16_t *buffer;
+	u16_t *repeat_buffer;
+
+	u8_t channel_count;
+	u8_t resolution;
+	u8_t oversampling;
+	u8_t acq_time[ADC_STM32_CHANNEL_MAX + 1];
+};
+
+static int acq_time_index(u16_t acq_time)
+{
+	int i;
+
+	if (acq_time == ADC_ACQ_TIME_DEFAULT) {
+		return ADC_STM32_ACQ_TIME_DEFAULT;
+	}
+
+	if (ADC_ACQ_TIME_UNIT(acq_time) != ADC_ACQ_TIME_TICKS) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(acq_time_tbl); i++) {
+		if (acq_time_tbl[i] >= ADC_ACQ_TIME_VALUE(acq_time)) {
+			return i;
+		}
+	}
+
+	return -EINVAL;
+}
+
+static void adc_stm32_disable(ADC_TypeDef *adc)
+{
+	if (!LL_ADC_IsEnabled(adc)) {
+		return;
+	}
+
+	LL_ADC_Disable(adc);
+	while (LL_ADC_IsEnabled(adc)) {
+	}
+}
+
+static void adc_stm32_enable(ADC_TypeDef *adc)
+{
+	if (LL_ADC_IsEnabled(adc)) {
+		return;
+	}
+
+	LL_ADC_ClearFlag_ADRDY(adc);
+	LL_ADC_Enable(adc);
+	while (!LL_ADC_IsActiveFlag_ADRDY(adc)) {
+	}
+}
+
+/* The internal channels need their measurement path enabled. */
+static void adc_stm32_enable_path(ADC_TypeDef *adc, u8_t channel_id)
+{
+	ADC_Common_TypeDef *common = __LL_ADC_COMMON_INSTANCE(adc);
+	u32_t path = LL_ADC_GetCommonPathInternalCh(common);
+
+	switch (channel_id) {
+	case ADC_STM32_CHANNEL_VREFINT:
+#if defined(CONFIG_SOC_SERIES_STM32L0X)
+		LL_SYSCFG_VREFINT_EnableADC();
+#endif
+		path |= LL_ADC_PATH_INTERNAL_VREFINT;
+		break;
+	case ADC_STM32_CHANNEL_TEMPSENSOR:
+#if defined(CONFIG_SOC_SERIES_STM32L0X)
+		LL_SYSCFG_TEMPSENSOR_Enable();
+#endif
+		path |= LL_ADC_PATH_INTERNAL_TEMPSENSOR;
+		break;
+#if defined(ADC_STM32_CHANNEL_VBAT)
+	case ADC_STM32_CHANNEL_VBAT:
+		path |= LL_ADC_PATH_INTERNAL_VBAT;
+		break;
+#endif
+	default:
+		return;
+	}
+
+	if (path == LL_ADC_GetCommonPathInternalCh(common)) {
+		return;
+	}
+
+	/* The common register can only be written while the ADC is
+	 * disabled, adc_stm32_start_read() enables it again.
+	 */
+	adc_stm32_disable(adc);
+
+	LL_ADC_SetCommonPathInternalCh(common, path);
+	k_busy_wait(LL_ADC_DELAY_TEMPSENSOR_STAB_US);
+}
+
+static int adc_stm32_channel_setup(struct device *dev,
+				   const struct adc_channel_cfg *channel_cfg)
+{
+	const struct adc_stm32_cfg *config = dev->config->config_info;
+	struct adc_stm32_data *data = dev->driver_data;
+	u8_t channel_id = channel_cfg->channel_id;
+	int acq_time;
+
+	if (channel_id > ADC_STM32_CHANNEL_MAX) {
+		LOG_ERR("Channel %d is not valid", channel_id);
+		return -EINVAL;
+	}
+
+	acq_time = acq_time_index(channel_cfg->acquisition_time);
+	if (acq_time < 0) {
+		LOG_ERR("Invalid channel acquisition time");
+		return -EINVAL;
+	}
+
+	if (channel_cfg->differential) {
+		LOG_ERR("Differential channels are not supported");
+		return -EINVAL;
+	}
+
+	if (channel_cfg->gain != ADC_GAIN_1) {
+		LOG_ERR("Invalid channel gain");
+		return -EINVAL;
+	}
+
+	if (channel_cfg->reference != ADC_REF_INTERNAL) {
+		LOG_ERR("Invalid channel reference");
+		return -EINVAL;
+	}
+
+	data->acq_time[channel_id] = acq_time;
+
+	adc_stm32_enable_path(config->base, channel_id);
+
+	return 0;
+}
+
+static int check_buffer_size(const struct adc_sequence *sequence,
+			     u8_t active_channels)
+{
+	size_t needed_buffer_size;
+
+	needed_buffer_size = active_channels * sizeof(u16_t);
+	if (sequence->options) {
+		needed_buffer_size *= (1 + sequence->options->extra_samplings);
+	}
+
+	if (sequence->buffer_size < needed_buffer_size) {
+		LOG_ERR("Provided buffer is too small (%u/%u)",
+			    sequence->buffer_size, needed_buffer_size);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void adc_stm32_setup_sequencer(ADC_TypeDef *adc,
+				      struct adc_stm32_data *data,
+				      u32_t channels)
+{
+#if defined(CONFIG_SOC_SERIES_STM32L0X)
+	u8_t acq_time = 0U;
+	u8_t channel_id;
+
+	/* The sampling time is shared by all the channels, the longest
+	 * one of the sequence is used.
+	 */
+	for (channel_id = 0; channel_id <= ADC_STM32_CHANNEL_MAX;
+	     channel_id++) {
+		if ((channels & BIT(channel_id)) &&
+		    data->acq_time[channel_id] > acq_time) {
+			acq_time = data->acq_time[channel_id];
+		}
+	}
+
+	LL_ADC_SetSamplingTimeCommonChannels(adc, acq_time_ll[acq_time]);
+
+	/* The channels are converted in ascending order. */
+	adc->CHSELR = channels;
+#else
+	u32_t channel;
+	u8_t channel_id;
+	u8_t rank = 0U;
+
+	for (channel_id = 0; channel_id <= ADC_STM32_CHANNEL_MAX;
+	     channel_id++) {
+		if (!(channels & BIT(channel_id))) {
+			continue;
+		}
+
+		channel = __LL_ADC_DECIMAL_NB_TO_CHANNEL(channel_id);
+
+		LL_ADC_REG_SetSequencerRanks(adc, rank_tbl[rank++], channel);
+		LL_ADC_SetChannelSamplingTime(adc, channel,
+				acq_time_ll[data->acq_time[channel_id]]);
+	}
+
+	LL_ADC_REG_SetSequencerLength(adc, (rank - 1) << ADC_SQR1_L_Pos);
+#endif
+}
+
+static int start_read(struct device *dev, const struct adc_sequence *sequence)
+{
+	const struct adc_stm32_cfg *config = dev->config->config_info;
+	struct adc_stm32_data *data = dev->driver_data;
+	ADC_TypeDef *adc = config->base;
+	u32_t channels = sequence->channels;
+	u32_t resolution;
+	u8_t oversampling = sequence->oversampling;
+	int error;
+
+	switch (sequence->resolution) {
+	case 6:
+		resolution = LL_ADC_RESOLUTION_6B;
+		break;
+	case 8:
+		resolution = LL_ADC_RESOLUTION_8B;
+		break;
+	case 10:
+		resolution = LL_ADC_RESOLUTION_10B;
+		break;
+	case 12:
+		resolution = LL_ADC_RESOLUTION_12B;
+		break;
+	default:
+		LOG_ERR("Invalid resolution");
+		return -EINVAL;
+	}
+
+	if (!channels ||
+	    (channels & ~BIT_MASK(ADC_STM32_CHANNEL_MAX + 1))) {
+		LOG_ERR("Invalid selection of channels");
+		return -EINVAL;
+	}
+
+	data->channel_count = popcount(channels);
+
+#if defined(CONFIG_SOC_SERIES_STM32L4X)
+	if (data->channel_count > ARRAY_SIZE(rank_tbl)) {
+		LOG_ERR("Too many channels");
+		return -EINVAL;
+	}
+#endif
+
+	if (oversampling > ADC_STM32_OVERSAMPLING_MAX) {
+		LOG_ERR("Invalid oversampling");
+		return -EINVAL;
+	}
+
+	error = check_buffer_size(sequence, data->channel_count);
+	if (error) {
+		return error;
+	}
+
+	/* The resolution and the oversampler can only be changed while
+	 * the ADC is disabled, which takes a new stabilization time, so it
+	 * is only done when they change.
+	 */
+	if (sequence->resolution != data->resolution ||
+	    oversampling != data->oversampling) {
+		adc_stm32_disable(adc);
+
+		LL_ADC_SetResolution(adc, resolution);
+
+		if (oversampling) {
+			/* 2^n conversions are accumulated by the hardware,
+			 * and the sum is shifted right by n bits.
+			 */
+			LL_ADC_SetOverSamplingScope(adc,
+					LL_ADC_OVS_GRP_REGULAR_CONTINUED);
+			LL_ADC_ConfigOverSamplingRatioShift(adc,
+				(oversampling - 1) << ADC_CFGR2_OVSR_Pos,
+				oversampling << ADC_CFGR2_OVSS_Pos);
+		} else {
+			LL_ADC_SetOverSamplingScope(adc, LL_ADC_OVS_DISABLE);
+		}
+
+		data->resolution = sequence->resolution;
+		data->oversampling = oversampling;
+	}
+
+	adc_stm32_enable(adc);
+	adc_stm32_setup_sequencer(adc, data, channels);
+
+	data->buffer = sequence->buffer;
+
+	adc_context_start_read(&data->ctx, sequence);
+
+	return adc_context_wait_for_completion(&data->ctx);
+}
+
+static void adc_context_start_sampling(struct adc_context *ctx)
+{
+	struct adc_stm32_data *data =
+		CONTAINER_OF(ctx, struct adc_stm32_data, ctx);
+	const struct adc_stm32_cfg *config = data->dev->config->config_info;
+	ADC_TypeDef *adc = config->base;
+
+	data->repeat_buffer = data->buffer;
+
+#ifdef CONFIG_ADC_STM32_DMA
+	LL_DMA_DisableChannel(DMA1, ADC_STM32_DMA_CHANNEL);
+	LL_DMA_SetMemoryAddress(DMA1, ADC_STM32_DMA_CHANNEL,
+				(u32_t)data->buffer);
+	LL_DMA_SetDataLength(DMA1, ADC_STM32_DMA_CHANNEL,
+			     data->channel_count);
+	LL_DMA_EnableChannel(DMA1, ADC_STM32_DMA_CHANNEL);
+
+	/* DMA requests stop after each sequence in one shot mode, they
+	 * are enabled again for the next one.
+	 */
+	LL_ADC_REG_SetDMATransfer(adc, LL_ADC_REG_DMA_TRANSFER_NONE);
+	LL_ADC_REG_SetDMATransfer(adc, LL_ADC_REG_DMA_TRANSFER_LIMITED);
+#endif
+
+	LL_ADC_REG_StartConversion(adc);
+}
+
+static void adc_context_update_buffer_pointer(struct adc_context *ctx,
+					      bool repeat_sampling)
+{
+	struct adc_stm32_data *data =
+		CONTAINER_OF(ctx, struct adc_stm32_data, ctx);
+
+	if (repeat_sampling) {
+		data->buffer = data->repeat_buffer;
+	}
+}
+
+#ifdef CONFIG_ADC_STM32_DMA
+static void adc_stm32_dma_isr(void *arg)
+{
+	struct device *dev = (struct device *)arg;
+	struct adc_stm32_data *data = dev->driver_data;
+
+	if (LL_DMA_IsActiveFlag_TE1(DMA1)) {
+		LL_DMA_ClearFlag_GI1(DMA1);
+		LOG_ERR("DMA transfer error");
+		adc_context_complete(&data->ctx, -EIO);
+		return;
+	}
+
+	if (LL_DMA_IsActiveFlag_TC1(DMA1)) {
+		LL_DMA_ClearFlag_GI1(DMA1);
+
+		data->buffer += data->channel_count;
+		adc_context_on_sampling_done(&data->ctx, dev);
+	}
+}
+#else
+static void adc_stm32_isr(void *arg)
+{
+	struct device *dev = (struct device *)arg;
+	const struct adc_stm32_cfg *config = dev->config->config_info;
+	struct adc_stm32_data *data = dev->driver_data;
+	ADC_TypeDef *adc = config->base;
+
+	/* Reading the result clears the flag. */
+	if (LL_ADC_IsActiveFlag_EOC(adc)) {
+		*data->buffer++ = LL_ADC_REG_ReadConversionData32(adc);
+	}
+
+	if (LL_ADC_IsActiveFlag_EOS(adc)) {
+		LL_ADC_ClearFlag_EOS(adc);
+		adc_context_on_sampling_done(&data->ctx, dev);
+	}
+}
+#endif /* CONFIG_ADC_STM32_DMA */
+
+static int adc_stm32_read(struct device *dev,
+			  const struct adc_sequence *sequence)
+{
+	struct adc_stm32_data *data = dev->driver_data;
+	int error;
+
+	adc_context_lock(&data->ctx, false, NULL);
+	error = start_read(dev, sequence);
+	adc_context_release(&data->ctx, error);
+
+	return error;
+}
+
+#ifdef CONFIG_ADC_ASYNC
+static int adc_stm32_read_async(struct device *dev,
+				const struct adc_sequence *sequence,
+				struct k_poll_signal *async)
+{
+	struct adc_stm32_data *data = dev->driver_data;
+	int error;
+
+	adc_context_lock(&data->ctx, true, async);
+	error = start_read(dev, sequence);
+	adc_context_release(&data->ctx, error);
+
+	return error;
+}
+#endif
+
+static int adc_stm32_init(struct device *dev)
+{
+	const struct adc_stm32_cfg *config = dev->config->config_info;
+	struct adc_stm32_data *data = dev->driver_data;
+	struct device *clk = device_get_binding(STM32_CLOCK_CONTROL_NAME);
+	ADC_TypeDef *adc = config->base;
+#ifdef CONFIG_ADC_STM32_DMA
+	struct stm32_pclken dma_pclken = {
+		.bus = STM32_CLOCK_BUS_AHB1,
+		.enr = LL_AHB1_GRP1_PERIPH_DMA1,
+	};
+#endif
+
+	data->dev = dev;
+
+	if (clock_control_on(clk,
+		(clock_control_subsys_t *)&config->pclken) != 0) {
+		return -EIO;
+	}
+
+#if defined(CONFIG_SOC_SERIES_STM32L0X)
+	/* The VREFINT and temperature sensor buffers are in SYSCFG. */
+	LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_SYSCFG);
+
+	LL_ADC_SetClock(adc, LL_ADC_CLOCK_SYNC_PCLK_DIV4);
+	LL_ADC_EnableInternalRegulator(adc);
+	k_busy_wait(LL_ADC_DELAY_INTERNAL_REGUL_STAB_US);
+
+	LL_ADC_StartCalibration(adc);
+#else
+	LL_ADC_SetCommonClock(__LL_ADC_COMMON_INSTANCE(adc),
+			      LL_ADC_CLOCK_SYNC_PCLK_DIV4);
+	LL_ADC_DisableDeepPowerDown(adc);
+	LL_ADC_EnableInternalRegulator(adc);
+	k_busy_wait(LL_ADC_DELAY_INTERNAL_REGUL_STAB_US);
+
+	LL_ADC_StartCalibration(adc, LL_ADC_SINGLE_ENDED);
+#endif
+	while (LL_ADC_IsCalibrationOnGoing(adc)) {
+	}
+
+	/* A few ADC clock cycles are needed between the end of the
+	 * calibration and the enabling of the ADC.
+	 */
+	k_busy_wait(10);
+
+	LL_ADC_REG_SetOverrun(adc, LL_ADC_REG_OVR_DATA_OVERWRITTEN);
+
+#ifdef CONFIG_ADC_STM32_DMA
+	if (clock_control_on(clk, (clock_control_subsys_t *)&dma_pclken)) {
+		return -EIO;
+	}
+
+	LL_DMA_SetPeriphRequest(DMA1, ADC_STM32_DMA_CHANNEL,
+				LL_DMA_REQUEST_0);
+	LL_DMA_ConfigTransfer(DMA1, ADC_STM32_DMA_CHANNEL,
+			      LL_DMA_DIRECTION_PERIPH_TO_MEMORY |
+			      LL_DMA_MODE_NORMAL |
+			      LL_DMA_PERIPH_NOINCREMENT |
+			      LL_DMA_MEMORY_INCREMENT |
+			      LL_DMA_PDATAALIGN_HALFWORD |
+			      LL_DMA_MDATAALIGN_HALFWORD |
+			      LL_DMA_PRIORITY_HIGH);
+	LL_DMA_SetPeriphAddress(DMA1, ADC_STM32_DMA_CHANNEL,
+			LL_ADC_DMA_GetRegAddr(adc,
+					      LL_ADC_DMA_REG_REGULAR_DATA));
+	LL_DMA_EnableIT_TC(DMA1, ADC_STM32_DMA_CHANNEL);
+	LL_DMA_EnableIT_TE(DMA1, ADC_STM32_DMA_CHANNEL);
+#else
+	/* The next conversion waits for the result of the previous one
+	 * to be read, so that none is lost when interrupts are late.
+	 */
+	LL_ADC_SetLowPowerMode(adc, LL_ADC_LP_AUTOWAIT);
+	LL_ADC_EnableIT_EOC(adc);
+	LL_ADC_EnableIT_EOS(adc);
+#endif
+
+	config->irq_cfg_func();
+
+	adc_context_unlock_unconditionally(&data->ctx);
+
+	return 0;
+}
+
+static const struct adc_driver_api adc_stm32_driver_api = {
+	.channel_setup = adc_stm32_channel_setup,
+	.read = adc_stm32_read,
+#ifdef CONFIG_ADC_ASYNC
+	.read_async = adc_stm32_read_async,
+#endif
+};
+
+#ifdef CONFIG_ADC_1
+static void adc_stm32_cfg_func_1(void);
+
+static const struct adc_stm32_cfg adc_stm32_cfg_1 = {
+	.base = (ADC_TypeDef *)DT_ADC_1_BASE_ADDRESS,
+	.pclken = {
+		.enr = DT_ADC_1_CLOCK_BITS,
+		.bus = DT_ADC_1_CLOCK_BUS,
+	},
+	.irq_cfg_func = adc_stm32_cfg_func_1,
+};
+
+static struct adc_stm32_data adc_stm32_data_1 = {
+	ADC_CONTEXT_INIT_TIMER(adc_stm32_data_1, ctx),
+	ADC_CONTEXT_INIT_LOCK(adc_stm32_data_1, ctx),
+	ADC_CONTEXT_INIT_SYNC(adc_stm32_data_1, ctx),
+};
+
+DEVICE_AND_API_INIT(adc_stm32_1, DT_ADC_1_NAME, &adc_stm32_init,
+		    &adc_stm32_data_1, &adc_stm32_cfg_1,
+		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    &adc_stm32_driver_api);
+
+static void adc_stm32_cfg_func_1(void)
+{
+#ifdef CONFIG_ADC_STM32_DMA
+	IRQ_CONNECT(ADC_STM32_DMA_IRQ, DT_ADC_1_IRQ_PRI,
+		    adc_stm32_dma_isr, DEVICE_GET(adc_stm32_1), 0);
+	irq_enable(ADC_STM32_DMA_IRQ);
+#else
+	IRQ_CONNECT(DT_ADC_1_IRQ, DT_ADC_1_IRQ_PRI,
+		    adc_stm32_isr, DEVICE_GET(adc_stm32_1), 0);
+	irq_enable(DT_ADC_1_IRQ);
+#endif
+}
+#endif /* CONFIG_ADC_1 */
@@ -46,9 +46,16 @@ int i2c_stm32_runtime_configure(struct device *dev, u32_t config)
 	data->dev_config = config;
 
 	k_sem_take(&data->bus_mutex, K_FOREVER);
+	ret = device_pm_get_sync(dev);
+	if (ret < 0) {
+		k_sem_give(&data->bus_mutex);
+		return ret;
+	}
+
 	LL_I2C_Disable(i2c);
 	LL_I2C_SetMode(i2c, LL_I2C_MODE_I2C);
 	ret = stm32_i2c_configure_timing(dev, clock);
+	(void)device_pm_put(dev);
 	k_sem_give(&data->bus_mutex);
 
 	return ret;
@@ -118,6 +125,12 @@ static int i2c_stm32_transfer(struct device *dev, struct i2c_msg *msg,
 
 	/* Send out messages */
 	k_sem_take(&data->bus_mutex, K_FOREVER);
+	ret = device_pm_get_sync(dev);
+	if (ret < 0) {
+		k_sem_give(&data->bus_mutex);
+		return ret;
+	}
+
 #if defined(CONFIG_I2C_STM32_V1)
 	LL_I2C_Enable(i2c);
 #endif
@@ -150,6 +163,7 @@ static int i2c_stm32_transfer(struct device *dev, struct i2c_msg *msg,
 #if defined(CONFIG_I2C_STM32_V1)
 	LL_I2C_Disable(i2c);
 #endif
+	(void)device_pm_put(dev);
 	k_sem_give(&data->bus_mutex);
 	return ret;
 }
@@ -163,6 +177,54 @@ static const struct i2c_driver_api api_funcs = {
 #endif
 };
 
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+/* The registers of the I2C are kept while its clock is gated */
+static int i2c_stm32_set_power_state(struct device *dev, u32_t new_state)
+{
+	const struct i2c_stm32_config *cfg = DEV_CFG(dev);
+	struct i2c_stm32_data *data = DEV_DATA(dev);
+	struct device *clock = device_get_binding(STM32_CLOCK_CONTROL_NAME);
+	int ret;
+
+	if (new_state == DEVICE_PM_ACTIVE_STATE) {
+		ret = clock_control_on(clock,
+				       (clock_control_subsys_t *) &cfg->pclken);
+	} else {
+		ret = clock_control_off(clock,
+					(clock_control_subsys_t *) &cfg->pclken);
+	}
+
+	if (ret) {
+		LOG_ERR("i2c: failure gating clock");
+		return -EIO;
+	}
+
+	data->pm_state = new_state;
+
+	return 0;
+}
+
+static int i2c_stm32_pm_control(struct device *dev, u32_t ctrl_command,
+				void *context)
+{
+	struct i2c_stm32_data *data = DEV_DATA(dev);
+	int ret = 0;
+
+	if (ctrl_command == DEVICE_PM_SET_POWER_STATE) {
+		u32_t new_state = *((const u32_t *)context);
+
+		if (new_state != data->pm_state) {
+			ret = i2c_stm32_set_power_state(dev, new_state);
+		}
+	} else {
+		__ASSERT_NO_MSG(ctrl_command == DEVICE_PM_GET_POWER_STATE);
+		*((u32_t *)context) = data->pm_state;
+	}
+
+	return ret;
+}
+#endif /* CONFIG_DEVICE_POWER_MANAGEMENT */
+
 static int i2c_stm32_init(struct device *dev)
 {
 	struct device *clock = device_get_binding(STM32_CLOCK_CONTROL_NAME);
@@ -219,6 +281,11 @@ static int i2c_stm32_init(struct device *dev)
 
 	bitrate_cfg = _i2c_map_dt_bitrate(cfg->bitrate);
 
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+	data->pm_state = DEVICE_PM_ACTIVE_STATE;
+#endif
+	device_pm_enable(dev);
+
 	ret = i2c_stm32_runtime_configure(dev, I2C_MODE_MASTER | bitrate_cfg);
 	if (ret < 0) {
 		LOG_ERR("i2c: failure initializing");
@@ -248,10 +315,10 @@ static const struct i2c_stm32_config i2c_stm32_cfg_1 = {
 
 static struct i2c_stm32_data i2c_stm32_dev_data_1;
 
-DEVICE_AND_API_INIT(i2c_stm32_1, CONFIG_I2C_1_NAME, &i2c_stm32_init,
-		    &i2c_stm32_dev_data_1, &i2c_stm32_cfg_1,
-		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
-		    &api_funcs);
+DEVICE_DEFINE(i2c_stm32_1, CONFIG_I2C_1_NAME, &i2c_stm32_init,
+	      i2c_stm32_pm_control, &i2c_stm32_dev_data_1,
+	      &i2c_stm32_cfg_1, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &api_funcs);
 
 #ifdef CONFIG_I2C_STM32_INTERRUPT
 static void i2c_stm32_irq_config_func_1(struct device *dev)
@@ -294,10 +361,10 @@ static const struct i2c_stm32_config i2c_stm32_cfg_2 = {
 
 static struct i2c_stm32_data i2c_stm32_dev_data_2;
 
-DEVICE_AND_API_INIT(i2c_stm32_2, CONFIG_I2C_2_NAME, &i2c_stm32_init,
-		    &i2c_stm32_dev_data_2, &i2c_stm32_cfg_2,
-		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
-		    &api_funcs);
+DEVICE_DEFINE(i2c_stm32_2, CONFIG_I2C_2_NAME, &i2c_stm32_init,
+	      i2c_stm32_pm_control, &i2c_stm32_dev_data_2,
+	      &i2c_stm32_cfg_2, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &api_funcs);
 
 #ifdef CONFIG_I2C_STM32_INTERRUPT
 static void i2c_stm32_irq_config_func_2(struct device *dev)
@@ -344,10 +411,10 @@ static const struct i2c_stm32_config i2c_stm32_cfg_3 = {
 
 static struct i2c_stm32_data i2c_stm32_dev_data_3;
 
-DEVICE_AND_API_INIT(i2c_stm32_3, CONFIG_I2C_3_NAME, &i2c_stm32_init,
-		    &i2c_stm32_dev_data_3, &i2c_stm32_cfg_3,
-		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
-		    &api_funcs);
+DEVICE_DEFINE(i2c_stm32_3, CONFIG_I2C_3_NAME, &i2c_stm32_init,
+	      i2c_stm32_pm_control, &i2c_stm32_dev_data_3,
+	      &i2c_stm32_cfg_3, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &api_funcs);
 
 #ifdef CONFIG_I2C_STM32_INTERRUPT
 static void i2c_stm32_irq_config_func_3(struct device *dev)
@@ -388,10 +455,10 @@ static const struct i2c_stm32_config i2c_stm32_cfg_4 = {
 
 static struct i2c_stm32_data i2c_stm32_dev_data_4;
 
-DEVICE_AND_API_INIT(i2c_stm32_4, CONFIG_I2C_4_NAME, &i2c_stm32_init,
-		    &i2c_stm32_dev_data_4, &i2c_stm32_cfg_4,
-		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
-		    &api_funcs);
+DEVICE_DEFINE(i2c_stm32_4, CONFIG_I2C_4_NAME, &i2c_stm32_init,
+	      i2c_stm32_pm_control, &i2c_stm32_dev_data_4,
+	      &i2c_stm32_cfg_4, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &api_funcs);
 
 #ifdef CONFIG_I2C_STM32_INTERRUPT
 static void i2c_stm32_irq_config_func_4(struct device *dev)
@@ -47,6 +47,9 @@ struct i2c_stm32_data {
 	struct i2c_slave_config *slave_cfg;
 	bool slave_attached;
 #endif
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+	u32_t pm_state;
+#endif
 };
 
 s32_t stm32_i2c_msg_write(struct device *dev, struct i2c_msg *msg, u8_t *flg,
@@ -203,6 +203,12 @@ int i2c_stm32_slave_register(struct device *dev,
 		return ret;
 	}
 
+	/* Held active until the slave is unregistered */
+	ret = device_pm_get_sync(dev);
+	if (ret < 0) {
+		return ret;
+	}
+
 	data->slave_cfg = config;
 
 	LL_I2C_Enable(i2c);
@@ -246,6 +252,9 @@ int i2c_stm32_slave_unregister(struct device *dev,
 
 	LL_I2C_Disable(i2c);
 
+	data->slave_attached = false;
+	(void)device_pm_put(dev);
+
 	LOG_DBG("i2c: slave unregistered");
 
 	return 0;
@@ -59,6 +59,33 @@ static int hts221_channel_get(struct device *dev,
 	return 0;
 }
 
+static int hts221_channel_get_raw(struct device *dev,
+				  enum sensor_channel chan,
+				  s32_t *raw, struct sensor_scale *scale)
+{
+	struct hts221_data *drv_data = dev->driver_data;
+
+	if (chan == SENSOR_CHAN_AMBIENT_TEMP) {
+		if (raw) {
+			*raw = drv_data->t_sample;
+		}
+		if (scale) {
+			*scale = drv_data->t_scale;
+		}
+	} else if (chan == SENSOR_CHAN_HUMIDITY) {
+		if (raw) {
+			*raw = drv_data->rh_sample;
+		}
+		if (scale) {
+			*scale = drv_data->rh_scale;
+		}
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static int hts221_sample_fetch(struct device *dev, enum sensor_channel chan)
 {
 	struct hts221_data *drv_data = dev->driver_data;
@@ -79,6 +106,20 @@ static int hts221_sample_fetch(struct device *dev, enum sensor_channel chan)
 	return 0;
 }
 
+/*
+ * Scale of the raw readings interpolating linearly between the calibration
+ * points (x0, y0) and (x1, y1), y being in units of @a unit micro units.
+ */
+static void hts221_calib_scale(struct sensor_scale *scale, s32_t y0,
+			       s32_t y1, s16_t x0, s16_t x1, s32_t unit)
+{
+	scale->mult = ((s64_t)(y1 - y0) * unit << HTS221_RAW_SHIFT) /
+		      (x1 - x0);
+	scale->shift = HTS221_RAW_SHIFT;
+	scale->offset = y0 * unit -
+			(((s64_t)x0 * scale->mult) >> HTS221_RAW_SHIFT);
+}
+
 static int hts221_read_conversion_data(struct hts221_data *drv_data)
 {
 	u8_t buf[16];
@@ -99,6 +140,20 @@ static int hts221_read_conversion_data(struct hts221_data *drv_data)
 	drv_data->t0_out = sys_le16_to_cpu(buf[12] | (buf[13] << 8));
 	drv_data->t1_out = sys_le16_to_cpu(buf[14] | (buf[15] << 8));
 
+	if (drv_data->h1_t0_out == drv_data->h0_t0_out ||
+	    drv_data->t1_out == drv_data->t0_out) {
+		LOG_ERR("Invalid conversion data.");
+		return -EINVAL;
+	}
+
+	/* temperature x8 and humidity x2 to micro units */
+	hts221_calib_scale(&drv_data->t_scale, drv_data->t0_degc_x8,
+			   drv_data->t1_degc_x8, drv_data->t0_out,
+			   drv_data->t1_out, 1000000 / 8);
+	hts221_calib_scale(&drv_data->rh_scale, drv_data->h0_rh_x2,
+			   drv_data->h1_rh_x2, drv_data->h0_t0_out,
+			   drv_data->h1_t0_out, 1000000 / 2);
+
 	return 0;
 }
 
@@ -108,6 +163,7 @@ static const struct sensor_driver_api hts221_driver_api = {
 #endif
 	.sample_fetch = hts221_sample_fetch,
 	.channel_get = hts221_channel_get,
+	.channel_get_raw = hts221_channel_get_raw,
 };
 
 int hts221_init(struct device *dev)
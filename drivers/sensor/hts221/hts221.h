@@ -28,6 +28,9 @@
 #define HTS221_REG_DATA_START		0x28
 #define HTS221_REG_CONVERSION_START	0x30
 
+/* Fractional bits of the scale of the raw samples */
+#define HTS221_RAW_SHIFT		8
+
 struct hts221_data {
 	struct device *i2c;
 	s16_t rh_sample;
@@ -42,6 +45,10 @@ struct hts221_data {
 	s16_t t0_out;
 	s16_t t1_out;
 
+	/* scale of the raw samples, from the conversion data */
+	struct sensor_scale t_scale;
+	struct sensor_scale rh_scale;
+
 #ifdef CONFIG_HTS221_TRIGGER
 	struct device *gpio;
 	struct gpio_callback gpio_cb;
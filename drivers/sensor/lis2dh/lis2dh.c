@@ -88,32 +88,43 @@ static void lis2dh_convert(s16_t raw_val, u16_t scale,
 	}
 }
 
-static int lis2dh_channel_get(struct device *dev,
-			      enum sensor_channel chan,
-			      struct sensor_value *val)
+static int lis2dh_channel_axes(enum sensor_channel chan, int *ofs_start,
+			       int *ofs_end)
 {
-	struct lis2dh_data *lis2dh = dev->driver_data;
-	int ofs_start;
-	int ofs_end;
-	int i;
-
 	switch (chan) {
 	case SENSOR_CHAN_ACCEL_X:
-		ofs_start = ofs_end = 0;
+		*ofs_start = *ofs_end = 0;
 		break;
 	case SENSOR_CHAN_ACCEL_Y:
-		ofs_start = ofs_end = 1;
+		*ofs_start = *ofs_end = 1;
 		break;
 	case SENSOR_CHAN_ACCEL_Z:
-		ofs_start = ofs_end = 2;
+		*ofs_start = *ofs_end = 2;
 		break;
 	case SENSOR_CHAN_ACCEL_XYZ:
-		ofs_start = 0;
-		ofs_end = 2;
+		*ofs_start = 0;
+		*ofs_end = 2;
 		break;
 	default:
 		return -ENOTSUP;
 	}
+
+	return 0;
+}
+
+static int lis2dh_channel_get(struct device *dev,
+			      enum sensor_channel chan,
+			      struct sensor_value *val)
+{
+	struct lis2dh_data *lis2dh = dev->driver_data;
+	int ofs_start;
+	int ofs_end;
+	int i;
+
+	if (lis2dh_channel_axes(chan, &ofs_start, &ofs_end) < 0) {
+		return -ENOTSUP;
+	}
+
 	for (i = ofs_start; i <= ofs_end; i++, val++) {
 		lis2dh_convert(lis2dh->sample.xyz[i], lis2dh->scale, val);
 	}
@@ -121,6 +132,35 @@ static int lis2dh_channel_get(struct device *dev,
 	return 0;
 }
 
+static int lis2dh_channel_get_raw(struct device *dev,
+				  enum sensor_channel chan,
+				  s32_t *raw, struct sensor_scale *scale)
+{
+	struct lis2dh_data *lis2dh = dev->driver_data;
+	int ofs_start;
+	int ofs_end;
+	int i;
+
+	if (lis2dh_channel_axes(chan, &ofs_start, &ofs_end) < 0) {
+		return -ENOTSUP;
+	}
+
+	if (raw) {
+		for (i = ofs_start; i <= ofs_end; i++) {
+			*raw++ = lis2dh->sample.xyz[i];
+		}
+	}
+
+	if (scale) {
+		/* same scale as lis2dh_convert(), in um/s^2/LSB */
+		scale->mult = lis2dh->scale;
+		scale->shift = 0;
+		scale->offset = 0;
+	}
+
+	return 0;
+}
+
 static int lis2dh_sample_fetch(struct device *dev, enum sensor_channel chan)
 {
 	struct lis2dh_data *lis2dh = dev->driver_data;
@@ -162,11 +202,13 @@ static int lis2dh_sample_fetch(struct device *dev, enum sensor_channel chan)
 	return -ENODATA;
 }
 
-#ifdef CONFIG_LIS2DH_ODR_RUNTIME
+#if defined(CONFIG_LIS2DH_ODR_RUNTIME) || defined(CONFIG_LIS2DH_FIFO)
 /* 1620 & 5376 are low power only */
 static const u16_t lis2dh_odr_map[] = {0, 1, 10, 25, 50, 100, 200, 400, 1620,
 				       1344, 5376};
+#endif
 
+#ifdef CONFIG_LIS2DH_ODR_RUNTIME
 static int lis2dh_freq_to_odr_val(u16_t freq)
 {
 	size_t i;
@@ -187,6 +229,9 @@ static int lis2dh_freq_to_odr_val(u16_t freq)
 
 static int lis2dh_acc_odr_set(struct device *dev, u16_t freq)
 {
+#ifdef CONFIG_LIS2DH_FIFO
+	struct lis2dh_data *lis2dh = dev->driver_data;
+#endif
 	int odr;
 	int status;
 	u8_t value;
@@ -212,9 +257,18 @@ static int lis2dh_acc_odr_set(struct device *dev, u16_t freq)
 		odr--;
 	}
 
-	return lis2dh_reg_write_byte(dev, LIS2DH_REG_CTRL1,
-				  (value & ~LIS2DH_ODR_MASK) |
-				  LIS2DH_ODR_RATE(odr));
+	status = lis2dh_reg_write_byte(dev, LIS2DH_REG_CTRL1,
+				       (value & ~LIS2DH_ODR_MASK) |
+				       LIS2DH_ODR_RATE(odr));
+	if (status < 0) {
+		return status;
+	}
+
+#ifdef CONFIG_LIS2DH_FIFO
+	lis2dh->freq = freq;
+#endif
+
+	return 0;
 }
 #endif
 
@@ -303,6 +357,94 @@ static int lis2dh_attr_set(struct device *dev, enum sensor_channel chan,
 	return 0;
 }
 
+#ifdef CONFIG_LIS2DH_FIFO
+static int lis2dh_fifo_read(struct device *dev,
+			    enum sensor_frame_format format,
+			    void *frames, size_t max_frames)
+{
+	struct lis2dh_data *lis2dh = dev->driver_data;
+	u32_t now = (u32_t)(k_uptime_get() * USEC_PER_MSEC);
+	u32_t period = 0U;
+	u32_t timestamp;
+	size_t count;
+	size_t i;
+	int status;
+	u8_t fifo_src;
+	u8_t *sample;
+	s16_t xyz[3];
+	int axis;
+
+	status = lis2dh_reg_read_byte(dev, LIS2DH_REG_FIFO_SRC, &fifo_src);
+	if (status < 0) {
+		return status;
+	}
+
+	if (fifo_src & LIS2DH_FIFO_SRC_EMPTY) {
+		return 0;
+	}
+
+	/* the level only counts up to 31, a full FIFO flags an overrun */
+	if (fifo_src & LIS2DH_FIFO_SRC_OVRN) {
+		count = LIS2DH_FIFO_SIZE;
+	} else {
+		count = fifo_src & LIS2DH_FIFO_SRC_FSS_MASK;
+	}
+
+	count = min(count, max_frames);
+	if (count == 0) {
+		return 0;
+	}
+
+	/*
+	 * when the FIFO is enabled, the address rolls back from the last
+	 * data register to the first one, so the whole batch is drained
+	 * with a single burst read
+	 */
+	status = lis2dh_burst_read(dev, LIS2DH_REG_ACCEL_X_LSB,
+				   lis2dh->fifo_buf,
+				   count * LIS2DH_FIFO_SAMPLE_SZ);
+	if (status < 0) {
+		LOG_WRN("Could not read FIFO data");
+		return status;
+	}
+
+	if (lis2dh->freq) {
+		period = USEC_PER_SEC / lis2dh->freq;
+	}
+
+	for (i = 0; i < count; i++) {
+		sample = &lis2dh->fifo_buf[i * LIS2DH_FIFO_SAMPLE_SZ];
+		timestamp = now - (count - 1 - i) * period;
+
+		for (axis = 0; axis < 3; axis++) {
+			xyz[axis] = (s16_t)((u16_t)sample[2 * axis] |
+					    ((u16_t)sample[2 * axis + 1] << 8));
+		}
+
+		if (format == SENSOR_FRAME_RAW) {
+			struct sensor_frame_raw *frame =
+				&((struct sensor_frame_raw *)frames)[i];
+
+			frame->timestamp = timestamp;
+			frame->chan = SENSOR_CHAN_ACCEL_XYZ;
+			memcpy(frame->val, xyz, sizeof(frame->val));
+		} else {
+			struct sensor_frame *frame =
+				&((struct sensor_frame *)frames)[i];
+
+			frame->timestamp = timestamp;
+			frame->chan = SENSOR_CHAN_ACCEL_XYZ;
+			for (axis = 0; axis < 3; axis++) {
+				lis2dh_convert(xyz[axis], lis2dh->scale,
+					       &frame->val[axis]);
+			}
+		}
+	}
+
+	return count;
+}
+#endif
+
 static const struct sensor_driver_api lis2dh_driver_api = {
 	.attr_set = lis2dh_attr_set,
 #if CONFIG_LIS2DH_TRIGGER
@@ -310,6 +452,10 @@ static const struct sensor_driver_api lis2dh_driver_api = {
 #endif
 	.sample_fetch = lis2dh_sample_fetch,
 	.channel_get = lis2dh_channel_get,
+#ifdef CONFIG_LIS2DH_FIFO
+	.fifo_read = lis2dh_fifo_read,
+#endif
+	.channel_get_raw = lis2dh_channel_get_raw,
 };
 
 int lis2dh_init(struct device *dev)
@@ -347,6 +493,29 @@ int lis2dh_init(struct device *dev)
 		return status;
 	}
 
+#ifdef CONFIG_LIS2DH_FIFO
+	/* the 5kHz rate of the low power mode is stored after 1.25kHz */
+	if (LIS2DH_LP_EN_BIT && LIS2DH_ODR_IDX == LIS2DH_ODR_9) {
+		lis2dh->freq = lis2dh_odr_map[LIS2DH_ODR_IDX + 1];
+	} else {
+		lis2dh->freq = lis2dh_odr_map[LIS2DH_ODR_IDX];
+	}
+
+	status = lis2dh_reg_write_byte(dev, LIS2DH_REG_CTRL5,
+				       LIS2DH_FIFO_EN_BIT);
+	if (status < 0) {
+		LOG_ERR("Failed to enable FIFO.");
+		return status;
+	}
+
+	status = lis2dh_reg_write_byte(dev, LIS2DH_REG_FIFO_CTRL,
+				       LIS2DH_FIFO_MODE_STREAM);
+	if (status < 0) {
+		LOG_ERR("Failed to set FIFO mode.");
+		return status;
+	}
+#endif
+
 #ifdef CONFIG_LIS2DH_TRIGGER
 	status = lis2dh_init_interrupt(dev);
 	if (status < 0) {
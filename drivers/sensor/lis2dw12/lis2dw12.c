@@ -142,6 +142,47 @@ static int lis2dw12_channel_get(struct device *dev,
 	return -ENOTSUP;
 }
 
+/* Fractional bits of the scale of the raw readings */
+#define LIS2DW12_RAW_SHIFT	8
+
+static int lis2dw12_channel_get_raw(struct device *dev,
+				    enum sensor_channel chan,
+				    s32_t *raw, struct sensor_scale *scale)
+{
+	struct lis2dw12_data *lis2dw12 = dev->driver_data;
+	int i;
+
+	switch (chan) {
+	case SENSOR_CHAN_ACCEL_X:
+	case SENSOR_CHAN_ACCEL_Y:
+	case SENSOR_CHAN_ACCEL_Z:
+		if (raw) {
+			*raw = lis2dw12->acc[chan - SENSOR_CHAN_ACCEL_X];
+		}
+		break;
+	case SENSOR_CHAN_ACCEL_XYZ:
+		if (raw) {
+			for (i = 0; i < 3; i++) {
+				raw[i] = lis2dw12->acc[i];
+			}
+		}
+		break;
+	default:
+		LOG_DBG("Channel not supported");
+		return -ENOTSUP;
+	}
+
+	if (scale) {
+		/* Gain is in ug/LSB, convert to um/s^2/LSB */
+		scale->mult = ((s64_t)lis2dw12->gain * SENSOR_G <<
+			       LIS2DW12_RAW_SHIFT) / 1000000LL;
+		scale->shift = LIS2DW12_RAW_SHIFT;
+		scale->offset = 0;
+	}
+
+	return 0;
+}
+
 static int lis2dw12_config(struct device *dev, enum sensor_channel chan,
 			    enum sensor_attribute attr,
 			    const struct sensor_value *val)
@@ -226,6 +267,7 @@ static const struct sensor_driver_api lis2dw12_driver_api = {
 #endif /* CONFIG_LIS2DW12_TRIGGER */
 	.sample_fetch = lis2dw12_sample_fetch,
 	.channel_get = lis2dw12_channel_get,
+	.channel_get_raw = lis2dw12_channel_get_raw,
 };
 
 static int lis2dw12_init_interface(struct device *dev)
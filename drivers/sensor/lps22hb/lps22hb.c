@@ -89,9 +89,41 @@ static int lps22hb_channel_get(struct device *dev,
 	return 0;
 }
 
+static int lps22hb_channel_get_raw(struct device *dev,
+				   enum sensor_channel chan,
+				   s32_t *raw, struct sensor_scale *scale)
+{
+	struct lps22hb_data *data = dev->driver_data;
+	struct sensor_scale chan_scale = { 0 };
+
+	if (chan == SENSOR_CHAN_PRESS) {
+		/* 4096 LSB/hPa, i.e. 100000 / 2^12 ukPa/LSB */
+		if (raw) {
+			*raw = data->sample_press;
+		}
+		chan_scale.mult = 100000;
+		chan_scale.shift = 12;
+	} else if (chan == SENSOR_CHAN_AMBIENT_TEMP) {
+		/* 100 LSB/deg C */
+		if (raw) {
+			*raw = data->sample_temp;
+		}
+		chan_scale.mult = 10000;
+	} else {
+		return -ENOTSUP;
+	}
+
+	if (scale) {
+		*scale = chan_scale;
+	}
+
+	return 0;
+}
+
 static const struct sensor_driver_api lps22hb_api_funcs = {
 	.sample_fetch = lps22hb_sample_fetch,
 	.channel_get = lps22hb_channel_get,
+	.channel_get_raw = lps22hb_channel_get_raw,
 };
 
 static int lps22hb_init_chip(struct device *dev)
@@ -131,6 +131,9 @@ static int lsm6dsl_accel_set_odr_raw(struct device *dev, u8_t odr)
 	}
 
 	data->accel_freq = lsm6dsl_odr_to_freq_val(odr);
+#ifdef CONFIG_LSM6DSL_FIFO
+	data->accel_odr = odr;
+#endif
 
 	return 0;
 }
@@ -169,9 +172,64 @@ static int lsm6dsl_gyro_set_odr_raw(struct device *dev, u8_t odr)
 		return -EIO;
 	}
 
+#ifdef CONFIG_LSM6DSL_FIFO
+	data->gyro_odr = odr;
+#endif
+
 	return 0;
 }
 
+#ifdef CONFIG_LSM6DSL_FIFO
+static int lsm6dsl_fifo_config(struct device *dev)
+{
+	struct lsm6dsl_data *data = dev->driver_data;
+	u8_t dec_xl = data->accel_odr ? LSM6DSL_FIFO_DEC_1 :
+					LSM6DSL_FIFO_DEC_NONE;
+	u8_t dec_gyro = data->gyro_odr ? LSM6DSL_FIFO_DEC_1 :
+					 LSM6DSL_FIFO_DEC_NONE;
+	u8_t odr = max(data->accel_odr, data->gyro_odr);
+
+	/* the FIFO is emptied while the data sets it stores are changed */
+	if (data->hw_tf->update_reg(data,
+			LSM6DSL_REG_FIFO_CTRL5,
+			LSM6DSL_MASK_FIFO_CTRL5_FIFO_MODE,
+			LSM6DSL_FIFO_MODE_BYPASS <<
+			LSM6DSL_SHIFT_FIFO_CTRL5_FIFO_MODE) < 0) {
+		return -EIO;
+	}
+
+	data->fifo_odr = 0U;
+
+	if (data->hw_tf->update_reg(data,
+			LSM6DSL_REG_FIFO_CTRL3,
+			LSM6DSL_MASK_FIFO_CTRL3_DEC_FIFO_GYRO |
+			LSM6DSL_MASK_FIFO_CTRL3_DEC_FIFO_XL,
+			(dec_gyro << LSM6DSL_SHIFT_FIFO_CTRL3_DEC_FIFO_GYRO) |
+			(dec_xl << LSM6DSL_SHIFT_FIFO_CTRL3_DEC_FIFO_XL)) < 0) {
+		return -EIO;
+	}
+
+	if (odr == 0) {
+		return 0;
+	}
+
+	/* the FIFO rates use the same coding as the sensor rates */
+	if (data->hw_tf->update_reg(data,
+			LSM6DSL_REG_FIFO_CTRL5,
+			LSM6DSL_MASK_FIFO_CTRL5_ODR_FIFO |
+			LSM6DSL_MASK_FIFO_CTRL5_FIFO_MODE,
+			(odr << LSM6DSL_SHIFT_FIFO_CTRL5_ODR_FIFO) |
+			(LSM6DSL_FIFO_MODE_CONTINUOUS <<
+			 LSM6DSL_SHIFT_FIFO_CTRL5_FIFO_MODE)) < 0) {
+		return -EIO;
+	}
+
+	data->fifo_odr = odr;
+
+	return 0;
+}
+#endif
+
 #ifdef LSM6DSL_ACCEL_ODR_RUNTIME
 static int lsm6dsl_accel_odr_set(struct device *dev, u16_t freq)
 {
@@ -187,6 +245,13 @@ static int lsm6dsl_accel_odr_set(struct device *dev, u16_t freq)
 		return -EIO;
 	}
 
+#ifdef CONFIG_LSM6DSL_FIFO
+	if (lsm6dsl_fifo_config(dev) < 0) {
+		LOG_DBG("failed to configure FIFO");
+		return -EIO;
+	}
+#endif
+
 	return 0;
 }
 #endif
@@ -249,6 +314,13 @@ static int lsm6dsl_gyro_odr_set(struct device *dev, u16_t freq)
 		return -EIO;
 	}
 
+#ifdef CONFIG_LSM6DSL_FIFO
+	if (lsm6dsl_fifo_config(dev) < 0) {
+		LOG_DBG("failed to configure FIFO");
+		return -EIO;
+	}
+#endif
+
 	return 0;
 }
 #endif
@@ -694,6 +766,253 @@ static int lsm6dsl_channel_get(struct device *dev,
 	return 0;
 }
 
+/* Fractional bits of the scale of the raw readings */
+#define LSM6DSL_RAW_SHIFT	16
+
+static int lsm6dsl_channel_get_raw(struct device *dev,
+				   enum sensor_channel chan,
+				   s32_t *raw, struct sensor_scale *scale)
+{
+	struct lsm6dsl_data *data = dev->driver_data;
+	s32_t sample[3];
+	int axis = 0;
+	/* one LSB is worth sensitivity * unit micro units */
+	float sensitivity;
+	double unit;
+	s32_t offset = 0;
+
+	switch (chan) {
+	case SENSOR_CHAN_ACCEL_X:
+	case SENSOR_CHAN_ACCEL_Y:
+	case SENSOR_CHAN_ACCEL_Z:
+	case SENSOR_CHAN_ACCEL_XYZ:
+		axis = chan - SENSOR_CHAN_ACCEL_X;
+		sample[0] = data->accel_sample_x;
+		sample[1] = data->accel_sample_y;
+		sample[2] = data->accel_sample_z;
+		/* mg/LSB to um/s^2/LSB */
+		sensitivity = data->accel_sensitivity;
+		unit = SENSOR_G / 1000.0;
+		break;
+	case SENSOR_CHAN_GYRO_X:
+	case SENSOR_CHAN_GYRO_Y:
+	case SENSOR_CHAN_GYRO_Z:
+	case SENSOR_CHAN_GYRO_XYZ:
+		axis = chan - SENSOR_CHAN_GYRO_X;
+		sample[0] = data->gyro_sample_x;
+		sample[1] = data->gyro_sample_y;
+		sample[2] = data->gyro_sample_z;
+		/* mdps/LSB to urad/s/LSB */
+		sensitivity = data->gyro_sensitivity;
+		unit = SENSOR_PI / 180.0 / 1000.0;
+		break;
+#if defined(CONFIG_LSM6DSL_ENABLE_TEMP)
+	case SENSOR_CHAN_DIE_TEMP:
+		/* val = temp_sample / 256 + 25 */
+		sample[0] = data->temp_sample;
+		sensitivity = 1.0f / 256;
+		unit = 1000000.0;
+		offset = 25000000;
+		break;
+#endif
+#if defined(CONFIG_LSM6DSL_EXT0_LIS2MDL)
+	case SENSOR_CHAN_MAGN_X:
+	case SENSOR_CHAN_MAGN_Y:
+	case SENSOR_CHAN_MAGN_Z:
+	case SENSOR_CHAN_MAGN_XYZ:
+		axis = chan - SENSOR_CHAN_MAGN_X;
+		sample[0] = data->magn_sample_x;
+		sample[1] = data->magn_sample_y;
+		sample[2] = data->magn_sample_z;
+		/* mgauss/LSB to ugauss/LSB */
+		sensitivity = data->magn_sensitivity;
+		unit = 1000.0;
+		break;
+#endif
+#if defined(CONFIG_LSM6DSL_EXT0_LPS22HB)
+	case SENSOR_CHAN_PRESS:
+		/* 4096 LSB/hPa to ukPa/LSB */
+		sample[0] = data->sample_press;
+		sensitivity = 1.0f / 4096;
+		unit = 100000.0;
+		break;
+	case SENSOR_CHAN_AMBIENT_TEMP:
+		/* 100 LSB/deg C to udeg C/LSB */
+		sample[0] = data->sample_temp;
+		sensitivity = 1.0f / 100;
+		unit = 1000000.0;
+		break;
+#endif
+	default:
+		return -ENOTSUP;
+	}
+
+	if (raw) {
+		if (axis == 3) {
+			memcpy(raw, sample, sizeof(sample));
+		} else {
+			*raw = sample[axis];
+		}
+	}
+
+	if (scale) {
+		scale->mult = (s32_t)(sensitivity * unit *
+				      (1 << LSM6DSL_RAW_SHIFT) + 0.5);
+		scale->shift = LSM6DSL_RAW_SHIFT;
+		scale->offset = offset;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_LSM6DSL_FIFO
+static void lsm6dsl_fifo_frame(struct lsm6dsl_data *data,
+			       enum sensor_frame_format format,
+			       void *frames, size_t index,
+			       enum sensor_channel chan, const u8_t *buf,
+			       u32_t timestamp)
+{
+	s16_t xyz[3];
+	int axis;
+
+	for (axis = 0; axis < 3; axis++) {
+		xyz[axis] = (s16_t)((u16_t)(buf[2 * axis]) |
+				    ((u16_t)(buf[2 * axis + 1]) << 8));
+	}
+
+	if (format == SENSOR_FRAME_RAW) {
+		struct sensor_frame_raw *frame =
+			&((struct sensor_frame_raw *)frames)[index];
+
+		frame->timestamp = timestamp;
+		frame->chan = chan;
+		memcpy(frame->val, xyz, sizeof(frame->val));
+	} else {
+		struct sensor_frame *frame =
+			&((struct sensor_frame *)frames)[index];
+
+		frame->timestamp = timestamp;
+		frame->chan = chan;
+		for (axis = 0; axis < 3; axis++) {
+			if (chan == SENSOR_CHAN_GYRO_XYZ) {
+				lsm6dsl_gyro_convert(&frame->val[axis],
+						     xyz[axis],
+						     data->gyro_sensitivity);
+			} else {
+				lsm6dsl_accel_convert(&frame->val[axis],
+						      xyz[axis],
+						      data->accel_sensitivity);
+			}
+		}
+	}
+}
+
+static int lsm6dsl_fifo_read(struct device *dev,
+			     enum sensor_frame_format format,
+			     void *frames, size_t max_frames)
+{
+	struct lsm6dsl_data *data = dev->driver_data;
+	u32_t now = (u32_t)(k_uptime_get() * USEC_PER_MSEC);
+	u32_t period;
+	u32_t timestamp;
+	u8_t status[4];
+	u8_t sets_per_burst;
+	u8_t set_words;
+	u8_t sensors;
+	u8_t *set;
+	u16_t pattern;
+	u16_t words;
+	u16_t skip;
+	size_t sets;
+	size_t done;
+	size_t burst;
+	size_t count = 0;
+	size_t i;
+
+	if (data->fifo_odr == 0) {
+		return 0;
+	}
+
+	/* FIFO_STATUS1 to FIFO_STATUS4 */
+	if (data->hw_tf->read_data(data, LSM6DSL_REG_FIFO_STATUS1,
+				   status, sizeof(status)) < 0) {
+		LOG_DBG("failed to read FIFO status");
+		return -EIO;
+	}
+
+	if (status[1] & LSM6DSL_MASK_FIFO_STATUS2_FIFO_EMPTY) {
+		return 0;
+	}
+
+	words = status[0] |
+		((status[1] & LSM6DSL_MASK_FIFO_STATUS2_DIFF_FIFO) << 8);
+	pattern = (status[2] & LSM6DSL_MASK_FIFO_STATUS3_FIFO_PATTERN) |
+		  ((status[3] & LSM6DSL_MASK_FIFO_STATUS4_FIFO_PATTERN) << 8);
+
+	/* the gyroscope data set comes first in the FIFO pattern */
+	sensors = (data->accel_odr ? 1 : 0) + (data->gyro_odr ? 1 : 0);
+	set_words = 3 * sensors;
+
+	/* drop the end of a data set left by an overrun */
+	skip = (set_words - pattern % set_words) % set_words;
+	if (skip > words) {
+		return 0;
+	}
+
+	if (skip) {
+		if (data->hw_tf->read_data(data, LSM6DSL_REG_FIFO_DATA_OUT_L,
+					   data->fifo_buf,
+					   skip * sizeof(u16_t)) < 0) {
+			LOG_DBG("failed to read FIFO data");
+			return -EIO;
+		}
+		words -= skip;
+	}
+
+	sets = min(words / set_words, max_frames / sensors);
+	sets_per_burst = LSM6DSL_FIFO_BURST_WORDS / set_words;
+	period = USEC_PER_SEC / lsm6dsl_odr_to_freq_val(data->fifo_odr);
+
+	/*
+	 * the address rolls back to FIFO_DATA_OUT_L after FIFO_DATA_OUT_H,
+	 * so each burst drains as many data sets as the buffer can hold
+	 */
+	for (done = 0; done < sets; done += burst) {
+		burst = min(sets - done, sets_per_burst);
+
+		if (data->hw_tf->read_data(data, LSM6DSL_REG_FIFO_DATA_OUT_L,
+					   data->fifo_buf,
+					   burst * set_words *
+					   sizeof(u16_t)) < 0) {
+			LOG_DBG("failed to read FIFO data");
+			return -EIO;
+		}
+
+		for (i = 0; i < burst; i++) {
+			set = &data->fifo_buf[i * set_words * sizeof(u16_t)];
+			timestamp = now - (sets - 1 - (done + i)) * period;
+
+			if (data->gyro_odr) {
+				lsm6dsl_fifo_frame(data, format, frames,
+						   count++,
+						   SENSOR_CHAN_GYRO_XYZ,
+						   set, timestamp);
+				set += 3 * sizeof(u16_t);
+			}
+
+			if (data->accel_odr) {
+				lsm6dsl_fifo_frame(data, format, frames,
+						   count++,
+						   SENSOR_CHAN_ACCEL_XYZ,
+						   set, timestamp);
+			}
+		}
+	}
+
+	return count;
+}
+#endif
+
 static const struct sensor_driver_api lsm6dsl_api_funcs = {
 	.attr_set = lsm6dsl_attr_set,
 #if CONFIG_LSM6DSL_TRIGGER
@@ -701,6 +1020,10 @@ static const struct sensor_driver_api lsm6dsl_api_funcs = {
 #endif
 	.sample_fetch = lsm6dsl_sample_fetch,
 	.channel_get = lsm6dsl_channel_get,
+#ifdef CONFIG_LSM6DSL_FIFO
+	.fifo_read = lsm6dsl_fifo_read,
+#endif
+	.channel_get_raw = lsm6dsl_channel_get_raw,
 };
 
 static int lsm6dsl_init_chip(struct device *dev)
@@ -769,6 +1092,13 @@ static int lsm6dsl_init_chip(struct device *dev)
 		return -EIO;
 	}
 
+#ifdef CONFIG_LSM6DSL_FIFO
+	if (lsm6dsl_fifo_config(dev) < 0) {
+		LOG_DBG("failed to configure FIFO");
+		return -EIO;
+	}
+#endif
+
 	return 0;
 }
 
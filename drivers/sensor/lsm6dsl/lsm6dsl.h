@@ -70,8 +70,8 @@
 #define LSM6DSL_SHIFT_FIFO_CTRL4_DEC_DS3_FIFO		0
 
 #define LSM6DSL_REG_FIFO_CTRL5				0x0A
-#define LSM6DSL_MASK_FIFO_CTRL5_ODR_FIFO		(BIT(5) | BIT(4) | \
-							 BIT(3))
+#define LSM6DSL_MASK_FIFO_CTRL5_ODR_FIFO		(BIT(6) | BIT(5) | \
+							 BIT(4) | BIT(3))
 #define LSM6DSL_SHIFT_FIFO_CTRL5_ODR_FIFO		3
 #define LSM6DSL_MASK_FIFO_CTRL5_FIFO_MODE		(BIT(2) | BIT(1) | \
 							 BIT(0))
@@ -365,10 +365,10 @@
 #define LSM6DSL_SHIFT_FIFO_STATUS2_DIFF_FIFO		0
 
 #define LSM6DSL_REG_FIFO_STATUS3			0x3C
-#define LSM6DSL_MASK_FIFO_STATUS3_FIFO_PATTERN		0x0F
+#define LSM6DSL_MASK_FIFO_STATUS3_FIFO_PATTERN		0xFF
 #define LSM6DSL_SHIFT_FIFO_STATUS3_FIFO_PATTERN		0
 
-#define LSM6DSL_REG_FIFO_STATUS4			0x3C
+#define LSM6DSL_REG_FIFO_STATUS4			0x3D
 #define LSM6DSL_MASK_FIFO_STATUS4_FIFO_PATTERN		(BIT(1) | BIT(0))
 #define LSM6DSL_SHIFT_FIFO_STATUS4_FIFO_PATTERN		0
 
@@ -603,6 +603,16 @@
 #define LSM6DSL_GYRO_ODR_RUNTIME 1
 #endif
 
+#define LSM6DSL_FIFO_MODE_BYPASS	0
+#define LSM6DSL_FIFO_MODE_CONTINUOUS	6
+
+/* decimation factor of a data set in the FIFO */
+#define LSM6DSL_FIFO_DEC_NONE		0
+#define LSM6DSL_FIFO_DEC_1		1
+
+/* FIFO words read per bus transaction, a multiple of the data sets */
+#define LSM6DSL_FIFO_BURST_WORDS	120
+
 struct lsm6dsl_config {
 	char *comm_master_dev_name;
 };
@@ -649,6 +659,13 @@ struct lsm6dsl_data {
 	u16_t gyro_freq;
 	u8_t gyro_fs;
 
+#ifdef CONFIG_LSM6DSL_FIFO
+	u8_t accel_odr;
+	u8_t gyro_odr;
+	u8_t fifo_odr;
+	u8_t fifo_buf[LSM6DSL_FIFO_BURST_WORDS * sizeof(u16_t)];
+#endif
+
 #ifdef CONFIG_LSM6DSL_TRIGGER
 	struct device *gpio;
 	struct gpio_callback gpio_cb;
@@ -34,3 +34,44 @@ Z_SYSCALL_HANDLER(sensor_channel_get, dev, chan, val)
 	return _impl_sensor_channel_get((struct device *)dev, chan,
 					(struct sensor_value *)val);
 }
+
+Z_SYSCALL_HANDLER(sensor_fifo_read, dev, format, frames, max_frames)
+{
+	size_t frame_size = (format == SENSOR_FRAME_RAW) ?
+			    sizeof(struct sensor_frame_raw) :
+			    sizeof(struct sensor_frame);
+
+	Z_OOPS(Z_SYSCALL_DRIVER_SENSOR(dev, fifo_read));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(frames, max_frames, frame_size));
+	return _impl_sensor_fifo_read((struct device *)dev, format,
+				      (void *)frames, max_frames);
+}
+
+Z_SYSCALL_HANDLER(sensor_channel_get_raw, dev, chan, raw, scale)
+{
+	size_t count;
+
+	switch (chan) {
+	case SENSOR_CHAN_ACCEL_XYZ:
+	case SENSOR_CHAN_GYRO_XYZ:
+	case SENSOR_CHAN_MAGN_XYZ:
+		count = 3;
+		break;
+	default:
+		count = 1;
+		break;
+	}
+
+	Z_OOPS(Z_SYSCALL_DRIVER_SENSOR(dev, channel_get_raw));
+	if (raw) {
+		Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(raw, count,
+						    sizeof(s32_t)));
+	}
+	if (scale) {
+		Z_OOPS(Z_SYSCALL_MEMORY_WRITE(scale,
+					      sizeof(struct sensor_scale)));
+	}
+	return _impl_sensor_channel_get_raw((struct device *)dev, chan,
+					    (s32_t *)raw,
+					    (struct sensor_scale *)scale);
+}
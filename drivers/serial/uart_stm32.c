@@ -326,6 +326,10 @@ static int uart_stm32_configure(struct device *dev,
 		return -ENOTSUP;
 	}
 
+	if (device_pm_get_sync(dev) < 0) {
+		return -EIO;
+	}
+
 	LL_USART_Disable(UartInstance);
 
 	if (parity != uart_stm32_get_parity(dev)) {
@@ -346,6 +350,7 @@ static int uart_stm32_configure(struct device *dev,
 	}
 
 	LL_USART_Enable(UartInstance);
+	(void)device_pm_put(dev);
 	return 0;
 };
 
@@ -353,6 +358,10 @@ static int uart_stm32_config_get(struct device *dev, struct uart_config *cfg)
 {
 	struct uart_stm32_data *data = DEV_DATA(dev);
 
+	if (device_pm_get_sync(dev) < 0) {
+		return -EIO;
+	}
+
 	cfg->baudrate = data->baud_rate;
 	cfg->parity = uart_stm32_ll2cfg_parity(uart_stm32_get_parity(dev));
 	cfg->stop_bits = uart_stm32_ll2cfg_stopbits(
@@ -360,25 +369,34 @@ static int uart_stm32_config_get(struct device *dev, struct uart_config *cfg)
 	cfg->data_bits = uart_stm32_ll2cfg_databits(
 		uart_stm32_get_databits(dev));
 	cfg->flow_ctrl = UART_CFG_FLOW_CTRL_NONE;
+	(void)device_pm_put(dev);
 	return 0;
 }
 
 static int uart_stm32_poll_in(struct device *dev, unsigned char *c)
 {
 	USART_TypeDef *UartInstance = UART_STRUCT(dev);
+	int ret = 0;
+
+	/* Polling keeps the device active, so that it receives */
+	if (device_pm_get_sync(dev) < 0) {
+		return -1;
+	}
 
 	/* Clear overrun error flag */
 	if (LL_USART_IsActiveFlag_ORE(UartInstance)) {
 		LL_USART_ClearFlag_ORE(UartInstance);
 	}
 
-	if (!LL_USART_IsActiveFlag_RXNE(UartInstance)) {
-		return -1;
+	if (LL_USART_IsActiveFlag_RXNE(UartInstance)) {
+		*c = (unsigned char)LL_USART_ReceiveData8(UartInstance);
+	} else {
+		ret = -1;
 	}
 
-	*c = (unsigned char)LL_USART_ReceiveData8(UartInstance);
+	(void)device_pm_put(dev);
 
-	return 0;
+	return ret;
 }
 
 static void uart_stm32_poll_out(struct device *dev,
@@ -386,6 +404,11 @@ static void uart_stm32_poll_out(struct device *dev,
 {
 	USART_TypeDef *UartInstance = UART_STRUCT(dev);
 
+	/* The character is dropped if the device cannot be resumed */
+	if (device_pm_get_sync(dev) < 0) {
+		return;
+	}
+
 	/* Wait for TXE flag to be raised */
 	while (!LL_USART_IsActiveFlag_TXE(UartInstance))
 		;
@@ -393,6 +416,9 @@ static void uart_stm32_poll_out(struct device *dev,
 	LL_USART_ClearFlag_TC(UartInstance);
 
 	LL_USART_TransmitData8(UartInstance, (u8_t)c);
+
+	/* The suspend waits for the character to be sent */
+	(void)device_pm_put(dev);
 }
 
 static inline void __uart_stm32_get_clock(struct device *dev)
@@ -451,10 +477,29 @@ static int uart_stm32_fifo_read(struct device *dev, u8_t *rx_data,
 	return num_rx;
 }
 
+#ifdef CONFIG_DEVICE_IDLE_PM
+/* Holds the device active while an interrupt is enabled */
+static void uart_stm32_pm_hold(struct device *dev, bool *held, bool hold)
+{
+	if (hold && !*held) {
+		*held = (device_pm_get_sync(dev) == 0);
+	} else if (!hold && *held) {
+		*held = false;
+		(void)device_pm_put(dev);
+	}
+}
+
+#define UART_STM32_PM_HOLD(dev, irq, hold) \
+	uart_stm32_pm_hold(dev, &DEV_DATA(dev)->irq##_held, hold)
+#else
+#define UART_STM32_PM_HOLD(dev, irq, hold)
+#endif /* CONFIG_DEVICE_IDLE_PM */
+
 static void uart_stm32_irq_tx_enable(struct device *dev)
 {
 	USART_TypeDef *UartInstance = UART_STRUCT(dev);
 
+	UART_STM32_PM_HOLD(dev, tx, true);
 	LL_USART_EnableIT_TC(UartInstance);
 }
 
@@ -463,6 +508,7 @@ static void uart_stm32_irq_tx_disable(struct device *dev)
 	USART_TypeDef *UartInstance = UART_STRUCT(dev);
 
 	LL_USART_DisableIT_TC(UartInstance);
+	UART_STM32_PM_HOLD(dev, tx, false);
 }
 
 static int uart_stm32_irq_tx_ready(struct device *dev)
@@ -483,6 +529,7 @@ static void uart_stm32_irq_rx_enable(struct device *dev)
 {
 	USART_TypeDef *UartInstance = UART_STRUCT(dev);
 
+	UART_STM32_PM_HOLD(dev, rx, true);
 	LL_USART_EnableIT_RXNE(UartInstance);
 }
 
@@ -491,6 +538,7 @@ static void uart_stm32_irq_rx_disable(struct device *dev)
 	USART_TypeDef *UartInstance = UART_STRUCT(dev);
 
 	LL_USART_DisableIT_RXNE(UartInstance);
+	UART_STM32_PM_HOLD(dev, rx, false);
 }
 
 static int uart_stm32_irq_rx_ready(struct device *dev)
@@ -592,6 +640,59 @@ static const struct uart_driver_api uart_stm32_driver_api = {
 #endif	/* CONFIG_UART_INTERRUPT_DRIVEN */
 };
 
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+/*
+ * The registers of the USART are kept while its clock is gated. The clock
+ * is only gated once the last character is sent.
+ */
+static int uart_stm32_set_power_state(struct device *dev, u32_t new_state)
+{
+	const struct uart_stm32_config *config = DEV_CFG(dev);
+	struct uart_stm32_data *data = DEV_DATA(dev);
+	USART_TypeDef *UartInstance = UART_STRUCT(dev);
+	int ret;
+
+	if (new_state == DEVICE_PM_ACTIVE_STATE) {
+		ret = clock_control_on(data->clock,
+				(clock_control_subsys_t *)&config->pclken);
+	} else {
+		while (!LL_USART_IsActiveFlag_TC(UartInstance))
+			;
+
+		ret = clock_control_off(data->clock,
+				(clock_control_subsys_t *)&config->pclken);
+	}
+
+	if (ret != 0) {
+		return -EIO;
+	}
+
+	data->pm_state = new_state;
+
+	return 0;
+}
+
+static int uart_stm32_pm_control(struct device *dev, u32_t ctrl_command,
+				 void *context)
+{
+	struct uart_stm32_data *data = DEV_DATA(dev);
+	int ret = 0;
+
+	if (ctrl_command == DEVICE_PM_SET_POWER_STATE) {
+		u32_t new_state = *((const u32_t *)context);
+
+		if (new_state != data->pm_state) {
+			ret = uart_stm32_set_power_state(dev, new_state);
+		}
+	} else {
+		__ASSERT_NO_MSG(ctrl_command == DEVICE_PM_GET_POWER_STATE);
+		*((u32_t *)context) = data->pm_state;
+	}
+
+	return ret;
+}
+#endif /* CONFIG_DEVICE_POWER_MANAGEMENT */
+
 /**
  * @brief Initialize UART channel
  *
@@ -647,6 +748,12 @@ static int uart_stm32_init(struct device *dev)
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	config->uconf.irq_config_func(dev);
 #endif
+
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+	data->pm_state = DEVICE_PM_ACTIVE_STATE;
+#endif
+	device_pm_enable(dev);
+
 	return 0;
 }
 
@@ -688,11 +795,11 @@ static struct uart_stm32_data uart_stm32_data_##name = {		\
 	.baud_rate = DT_UART_STM32_##name##_BAUD_RATE			\
 };									\
 									\
-DEVICE_AND_API_INIT(uart_stm32_##name, DT_UART_STM32_##name##_NAME,	\
-		    &uart_stm32_init,					\
-		    &uart_stm32_data_##name, &uart_stm32_cfg_##name,	\
-		    PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,	\
-		    &uart_stm32_driver_api);				\
+DEVICE_DEFINE(uart_stm32_##name, DT_UART_STM32_##name##_NAME,		\
+	      &uart_stm32_init, uart_stm32_pm_control,			\
+	      &uart_stm32_data_##name, &uart_stm32_cfg_##name,		\
+	      PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,		\
+	      &uart_stm32_driver_api);					\
 									\
 STM32_UART_IRQ_HANDLER(name)
 
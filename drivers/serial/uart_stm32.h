@@ -28,6 +28,14 @@ struct uart_stm32_data {
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	uart_irq_callback_user_data_t user_cb;
 	void *user_data;
+#ifdef CONFIG_DEVICE_IDLE_PM
+	/* whether the enabled interrupts hold the device active */
+	bool rx_held;
+	bool tx_held;
+#endif
+#endif
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+	u32_t pm_state;
 #endif
 };
 
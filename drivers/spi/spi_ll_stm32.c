@@ -173,9 +173,12 @@ static int spi_stm32_shift_frames(SPI_TypeDef *spi, struct spi_stm32_data *data)
 	return spi_stm32_get_err(spi);
 }
 
-static void spi_stm32_complete(struct spi_stm32_data *data, SPI_TypeDef *spi,
-			       int status)
+static void spi_stm32_complete(struct device *dev, int status)
 {
+	const struct spi_stm32_config *cfg = DEV_CFG(dev);
+	struct spi_stm32_data *data = DEV_DATA(dev);
+	SPI_TypeDef *spi = cfg->spi;
+
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 	LL_SPI_DisableIT_TXE(spi);
 	LL_SPI_DisableIT_RXNE(spi);
@@ -199,6 +202,8 @@ static void spi_stm32_complete(struct spi_stm32_data *data, SPI_TypeDef *spi,
 
 	LL_SPI_Disable(spi);
 
+	(void)device_pm_put(dev);
+
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 	spi_context_complete(&data->ctx, status);
 #endif
@@ -215,7 +220,7 @@ static void spi_stm32_isr(void *arg)
 
 	err = spi_stm32_get_err(spi);
 	if (err) {
-		spi_stm32_complete(data, spi, err);
+		spi_stm32_complete(dev, err);
 		return;
 	}
 
@@ -224,7 +229,7 @@ static void spi_stm32_isr(void *arg)
 	}
 
 	if (err || !spi_stm32_transfer_ongoing(data)) {
-		spi_stm32_complete(data, spi, err);
+		spi_stm32_complete(dev, err);
 	}
 }
 #endif
@@ -381,8 +386,16 @@ static int transceive(struct device *dev,
 
 	spi_context_lock(&data->ctx, asynchronous, signal);
 
+	/* Put back once the transfer is complete */
+	ret = device_pm_get_sync(dev);
+	if (ret) {
+		spi_context_release(&data->ctx, ret);
+		return ret;
+	}
+
 	ret = spi_stm32_configure(dev, config);
 	if (ret) {
+		(void)device_pm_put(dev);
 		return ret;
 	}
 
@@ -416,7 +429,7 @@ static int transceive(struct device *dev,
 		ret = spi_stm32_shift_frames(spi, data);
 	} while (!ret && spi_stm32_transfer_ongoing(data));
 
-	spi_stm32_complete(data, spi, ret);
+	spi_stm32_complete(dev, ret);
 
 #ifdef CONFIG_SPI_SLAVE
 	if (spi_context_is_slave(&data->ctx) && !ret) {
@@ -458,6 +471,54 @@ static const struct spi_driver_api api_funcs = {
 	.release = spi_stm32_release,
 };
 
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+/* The registers of the SPI are kept while its clock is gated */
+static int spi_stm32_set_power_state(struct device *dev, u32_t new_state)
+{
+	const struct spi_stm32_config *cfg = DEV_CFG(dev);
+	struct spi_stm32_data *data = DEV_DATA(dev);
+	struct device *clk = device_get_binding(STM32_CLOCK_CONTROL_NAME);
+	int ret;
+
+	if (new_state == DEVICE_PM_ACTIVE_STATE) {
+		ret = clock_control_on(clk,
+				       (clock_control_subsys_t) &cfg->pclken);
+	} else {
+		ret = clock_control_off(clk,
+					(clock_control_subsys_t) &cfg->pclken);
+	}
+
+	if (ret) {
+		LOG_ERR("Could not gate SPI clock");
+		return -EIO;
+	}
+
+	data->pm_state = new_state;
+
+	return 0;
+}
+
+static int spi_stm32_pm_control(struct device *dev, u32_t ctrl_command,
+				void *context)
+{
+	struct spi_stm32_data *data = DEV_DATA(dev);
+	int ret = 0;
+
+	if (ctrl_command == DEVICE_PM_SET_POWER_STATE) {
+		u32_t new_state = *((const u32_t *)context);
+
+		if (new_state != data->pm_state) {
+			ret = spi_stm32_set_power_state(dev, new_state);
+		}
+	} else {
+		__ASSERT_NO_MSG(ctrl_command == DEVICE_PM_GET_POWER_STATE);
+		*((u32_t *)context) = data->pm_state;
+	}
+
+	return ret;
+}
+#endif /* CONFIG_DEVICE_POWER_MANAGEMENT */
+
 static int spi_stm32_init(struct device *dev)
 {
 	struct spi_stm32_data *data __attribute__((unused)) = dev->driver_data;
@@ -477,6 +538,11 @@ static int spi_stm32_init(struct device *dev)
 
 	spi_context_unlock_unconditionally(&data->ctx);
 
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+	data->pm_state = DEVICE_PM_ACTIVE_STATE;
+#endif
+	device_pm_enable(dev);
+
 	return 0;
 }
 
@@ -502,10 +568,10 @@ static struct spi_stm32_data spi_stm32_dev_data_1 = {
 	SPI_CONTEXT_INIT_SYNC(spi_stm32_dev_data_1, ctx),
 };
 
-DEVICE_AND_API_INIT(spi_stm32_1, DT_SPI_1_NAME, &spi_stm32_init,
-		    &spi_stm32_dev_data_1, &spi_stm32_cfg_1,
-		    POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
-		    &api_funcs);
+DEVICE_DEFINE(spi_stm32_1, DT_SPI_1_NAME, &spi_stm32_init,
+	      spi_stm32_pm_control, &spi_stm32_dev_data_1,
+	      &spi_stm32_cfg_1, POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
+	      &api_funcs);
 
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 static void spi_stm32_irq_config_func_1(struct device *dev)
@@ -540,10 +606,10 @@ static struct spi_stm32_data spi_stm32_dev_data_2 = {
 	SPI_CONTEXT_INIT_SYNC(spi_stm32_dev_data_2, ctx),
 };
 
-DEVICE_AND_API_INIT(spi_stm32_2, DT_SPI_2_NAME, &spi_stm32_init,
-		    &spi_stm32_dev_data_2, &spi_stm32_cfg_2,
-		    POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
-		    &api_funcs);
+DEVICE_DEFINE(spi_stm32_2, DT_SPI_2_NAME, &spi_stm32_init,
+	      spi_stm32_pm_control, &spi_stm32_dev_data_2,
+	      &spi_stm32_cfg_2, POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
+	      &api_funcs);
 
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 static void spi_stm32_irq_config_func_2(struct device *dev)
@@ -578,10 +644,10 @@ static struct spi_stm32_data spi_stm32_dev_data_3 = {
 	SPI_CONTEXT_INIT_SYNC(spi_stm32_dev_data_3, ctx),
 };
 
-DEVICE_AND_API_INIT(spi_stm32_3, DT_SPI_3_NAME, &spi_stm32_init,
-		    &spi_stm32_dev_data_3, &spi_stm32_cfg_3,
-		    POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
-		    &api_funcs);
+DEVICE_DEFINE(spi_stm32_3, DT_SPI_3_NAME, &spi_stm32_init,
+	      spi_stm32_pm_control, &spi_stm32_dev_data_3,
+	      &spi_stm32_cfg_3, POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
+	      &api_funcs);
 
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 static void spi_stm32_irq_config_func_3(struct device *dev)
@@ -616,10 +682,10 @@ static struct spi_stm32_data spi_stm32_dev_data_4 = {
 	SPI_CONTEXT_INIT_SYNC(spi_stm32_dev_data_4, ctx),
 };
 
-DEVICE_AND_API_INIT(spi_stm32_4, DT_SPI_4_NAME, &spi_stm32_init,
-		    &spi_stm32_dev_data_4, &spi_stm32_cfg_4,
-		    POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
-		    &api_funcs);
+DEVICE_DEFINE(spi_stm32_4, DT_SPI_4_NAME, &spi_stm32_init,
+	      spi_stm32_pm_control, &spi_stm32_dev_data_4,
+	      &spi_stm32_cfg_4, POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
+	      &api_funcs);
 
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 static void spi_stm32_irq_config_func_4(struct device *dev)
@@ -654,10 +720,10 @@ static struct spi_stm32_data spi_stm32_dev_data_5 = {
 	SPI_CONTEXT_INIT_SYNC(spi_stm32_dev_data_5, ctx),
 };
 
-DEVICE_AND_API_INIT(spi_stm32_5, DT_SPI_5_NAME, &spi_stm32_init,
-		    &spi_stm32_dev_data_5, &spi_stm32_cfg_5,
-		    POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
-		    &api_funcs);
+DEVICE_DEFINE(spi_stm32_5, DT_SPI_5_NAME, &spi_stm32_init,
+	      spi_stm32_pm_control, &spi_stm32_dev_data_5,
+	      &spi_stm32_cfg_5, POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
+	      &api_funcs);
 
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 static void spi_stm32_irq_config_func_5(struct device *dev)
@@ -692,10 +758,10 @@ static struct spi_stm32_data spi_stm32_dev_data_6 = {
 	SPI_CONTEXT_INIT_SYNC(spi_stm32_dev_data_6, ctx),
 };
 
-DEVICE_AND_API_INIT(spi_stm32_6, DT_SPI_6_NAME, &spi_stm32_init,
-		    &spi_stm32_dev_data_6, &spi_stm32_cfg_6,
-		    POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
-		    &api_funcs);
+DEVICE_DEFINE(spi_stm32_6, DT_SPI_6_NAME, &spi_stm32_init,
+	      spi_stm32_pm_control, &spi_stm32_dev_data_6,
+	      &spi_stm32_cfg_6, POST_KERNEL, CONFIG_SPI_INIT_PRIORITY,
+	      &api_funcs);
 
 #ifdef CONFIG_SPI_STM32_INTERRUPT
 static void spi_stm32_irq_config_func_6(struct device *dev)
@@ -21,6 +21,9 @@ struct spi_stm32_config {
 
 struct spi_stm32_data {
 	struct spi_context ctx;
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+	u32_t pm_state;
+#endif
 };
 
 #endif	/* ZEPHYR_DRIVERS_SPI_SPI_LL_STM32_H_ */
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief STM32 LPTIM-based system timer
+ *
+ * LPTIM1 is clocked by the LSE and keeps counting in STOP modes, so that
+ * the kernel keeps its time while the SoC sleeps. As the next timeout is
+ * never set further than the 16-bit counter span, the cycles elapsed since
+ * the last tick announced are always known from the counter.
+ */
+
+#include <soc.h>
+#include <system_timer.h>
+#include <sys_clock.h>
+#include <spinlock.h>
+
+#define LPTIM LPTIM1
+
+#define LSE_FREQ	32768
+#define LPTIM_FREQ	(LSE_FREQ / CONFIG_STM32_LPTIM_TIMER_PRESCALER)
+
+BUILD_ASSERT_MSG((CONFIG_STM32_LPTIM_TIMER_PRESCALER &
+		  (CONFIG_STM32_LPTIM_TIMER_PRESCALER - 1)) == 0,
+		 "LPTIM prescaler must be a power of two");
+BUILD_ASSERT_MSG(LPTIM_FREQ % CONFIG_SYS_CLOCK_TICKS_PER_SEC == 0,
+		 "LPTIM frequency must be a multiple of the tick frequency");
+
+/*
+ * A compare value is taken into account a couple of LPTIM clock cycles
+ * after it is written, once synchronized to the LSE.  Keep it that far
+ * ahead of the counter, so that it normally fires; set_comparator()
+ * catches the cases where it did not.
+ */
+#define MIN_DELAY 4
+
+#define CYC_PER_TICK (LPTIM_FREQ / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+#if CYC_PER_TICK < MIN_DELAY
+#error Cycles per tick is too small
+#endif
+
+#define COUNTER_MAX 0x0000ffffU
+#define MAX_TICKS ((COUNTER_MAX - MIN_DELAY) / CYC_PER_TICK)
+#define MAX_DELAY (MAX_TICKS * CYC_PER_TICK)
+
+static struct k_spinlock lock;
+
+static u32_t last_count;
+
+static inline u32_t counter_sub(u32_t a, u32_t b)
+{
+	return (a - b) & COUNTER_MAX;
+}
+
+/*
+ * The counter runs on the LSE, asynchronously to the bus: it is read until
+ * two reads match.
+ */
+static u32_t counter(void)
+{
+	u32_t cnt;
+
+	do {
+		cnt = LL_LPTIM_GetCounter(LPTIM);
+	} while (cnt != LL_LPTIM_GetCounter(LPTIM));
+
+	return cnt;
+}
+
+/*
+ * Sets the compare value to cyc, computed from the counter value t. The
+ * write is waited for, so that the next one is never lost and the counter
+ * can be checked against it: if it passed the compare value already, the
+ * match would only happen after a wrap, so the interrupt is pended.
+ */
+static void set_comparator(u32_t cyc, u32_t t)
+{
+	u32_t cmp = cyc & COUNTER_MAX;
+
+	/*
+	 * Compare must be lower than autoreload: match one cycle later
+	 * rather than one earlier.
+	 */
+	if (cmp == COUNTER_MAX) {
+		cmp = 0U;
+	}
+
+	LL_LPTIM_ClearFlag_CMPOK(LPTIM);
+	LL_LPTIM_SetCompare(LPTIM, cmp);
+	while (!LL_LPTIM_IsActiveFlag_CMPOK(LPTIM)) {
+	}
+
+	if (counter_sub(counter(), t) >= counter_sub(cmp, t)) {
+		NVIC_SetPendingIRQ(LPTIM1_IRQn);
+	}
+}
+
+static void lptim_isr(void *arg)
+{
+	ARG_UNUSED(arg);
+	LL_LPTIM_ClearFLAG_CMPM(LPTIM);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u32_t t = counter();
+	u32_t dticks = counter_sub(t, last_count) / CYC_PER_TICK;
+
+	last_count += dticks * CYC_PER_TICK;
+
+	if (!IS_ENABLED(CONFIG_TICKLESS_KERNEL)) {
+		u32_t next = last_count + CYC_PER_TICK;
+
+		if (counter_sub(next, t) < MIN_DELAY) {
+			next += CYC_PER_TICK;
+		}
+		set_comparator(next, t);
+	}
+
+	k_spin_unlock(&lock, key);
+	z_clock_announce(dticks);
+}
+
+int z_clock_driver_init(struct device *device)
+{
+	extern int z_clock_hw_cycles_per_sec;
+
+	ARG_UNUSED(device);
+
+	/* The LSE is in the backup domain */
+	LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_PWR);
+	LL_PWR_EnableBkUpAccess();
+
+	if (!LL_RCC_LSE_IsReady()) {
+		LL_RCC_LSE_Enable();
+		while (!LL_RCC_LSE_IsReady()) {
+		}
+	}
+
+	LL_RCC_SetLPTIMClockSource(LL_RCC_LPTIM1_CLKSOURCE_LSE);
+	LL_APB1_GRP1_EnableClock(LL_APB1_GRP1_PERIPH_LPTIM1);
+
+	/* Configuration and interrupts are set while the timer is disabled */
+	LL_LPTIM_Disable(LPTIM);
+	LL_LPTIM_SetClockSource(LPTIM, LL_LPTIM_CLK_SOURCE_INTERNAL);
+	LL_LPTIM_SetPrescaler(LPTIM,
+			      (find_lsb_set(CONFIG_STM32_LPTIM_TIMER_PRESCALER)
+			       - 1) << LPTIM_CFGR_PRESC_Pos);
+	LL_LPTIM_SetUpdateMode(LPTIM, LL_LPTIM_UPDATE_MODE_IMMEDIATE);
+	LL_LPTIM_SetCounterMode(LPTIM, LL_LPTIM_COUNTER_MODE_INTERNAL);
+	LL_LPTIM_EnableIT_CMPM(LPTIM);
+
+	z_clock_hw_cycles_per_sec = LPTIM_FREQ;
+
+	/* The LPTIM1 EXTI line, which wakes up from STOP, is on at reset */
+	IRQ_CONNECT(LPTIM1_IRQn, 1, lptim_isr, 0, 0);
+	irq_enable(LPTIM1_IRQn);
+
+	LL_LPTIM_Enable(LPTIM);
+
+	LL_LPTIM_SetAutoReload(LPTIM, COUNTER_MAX);
+	while (!LL_LPTIM_IsActiveFlag_ARROK(LPTIM)) {
+	}
+	LL_LPTIM_ClearFlag_ARROK(LPTIM);
+
+	set_comparator(CYC_PER_TICK, 0);
+
+	LL_LPTIM_StartCounter(LPTIM, LL_LPTIM_OPERATING_MODE_CONTINUOUS);
+
+	return 0;
+}
+
+void z_clock_set_timeout(s32_t ticks, bool idle)
+{
+	ARG_UNUSED(idle);
+
+#ifdef CONFIG_TICKLESS_KERNEL
+	ticks = (ticks == K_FOREVER) ? MAX_TICKS : ticks;
+	ticks = max(min(ticks - 1, (s32_t)MAX_TICKS), 0);
+
+	/*
+	 * Get the requested delay in tick-aligned cycles.  Increase
+	 * by one tick to round up so we don't timeout early due to
+	 * cycles elapsed since the last tick.  Cap at the maximum
+	 * tick-aligned delta.
+	 */
+	u32_t cyc = min((1 + ticks) * CYC_PER_TICK, MAX_DELAY);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u32_t t = counter();
+	u32_t d = counter_sub(t, last_count);
+
+	/*
+	 * We've already accounted for anything less than a full tick,
+	 * and assumed we meet the minimum delay for the tick.  If
+	 * that's not true, we have to adjust, which may involve a
+	 * rare and expensive integer division.
+	 */
+	if (d > (CYC_PER_TICK - MIN_DELAY)) {
+		if (d >= CYC_PER_TICK) {
+			/*
+			 * We're late by at least one tick.  Adjust
+			 * the compare offset for the missed ones, and
+			 * reduce d to be the portion since the last
+			 * (unseen) tick.
+			 */
+			u32_t missed_ticks = d / CYC_PER_TICK;
+			u32_t missed_cycles = missed_ticks * CYC_PER_TICK;
+
+			cyc += missed_cycles;
+			d -= missed_cycles;
+		}
+		if (d > (CYC_PER_TICK - MIN_DELAY)) {
+			/*
+			 * We're (now) within the tick, but too close
+			 * to meet the minimum delay required to
+			 * guarantee compare firing.  Step up to the
+			 * next tick.
+			 */
+			cyc += CYC_PER_TICK;
+		}
+		if (cyc > MAX_DELAY) {
+			/* Don't adjust beyond the counter range. */
+			cyc = MAX_DELAY;
+		}
+	}
+	set_comparator(last_count + cyc, t);
+
+	k_spin_unlock(&lock, key);
+#endif
+}
+
+u32_t z_clock_elapsed(void)
+{
+	if (!IS_ENABLED(CONFIG_TICKLESS_KERNEL)) {
+		return 0;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u32_t ret = counter_sub(counter(), last_count) / CYC_PER_TICK;
+
+	k_spin_unlock(&lock, key);
+	return ret;
+}
+
+u32_t _timer_cycle_get_32(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	u32_t ret = counter_sub(counter(), last_count) + last_count;
+
+	k_spin_unlock(&lock, key);
+	return ret;
+}
+
+#if defined(CONFIG_ARCH_HAS_CUSTOM_BUSY_WAIT)
+/*
+ * k_busy_wait() cannot be timed by the LPTIM, whose cycles last 30 us or
+ * more. It counts the core clock cycles on the SysTick instead, which is
+ * free as it is not the system timer, and runs without its interrupt.
+ */
+void z_arch_busy_wait(u32_t usec_to_wait)
+{
+	u32_t cycles_to_wait = (u32_t)((u64_t)usec_to_wait *
+				       SystemCoreClock / USEC_PER_SEC);
+	u32_t elapsed = 0U;
+	u32_t prev;
+	u32_t now;
+
+	if (!(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)) {
+		SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+		SysTick->VAL = 0U;
+		SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk |
+				SysTick_CTRL_ENABLE_Msk;
+	}
+
+	/* The 24-bit down counter wraps many times during long waits */
+	prev = SysTick->VAL;
+	while (elapsed < cycles_to_wait) {
+		now = SysTick->VAL;
+		elapsed += (prev - now) & SysTick_LOAD_RELOAD_Msk;
+		prev = now;
+	}
+}
+#endif /* CONFIG_ARCH_HAS_CUSTOM_BUSY_WAIT */
@@ -25,6 +25,9 @@
 #include <init.h>
 #include <dfu/mcuboot.h>
 #include <dfu/flash_img.h>
+#ifdef CONFIG_IMG_DELTA
+#include <dfu/delta_img.h>
+#endif
 #include <mgmt/mgmt.h>
 #include <img_mgmt/img_mgmt_impl.h>
 #include <img_mgmt/img_mgmt.h>
@@ -190,6 +193,11 @@ img_mgmt_impl_write_image_data(unsigned int offset, const void *data,
 	static struct flash_img_context ctx_data;
 #define ctx (&ctx_data)
 #endif
+#ifdef CONFIG_IMG_DELTA
+	/* The upload is a patch applied to the image slot 0 */
+	static struct delta_img_context delta;
+	static bool is_delta;
+#endif
 
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 	if (offset != 0 && ctx == NULL) {
@@ -212,14 +220,37 @@ img_mgmt_impl_write_image_data(unsigned int offset, const void *data,
 		if (rc != 0) {
 			return MGMT_ERR_EUNKNOWN;
 		}
+
+#ifdef CONFIG_IMG_DELTA
+		is_delta = delta_img_is_patch(data, num_bytes);
+		if (is_delta) {
+			rc = delta_img_flash_init(&delta, ctx);
+			if (rc != 0) {
+				return MGMT_ERR_EUNKNOWN;
+			}
+		}
+#endif
 	}
 
-	if (offset != ctx->bytes_written + ctx->buf_bytes) {
-		return MGMT_ERR_EUNKNOWN;
+#ifdef CONFIG_IMG_DELTA
+	if (is_delta) {
+		if (offset != delta_img_bytes_read(&delta)) {
+			return MGMT_ERR_EUNKNOWN;
+		}
+
+		rc = delta_img_write(&delta, data, num_bytes, last);
+	} else
+#endif
+	{
+		if (offset != ctx->bytes_written + ctx->buf_bytes) {
+			return MGMT_ERR_EUNKNOWN;
+		}
+
+		/* Cast away const. */
+		rc = flash_img_buffered_write(ctx, (void *)data, num_bytes,
+					      last);
 	}
 
-	/* Cast away const. */
-	rc = flash_img_buffered_write(ctx, (void *)data, num_bytes, last);
 	if (rc != 0) {
 		return MGMT_ERR_EUNKNOWN;
 	}
@@ -29,6 +29,9 @@
 #include "img_mgmt/img_mgmt_impl.h"
 #include "img_mgmt_priv.h"
 #include "img_mgmt_config.h"
+#ifdef CONFIG_IMG_DELTA
+#include <dfu/delta_img.h>
+#endif
 
 #define IMG_MGMT_DATA_SHA_LEN 32
 
@@ -289,6 +292,13 @@ img_mgmt_check_header(const uint8_t *req_data, size_t len)
         return MGMT_ERR_EINVAL;
     }
 
+#ifdef CONFIG_IMG_DELTA
+    /* A patch rebuilds the image from the one in slot 0. */
+    if (delta_img_is_patch(req_data, len)) {
+        return 0;
+    }
+#endif
+
     memcpy(&hdr, req_data, sizeof(hdr));
     if (hdr.ih_magic != IMAGE_MAGIC) {
         return MGMT_ERR_EINVAL;
@@ -313,10 +323,13 @@ img_mgmt_upload_first_chunk(struct mgmt_ctxt *ctxt, const uint8_t *req_data,
         return MGMT_ERR_ENOMEM;
     }
 
+#ifndef CONFIG_IMG_ERASE_PROGRESSIVELY
+    /* Otherwise the image writer erases the slot as it goes. */
     rc = img_mgmt_impl_erase_slot();
     if (rc != 0) {
         return rc;
     }
+#endif
 
     img_mgmt_ctxt.uploading = true;
     img_mgmt_ctxt.off = 0;
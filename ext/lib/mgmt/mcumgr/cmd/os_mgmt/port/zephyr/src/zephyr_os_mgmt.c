@@ -21,6 +21,9 @@
 #include <misc/reboot.h>
 #include <debug/object_tracing.h>
 #include <kernel_structs.h>
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+#include <tracing_cpu_stats.h>
+#endif
 #include <mgmt/mgmt.h>
 #include <util/mcumgr_util.h>
 #include <os_mgmt/os_mgmt.h>
@@ -56,6 +59,9 @@ int
 os_mgmt_impl_task_info(int idx, struct os_mgmt_task_info *out_info)
 {
     const struct k_thread *thread;
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+    struct cpu_stats_thread stats;
+#endif
 
     thread = zephyr_os_mgmt_task_at(idx);
     if (thread == NULL) {
@@ -67,9 +73,15 @@ os_mgmt_impl_task_info(int idx, struct os_mgmt_task_info *out_info)
     out_info->oti_prio = thread->base.prio;
     out_info->oti_taskid = idx;
     out_info->oti_state = thread->base.thread_state;
-#ifdef THREAD_STACK_INFO
+#ifdef CONFIG_THREAD_STACK_INFO
     out_info->oti_stksize = thread->stack_info.size / 4;
 #endif
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+    cpu_stats_thread_get(thread, &stats);
+    out_info->oti_stkusage = stats.stack_used / 4;
+    out_info->oti_cswcnt = stats.switches;
+    out_info->oti_runtime = stats.runtime / (NSEC_PER_USEC * USEC_PER_MSEC);
+#endif
 
     return 0;
 }
@@ -20,6 +20,9 @@
 #ifndef H_STAT_MGMT_
 #define H_STAT_MGMT_
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -27,8 +30,10 @@ extern "C" {
 /**
  * Command IDs for statistics management group.
  */
-#define STAT_MGMT_ID_SHOW   0
-#define STAT_MGMT_ID_LIST   1
+#define STAT_MGMT_ID_SHOW       0
+#define STAT_MGMT_ID_LIST       1
+#define STAT_MGMT_ID_SCHEMA     2
+#define STAT_MGMT_ID_SNAPSHOT   3
 
 /**
  * @brief Represents a single value in a statistics group.
@@ -38,6 +43,28 @@ struct stat_mgmt_entry {
     uint64_t value;
 };
 
+/**
+ * @brief Represents a snapshot of the values of the statistics groups.
+ *
+ * The values are encoded as LEB128 varints, group after group in the order
+ * of the stat list command, and within a group in the order of the stat
+ * schema command.
+ */
+struct stat_mgmt_snapshot {
+    /** Index of the first group to encode. */
+    int start;
+    /** Whether to encode the differences from the previous snapshot. */
+    bool delta;
+    /** On success, index of the first group not encoded. */
+    int next;
+    /** On success, number of stat groups. */
+    int groups;
+    /** On success, number of leading values encoded as differences. */
+    int delta_cnt;
+    /** On success, sequence number of the snapshot. */
+    uint32_t seq;
+};
+
 /**
  * @brief Registers the statistics management command handler group.
  */ 
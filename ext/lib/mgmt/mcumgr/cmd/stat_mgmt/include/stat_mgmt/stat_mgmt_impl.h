@@ -27,11 +27,15 @@
 #ifndef H_STAT_MGMT_IMPL_
 #define H_STAT_MGMT_IMPL_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct stat_mgmt_entry;
+struct stat_mgmt_snapshot;
 
 typedef int stat_mgmt_foreach_entry_fn(struct stat_mgmt_entry *entry,
                                        void *arg);
@@ -63,6 +67,40 @@ int stat_mgmt_impl_foreach_entry(const char *group_name,
                                  stat_mgmt_foreach_entry_fn *cb,
                                  void *arg);
 
+/**
+ * @brief Retrieves the size of the entries of the specified stat group.
+ *
+ * @param group_name            The name of the stat group.
+ * @param out_size              On success, the size of the entries of the
+ *                                  group, in bytes, gets written here.
+ *
+ * @return                      0 on success;
+ *                              MGMT_ERR_ENOENT if no group with the specified
+ *                                  name exists;
+ *                              Other MGMT_ERR_[...] code on failure.
+ */
+int stat_mgmt_impl_get_group_size(const char *group_name, int *out_size);
+
+/**
+ * @brief Encodes a snapshot of the values of the stat groups.
+ *
+ * Only whole groups are encoded, as many as fit in the buffer.
+ *
+ * @param snap                  The snapshot to encode.
+ * @param buf                   The buffer to encode the values into.
+ * @param len                   The size of the buffer; on success, the
+ *                                  length of the encoded values.
+ *
+ * @return                      0 on success;
+ *                              MGMT_ERR_ENOENT if the start group does not
+ *                                  exist;
+ *                              MGMT_ERR_ENOMEM if the start group does not
+ *                                  fit in the buffer;
+ *                              Other MGMT_ERR_[...] code on failure.
+ */
+int stat_mgmt_impl_snapshot(struct stat_mgmt_snapshot *snap, uint8_t *buf,
+                            size_t *len);
+
 #ifdef __cplusplus
 }
 #endif
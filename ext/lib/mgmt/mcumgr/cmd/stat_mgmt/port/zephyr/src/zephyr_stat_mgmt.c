@@ -17,6 +17,7 @@
  * under the License.
  */
 
+#include <errno.h>
 #include <misc/util.h>
 #include <stats.h>
 #include <mgmt/mgmt.h>
@@ -95,3 +96,48 @@ stat_mgmt_impl_foreach_entry(const char *group_name,
 
     return stats_walk(hdr, zephyr_stat_mgmt_walk_cb, &walk_arg);
 }
+
+int
+stat_mgmt_impl_get_group_size(const char *group_name, int *out_size)
+{
+    struct stats_hdr *hdr;
+
+    hdr = stats_group_find(group_name);
+    if (hdr == NULL) {
+        return MGMT_ERR_ENOENT;
+    }
+
+    *out_size = hdr->s_size;
+    return 0;
+}
+
+int
+stat_mgmt_impl_snapshot(struct stat_mgmt_snapshot *snap, uint8_t *buf,
+                        size_t *len)
+{
+    struct stats_snapshot zsnap;
+    int rc;
+
+    zsnap = (struct stats_snapshot) {
+        .start = snap->start,
+        .delta = snap->delta,
+    };
+
+    rc = stats_snapshot_encode(&zsnap, buf, len);
+    switch (rc) {
+    case 0:
+        break;
+    case -ENOENT:
+        return MGMT_ERR_ENOENT;
+    case -ENOMEM:
+        return MGMT_ERR_ENOMEM;
+    default:
+        return MGMT_ERR_EUNKNOWN;
+    }
+
+    snap->next = zsnap.next;
+    snap->groups = zsnap.groups;
+    snap->delta_cnt = zsnap.delta_cnt;
+    snap->seq = zsnap.seq;
+    return 0;
+}
@@ -19,6 +19,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
 
 #include "mgmt/mgmt.h"
 #include "cborattr/cborattr.h"
@@ -28,10 +29,14 @@
 
 static mgmt_handler_fn stat_mgmt_show;
 static mgmt_handler_fn stat_mgmt_list;
+static mgmt_handler_fn stat_mgmt_schema;
+static mgmt_handler_fn stat_mgmt_snapshot;
 
 static struct mgmt_handler stat_mgmt_handlers[] = {
     [STAT_MGMT_ID_SHOW] = { stat_mgmt_show, NULL },
     [STAT_MGMT_ID_LIST] = { stat_mgmt_list, NULL },
+    [STAT_MGMT_ID_SCHEMA] = { stat_mgmt_schema, NULL },
+    [STAT_MGMT_ID_SNAPSHOT] = { stat_mgmt_snapshot, NULL },
 };
 
 #define STAT_MGMT_HANDLER_CNT \
@@ -153,6 +158,163 @@ stat_mgmt_list(struct mgmt_ctxt *ctxt)
     return 0;
 }
 
+static int
+stat_mgmt_cb_encode_name(struct stat_mgmt_entry *entry, void *arg)
+{
+    CborEncoder *enc;
+    CborError err;
+
+    enc = arg;
+
+    err = cbor_encode_text_stringz(enc, entry->name);
+    if (err != 0) {
+        return MGMT_ERR_ENOMEM;
+    }
+
+    return 0;
+}
+
+/**
+ * Command handler: stat schema
+ *
+ * Returns the entry size and the field names of a stat group, which describe
+ * its values in the stat snapshot responses.
+ */
+static int
+stat_mgmt_schema(struct mgmt_ctxt *ctxt)
+{
+    char stat_name[STAT_MGMT_MAX_NAME_LEN];
+    CborEncoder arr_enc;
+    CborError err;
+    int size;
+    int rc;
+
+    struct cbor_attr_t attrs[] = {
+        {
+            .attribute = "name",
+            .type = CborAttrTextStringType,
+            .addr.string = stat_name,
+            .len = sizeof(stat_name)
+        },
+        { NULL },
+    };
+
+    err = cbor_read_object(&ctxt->it, attrs);
+    if (err != 0) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    rc = stat_mgmt_impl_get_group_size(stat_name, &size);
+    if (rc != 0) {
+        return rc;
+    }
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "rc");
+    err |= cbor_encode_int(&ctxt->encoder, MGMT_ERR_EOK);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "name");
+    err |= cbor_encode_text_stringz(&ctxt->encoder, stat_name);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "size");
+    err |= cbor_encode_uint(&ctxt->encoder, size);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "fields");
+    err |= cbor_encoder_create_array(&ctxt->encoder, &arr_enc,
+                                     CborIndefiniteLength);
+
+    rc = stat_mgmt_impl_foreach_entry(stat_name, stat_mgmt_cb_encode_name,
+                                      &arr_enc);
+    if (rc != 0) {
+        return rc;
+    }
+
+    err |= cbor_encoder_close_container(&ctxt->encoder, &arr_enc);
+
+    if (err != 0) {
+        return MGMT_ERR_ENOMEM;
+    }
+
+    return 0;
+}
+
+/**
+ * Command handler: stat snapshot
+ *
+ * Returns the values of the stat groups from the start one on, as many as fit
+ * in a response, as LEB128 varints.  With delta, the values are encoded as
+ * their differences from the previous snapshot, modulo the entry size, for the
+ * number of leading values given in the response.  A gap in the sequence
+ * number means that a difference was lost, and that an absolute snapshot is
+ * needed.
+ */
+static int
+stat_mgmt_snapshot(struct mgmt_ctxt *ctxt)
+{
+    static uint8_t data[STAT_MGMT_SNAPSHOT_LEN];
+    struct stat_mgmt_snapshot snap;
+    unsigned long long start;
+    bool delta;
+    size_t len;
+    CborError err;
+    int rc;
+
+    struct cbor_attr_t attrs[] = {
+        {
+            .attribute = "start",
+            .type = CborAttrUnsignedIntegerType,
+            .addr.uinteger = &start,
+            .dflt.integer = 0,
+        },
+        {
+            .attribute = "delta",
+            .type = CborAttrBooleanType,
+            .addr.boolean = &delta,
+            .dflt.boolean = false,
+        },
+        { NULL },
+    };
+
+    err = cbor_read_object(&ctxt->it, attrs);
+    if (err != 0 || start > INT_MAX) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    snap = (struct stat_mgmt_snapshot) {
+        .start = start,
+        .delta = delta,
+    };
+    len = sizeof(data);
+
+    rc = stat_mgmt_impl_snapshot(&snap, data, &len);
+    if (rc != 0) {
+        return rc;
+    }
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "rc");
+    err |= cbor_encode_int(&ctxt->encoder, MGMT_ERR_EOK);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "seq");
+    err |= cbor_encode_uint(&ctxt->encoder, snap.seq);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "next");
+    err |= cbor_encode_uint(&ctxt->encoder, snap.next);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "groups");
+    err |= cbor_encode_uint(&ctxt->encoder, snap.groups);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "delta");
+    err |= cbor_encode_uint(&ctxt->encoder, snap.delta_cnt);
+
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "data");
+    err |= cbor_encode_byte_string(&ctxt->encoder, data, len);
+
+    if (err != 0) {
+        return MGMT_ERR_ENOMEM;
+    }
+
+    return 0;
+}
+
 void
 stat_mgmt_register_group(void)
 {
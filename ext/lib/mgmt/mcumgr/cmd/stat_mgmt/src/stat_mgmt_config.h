@@ -25,10 +25,12 @@
 #include "syscfg/syscfg.h"
 
 #define STAT_MGMT_MAX_NAME_LEN  MYNEWT_VAL(STAT_MGMT_MAX_NAME_LEN)
+#define STAT_MGMT_SNAPSHOT_LEN  MYNEWT_VAL(STAT_MGMT_SNAPSHOT_LEN)
 
 #elif defined __ZEPHYR__
 
 #define STAT_MGMT_MAX_NAME_LEN  CONFIG_STAT_MGMT_MAX_NAME_LEN
+#define STAT_MGMT_SNAPSHOT_LEN  CONFIG_STAT_MGMT_SNAPSHOT_LEN
 
 #else
 
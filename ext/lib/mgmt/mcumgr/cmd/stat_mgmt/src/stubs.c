@@ -38,3 +38,16 @@ stat_mgmt_impl_foreach_entry(const char *stat_name,
 {
     return MGMT_ERR_ENOTSUP;
 }
+
+int __attribute__((weak))
+stat_mgmt_impl_get_group_size(const char *group_name, int *out_size)
+{
+    return MGMT_ERR_ENOTSUP;
+}
+
+int __attribute__((weak))
+stat_mgmt_impl_snapshot(struct stat_mgmt_snapshot *snap, uint8_t *buf,
+                        size_t *len)
+{
+    return MGMT_ERR_ENOTSUP;
+}
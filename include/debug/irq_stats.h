@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief APIs to read the per-IRQ latency and duration histograms.
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_IRQ_STATS_H_
+#define ZEPHYR_INCLUDE_DEBUG_IRQ_STATS_H_
+
+#ifdef CONFIG_IRQ_STATS
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statistics of an interrupt line.
+ *
+ * All the values are in core clock cycles, see irq_stats_bucket_limit()
+ * for the range of the histogram buckets.
+ */
+struct irq_stats {
+	/** Number of ISR runs */
+	u32_t count;
+	/** Longest entry latency, from the interrupt wrapper to the ISR */
+	u32_t latency_max;
+	/** Longest ISR duration, nested interrupts excluded */
+	u32_t duration_max;
+	/** Histogram of the entry latency */
+	u32_t latency[CONFIG_IRQ_STATS_BUCKETS];
+	/** Histogram of the ISR duration */
+	u32_t duration[CONFIG_IRQ_STATS_BUCKETS];
+};
+
+/**
+ * @brief Get the statistics of an interrupt line.
+ *
+ * @param irq Interrupt line.
+ * @param stats Statistics, copied at once.
+ *
+ * @retval 0 If successful.
+ * @retval -EINVAL If the line does not exist.
+ */
+int irq_stats_get(unsigned int irq, struct irq_stats *stats);
+
+/**
+ * @brief Reset the statistics of all the interrupt lines.
+ */
+void irq_stats_reset(void);
+
+/**
+ * @brief Get the upper limit of a histogram bucket.
+ *
+ * @param bucket Bucket index.
+ *
+ * @return Number of cycles the values counted in the bucket are below, or 0
+ * for the last bucket which has no limit.
+ */
+static inline u32_t irq_stats_bucket_limit(unsigned int bucket)
+{
+	if (bucket >= CONFIG_IRQ_STATS_BUCKETS - 1) {
+		return 0;
+	}
+
+	return 1U << (CONFIG_IRQ_STATS_BUCKET_SHIFT + bucket);
+}
+
+/**
+ * @brief Get the frequency of the cycles counted.
+ *
+ * @return Core clock frequency, in Hz.
+ */
+u32_t irq_stats_cycles_per_sec(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_IRQ_STATS */
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_IRQ_STATS_H_ */
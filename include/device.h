@@ -144,10 +144,12 @@ extern "C" {
 #else
 #define DEVICE_DEFINE(dev_name, drv_name, init_fn, pm_control_fn,	  \
 		      data, cfg_info, level, prio, api)			  \
+	_DEVICE_PM_DEFINE(dev_name)					  \
 	static struct device_config _CONCAT(__config_, dev_name) __used	  \
 	__attribute__((__section__(".devconfig.init"))) = {		  \
 		.name = drv_name, .init = (init_fn),			  \
 		.device_pm_control = (pm_control_fn),			  \
+		_DEVICE_PM_INIT(dev_name)				  \
 		.config_info = (cfg_info)				  \
 	};								  \
 	static struct device _CONCAT(__device_, dev_name) __used	  \
@@ -158,6 +160,16 @@ extern "C" {
 	}
 #endif
 
+#ifdef CONFIG_DEVICE_IDLE_PM
+#define _DEVICE_PM_DEFINE(dev_name) \
+	static struct device_pm _CONCAT(__pm_, dev_name) __used;
+#define _DEVICE_PM_INIT(dev_name) \
+	.pm = &_CONCAT(__pm_, dev_name),
+#else
+#define _DEVICE_PM_DEFINE(dev_name)
+#define _DEVICE_PM_INIT(dev_name)
+#endif
+
 /**
  * @def DEVICE_NAME_GET
  *
@@ -208,6 +220,30 @@ extern "C" {
 
 struct device;
 
+#ifdef CONFIG_DEVICE_IDLE_PM
+/**
+ * @brief Runtime power management data of a device
+ *
+ * @param dev Device the data belongs to
+ * @param work Work running the deferred power state transitions
+ * @param lock Serializes the power state transitions
+ * @param signal Raised with the result of a deferred transition
+ * @param usage Number of users holding the device active
+ * @param autosuspend_delay Delay before suspending the unused device, in ms
+ * @param state Current device power state
+ * @param enable Whether runtime power management is enabled
+ */
+struct device_pm {
+	struct device *dev;
+	struct k_delayed_work work;
+	struct k_sem lock;
+	struct k_poll_signal signal;
+	atomic_t usage;
+	s32_t autosuspend_delay;
+	u32_t state;
+	bool enable;
+};
+#endif
 
 /**
  * @brief Static device information (In ROM) Per driver instance
@@ -222,6 +258,9 @@ struct device_config {
 #ifdef CONFIG_DEVICE_POWER_MANAGEMENT
 	int (*device_pm_control)(struct device *device, u32_t command,
 				 void *context);
+#ifdef CONFIG_DEVICE_IDLE_PM
+	struct device_pm *pm;
+#endif
 #endif
 	const void *config_info;
 };
@@ -449,6 +488,103 @@ int device_busy_check(struct device *chk_dev);
 
 #endif
 
+#ifdef CONFIG_DEVICE_IDLE_PM
+/**
+ * @brief Enable runtime power management of a device
+ *
+ * Called by a device driver, typically from its init function, once the
+ * device is active. From then on, the device is resumed when a user gets
+ * it and suspended once it has been put by all its users for its
+ * autosuspend delay, through the device power control function.
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ */
+void device_pm_enable(struct device *dev);
+
+/**
+ * @brief Disable runtime power management of a device
+ *
+ * The device is resumed and stays active from then on.
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ */
+void device_pm_disable(struct device *dev);
+
+/**
+ * @brief Set the autosuspend delay of a device
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ * @param delay Delay in milliseconds before suspending the device once it
+ * is no longer used, K_FOREVER to only suspend it with device_pm_put_sync().
+ */
+void device_pm_autosuspend_delay_set(struct device *dev, s32_t delay);
+
+/**
+ * @brief Get a device, resuming it asynchronously
+ *
+ * Increments the usage count of the device and resumes it from the system
+ * workqueue if needed. The device runtime power management signal,
+ * dev->config->pm->signal, is raised with the result of the resume once the
+ * device is active. It may be called from an ISR.
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ *
+ * @retval 0 If the resume was scheduled.
+ * @retval Errno Negative errno code if failure.
+ */
+int device_pm_get(struct device *dev);
+
+/**
+ * @brief Get a device, resuming it synchronously
+ *
+ * Increments the usage count of the device and resumes it if needed. From
+ * an ISR, the device power control function is called in the ISR, which
+ * fails if a transition of the device is in progress.
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ *
+ * @retval 0 If the device is active.
+ * @retval -EBUSY If called from an ISR while a transition is in progress.
+ * @retval Errno Negative errno code if the resume failed. The usage count
+ * is not incremented on failure.
+ */
+int device_pm_get_sync(struct device *dev);
+
+/**
+ * @brief Put a device, suspending it after its autosuspend delay
+ *
+ * Decrements the usage count of the device, and schedules its suspend on
+ * the system workqueue once it is no longer used. It may be called from an
+ * ISR.
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ *
+ * @retval 0 If successful.
+ * @retval Errno Negative errno code if failure.
+ */
+int device_pm_put(struct device *dev);
+
+/**
+ * @brief Put a device, suspending it at once if no longer used
+ *
+ * @param dev Pointer to device structure of the driver instance.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If called from an ISR while a transition is in progress.
+ * @retval Errno Negative errno code if the suspend failed.
+ */
+int device_pm_put_sync(struct device *dev);
+#else
+static inline void device_pm_enable(struct device *dev) { }
+static inline void device_pm_disable(struct device *dev) { }
+static inline void device_pm_autosuspend_delay_set(struct device *dev,
+						   s32_t delay) { }
+static inline int device_pm_get(struct device *dev) { return 0; }
+static inline int device_pm_get_sync(struct device *dev) { return 0; }
+static inline int device_pm_put(struct device *dev) { return 0; }
+static inline int device_pm_put_sync(struct device *dev) { return 0; }
+#endif /* CONFIG_DEVICE_IDLE_PM */
+
 /**
  * @}
  */
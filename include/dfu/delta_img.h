@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Delta image patch applier
+ *
+ * A patch rebuilds a target image from a source image, usually the image
+ * currently running, so that only the differences between the two images
+ * are transferred. Patches are created with scripts/delta_img.py.
+ *
+ * A patch is a header followed by records, all integers being little
+ * endian:
+ *
+ * - header: magic (u32), source size (u32), CRC-32 of the source (u32) and
+ *   target size (u32).
+ * - COPY record: op 0, length and offset, copies length bytes of the
+ *   source from the offset.
+ * - INSERT record: op 1, length and length bytes, copied as they are.
+ *
+ * Lengths are unsigned LEB128 varints. Offsets are zigzag encoded LEB128
+ * varints, relative to the end of the previous COPY record, so that the
+ * code that moved or was patched between the two images costs a few bytes.
+ */
+
+#ifndef ZEPHYR_INCLUDE_DFU_DELTA_IMG_H_
+#define ZEPHYR_INCLUDE_DFU_DELTA_IMG_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DELTA_IMG_MAGIC		0x31544c44
+#define DELTA_IMG_HEADER_SIZE	16
+
+/**
+ * @brief Read from the source image, as flash_area_read() does.
+ */
+typedef int (*delta_img_read_t)(void *arg, off_t off, void *dst, size_t len);
+
+/**
+ * @brief Write to the target image, as flash_img_buffered_write() does.
+ */
+typedef int (*delta_img_write_t)(void *arg, u8_t *data, size_t len,
+				 bool flush);
+
+struct delta_img_context {
+	u8_t buf[CONFIG_IMG_DELTA_BUF_SIZE];
+	delta_img_read_t read;
+	void *read_arg;
+	delta_img_write_t write;
+	void *write_arg;
+	size_t bytes_read;
+	/* Internal use only */
+	u8_t hdr[DELTA_IMG_HEADER_SIZE];
+	u32_t src_size;
+	u32_t dst_size;
+	u32_t src_off;
+	u32_t dst_off;
+	u32_t len;
+	u32_t val;
+	u8_t shift;
+	u8_t state;
+	u8_t op;
+};
+
+/**
+ * @brief Check whether the first bytes of an upload are a patch.
+ *
+ * @param data first bytes of the upload
+ * @param len number of bytes in @a data
+ *
+ * @return true if @a data starts with the magic of a patch
+ */
+bool delta_img_is_patch(const u8_t *data, size_t len);
+
+/**
+ * @brief Initialize the context for a patch.
+ *
+ * @param ctx context to be initialized
+ * @param read function reading the source image
+ * @param read_arg argument of @a read
+ * @param write function writing the target image
+ * @param write_arg argument of @a write
+ *
+ * @return  0 on success, negative errno code on fail
+ */
+int delta_img_init(struct delta_img_context *ctx, delta_img_read_t read,
+		   void *read_arg, delta_img_write_t write,
+		   void *write_arg);
+
+struct flash_img_context;
+
+/**
+ * @brief Initialize the context to patch the image slot 0 into the image
+ * slot 1.
+ *
+ * The target image is written with flash_img_buffered_write().
+ *
+ * @param ctx context to be initialized
+ * @param img context of the image writer, already initialized
+ *
+ * @return  0 on success, negative errno code on fail
+ */
+int delta_img_flash_init(struct delta_img_context *ctx,
+			 struct flash_img_context *img);
+
+/**
+ * @brief Read number of patch bytes processed.
+ *
+ * @param ctx context
+ *
+ * @return Number of bytes of the patch processed.
+ */
+size_t delta_img_bytes_read(struct delta_img_context *ctx);
+
+/**
+ * @brief  Apply the next bytes of a patch.
+ *
+ * The patch can be split in buffers of any size. The source image is read
+ * and the target image is written as the records are decoded, through the
+ * CONFIG_IMG_DELTA_BUF_SIZE bytes buffer of the context. The CRC-32 of the
+ * source is checked once the header is complete.
+ *
+ * A final call to this function with flush set to true checks that the
+ * target image is complete and flushes it.
+ *
+ * @param ctx context
+ * @param data patch bytes
+ * @param len Number of bytes in @a data
+ * @param flush true for the last bytes of the patch
+ *
+ * @return  0 on success, -EINVAL if the patch is malformed or does not
+ * apply to the source, other negative errno code on read or write fail
+ */
+int delta_img_write(struct delta_img_context *ctx, const u8_t *data,
+		    size_t len, bool flush);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* ZEPHYR_INCLUDE_DFU_DELTA_IMG_H_ */
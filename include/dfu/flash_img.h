@@ -13,12 +13,33 @@ extern "C" {
 #endif
 
 #include <flash_map.h>
+#include <kernel.h>
+#ifdef CONFIG_IMG_STREAM_HASH
+#include <tinycrypt/sha256.h>
+#endif
 
 struct flash_img_context {
 	u8_t buf[CONFIG_IMG_BLOCK_BUF_SIZE];
 	const struct flash_area *flash_area;
 	size_t bytes_written;
 	u16_t buf_bytes;
+#ifdef CONFIG_IMG_ERASE_PROGRESSIVELY
+	/* Offset of the first byte of the slot not erased yet */
+	off_t off_erased;
+#endif
+#ifdef CONFIG_IMG_WRITE_PIPELINE
+	/* Block handed to the writer thread */
+	u8_t wbuf[CONFIG_IMG_BLOCK_BUF_SIZE];
+	off_t woff;
+	int wrc;
+	struct k_work work;
+#endif
+#ifdef CONFIG_IMG_STREAM_HASH
+	/* Hash of the bytes received, up to hash_len if known */
+	struct tc_sha256_state_struct sha;
+	size_t hash_len;
+	bool hash_len_known;
+#endif
 };
 
 /**
@@ -48,6 +69,15 @@ size_t flash_img_bytes_written(struct flash_img_context *ctx);
  * in blocks, the contents of flash from the last byte written up to the next
  * multiple of CONFIG_IMG_BLOCK_BUF_SIZE is padded with 0xff.
  *
+ * With CONFIG_IMG_WRITE_PIPELINE, a full block is written to flash by a
+ * dedicated thread while the function returns, and an error writing it is
+ * returned by the next call. The final call waits for all the blocks to be
+ * written.
+ *
+ * With CONFIG_IMG_STREAM_HASH, the final call also reads back the image
+ * and checks it against the hash of the data received and against the
+ * SHA-256 TLV of its mcuboot trailer.
+ *
  * @param ctx context
  * @param data data to write
  * @param len Number of bytes to write
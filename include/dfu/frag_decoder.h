@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Fragmented data block decoder
+ *
+ * The decoder rebuilds a file sent as fragments over a lossy, possibly
+ * multicast, link, with the forward error correction of the LoRaWAN
+ * fragmented data block transport. The file is sent as N uncoded
+ * fragments, followed by coded fragments, each the XOR of a pseudo-random
+ * half of the uncoded fragments. The file is rebuilt from any N fragments
+ * or a few more, whichever they are, without any request to the sender.
+ *
+ * The uncoded fragments are written to the file flash area as they are
+ * received. The coded fragments are reduced against the fragments and the
+ * rows of the reconstruction matrix already known, and stored as a new row
+ * of the matrix in a second flash area, so that the RAM used does not
+ * depend on the number of fragments lost. Both areas are written once
+ * after they are erased, the missing fragments being written to the file
+ * area once all of them can be computed.
+ */
+
+#ifndef ZEPHYR_INCLUDE_DFU_FRAG_DECODER_H_
+#define ZEPHYR_INCLUDE_DFU_FRAG_DECODER_H_
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <flash_map.h>
+#include <misc/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest write block size supported */
+#define FRAG_DECODER_ALIGN_MAX	8
+
+#define FRAG_DECODER_ROW_SIZE \
+	ROUND_UP(ceiling_fraction(CONFIG_FRAG_DECODER_MAX_MISSING, 8), \
+		 FRAG_DECODER_ALIGN_MAX)
+
+struct frag_decoder {
+	/** Flash area the file is rebuilt in. */
+	const struct flash_area *file;
+	/** Flash area the reconstruction matrix is stored in. */
+	const struct flash_area *matrix;
+	/** Number of uncoded fragments of the file. */
+	u16_t nb_frags;
+	/** Size of the fragments. */
+	u16_t frag_size;
+	/** Number of fragments processed, but the duplicate uncoded ones. */
+	u16_t nb_rx;
+	/** Number of uncoded fragments lost, once coded fragments arrive. */
+	u16_t nb_lost;
+
+	/* Internal use only */
+	u16_t nb_uncoded;
+	u16_t nb_rows;
+	u16_t row_len;
+	u8_t align;
+	bool coding;
+	bool done;
+	u8_t received[ceiling_fraction(CONFIG_FRAG_DECODER_MAX_FRAGMENTS, 8)];
+	u8_t parity[ceiling_fraction(CONFIG_FRAG_DECODER_MAX_FRAGMENTS, 8)];
+	u8_t rows[ceiling_fraction(CONFIG_FRAG_DECODER_MAX_MISSING, 8)];
+	u8_t row[FRAG_DECODER_ROW_SIZE];
+	u8_t data[CONFIG_FRAG_DECODER_MAX_FRAG_SIZE];
+};
+
+/**
+ * @brief Start a fragmentation session.
+ *
+ * Both flash areas are erased.
+ *
+ * @param dec decoder to be initialized
+ * @param file flash area the file is rebuilt in
+ * @param matrix flash area the reconstruction matrix is stored in, which
+ * needs up to nb_lost * (nb_lost / 8 + frag_size) bytes, rounded to the
+ * write block size
+ * @param nb_frags number of uncoded fragments of the file
+ * @param frag_size size of the fragments, a multiple of the write block
+ * size of both flash areas
+ *
+ * @return  0 on success, -EINVAL if the parameters are not supported,
+ * negative errno code on flash erase fail
+ */
+int frag_decoder_init(struct frag_decoder *dec,
+		      const struct flash_area *file,
+		      const struct flash_area *matrix,
+		      u16_t nb_frags, u16_t frag_size);
+
+/**
+ * @brief Process a fragment.
+ *
+ * @param dec decoder
+ * @param index index of the fragment, from 1 to nb_frags for the uncoded
+ * fragments, and from nb_frags + 1 for the coded fragments
+ * @param data frag_size bytes of the fragment
+ *
+ * @return 1 if the file is complete, 0 if more fragments are needed,
+ * -ENOSPC if more fragments were lost than CONFIG_FRAG_DECODER_MAX_MISSING
+ * or the matrix area can hold, negative errno code on flash fail
+ */
+int frag_decoder_process(struct frag_decoder *dec, u16_t index,
+			 const u8_t *data);
+
+/**
+ * @brief Check whether the file is complete.
+ *
+ * @param dec decoder
+ *
+ * @return true once all the fragments of the file are in the file area
+ */
+static inline bool frag_decoder_done(const struct frag_decoder *dec)
+{
+	return dec->done;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* ZEPHYR_INCLUDE_DFU_FRAG_DECODER_H_ */
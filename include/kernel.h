@@ -18,6 +18,10 @@
 #include <errno.h>
 #include <stdbool.h>
 
+#if defined(CONFIG_TRACING_CPU_STATS_THREADS_STATS)
+#include <stats.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -489,6 +493,37 @@ struct _thread_stack_info {
 typedef struct _thread_stack_info _thread_stack_info_t;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#if defined(CONFIG_TRACING_CPU_STATS_THREADS)
+/* CPU and stack usage of a thread, updated by the CPU stats tracing hooks */
+struct _thread_cpu_stats {
+#if defined(CONFIG_TRACING_CPU_STATS_THREADS_STATS)
+	/* The 32-bit entries below, up to the runtime, are exported as a
+	 * statistics group.
+	 */
+	struct stats_hdr s_hdr;
+#endif
+	/* Number of times the thread was switched in */
+	u32_t switches;
+
+	/* Stack usage high-water mark sampled so far, in bytes */
+	u32_t stack_used;
+
+#if defined(CONFIG_TRACING_CPU_STATS_THREADS_STATS)
+	/* Runtime in milliseconds, and the cycles not accounted in it yet */
+	u32_t runtime;
+	u32_t runtime_cycles;
+
+	/* Statistics group name, when the thread has none */
+	char name[sizeof("0x") + 2 * sizeof(void *)];
+#endif
+	/* Runtime out of interrupts, in cycles */
+	u64_t cycles;
+
+	/* Offset of the next stack word to sample */
+	u32_t stack_cursor;
+};
+#endif /* CONFIG_TRACING_CPU_STATS_THREADS */
+
 #if defined(CONFIG_USERSPACE)
 struct _mem_domain_info {
 	/* memory domain queue node */
@@ -561,6 +596,11 @@ struct k_thread {
 	struct _thread_stack_info stack_info;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#if defined(CONFIG_TRACING_CPU_STATS_THREADS)
+	/** CPU and stack usage */
+	struct _thread_cpu_stats cpu_stats;
+#endif
+
 #if defined(CONFIG_USERSPACE)
 	/** memory domain info of the thread */
 	struct _mem_domain_info mem_domain_info;
@@ -14,6 +14,9 @@
 #include <zephyr/types.h>
 #include <misc/util.h>
 #include <zephyr.h>
+#if defined(CONFIG_NET_BUF_POOL_STATS)
+#include <stats.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -532,6 +535,29 @@ struct net_buf_data_alloc {
 	void *alloc_data;
 };
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+/** Allocation statistics of a buffer pool. */
+struct net_buf_pool_stats {
+#if defined(CONFIG_NET_BUF_POOL_STATS)
+	/** Statistics group header, the counters below are exported
+	 *  as a stats group named after the pool.
+	 */
+	struct stats_hdr s_hdr;
+#endif
+	/** Number of successful allocations. */
+	u32_t alloc_count;
+
+	/** Number of failed allocations. */
+	u32_t alloc_failed;
+
+	/** Total time spent waiting in allocations, in milliseconds. */
+	u32_t wait_time;
+
+	/** Highest number of buffers in use at the same time. */
+	u32_t max_used;
+};
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 struct net_buf_pool {
 	/** LIFO to place the buffer into when free */
 	struct k_lifo free;
@@ -551,6 +577,9 @@ struct net_buf_pool {
 
 	/** Name of the pool. Used when printing pool information. */
 	const char *name;
+
+	/** Allocation statistics of the pool. */
+	struct net_buf_pool_stats stats;
 #endif /* CONFIG_NET_BUF_POOL_USAGE */
 
 	/** Optional destroy callback when buffer is freed. */
@@ -706,6 +735,40 @@ extern const struct net_buf_data_cb net_buf_var_cb;
 		NET_BUF_POOL_INITIALIZER(_name, &net_buf_data_alloc_##_name,  \
 					 _net_buf_##_name, _count, _destroy)
 
+/** Space used by the variable size data allocator in front of each payload. */
+#define NET_BUF_VAR_DATA_OVERHEAD (sizeof(struct k_mem_block_id) + 1)
+
+/** @def NET_BUF_POOL_VAR_BOUNDED_DEFINE
+ *  @brief Define a new pool for buffers with bounded variable size payloads
+ *
+ *  Same as NET_BUF_POOL_VAR_DEFINE(), except that a single payload
+ *  allocation can not take more than @a _max_frag bytes of the data memory
+ *  (including NET_BUF_VAR_DATA_OVERHEAD). Small payloads get a block close
+ *  to their size, and users needing more data than @a _max_frag chain
+ *  several buffers, so one large packet can not exhaust or fragment the
+ *  whole pool.
+ *
+ *  @param _name      Name of the pool variable.
+ *  @param _count     Number of buffers in the pool.
+ *  @param _data_size Total amount of memory available for data payloads.
+ *  @param _max_frag  Maximum memory used by one payload. Must be 16 times
+ *                    a power of four, e.g. 64, 256 or 1024.
+ *  @param _destroy   Optional destroy callback when buffer is freed.
+ */
+#define NET_BUF_POOL_VAR_BOUNDED_DEFINE(_name, _count, _data_size,           \
+					_max_frag, _destroy)                  \
+	static struct net_buf _net_buf_##_name[_count] __noinit;              \
+	K_MEM_POOL_DEFINE(net_buf_mem_pool_##_name, 16, _max_frag,            \
+			  (_data_size) / (_max_frag), 4);                     \
+	static const struct net_buf_data_alloc net_buf_data_alloc_##_name = { \
+		.cb = &net_buf_var_cb,                                        \
+		.alloc_data = &net_buf_mem_pool_##_name,                      \
+	};                                                                    \
+	struct net_buf_pool _name __net_buf_align                             \
+			__in_section(_net_buf_pool, static, _name) =          \
+		NET_BUF_POOL_INITIALIZER(_name, &net_buf_data_alloc_##_name,  \
+					 _net_buf_##_name, _count, _destroy)
+
 /** @def NET_BUF_POOL_DEFINE
  *  @brief Define a new pool for buffers
  *
@@ -739,6 +802,25 @@ extern const struct net_buf_data_cb net_buf_var_cb;
  */
 struct net_buf_pool *net_buf_pool_get(int id);
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+/**
+ *  @typedef net_buf_pool_cb_t
+ *  @brief Callback used while iterating over buffer pools
+ *
+ *  @param pool A valid pointer on current buffer pool
+ *  @param user_data A valid pointer on some user data or NULL
+ */
+typedef void (*net_buf_pool_cb_t)(struct net_buf_pool *pool, void *user_data);
+
+/**
+ *  @brief Go through all the buffer pools defined in the system.
+ *
+ *  @param cb User-supplied callback function to call
+ *  @param user_data User specified data
+ */
+void net_buf_pool_foreach(net_buf_pool_cb_t cb, void *user_data);
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 /**
  *  @brief Get a zero-based index for a buffer.
  *
@@ -208,6 +208,19 @@ struct coap_packet {
 	u16_t delta; /* Used for delta calculation in CoAP packet */
 };
 
+/**
+ * @brief Pre-encoded CoAP message, see coap_template_init().
+ */
+struct coap_template {
+	struct coap_packet opts; /* Pre-encoded options */
+	u16_t observe_pos; /* Offset of the Observe value, 0 if none */
+	u8_t type; /* CoAP header type */
+	u8_t code; /* CoAP header code */
+};
+
+/** Length of the Observe option value in a #coap_template */
+#define COAP_TEMPLATE_OBSERVE_LEN 3
+
 struct coap_option {
 	u16_t delta;
 #if defined(CONFIG_COAP_EXTENDED_OPTIONS_LEN)
@@ -447,6 +460,94 @@ int coap_packet_append_payload_marker(struct coap_packet *cpkt);
 int coap_packet_append_payload(struct coap_packet *cpkt, u8_t *payload,
 			       u16_t payload_len);
 
+/**
+ * @brief Initializes a CoAP message template.
+ *
+ * A template holds the parts of a message that don't change from one
+ * message to the next, typically the notifications of an observed
+ * resource. The options are encoded once into @a data, and
+ * coap_template_build() only has to copy them and fill in the message
+ * id, the token, the Observe sequence number and the payload.
+ *
+ * @param tmpl Template to be initialized using the storage from @a data
+ * @param data Storage for the encoded options
+ * @param max_len Size of @a data
+ * @param type CoAP header type
+ * @param code CoAP header code
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_template_init(struct coap_template *tmpl, u8_t *data,
+		       u16_t max_len, u8_t type, u8_t code);
+
+/**
+ * @brief Appends an option to a template.
+ *
+ * Same as coap_packet_append_option(), options must be added in
+ * numeric order of their codes.
+ *
+ * @param tmpl Template to be updated
+ * @param code Option code to add, see #coap_option_num
+ * @param value Pointer to the value of the option
+ * @param len Size of the value
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_template_append_option(struct coap_template *tmpl, u16_t code,
+				const u8_t *value, u16_t len);
+
+/**
+ * @brief Appends an integer value option to a template.
+ *
+ * @param tmpl Template to be updated
+ * @param code Option code to add, see #coap_option_num
+ * @param val Integer value to be added
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_template_append_option_int(struct coap_template *tmpl, u16_t code,
+				    unsigned int val);
+
+/**
+ * @brief Appends an Observe option to a template.
+ *
+ * The option value is left empty in the template and written by
+ * coap_template_build(). It is always encoded on
+ * #COAP_TEMPLATE_OBSERVE_LEN bytes, so that the other options don't
+ * move when the sequence number grows.
+ *
+ * @param tmpl Template to be updated
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_template_append_observe(struct coap_template *tmpl);
+
+/**
+ * @brief Creates a CoAP packet from a template.
+ *
+ * The resulting packet can be extended with options following the
+ * ones of the template and with a payload, as long as @a payload_len
+ * is 0.
+ *
+ * @param tmpl Template to use
+ * @param cpkt New packet to be initialized using the storage from @a data
+ * @param data Data that will contain the CoAP packet
+ * @param max_len Maximum allowable length of data
+ * @param id CoAP header message id
+ * @param token CoAP header token
+ * @param tkl CoAP header token length
+ * @param observe Observe sequence number, ignored if the template has
+ * no Observe option
+ * @param payload Payload to add after the options, can be NULL
+ * @param payload_len Payload length, 0 to add no payload marker
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_template_build(const struct coap_template *tmpl,
+			struct coap_packet *cpkt, u8_t *data, u16_t max_len,
+			u16_t id, const u8_t *token, u8_t tkl,
+			u32_t observe, const u8_t *payload, u16_t payload_len);
+
 /**
  * @brief When a request is received, call the appropriate methods of
  * the matching resources.
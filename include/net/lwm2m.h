@@ -193,6 +193,25 @@ int lwm2m_engine_get_bool(char *path, bool *value);
 int lwm2m_engine_get_float32(char *pathstr, float32_value_t *buf);
 int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf);
 
+/**
+ * @brief Record the current value of a resource as a time series sample
+ *
+ * @details The value is stored with the current time, and reported in
+ * the next SenML CBOR read or notification of a path that contains the
+ * resource, as a record whose time is relative to the time of the
+ * report. Several samples of a resource can be sent in one notification
+ * this way. Up to CONFIG_LWM2M_RW_SENML_CBOR_SAMPLES samples are kept,
+ * the oldest one being dropped when there is no room for a new one.
+ *
+ * @param pathstr Resource or resource instance path, such as
+ * "3303/0/5700"
+ *
+ * @return 0 on success, -ENOTSUP if samples are not enabled, or another
+ * negative error code if the path does not designate a numeric or
+ * boolean resource.
+ */
+int lwm2m_engine_push_sample(char *pathstr);
+
 int lwm2m_engine_register_read_callback(char *path,
 					lwm2m_engine_get_data_cb_t cb);
 int lwm2m_engine_register_pre_write_callback(char *path,
@@ -220,6 +239,132 @@ int lwm2m_engine_set_res_data(char *pathstr, void *data_ptr, u16_t data_len,
 int lwm2m_engine_get_res_data(char *pathstr, void **data_ptr, u16_t *data_len,
 			      u8_t *data_flags);
 
+struct lwm2m_engine_obj_inst;
+struct lwm2m_engine_obj_field;
+struct lwm2m_engine_res_inst;
+
+/**
+ * @brief LwM2M resource handle
+ *
+ * @details A resource handle is resolved once from a path with
+ * lwm2m_engine_get_res_handle(). The lwm2m_engine_res_set_*() and
+ * lwm2m_engine_res_get_*() functions then access the resource without
+ * parsing the path and looking up the object instance again.
+ *
+ * A handle is valid until its object instance is deleted.
+ */
+struct lwm2m_res_handle {
+	/** Private engine structures */
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res_inst *res;
+};
+
+/**
+ * @brief Resource value of a batch update
+ *
+ * @details The value must have the size and type of the resource data,
+ * as for the typed setters.
+ */
+struct lwm2m_res_update {
+	/** Resource to update */
+	const struct lwm2m_res_handle *handle;
+	/** New value of the resource */
+	const void *value;
+	/** Length of the value */
+	u16_t len;
+};
+
+/** Initializer of a struct lwm2m_res_update from a pointer to a value */
+#define LWM2M_RES_UPDATE(_handle, _value_ptr)		\
+	{						\
+		.handle = (_handle),			\
+		.value = (_value_ptr),			\
+		.len = sizeof(*(_value_ptr)),		\
+	}
+
+/**
+ * @brief Resolve a resource path into a handle
+ *
+ * @param pathstr Resource path, such as "3303/0/5700"
+ * @param handle Handle to fill
+ *
+ * @return 0 on success, a negative error code if the path does not
+ * designate an existing resource.
+ */
+int lwm2m_engine_get_res_handle(char *pathstr,
+				struct lwm2m_res_handle *handle);
+
+/**
+ * @brief Update several resources at once
+ *
+ * @details The values are written in order, as with the typed setters,
+ * and the changed resources are notified to their observers in a single
+ * run of the engine service. The update stops at the first error, the
+ * resources written before it keep their new value.
+ *
+ * @param updates Resources and values to write
+ * @param count Number of entries in @p updates
+ *
+ * @return 0 on success, the error of the failed write otherwise.
+ */
+int lwm2m_engine_res_set_batch(const struct lwm2m_res_update *updates,
+			       int count);
+
+int lwm2m_engine_res_set_opaque(const struct lwm2m_res_handle *handle,
+				const void *data_ptr, u16_t data_len);
+int lwm2m_engine_res_set_string(const struct lwm2m_res_handle *handle,
+				const char *data_ptr);
+int lwm2m_engine_res_set_u8(const struct lwm2m_res_handle *handle,
+			    u8_t value);
+int lwm2m_engine_res_set_u16(const struct lwm2m_res_handle *handle,
+			     u16_t value);
+int lwm2m_engine_res_set_u32(const struct lwm2m_res_handle *handle,
+			     u32_t value);
+int lwm2m_engine_res_set_u64(const struct lwm2m_res_handle *handle,
+			     u64_t value);
+int lwm2m_engine_res_set_s8(const struct lwm2m_res_handle *handle,
+			    s8_t value);
+int lwm2m_engine_res_set_s16(const struct lwm2m_res_handle *handle,
+			     s16_t value);
+int lwm2m_engine_res_set_s32(const struct lwm2m_res_handle *handle,
+			     s32_t value);
+int lwm2m_engine_res_set_s64(const struct lwm2m_res_handle *handle,
+			     s64_t value);
+int lwm2m_engine_res_set_bool(const struct lwm2m_res_handle *handle,
+			      bool value);
+int lwm2m_engine_res_set_float32(const struct lwm2m_res_handle *handle,
+				 const float32_value_t *value);
+int lwm2m_engine_res_set_float64(const struct lwm2m_res_handle *handle,
+				 const float64_value_t *value);
+
+int lwm2m_engine_res_get_opaque(const struct lwm2m_res_handle *handle,
+				void *buf, u16_t buflen);
+int lwm2m_engine_res_get_string(const struct lwm2m_res_handle *handle,
+				void *buf, u16_t buflen);
+int lwm2m_engine_res_get_u8(const struct lwm2m_res_handle *handle,
+			    u8_t *value);
+int lwm2m_engine_res_get_u16(const struct lwm2m_res_handle *handle,
+			     u16_t *value);
+int lwm2m_engine_res_get_u32(const struct lwm2m_res_handle *handle,
+			     u32_t *value);
+int lwm2m_engine_res_get_u64(const struct lwm2m_res_handle *handle,
+			     u64_t *value);
+int lwm2m_engine_res_get_s8(const struct lwm2m_res_handle *handle,
+			    s8_t *value);
+int lwm2m_engine_res_get_s16(const struct lwm2m_res_handle *handle,
+			     s16_t *value);
+int lwm2m_engine_res_get_s32(const struct lwm2m_res_handle *handle,
+			     s32_t *value);
+int lwm2m_engine_res_get_s64(const struct lwm2m_res_handle *handle,
+			     s64_t *value);
+int lwm2m_engine_res_get_bool(const struct lwm2m_res_handle *handle,
+			      bool *value);
+int lwm2m_engine_res_get_float32(const struct lwm2m_res_handle *handle,
+				 float32_value_t *buf);
+int lwm2m_engine_res_get_float64(const struct lwm2m_res_handle *handle,
+				 float64_value_t *buf);
+
 int lwm2m_engine_start(struct lwm2m_ctx *client_ctx);
 
 /* LWM2M RD Client */
@@ -27,6 +27,9 @@
 #include <zephyr.h>
 #include <zephyr/types.h>
 #include <net/tls_credentials.h>
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+#include <fcb.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -401,6 +404,57 @@ struct mqtt_transport {
 	};
 };
 
+/**
+ * @brief Queue of outgoing QoS 1 messages.
+ *
+ * Messages published through the queue are copied to its storage, and
+ * sent as soon as the number of messages waiting for an acknowledgment
+ * is below the window. They are removed when acknowledged by the
+ * broker, and the messages not acknowledged are sent again, with the
+ * duplicate flag set, when the connection is established again.
+ */
+struct mqtt_outbox {
+	/** Storage for the queued messages. */
+	u8_t *buf;
+
+	/** Size of the storage. */
+	u32_t buf_size;
+
+	/** Maximum number of messages waiting for an acknowledgment,
+	 *  CONFIG_MQTT_OUTBOX_WINDOW if 0.
+	 */
+	u16_t window;
+
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+	/** Flash circular buffer keeping a copy of the queue across resets,
+	 *  or NULL. It shall be initialized with fcb_init(), with at least
+	 *  one scratch sector, before mqtt_outbox_init() is called.
+	 */
+	struct fcb *fcb;
+#endif
+
+	/** Internal. Offset of the oldest message. */
+	u32_t head;
+
+	/** Internal. Offset where the next message is stored. */
+	u32_t tail;
+
+	/** Internal. Offset of the next message to send. */
+	u32_t next;
+
+	/** Internal. Number of messages in the queue. */
+	u32_t count;
+
+	/** Internal. Number of messages sent on the current connection. */
+	u32_t sent;
+
+	/** Internal. Number of messages waiting for an acknowledgment. */
+	u16_t inflight;
+
+	/** Internal. Last message id used. */
+	u16_t message_id;
+};
+
 /** @brief MQTT internal state. */
 struct mqtt_internal {
 	/** Internal. Mutex to protect access to the client instance. */
@@ -486,6 +540,11 @@ struct mqtt_client {
 	 *  Default is 1.
 	 */
 	u8_t clean_session : 1;
+
+#if defined(CONFIG_MQTT_OUTBOX)
+	/** Queue of outgoing QoS 1 messages, see @ref mqtt_outbox_init. */
+	struct mqtt_outbox *outbox;
+#endif
 };
 
 /**
@@ -526,6 +585,11 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note Only the headers of the message are encoded in the transmit buffer,
+ *       the payload is sent directly from the buffer of the caller, in the
+ *       same transport write. Its size is not limited by the size of the
+ *       transmit buffer.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
 int mqtt_publish(struct mqtt_client *client,
@@ -697,6 +761,55 @@ int mqtt_input(struct mqtt_client *client);
 int mqtt_read_publish_payload(struct mqtt_client *client, void *buffer,
 			      size_t length);
 
+#if defined(CONFIG_MQTT_OUTBOX)
+/**
+ * @brief Attach a queue of outgoing QoS 1 messages to the client.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] outbox Queue, with its storage set. Shall not be NULL.
+ *
+ * @note Shall be called after @ref mqtt_client_init.
+ * @note When the queue has a flash circular buffer, the messages not
+ *       acknowledged before a reset are restored in the queue, and sent
+ *       again, with the duplicate flag set, once connected.
+ * @note The queue uses the message ids from 0x8000, the messages
+ *       published with @ref mqtt_publish shall use ids below 0x8000.
+ *
+ * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ */
+int mqtt_outbox_init(struct mqtt_client *client, struct mqtt_outbox *outbox);
+
+/**
+ * @brief Queue a QoS 1 message for publication.
+ *
+ * The topic and the payload are copied to the queue, and the message is
+ * sent when connected, and when the window allows. The message id is
+ * assigned by the queue. @ref MQTT_EVT_PUBACK is notified as usual when
+ * the message is acknowledged.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] param Message to publish, with QoS @ref MQTT_QOS_1_AT_LEAST_ONCE.
+ *                  Shall not be NULL.
+ *
+ * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         -ENOMEM if the queue is full.
+ */
+int mqtt_outbox_publish(struct mqtt_client *client,
+			const struct mqtt_publish_param *param);
+
+/**
+ * @brief Get the number of messages in the queue, sent or not.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ *
+ * @return Number of messages not acknowledged yet.
+ */
+u32_t mqtt_outbox_count(struct mqtt_client *client);
+#endif /* CONFIG_MQTT_OUTBOX */
+
 #ifdef __cplusplus
 }
 #endif
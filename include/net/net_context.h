@@ -187,6 +187,8 @@ struct net_conn_handle;
 
 struct tls_context;
 
+struct zsock_pollset_entry;
+
 /**
  * Note that we do not store the actual source IP address in the context
  * because the address is already be set in the network interface struct.
@@ -270,6 +272,11 @@ struct net_context {
 	/** TLS context information */
 	struct tls_context *tls;
 #endif /* CONFIG_NET_SOCKETS_SOCKOPT_TLS */
+
+#if defined(CONFIG_NET_SOCKETS_POLLSET)
+	/** Poll set registration of this socket, if any */
+	struct zsock_pollset_entry *poll_entry;
+#endif /* CONFIG_NET_SOCKETS_POLLSET */
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -871,6 +878,34 @@ int net_context_sendto_new(struct net_context *context,
 			   void *token,
 			   void *user_data);
 
+/**
+ * @brief Send data gathered from several buffers.
+ *
+ * @details Same as net_context_sendto_new(), with the data taken from the
+ * buffers of @a msghdr in order. The data is written directly to the
+ * network packet, without an intermediate copy. The destination is
+ * msghdr->msg_name, or the remote address of a connected context if it
+ * is not set. This is similar as BSD sendmsg() function.
+ *
+ * @param context The network context to use.
+ * @param msghdr The buffers to send, and the optional destination address.
+ * @param flags Flags for the message, currently unused.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Timeout for the connection. Possible values
+ * are K_FOREVER, K_NO_WAIT, >0.
+ * @param token Caller specified value that is passed as is to callback.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_sendmsg(struct net_context *context,
+			const struct msghdr *msghdr,
+			int flags,
+			net_context_send_cb_t cb,
+			s32_t timeout,
+			void *token,
+			void *user_data);
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
@@ -218,6 +218,23 @@ struct sockaddr_storage {
 	char data[NET_SOCKADDR_MAX_SIZE - sizeof(sa_family_t)];
 };
 
+/** Scatter/gather buffer, as in POSIX <sys/uio.h> */
+struct iovec {
+	void  *iov_base;
+	size_t iov_len;
+};
+
+/** Message for sendmsg(), as in POSIX <sys/socket.h> */
+struct msghdr {
+	void         *msg_name;       /* optional destination address */
+	socklen_t     msg_namelen;    /* size of the destination address */
+	struct iovec *msg_iov;        /* scatter/gather array */
+	size_t        msg_iovlen;     /* number of elements in msg_iov */
+	void         *msg_control;    /* ancillary data, not supported */
+	size_t        msg_controllen; /* ancillary data buffer length */
+	int           msg_flags;      /* flags on received message */
+};
+
 struct net_addr {
 	sa_family_t family;
 	union {
@@ -55,6 +55,11 @@ typedef struct zsock_fd_set {
 #define ZSOCK_POLLHUP 0x10
 #define ZSOCK_POLLNVAL 0x20
 
+/* Operations for zsock_pollset_ctl() */
+#define ZSOCK_POLLSET_ADD 1
+#define ZSOCK_POLLSET_DEL 2
+#define ZSOCK_POLLSET_MOD 3
+
 #define ZSOCK_MSG_PEEK 0x02
 #define ZSOCK_MSG_DONTWAIT 0x40
 
@@ -160,6 +165,25 @@ static inline ssize_t zsock_send(int sock, const void *buf, size_t len,
 	return zsock_sendto(sock, buf, len, flags, NULL, 0);
 }
 
+/**
+ * @brief Send data gathered from several buffers
+ *
+ * Same as zsock_sendto(), with the data taken from the buffers of
+ * @a msg in order, and the optional destination address from its
+ * msg_name. The buffers are sent in a single packet on datagram
+ * sockets, and queued without an intermediate copy on stream sockets.
+ * Ancillary data is not supported.
+ *
+ * @param sock Socket
+ * @param msg Message to send
+ * @param flags Same as for zsock_sendto()
+ *
+ * @return Number of bytes queued, which can be less than the total length
+ *         of the buffers on stream sockets, or -1 with errno set on error.
+ */
+__syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
+				int flags);
+
 __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
@@ -174,6 +198,75 @@ __syscall int zsock_fcntl(int sock, int cmd, int flags);
 
 __syscall int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
 
+/**
+ * @brief Poll sockets, or wait for a signal
+ *
+ * Same as zsock_poll(), but also returns when @a signal is raised. This
+ * lets another thread wake up the caller without a timeout, for example
+ * when the set of sockets to poll changed. The signal is not reset, the
+ * caller checks and resets it. Only available to kernel threads.
+ *
+ * @param fds Sockets to poll
+ * @param nfds Number of entries in @a fds
+ * @param signal Signal that ends the wait when raised
+ * @param timeout Timeout in milliseconds, negative value waits forever
+ *
+ * @return Number of ready sockets, 0 on timeout or if only the signal
+ *         was raised, or -1 with errno set on error.
+ */
+int zsock_poll_signal(struct zsock_pollfd *fds, int nfds,
+		      struct k_poll_signal *signal, int timeout);
+
+/**
+ * @brief Create a persistent poll set
+ *
+ * A poll set keeps a registered interest list of sockets, so that waiting
+ * for events does not need to walk all the sockets on every call, as
+ * zsock_poll() does. Sockets signal the poll set directly when they become
+ * readable, and zsock_pollset_wait() only looks at those.
+ *
+ * The poll set is itself a file descriptor and is released with
+ * zsock_close().
+ *
+ * @return Poll set descriptor, or -1 with errno set on error.
+ */
+__syscall int zsock_pollset_create(void);
+
+/**
+ * @brief Add, modify or remove a socket in a poll set
+ *
+ * A socket can be registered in at most one poll set at a time. Closing
+ * a socket removes it from its poll set.
+ *
+ * @param pset Poll set descriptor from zsock_pollset_create()
+ * @param op ZSOCK_POLLSET_ADD, ZSOCK_POLLSET_MOD or ZSOCK_POLLSET_DEL
+ * @param sock Socket descriptor
+ * @param events Requested events (ZSOCK_POLLIN, ZSOCK_POLLOUT), ignored
+ *        for ZSOCK_POLLSET_DEL
+ *
+ * @return 0 on success, -1 with errno set on error. errno is EINVAL if
+ *         @a events has other bits set.
+ */
+__syscall int zsock_pollset_ctl(int pset, int op, int sock, int events);
+
+/**
+ * @brief Wait for sockets in a poll set to become ready
+ *
+ * Only the ready sockets are reported, in the fd, events and revents
+ * fields of the @a ready array. The readiness is level-triggered: a
+ * socket that still has data pending is reported again on the next call.
+ *
+ * @param pset Poll set descriptor from zsock_pollset_create()
+ * @param ready Array to fill with ready sockets
+ * @param max_ready Number of entries in @a ready
+ * @param timeout Timeout in milliseconds, negative value waits forever
+ *
+ * @return Number of ready sockets stored in @a ready, 0 on timeout, or -1
+ *         with errno set on error.
+ */
+__syscall int zsock_pollset_wait(int pset, struct zsock_pollfd *ready,
+				 int max_ready, int timeout);
+
 /* select() API is inefficient, and implemented as inefficient wrapper on
  * top of poll(). Avoid select(), use poll directly().
  */
@@ -275,6 +368,12 @@ static inline ssize_t sendto(int sock, const void *buf, size_t len, int flags,
 	return zsock_sendto(sock, buf, len, flags, dest_addr, addrlen);
 }
 
+static inline ssize_t sendmsg(int sock, const struct msghdr *message,
+			      int flags)
+{
+	return zsock_sendmsg(sock, message, flags);
+}
+
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
 {
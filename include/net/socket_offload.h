@@ -140,6 +140,39 @@ static inline ssize_t sendto(int sock, const void *buf,
 	return socket_ops->sendto(sock, buf, len, flags, to, tolen);
 }
 
+static inline ssize_t sendmsg(int sock, const struct msghdr *msg, int flags)
+{
+	ssize_t len = 0;
+	ssize_t ret;
+	size_t i;
+
+	__ASSERT_NO_MSG(socket_ops);
+
+	if (socket_ops->sendmsg) {
+		return socket_ops->sendmsg(sock, msg, flags);
+	}
+
+	__ASSERT_NO_MSG(socket_ops->sendto);
+
+	/* Stream sockets only, datagrams would be split */
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		ret = socket_ops->sendto(sock, msg->msg_iov[i].iov_base,
+					 msg->msg_iov[i].iov_len, flags,
+					 msg->msg_name, msg->msg_namelen);
+		if (ret < 0) {
+			return len > 0 ? len : ret;
+		}
+
+		len += ret;
+
+		if (ret < msg->msg_iov[i].iov_len) {
+			break;
+		}
+	}
+
+	return len;
+}
+
 static inline int getaddrinfo(const char *node, const char *service,
 			      const struct addrinfo *hints,
 			      struct addrinfo **res)
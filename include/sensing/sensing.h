@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Public API of the sensor sampling service
+ */
+
+#ifndef ZEPHYR_INCLUDE_SENSING_SENSING_H_
+#define ZEPHYR_INCLUDE_SENSING_SENSING_H_
+
+/**
+ * @brief Sensor sampling service
+ * @defgroup sensing Sensor sampling service
+ * @ingroup io_interfaces
+ * @{
+ */
+
+#include <kernel.h>
+#include <sensor.h>
+#include <misc/slist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sensor sampled by the service.
+ *
+ * The sensors are fetched from a single thread, woken by a single timer.
+ * Sensors due within CONFIG_SENSING_COALESCE_MS of each other are fetched
+ * in the same wakeup, one bus after the other, so that the transactions on
+ * a bus are issued back to back.
+ */
+struct sensing_sensor {
+	/** Sensor device. */
+	struct device *dev;
+	/** Bus of the sensor, or NULL if it is not shared. */
+	struct device *bus;
+	/** Channels read after each fetch. */
+	const enum sensor_channel *chans;
+	/** Number of channels in @a chans. */
+	u8_t num_chans;
+	/** Sampling period, in milliseconds. */
+	u32_t period;
+	/** Number of failed fetches and reads. */
+	u32_t errors;
+
+	/* Internal use only */
+	sys_snode_t node;
+	u32_t next;
+	u32_t seq;
+};
+
+/**
+ * @brief Sample delivered to the subscribers.
+ */
+struct sensing_sample {
+	/** Time of the fetch, in microseconds of uptime modulo 2^32. */
+	u32_t timestamp;
+	/** Index of the fetch among those of the sensor. */
+	u32_t seq;
+	/** Sensor of the sample. */
+	struct sensing_sensor *sensor;
+	/** Channel of the sample. */
+	enum sensor_channel chan;
+	/** Value of the channel, 3 values for a channel with an _XYZ suffix. */
+	struct sensor_value val[3];
+};
+
+/**
+ * @brief Consumer of the samples.
+ *
+ * The samples of all sensors are stored in a single ring buffer of
+ * CONFIG_SENSING_RING_SIZE samples, that each subscriber reads at its own
+ * pace. A subscriber that falls behind by more than the size of the ring
+ * loses the oldest samples.
+ */
+struct sensing_subscriber {
+	/** Sensor whose samples are delivered, or NULL for all sensors. */
+	struct sensing_sensor *sensor;
+	/**
+	 * Delivery period, in milliseconds, or 0 for every sample. The
+	 * samples of @a sensor are decimated down to this period, which is
+	 * rounded to a multiple of the sampling period.
+	 */
+	u32_t period;
+	/** Number of samples overwritten before being read. */
+	u32_t lost;
+
+	/* Internal use only */
+	sys_snode_t node;
+	struct k_sem sem;
+	u32_t tail;
+	u32_t divider;
+};
+
+/**
+ * @brief Start sampling a sensor.
+ *
+ * The @a dev, @a bus, @a chans, @a num_chans and @a period fields must be
+ * set. The first fetch is aligned on the earliest fetch of the sensors
+ * already sampled, so that sensors with multiple periods share wakeups.
+ *
+ * @param sensor Sensor to sample.
+ *
+ * @return 0 on success, -EINVAL if the sensor is not valid.
+ */
+int sensing_sensor_add(struct sensing_sensor *sensor);
+
+/**
+ * @brief Stop sampling a sensor.
+ *
+ * The subscribers of the sensor must have unsubscribed first.
+ *
+ * @param sensor Sensor to stop sampling.
+ *
+ * @return 0 on success, -EBUSY if a subscriber still reads the sensor.
+ */
+int sensing_sensor_remove(struct sensing_sensor *sensor);
+
+/**
+ * @brief Subscribe to the samples.
+ *
+ * The @a sensor and @a period fields must be set. Only the samples fetched
+ * after the subscription are delivered.
+ *
+ * @param sub Subscriber.
+ *
+ * @return 0 on success, -EINVAL if the period is shorter than the sampling
+ * period of the sensor.
+ */
+int sensing_subscribe(struct sensing_subscriber *sub);
+
+/**
+ * @brief Cancel a subscription.
+ *
+ * @param sub Subscriber.
+ */
+void sensing_unsubscribe(struct sensing_subscriber *sub);
+
+/**
+ * @brief Read the next sample of a subscriber.
+ *
+ * @param sub Subscriber.
+ * @param sample Where to store the sample.
+ * @param timeout Waiting period for a sample, in milliseconds, or one of
+ * the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return 0 on success, -EAGAIN if no sample was delivered in time.
+ */
+int sensing_read(struct sensing_subscriber *sub,
+		 struct sensing_sample *sample, s32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_SENSING_SENSING_H_ */
@@ -210,6 +210,68 @@ enum sensor_attribute {
 	SENSOR_ATTR_CALIB_TARGET,
 };
 
+/**
+ * @brief Sample of a vector channel read from a sensor FIFO.
+ *
+ * The sensor FIFOs usually don't store the time at which the samples were
+ * taken, the timestamps are then estimated from the time of the read and
+ * the output data rate of the sensor.
+ */
+struct sensor_frame {
+	/** Time of the sample, in microseconds of uptime modulo 2^32. */
+	u32_t timestamp;
+	/** Channel of the sample, e.g. SENSOR_CHAN_ACCEL_XYZ. */
+	enum sensor_channel chan;
+	/** Values of the X, Y and Z axes, in that order. */
+	struct sensor_value val[3];
+};
+
+/**
+ * @brief Raw sample of a vector channel read from a sensor FIFO.
+ *
+ * Same as @ref sensor_frame, but the values are left as output by the
+ * sensor, in its current full scale range, which avoids the conversion
+ * when the samples are processed or stored in batches. The values can be
+ * converted later with the scale returned by sensor_channel_get_raw() for
+ * the channel of the frame.
+ */
+struct sensor_frame_raw {
+	/** Time of the sample, in microseconds of uptime modulo 2^32. */
+	u32_t timestamp;
+	/** Channel of the sample, e.g. SENSOR_CHAN_ACCEL_XYZ. */
+	u16_t chan;
+	/** Raw values of the X, Y and Z axes, in that order. */
+	s16_t val[3];
+};
+
+/**
+ * @brief Format of the frames read from a sensor FIFO.
+ */
+enum sensor_frame_format {
+	/** Frames of type @ref sensor_frame. */
+	SENSOR_FRAME_VALUE,
+	/** Frames of type @ref sensor_frame_raw. */
+	SENSOR_FRAME_RAW,
+};
+
+/**
+ * @brief Scale of the raw readings of a sensor channel.
+ *
+ * A raw reading is converted to micro units of its channel, e.g. micro
+ * m/s^2 for an acceleration, with a multiplication and a shift:
+ * ((raw * mult) >> shift) + offset. The scale only changes when the range
+ * of the sensor is reconfigured, it can then be read once and applied to
+ * any number of raw readings, see sensor_raw_to_micro().
+ */
+struct sensor_scale {
+	/** Value of one LSB in micro units, with @a shift fractional bits. */
+	s32_t mult;
+	/** Number of fractional bits of @a mult. */
+	u8_t shift;
+	/** Value of a raw reading of 0, in micro units. */
+	s32_t offset;
+};
+
 /**
  * @typedef sensor_trigger_handler_t
  * @brief Callback API upon firing of a trigger
@@ -256,12 +318,33 @@ typedef int (*sensor_sample_fetch_t)(struct device *dev,
 typedef int (*sensor_channel_get_t)(struct device *dev,
 				    enum sensor_channel chan,
 				    struct sensor_value *val);
+/**
+ * @typedef sensor_fifo_read_t
+ * @brief Callback API for reading the samples stored in a sensor FIFO
+ *
+ * See sensor_fifo_read() for argument description
+ */
+typedef int (*sensor_fifo_read_t)(struct device *dev,
+				  enum sensor_frame_format format,
+				  void *frames, size_t max_frames);
+/**
+ * @typedef sensor_channel_get_raw_t
+ * @brief Callback API for getting a raw reading from a sensor
+ *
+ * See sensor_channel_get_raw() for argument description
+ */
+typedef int (*sensor_channel_get_raw_t)(struct device *dev,
+					enum sensor_channel chan,
+					s32_t *raw,
+					struct sensor_scale *scale);
 
 struct sensor_driver_api {
 	sensor_attr_set_t attr_set;
 	sensor_trigger_set_t trigger_set;
 	sensor_sample_fetch_t sample_fetch;
 	sensor_channel_get_t channel_get;
+	sensor_fifo_read_t fifo_read;
+	sensor_channel_get_raw_t channel_get_raw;
 };
 
 /**
@@ -414,6 +497,117 @@ static inline int _impl_sensor_channel_get(struct device *dev,
 	return api->channel_get(dev, chan, val);
 }
 
+/**
+ * @brief Read the samples stored in the FIFO of a sensor
+ *
+ * Drain up to @a max_frames samples from the hardware FIFO of the sensor,
+ * oldest first, with as few bus transactions as the device allows. Each
+ * frame holds one sample of a vector channel; the FIFO of a multi function
+ * device can hold several channels, whose frames are then interleaved in
+ * the order they were stored. Samples that don't fit in @a frames are left
+ * in the FIFO for the next call.
+ *
+ * Since the function communicates with the sensor device, it is unsafe
+ * to call it in an ISR if the device is connected via I2C or SPI.
+ *
+ * @param dev Pointer to the sensor device
+ * @param format Format of the frames
+ * @param frames Array of @a max_frames frames of type @ref sensor_frame or
+ * @ref sensor_frame_raw, depending on @a format
+ * @param max_frames Number of frames in the array
+ *
+ * @return Number of frames read if successful, negative errno code if
+ * failure.
+ * @retval -ENOTSUP if the sensor has no FIFO.
+ */
+__syscall int sensor_fifo_read(struct device *dev,
+			       enum sensor_frame_format format,
+			       void *frames, size_t max_frames);
+
+static inline int _impl_sensor_fifo_read(struct device *dev,
+					 enum sensor_frame_format format,
+					 void *frames, size_t max_frames)
+{
+	const struct sensor_driver_api *api = dev->driver_api;
+
+	if (!api->fifo_read) {
+		return -ENOTSUP;
+	}
+
+	return api->fifo_read(dev, format, frames, max_frames);
+}
+
+/**
+ * @brief Get a raw reading from a sensor device
+ *
+ * Same as sensor_channel_get(), but the reading is returned as output by
+ * the sensor, an integer or fixed point value, along with the scale that
+ * converts it to the units of the channel. This avoids the conversion to
+ * struct sensor_value when the readings are filtered, compared to
+ * thresholds or stored before being interpreted.
+ *
+ * The scale of a channel doesn't depend on the sample, @a raw can be NULL
+ * to only read it, e.g. to convert the raw frames read with
+ * sensor_fifo_read(). Likewise, @a scale can be NULL once known.
+ *
+ * @param dev Pointer to the sensor device
+ * @param chan The channel to read
+ * @param raw Where to store the reading, 3 values for a channel with the
+ * _XYZ suffix, or NULL
+ * @param scale Where to store the scale of the reading, or NULL
+ *
+ * @return 0 if successful, negative errno code if failure.
+ * @retval -ENOTSUP if the sensor or the channel has no raw readings.
+ */
+__syscall int sensor_channel_get_raw(struct device *dev,
+				     enum sensor_channel chan,
+				     s32_t *raw, struct sensor_scale *scale);
+
+static inline int _impl_sensor_channel_get_raw(struct device *dev,
+					       enum sensor_channel chan,
+					       s32_t *raw,
+					       struct sensor_scale *scale)
+{
+	const struct sensor_driver_api *api = dev->driver_api;
+
+	if (!api->channel_get_raw) {
+		return -ENOTSUP;
+	}
+
+	return api->channel_get_raw(dev, chan, raw, scale);
+}
+
+/**
+ * @brief Helper function to convert a raw reading to micro units.
+ *
+ * @param raw The raw reading, as returned by sensor_channel_get_raw().
+ * @param scale The scale of the channel of the reading.
+ *
+ * @return The reading in micro units of its channel.
+ */
+static inline s64_t sensor_raw_to_micro(s32_t raw,
+					const struct sensor_scale *scale)
+{
+	return (((s64_t)raw * scale->mult) >> scale->shift) + scale->offset;
+}
+
+/**
+ * @brief Helper function to convert a raw reading to struct sensor_value.
+ *
+ * @param raw The raw reading, as returned by sensor_channel_get_raw().
+ * @param scale The scale of the channel of the reading.
+ * @param val A pointer to a sensor_value struct, where the result is stored.
+ */
+static inline void sensor_raw_to_value(s32_t raw,
+				       const struct sensor_scale *scale,
+				       struct sensor_value *val)
+{
+	s64_t micro = sensor_raw_to_micro(raw, scale);
+
+	val->val1 = micro / 1000000LL;
+	val->val2 = micro % 1000000LL;
+}
+
 /**
  * @brief The value of gravitational constant in micro m/s^2.
  */
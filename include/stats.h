@@ -53,6 +53,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -336,6 +337,57 @@ struct stats_hdr *stats_group_get_next(const struct stats_hdr *cur);
  */
 struct stats_hdr *stats_group_find(const char *name);
 
+/**
+ * @brief State of a statistics snapshot.
+ *
+ * See stats_snapshot_encode().
+ */
+struct stats_snapshot {
+	/** Index of the first group to encode. */
+	int start;
+	/** Whether to encode the values as differences. */
+	bool delta;
+	/** Index of the first group not encoded, filled by the encoder. */
+	int next;
+	/** Number of registered groups, filled by the encoder. */
+	int groups;
+	/** Number of leading values encoded as differences, filled by the
+	 *  encoder.
+	 */
+	int delta_cnt;
+	/** Sequence number of the snapshot, filled by the encoder. */
+	u32_t seq;
+};
+
+/**
+ * @brief Encodes a snapshot of the statistics values.
+ *
+ * The values of the groups, from the start one on, are encoded as unsigned
+ * LEB128 varints, in the order of registration of the groups then in the
+ * order of their entries.  The field names and sizes of the groups, which
+ * form the schema of the snapshot, are not repeated: they are retrieved
+ * once with stats_walk().  Since groups cannot be unregistered, the schema
+ * only grows with groups appended at the end.  Only whole groups are
+ * encoded, as many as fit in the buffer.
+ *
+ * With delta encoding, the values within the first
+ * CONFIG_STATS_SNAPSHOT_DELTA_ENTRIES entries of all the groups are encoded
+ * as their difference from the previous snapshot, modulo the entry size.
+ * Every snapshot becomes the reference of the next one, and increments the
+ * sequence number: a gap in the sequence means that a difference was lost.
+ *
+ * @param snap                  The snapshot state.
+ * @param buf                   The buffer to encode the values into.
+ * @param len                   The size of the buffer, then the length of
+ *                                  the encoded values.
+ *
+ * @return                      0 on success;
+ *                              -ENOENT if there is no start group;
+ *                              -ENOMEM if the start group does not fit.
+ */
+int stats_snapshot_encode(struct stats_snapshot *snap, u8_t *buf,
+			  size_t *len);
+
 #else /* CONFIG_STATS */
 
 #define STATS_SECT_START(group__) \
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019 HES-SO Valais-Wallis
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# This creates a patch rebuilding a new image from an old one, to be applied
+# on the device by subsys/dfu/img_util/delta_img.c. The format is described
+# in include/dfu/delta_img.h.
+#
+# Matches are searched from an index of the blocks of the old image, and
+# extended as long as most bytes still match, so that code that only differs
+# by a few relocated addresses is copied from the old image, and only the
+# addresses are inserted.
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x31544c44
+OP_COPY = 0
+OP_INSERT = 1
+
+# Length of the blocks indexed, and of the shortest match
+BLOCK = 8
+# Candidates tried for each block
+CANDIDATES = 16
+# Shortest exact run copied inside a match
+MIN_RUN = 4
+# Drop of the score (matches minus mismatches) ending a match
+MAX_DROP = 16
+
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7f
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return out
+
+
+def zigzag(value):
+    return varint((value << 1) if value >= 0 else ((-value << 1) - 1))
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def index(old):
+    idx = {}
+    for i in range(len(old) - BLOCK + 1):
+        cands = idx.setdefault(old[i:i + BLOCK], [])
+        if len(cands) < CANDIDATES:
+            cands.append(i)
+    return idx
+
+
+def extend(old, o, new, n):
+    """Length of the approximate match of new[n:] at old[o:]"""
+    limit = min(len(old) - o, len(new) - n)
+    score = best = length = 0
+    for i in range(limit):
+        score += 1 if old[o + i] == new[n + i] else -1
+        if score > best:
+            best = score
+            length = i + 1
+        elif score < best - MAX_DROP:
+            break
+    return length
+
+
+class Patch:
+    def __init__(self, old, new):
+        self.old = old
+        self.new = new
+        self.out = bytearray(struct.pack('<IIII', MAGIC, len(old),
+                                         zlib.crc32(old) & 0xffffffff,
+                                         len(new)))
+        self.src = 0
+
+    def insert(self, data):
+        if data:
+            self.out += bytes([OP_INSERT]) + varint(len(data)) + data
+
+    def copy(self, o, length):
+        self.out += bytes([OP_COPY]) + varint(length) + zigzag(o - self.src)
+        self.src = o + length
+
+    def match(self, o, n, length):
+        """Copy the exact runs of a match, insert the bytes in between"""
+        lit = n
+        i = 0
+        while i < length:
+            j = i
+            while j < length and self.old[o + j] == self.new[n + j]:
+                j += 1
+            if j - i >= MIN_RUN:
+                self.insert(self.new[lit:n + i])
+                self.copy(o + i, j - i)
+                lit = n + j
+            i = j + 1
+        self.insert(self.new[lit:n + length])
+
+
+def create(old, new):
+    idx = index(old)
+    patch = Patch(old, new)
+    lit = 0
+    n = 0
+
+    while n < len(new):
+        cands = list(idx.get(new[n:n + BLOCK], ()))
+        # code following a match is most likely to match what followed it
+        if patch.src < len(old):
+            cands.append(patch.src)
+
+        best_o, best_len = 0, 0
+        for o in cands:
+            length = extend(old, o, new, n)
+            if length > best_len:
+                best_o, best_len = o, length
+
+        if best_len < BLOCK:
+            n += 1
+            continue
+
+        patch.insert(new[lit:n])
+        patch.match(best_o, n, best_len)
+        n += best_len
+        lit = n
+
+    patch.insert(new[lit:])
+    return bytes(patch.out)
+
+
+def apply(old, patch):
+    magic, old_size, old_crc, new_size = struct.unpack_from('<IIII', patch)
+    if magic != MAGIC:
+        raise ValueError("not a patch")
+    if len(old) < old_size or zlib.crc32(old[:old_size]) & 0xffffffff != \
+       old_crc:
+        raise ValueError("patch does not apply to the old image")
+
+    new = bytearray()
+    pos = 16
+    src = 0
+    while pos < len(patch):
+        op = patch[pos]
+        length, pos = read_varint(patch, pos + 1)
+        if op == OP_COPY:
+            off, pos = read_varint(patch, pos)
+            src += (off >> 1) ^ -(off & 1)
+            new += old[src:src + length]
+            src += length
+        elif op == OP_INSERT:
+            new += patch[pos:pos + length]
+            pos += length
+        else:
+            raise ValueError("bad op {}".format(op))
+
+    if len(new) != new_size:
+        raise ValueError("patch truncated")
+    return bytes(new)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description="Create or apply a delta image patch.",
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest='command')
+    sub.required = True
+
+    p = sub.add_parser('create', help="Create a patch from old to new.")
+    p.add_argument("old", type=argparse.FileType('rb'))
+    p.add_argument("new", type=argparse.FileType('rb'))
+    p.add_argument("-o", "--output", required=True,
+                   type=argparse.FileType('wb'), help="Patch file name.")
+
+    p = sub.add_parser('apply', help="Apply a patch to old.")
+    p.add_argument("old", type=argparse.FileType('rb'))
+    p.add_argument("patch", type=argparse.FileType('rb'))
+    p.add_argument("-o", "--output", required=True,
+                   type=argparse.FileType('wb'), help="New image file name.")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    old = args.old.read()
+
+    if args.command == 'create':
+        new = args.new.read()
+        patch = create(old, new)
+        if apply(old, patch) != new:
+            sys.exit("internal error: patch does not rebuild the new image")
+        args.output.write(patch)
+        print("{} bytes patch for a {} bytes image".format(len(patch),
+                                                           len(new)))
+    else:
+        args.output.write(apply(old, args.patch.read()))
+
+
+if __name__ == "__main__":
+    main()
@@ -126,5 +126,12 @@
 #define DT_USB_NUM_BIDIR_ENDPOINTS		DT_ST_STM32_USB_40005C00_NUM_BIDIR_ENDPOINTS
 #define DT_USB_RAM_SIZE			DT_ST_STM32_USB_40005C00_RAM_SIZE
 
+#define DT_ADC_1_BASE_ADDRESS		DT_ST_STM32_ADC_40012400_BASE_ADDRESS
+#define DT_ADC_1_IRQ			DT_ST_STM32_ADC_40012400_IRQ_0
+#define DT_ADC_1_IRQ_PRI		DT_ST_STM32_ADC_40012400_IRQ_0_PRIORITY
+#define DT_ADC_1_NAME			DT_ST_STM32_ADC_40012400_LABEL
+#define DT_ADC_1_CLOCK_BITS		DT_ST_STM32_ADC_40012400_CLOCK_BITS
+#define DT_ADC_1_CLOCK_BUS		DT_ST_STM32_ADC_40012400_CLOCK_BUS
+
 #define DT_WDT_0_NAME                   DT_ST_STM32_WATCHDOG_0_LABEL
 /* End of SoC Level DTS fixup file */
@@ -60,6 +60,21 @@
 #include <stm32l0xx_ll_iwdg.h>
 #endif
 
+#ifdef CONFIG_ADC_STM32
+#include <stm32l0xx_ll_adc.h>
+#endif
+
+#ifdef CONFIG_ADC_STM32_DMA
+#include <stm32l0xx_ll_dma.h>
+#endif
+
+#ifdef CONFIG_STM32_LPTIM_TIMER
+#include <stm32l0xx_ll_lptim.h>
+#include <stm32l0xx_ll_bus.h>
+#include <stm32l0xx_ll_rcc.h>
+#include <stm32l0xx_ll_pwr.h>
+#endif /* CONFIG_STM32_LPTIM_TIMER */
+
 #endif /* !_ASMLANGUAGE */
 
 #endif /* _STM32L0_SOC_H_ */
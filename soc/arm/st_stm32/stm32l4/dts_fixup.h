@@ -301,5 +301,12 @@
 #define DT_CAN_1_CLOCK_BUS			DT_ST_STM32_CAN_40006400_CLOCK_BUS
 #define DT_CAN_1_CLOCK_BITS			DT_ST_STM32_CAN_40006400_CLOCK_BITS
 
+#define DT_ADC_1_BASE_ADDRESS		DT_ST_STM32_ADC_50040000_BASE_ADDRESS
+#define DT_ADC_1_IRQ			DT_ST_STM32_ADC_50040000_IRQ_0
+#define DT_ADC_1_IRQ_PRI		DT_ST_STM32_ADC_50040000_IRQ_0_PRIORITY
+#define DT_ADC_1_NAME			DT_ST_STM32_ADC_50040000_LABEL
+#define DT_ADC_1_CLOCK_BITS		DT_ST_STM32_ADC_50040000_CLOCK_BITS
+#define DT_ADC_1_CLOCK_BUS		DT_ST_STM32_ADC_50040000_CLOCK_BUS
+
 #define DT_WDT_0_NAME                   DT_ST_STM32_WATCHDOG_0_LABEL
 /* End of SoC Level DTS fixup file */
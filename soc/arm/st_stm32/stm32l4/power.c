@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <soc.h>
+#include <soc_power.h>
+#include <stm32l4xx_ll_cortex.h>
+#include <stm32l4xx_ll_pwr.h>
+#include <stm32l4xx_ll_rcc.h>
+
+#define LOG_LEVEL CONFIG_SOC_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_REGISTER(soc);
+
+#ifdef CONFIG_SYS_POWER_LOW_POWER_STATES
+/* System clock source before entering STOP mode */
+static u32_t sysclk_source;
+
+/*
+ * STOP mode turns off HSE and the PLL and wakes up on MSI or HSI16,
+ * restart the system clock source which was in use before.
+ */
+static void clock_restore(void)
+{
+	switch (sysclk_source) {
+	case LL_RCC_SYS_CLKSOURCE_STATUS_PLL:
+		if (LL_RCC_PLL_GetMainSource() == LL_RCC_PLLSOURCE_HSE) {
+			LL_RCC_HSE_Enable();
+			while (LL_RCC_HSE_IsReady() != 1) {
+			}
+		} else if (LL_RCC_PLL_GetMainSource() == LL_RCC_PLLSOURCE_HSI) {
+			LL_RCC_HSI_Enable();
+			while (LL_RCC_HSI_IsReady() != 1) {
+			}
+		}
+
+		LL_RCC_PLL_Enable();
+		while (LL_RCC_PLL_IsReady() != 1) {
+		}
+
+		LL_RCC_SetSysClkSource(LL_RCC_SYS_CLKSOURCE_PLL);
+		break;
+	case LL_RCC_SYS_CLKSOURCE_STATUS_HSE:
+		LL_RCC_HSE_Enable();
+		while (LL_RCC_HSE_IsReady() != 1) {
+		}
+
+		LL_RCC_SetSysClkSource(LL_RCC_SYS_CLKSOURCE_HSE);
+		break;
+	case LL_RCC_SYS_CLKSOURCE_STATUS_HSI:
+		LL_RCC_HSI_Enable();
+		while (LL_RCC_HSI_IsReady() != 1) {
+		}
+
+		LL_RCC_SetSysClkSource(LL_RCC_SYS_CLKSOURCE_HSI);
+		break;
+	default:
+		/* MSI, which is back already */
+		return;
+	}
+
+	while (LL_RCC_GetSysClkSource() != sysclk_source) {
+	}
+}
+
+static void stop_enter(u32_t mode)
+{
+	sysclk_source = LL_RCC_GetSysClkSource();
+
+	/* HSI16 starts faster than MSI, and feeds the PLL if used */
+	LL_RCC_SetClkAfterWakeFromStop(
+		sysclk_source == LL_RCC_SYS_CLKSOURCE_STATUS_MSI ?
+		LL_RCC_STOP_WAKEUPCLOCK_MSI : LL_RCC_STOP_WAKEUPCLOCK_HSI);
+
+	LL_PWR_ClearFlag_WU();
+	LL_PWR_SetPowerMode(mode);
+	LL_LPM_EnableDeepSleep();
+
+	k_cpu_idle();
+}
+#endif /* CONFIG_SYS_POWER_LOW_POWER_STATES */
+
+/* Invoke Low Power/System Off specific Tasks */
+void sys_set_power_state(enum power_states state)
+{
+	switch (state) {
+#ifdef CONFIG_SYS_POWER_LOW_POWER_STATES
+ #ifdef CONFIG_SYS_POWER_STATE_CPU_LPS_SUPPORTED
+	case SYS_POWER_STATE_CPU_LPS:
+		stop_enter(LL_PWR_MODE_STOP1);
+		break;
+ #endif
+ #ifdef CONFIG_SYS_POWER_STATE_CPU_LPS_1_SUPPORTED
+	case SYS_POWER_STATE_CPU_LPS_1:
+		stop_enter(LL_PWR_MODE_STOP2);
+		break;
+ #endif
+#endif
+#ifdef CONFIG_SYS_POWER_DEEP_SLEEP_STATES
+ #ifdef CONFIG_SYS_POWER_STATE_DEEP_SLEEP_SUPPORTED
+	case SYS_POWER_STATE_DEEP_SLEEP:
+		LL_PWR_ClearFlag_WU();
+		LL_PWR_ClearFlag_SB();
+		LL_PWR_SetPowerMode(LL_PWR_MODE_STANDBY);
+		LL_LPM_EnableDeepSleep();
+
+		k_cpu_idle();
+		break;
+ #endif
+#endif
+	default:
+		LOG_ERR("Unsupported power state %u", state);
+		break;
+	}
+}
+
+/* Handle SOC specific activity after Low Power Mode Exit */
+void sys_power_state_post_ops(enum power_states state)
+{
+	switch (state) {
+#ifdef CONFIG_SYS_POWER_LOW_POWER_STATES
+ #ifdef CONFIG_SYS_POWER_STATE_CPU_LPS_SUPPORTED
+	case SYS_POWER_STATE_CPU_LPS:
+		/* FALLTHROUGH */
+ #endif
+ #ifdef CONFIG_SYS_POWER_STATE_CPU_LPS_1_SUPPORTED
+	case SYS_POWER_STATE_CPU_LPS_1:
+ #endif
+		LL_LPM_EnableSleep();
+		clock_restore();
+		break;
+#endif
+#ifdef CONFIG_SYS_POWER_DEEP_SLEEP_STATES
+ #ifdef CONFIG_SYS_POWER_STATE_DEEP_SLEEP_SUPPORTED
+	case SYS_POWER_STATE_DEEP_SLEEP:
+		/* Standby resumes from the reset vector, unless it failed */
+		LL_LPM_EnableSleep();
+		break;
+ #endif
+#endif
+	default:
+		LOG_ERR("Unsupported power state %u", state);
+		break;
+	}
+
+	/*
+	 * System is now in active mode. Reenable interrupts which were disabled
+	 * when OS started idling code.
+	 */
+	irq_unlock(0);
+}
@@ -6,6 +6,9 @@
 
 #include <tracing_cpu_stats.h>
 #include <misc/printk.h>
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS_DWT
+#include <arch/arm/cortex_m/cmsis.h>
+#endif
 
 enum cpu_state {
 	CPU_STATE_IDLE,
@@ -21,6 +24,11 @@ static struct cpu_stats stats_hw_tick;
 static int nested_interrupts;
 static struct k_thread *current_thread;
 
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+/* Time the current thread last started running, out of interrupts */
+static u32_t thread_start;
+#endif
+
 #ifndef CONFIG_SMP
 extern k_tid_t const _idle_thread;
 #endif
@@ -68,6 +76,235 @@ static void cpu_stats_update_counters(void)
 	}
 }
 
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+#ifdef CONFIG_STACK_SENTINEL
+/* The sentinel at the bottom of the stack is not sampled, but used */
+#define STACK_CHECK_OFFSET 4
+#else
+#define STACK_CHECK_OFFSET 0
+#endif
+
+#define STACK_PATTERN 0xaaaaaaaaU
+
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS_DWT
+static inline u32_t thread_cycles_get(void)
+{
+	return DWT->CYCCNT;
+}
+
+static inline u32_t thread_cycles_per_sec(void)
+{
+	return SystemCoreClock;
+}
+
+static int cpu_stats_dwt_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#ifdef CONFIG_CPU_CORTEX_M7
+	/* Unlock the DWT registers */
+	DWT->LAR = 0xC5ACCE55;
+#endif
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	return 0;
+}
+
+SYS_INIT(cpu_stats_dwt_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#else
+static inline u32_t thread_cycles_get(void)
+{
+	return k_cycle_get_32();
+}
+
+static inline u32_t thread_cycles_per_sec(void)
+{
+	return sys_clock_hw_cycles_per_sec();
+}
+#endif /* CONFIG_TRACING_CPU_STATS_THREADS_DWT */
+
+/*
+ * While the kernel starts, the threads switched are none yet or the dummy
+ * one, which lives on the stack and whose fields are not initialized.
+ */
+static inline bool thread_is_accounted(struct k_thread *thread)
+{
+	return thread != NULL &&
+	       !(thread->base.thread_state & _THREAD_DUMMY);
+}
+
+/* Charges the current thread with the cycles it ran since it started */
+static void thread_charge(u32_t now)
+{
+	struct _thread_cpu_stats *stats;
+	u32_t cycles = now - thread_start;
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS_STATS
+	u32_t cycles_per_ms = thread_cycles_per_sec() / MSEC_PER_SEC;
+#endif
+
+	if (!thread_is_accounted(current_thread)) {
+		thread_start = now;
+		return;
+	}
+
+	stats = &current_thread->cpu_stats;
+	stats->cycles += cycles;
+	thread_start = now;
+
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS_STATS
+	/* Integer division only once a millisecond was run */
+	stats->runtime_cycles += cycles;
+	if (stats->runtime_cycles >= cycles_per_ms) {
+		stats->runtime += stats->runtime_cycles / cycles_per_ms;
+		stats->runtime_cycles %= cycles_per_ms;
+	}
+#endif
+}
+
+/*
+ * Checks the next few words of the stack, from its bottom up to the deepest
+ * usage found so far, against the initialization pattern. A word that was
+ * written to is a new high-water mark, and the sampling starts over.
+ */
+static void thread_stack_sample(struct k_thread *thread)
+{
+	struct _thread_cpu_stats *stats = &thread->cpu_stats;
+	const u8_t *stack = (const u8_t *)thread->stack_info.start +
+			    STACK_CHECK_OFFSET;
+	u32_t unused = thread->stack_info.size - stats->stack_used;
+	u32_t offset = stats->stack_cursor;
+	int i;
+
+	for (i = 0; i < CONFIG_TRACING_CPU_STATS_THREADS_STACK_WORDS; i++) {
+		if (offset >= unused) {
+			offset = 0U;
+			break;
+		}
+
+		if (*(const u32_t *)(stack + offset) != STACK_PATTERN) {
+			while (stack[offset] == 0xaaU) {
+				offset++;
+			}
+
+			if (offset < unused) {
+				stats->stack_used = thread->stack_info.size -
+						    offset;
+			}
+
+			offset = 0U;
+			break;
+		}
+
+		offset += sizeof(u32_t);
+	}
+
+	stats->stack_cursor = offset;
+}
+
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS_STATS
+#ifdef CONFIG_STATS_NAMES
+static const struct stats_name_map thread_stats_names[] = {
+	{ offsetof(struct _thread_cpu_stats, switches), "switches" },
+	{ offsetof(struct _thread_cpu_stats, stack_used), "stack_used" },
+	{ offsetof(struct _thread_cpu_stats, runtime), "runtime" },
+};
+#define THREAD_STATS_NAMES thread_stats_names, ARRAY_SIZE(thread_stats_names)
+#else
+#define THREAD_STATS_NAMES NULL, 0
+#endif /* CONFIG_STATS_NAMES */
+
+/*
+ * The header of a thread in non-zeroed memory holds garbage until it is
+ * registered: only its presence in the list of groups tells that it is.
+ */
+static bool thread_stats_registered(const struct stats_hdr *hdr)
+{
+	const struct stats_hdr *cur = NULL;
+
+	while ((cur = stats_group_get_next(cur)) != NULL) {
+		if (cur == hdr) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * A thread is registered once, when first created, as statistics groups
+ * cannot be unregistered. Creating a thread again reuses its group.
+ */
+static void thread_stats_register(struct k_thread *thread)
+{
+	struct _thread_cpu_stats *stats = &thread->cpu_stats;
+	const char *name = NULL;
+
+	stats->runtime_cycles = 0U;
+
+	if (thread_stats_registered(&stats->s_hdr)) {
+		stats_reset(&stats->s_hdr);
+		return;
+	}
+
+#ifdef CONFIG_THREAD_NAME
+	name = thread->name;
+#endif
+	if (name == NULL || stats_group_find(name) != NULL) {
+		snprintk(stats->name, sizeof(stats->name), "%p", thread);
+		name = stats->name;
+	}
+
+	stats->s_hdr.s_next = NULL;
+	(void)stats_init_and_reg(&stats->s_hdr, STATS_SIZE_32,
+				 (offsetof(struct _thread_cpu_stats,
+					   runtime_cycles) -
+				  sizeof(struct stats_hdr)) / STATS_SIZE_32,
+				 THREAD_STATS_NAMES, name);
+}
+#else
+static inline void thread_stats_register(struct k_thread *thread) { }
+#endif /* CONFIG_TRACING_CPU_STATS_THREADS_STATS */
+
+void sys_trace_thread_create(struct k_thread *thread)
+{
+	struct _thread_cpu_stats *stats = &thread->cpu_stats;
+	int key = irq_lock();
+
+	/* Statistics registration is not thread-safe */
+	thread_stats_register(thread);
+
+	stats->switches = 0U;
+	stats->stack_used = STACK_CHECK_OFFSET;
+	stats->cycles = 0U;
+	stats->stack_cursor = 0U;
+	irq_unlock(key);
+}
+
+void cpu_stats_thread_get(const struct k_thread *thread,
+			  struct cpu_stats_thread *stats)
+{
+	int key = irq_lock();
+	u64_t cycles = thread->cpu_stats.cycles;
+	u32_t freq = thread_cycles_per_sec();
+
+	/* Add the ongoing run of the thread calling */
+	if (thread == current_thread && nested_interrupts == 0 &&
+	    last_cpu_state != CPU_STATE_SCHEDULER) {
+		cycles += thread_cycles_get() - thread_start;
+	}
+
+	stats->switches = thread->cpu_stats.switches;
+	stats->stack_used = thread->cpu_stats.stack_used;
+	irq_unlock(key);
+
+	/* Seconds first, for the product not to overflow */
+	stats->runtime = (cycles / freq) * NSEC_PER_SEC +
+			 ((cycles % freq) * NSEC_PER_SEC) / freq;
+}
+#endif /* CONFIG_TRACING_CPU_STATS_THREADS */
+
 void cpu_stats_get_ns(struct cpu_stats *cpu_stats_ns)
 {
 	int key = irq_lock();
@@ -115,6 +352,12 @@ void sys_trace_thread_switched_in(void)
 	} else {
 		last_cpu_state = CPU_STATE_NON_IDLE;
 	}
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+	if (thread_is_accounted(current_thread)) {
+		current_thread->cpu_stats.switches++;
+	}
+	thread_start = thread_cycles_get();
+#endif
 	irq_unlock(key);
 }
 
@@ -126,6 +369,12 @@ void sys_trace_thread_switched_out(void)
 	__ASSERT_NO_MSG(current_thread == k_current_get());
 
 	cpu_stats_update_counters();
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+	thread_charge(thread_cycles_get());
+	if (thread_is_accounted(current_thread)) {
+		thread_stack_sample(current_thread);
+	}
+#endif
 	last_cpu_state = CPU_STATE_SCHEDULER;
 	irq_unlock(key);
 }
@@ -136,6 +385,11 @@ void sys_trace_isr_enter(void)
 
 	if (nested_interrupts == 0) {
 		cpu_stats_update_counters();
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+		if (last_cpu_state != CPU_STATE_SCHEDULER) {
+			thread_charge(thread_cycles_get());
+		}
+#endif
 		cpu_state_before_interrupts = last_cpu_state;
 		last_cpu_state = CPU_STATE_NON_IDLE;
 	}
@@ -151,6 +405,9 @@ void sys_trace_isr_exit(void)
 	if (nested_interrupts == 0) {
 		cpu_stats_update_counters();
 		last_cpu_state = cpu_state_before_interrupts;
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+		thread_start = thread_cycles_get();
+#endif
 	}
 	irq_unlock(key);
 }
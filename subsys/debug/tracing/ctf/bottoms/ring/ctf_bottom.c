@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <spinlock.h>
+#include <ring_buffer.h>
+#include <tracing_ctf.h>
+#include "ctf_bottom.h"
+
+/*
+ * Writers, from any context, are serialized by the lock, held only for the
+ * copy. The single reader, either the UART backend or the shell or mcumgr
+ * commands, does not take it: it only moves the head of the ring buffer,
+ * which the writers only read.
+ */
+RING_BUF_DECLARE(ctf_ring, CONFIG_TRACING_CTF_RING_SIZE);
+
+static struct k_spinlock ctf_ring_lock;
+
+static u32_t ctf_ring_dropped;
+
+void ctf_bottom_configure(void)
+{
+}
+
+void ctf_bottom_start(void)
+{
+}
+
+void ctf_bottom_emit(u8_t *epacket, u32_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&ctf_ring_lock);
+	u32_t tstamp;
+
+	if ((u32_t)ring_buf_space_get(&ctf_ring) < size) {
+		ctf_ring_dropped++;
+	} else {
+		tstamp = k_cycle_get_32();
+		memcpy(epacket, &tstamp, sizeof(tstamp));
+		(void)ring_buf_put(&ctf_ring, epacket, size);
+	}
+
+	k_spin_unlock(&ctf_ring_lock, key);
+}
+
+u32_t ctf_ring_claim(u8_t **data, u32_t size)
+{
+	return ring_buf_get_claim(&ctf_ring, data, size);
+}
+
+void ctf_ring_finish(u32_t size)
+{
+	(void)ring_buf_get_finish(&ctf_ring, size);
+}
+
+u32_t ctf_ring_read(u8_t *buf, u32_t len)
+{
+	return ring_buf_get(&ctf_ring, buf, len);
+}
+
+u32_t ctf_ring_used(void)
+{
+	return (ctf_ring.size - 1) - ring_buf_space_get(&ctf_ring);
+}
+
+u32_t ctf_bottom_dropped(void)
+{
+	return ctf_ring_dropped;
+}
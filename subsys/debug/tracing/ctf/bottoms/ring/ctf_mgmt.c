@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <init.h>
+#include <tracing_ctf.h>
+#include "mgmt/mgmt.h"
+#include "cborattr/cborattr.h"
+#include "ctf_bottom.h"
+
+/* First group ID left to the user */
+#define CTF_MGMT_GROUP_ID	MGMT_GROUP_ID_PERUSER
+
+#define CTF_MGMT_ID_READ	0
+
+/*
+ * Command handler: ctf read
+ *
+ * Returns the oldest bytes of the stream, which are dropped from the ring
+ * buffer once the response is encoded, along with the number of events
+ * dropped so far. An empty data means that the stream was read up to date.
+ */
+static int ctf_mgmt_read(struct mgmt_ctxt *ctxt)
+{
+	u8_t *data;
+	u32_t len;
+	CborError err;
+
+	len = ctf_ring_claim(&data,
+			     CONFIG_TRACING_CTF_BOTTOM_RAM_MCUMGR_CHUNK_SIZE);
+
+	err = 0;
+	err |= cbor_encode_text_stringz(&ctxt->encoder, "data");
+	err |= cbor_encode_byte_string(&ctxt->encoder, data, len);
+	err |= cbor_encode_text_stringz(&ctxt->encoder, "dropped");
+	err |= cbor_encode_uint(&ctxt->encoder, ctf_bottom_dropped());
+	err |= cbor_encode_text_stringz(&ctxt->encoder, "rc");
+	err |= cbor_encode_int(&ctxt->encoder, MGMT_ERR_EOK);
+
+	if (err != 0) {
+		ctf_ring_finish(0);
+		return MGMT_ERR_ENOMEM;
+	}
+
+	ctf_ring_finish(len);
+
+	return 0;
+}
+
+static const struct mgmt_handler ctf_mgmt_handlers[] = {
+	[CTF_MGMT_ID_READ] = {
+		.mh_read = ctf_mgmt_read,
+		.mh_write = NULL,
+	},
+};
+
+static struct mgmt_group ctf_mgmt_group = {
+	.mg_handlers = ctf_mgmt_handlers,
+	.mg_handlers_count = ARRAY_SIZE(ctf_mgmt_handlers),
+	.mg_group_id = CTF_MGMT_GROUP_ID,
+};
+
+static int ctf_mgmt_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	mgmt_register_group(&ctf_mgmt_group);
+
+	return 0;
+}
+
+SYS_INIT(ctf_mgmt_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
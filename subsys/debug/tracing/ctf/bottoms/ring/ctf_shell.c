@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <shell/shell.h>
+#include <tracing_ctf.h>
+
+/* Bytes of the stream per line */
+#define CTF_SHELL_LINE_LEN	32
+
+static int cmd_ctf_dump(const struct shell *shell, size_t argc, char **argv)
+{
+	static const char hex[] = "0123456789abcdef";
+	u8_t data[CTF_SHELL_LINE_LEN];
+	char line[2 * CTF_SHELL_LINE_LEN + 1];
+	u32_t left = ctf_ring_used();
+	u32_t len;
+	u32_t i;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	/*
+	 * Plain hexadecimal, which xxd -r -p turns back into the stream. The
+	 * dump stops at the events traced before it started, as printing
+	 * traces more of them.
+	 */
+	while (left > 0 &&
+	       (len = ctf_ring_read(data, min(left, sizeof(data)))) > 0) {
+		left -= len;
+
+		for (i = 0; i < len; i++) {
+			line[2 * i] = hex[data[i] >> 4];
+			line[2 * i + 1] = hex[data[i] & 0xf];
+		}
+		line[2 * len] = '\0';
+
+		shell_print(shell, "%s", line);
+	}
+
+	return 0;
+}
+
+static int cmd_ctf_status(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Used: %u/%u bytes", ctf_ring_used(),
+		    CONFIG_TRACING_CTF_RING_SIZE - 1);
+	shell_print(shell, "Dropped: %u events", ctf_bottom_dropped());
+
+	return 0;
+}
+
+SHELL_CREATE_STATIC_SUBCMD_SET(sub_ctf)
+{
+	/* Alphabetically sorted. */
+	SHELL_CMD(dump, NULL, "Dump and drop the CTF stream as hexadecimal",
+		  cmd_ctf_dump),
+	SHELL_CMD(status, NULL, "Show the CTF ring buffer usage",
+		  cmd_ctf_status),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+};
+
+SHELL_CMD_REGISTER(ctf, &sub_ctf, "CTF tracing commands", NULL);
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <spinlock.h>
+#include <SEGGER_RTT.h>
+#include <tracing_ctf.h>
+#include "ctf_bottom.h"
+
+#define CTF_RTT_BUFFER CONFIG_TRACING_CTF_BOTTOM_RTT_BUFFER
+
+static u8_t ctf_rtt_buf[CONFIG_TRACING_CTF_BOTTOM_RTT_BUFFER_SIZE];
+
+/*
+ * The up-buffer is not shared with the other RTT users: writers, from any
+ * context, are only serialized between them.
+ */
+static struct k_spinlock ctf_rtt_lock;
+
+static u32_t ctf_rtt_dropped;
+
+void ctf_bottom_configure(void)
+{
+	SEGGER_RTT_ConfigUpBuffer(CTF_RTT_BUFFER, "CTF", ctf_rtt_buf,
+				  sizeof(ctf_rtt_buf),
+				  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+}
+
+void ctf_bottom_start(void)
+{
+}
+
+void ctf_bottom_emit(u8_t *epacket, u32_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&ctf_rtt_lock);
+	u32_t tstamp = k_cycle_get_32();
+
+	memcpy(epacket, &tstamp, sizeof(tstamp));
+
+	/* Nothing is written unless the whole event-packet fits */
+	if (SEGGER_RTT_WriteSkipNoLock(CTF_RTT_BUFFER, epacket, size) == 0) {
+		ctf_rtt_dropped++;
+	}
+
+	k_spin_unlock(&ctf_rtt_lock, key);
+}
+
+u32_t ctf_bottom_dropped(void)
+{
+	return ctf_rtt_dropped;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SUBSYS_DEBUG_TRACING_BOTTOMS_RTT_CTF_BOTTOM_H
+#define SUBSYS_DEBUG_TRACING_BOTTOMS_RTT_CTF_BOTTOM_H
+
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/types.h>
+#include <ctf_map.h>
+
+
+/* Obtain a field's size at compile-time.
+ * Internal to this bottom-layer.
+ */
+#define CTF_BOTTOM_INTERNAL_FIELD_SIZE(x)      + sizeof(x)
+
+/* Append a field to current event-packet.
+ * Internal to this bottom-layer.
+ */
+#define CTF_BOTTOM_INTERNAL_FIELD_APPEND(x)		 \
+	{						 \
+		memcpy(epacket_cursor, &(x), sizeof(x)); \
+		epacket_cursor += sizeof(x);		 \
+	}
+
+/* Gather fields to a contiguous event-packet, leaving room for the
+ * timestamp, then emit. Used by middle-layer.
+ */
+#define CTF_BOTTOM_FIELDS(...)						    \
+{									    \
+	u8_t epacket[sizeof(u32_t)					    \
+		     MAP(CTF_BOTTOM_INTERNAL_FIELD_SIZE, ##__VA_ARGS__)];   \
+	u8_t *epacket_cursor = &epacket[sizeof(u32_t)];			    \
+									    \
+	MAP(CTF_BOTTOM_INTERNAL_FIELD_APPEND, ##__VA_ARGS__)		    \
+	ctf_bottom_emit(epacket, sizeof(epacket));			    \
+}
+
+/* ctf_bottom_emit locks the RTT up-buffer only while copying an
+ * event-packet. Used by middle-layer.
+ */
+#define CTF_BOTTOM_LOCK()         { /* empty */ }
+#define CTF_BOTTOM_UNLOCK()       { /* empty */ }
+
+/* The timestamp is sampled by ctf_bottom_emit while the RTT up-buffer is
+ * locked, so that the events of the stream are in time order.
+ * Used by middle-layer.
+ */
+#define CTF_BOTTOM_TIMESTAMPED_EXTERNALLY
+
+
+/* Configure initializes ctf_bottom context and the RTT up-buffer */
+void ctf_bottom_configure(void);
+
+/* Start a new trace stream */
+void ctf_bottom_start(void);
+
+/* Timestamp the event-packet and copy it to the RTT up-buffer, or drop it if
+ * the up-buffer is full
+ */
+void ctf_bottom_emit(u8_t *epacket, u32_t size);
+
+#endif /* SUBSYS_DEBUG_TRACING_BOTTOMS_RTT_CTF_BOTTOM_H */
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <init.h>
+#include <uart.h>
+#include <atomic.h>
+#include "ctf_bottom.h"
+
+/*
+ * The CTF stream is sent straight from the ring buffer, of which this is the
+ * single reader. Events traced while sending are sent in turn.
+ */
+static struct device *ctf_uart;
+
+#ifdef CONFIG_UART_ASYNC_API
+/* Whether a transfer is in progress */
+static atomic_t ctf_uart_busy;
+
+static struct k_timer ctf_uart_timer;
+
+/* Sends the oldest bytes of the ring buffer, in the busy state */
+static void ctf_uart_tx(void)
+{
+	u8_t *data;
+	u32_t len;
+
+	len = ctf_ring_claim(&data, CONFIG_TRACING_CTF_RING_SIZE);
+	if (len == 0) {
+		atomic_clear(&ctf_uart_busy);
+		return;
+	}
+
+	if (uart_tx(ctf_uart, data, len, K_FOREVER) != 0) {
+		ctf_ring_finish(0);
+		atomic_clear(&ctf_uart_busy);
+	}
+}
+
+static void ctf_uart_callback(struct uart_event *evt, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		ctf_ring_finish(evt->data.tx.len);
+		ctf_uart_tx();
+		break;
+	default:
+		break;
+	}
+}
+
+/* Restarts the transfers once new events are traced */
+static void ctf_uart_timer_expiry(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	if (atomic_cas(&ctf_uart_busy, 0, 1)) {
+		ctf_uart_tx();
+	}
+}
+
+static int ctf_uart_start(void)
+{
+	int ret;
+
+	ret = uart_callback_set(ctf_uart, ctf_uart_callback, NULL);
+	if (ret) {
+		return ret;
+	}
+
+	k_timer_init(&ctf_uart_timer, ctf_uart_timer_expiry, NULL);
+	k_timer_start(&ctf_uart_timer, CONFIG_TRACING_CTF_BOTTOM_UART_INTERVAL,
+		      CONFIG_TRACING_CTF_BOTTOM_UART_INTERVAL);
+
+	return 0;
+}
+#else
+#define CTF_UART_STACK_SIZE 512
+
+static K_THREAD_STACK_DEFINE(ctf_uart_stack, CTF_UART_STACK_SIZE);
+static struct k_thread ctf_uart_thread;
+
+/* Sends the ring buffer whenever the system has nothing else to do */
+static void ctf_uart_thread_fn(void *p1, void *p2, void *p3)
+{
+	u8_t *data;
+	u32_t len;
+	u32_t i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		while ((len = ctf_ring_claim(&data,
+					     CONFIG_TRACING_CTF_RING_SIZE)) > 0) {
+			for (i = 0; i < len; i++) {
+				uart_poll_out(ctf_uart, data[i]);
+			}
+
+			ctf_ring_finish(len);
+		}
+
+		k_sleep(CONFIG_TRACING_CTF_BOTTOM_UART_INTERVAL);
+	}
+}
+
+static int ctf_uart_start(void)
+{
+	k_thread_create(&ctf_uart_thread, ctf_uart_stack,
+			K_THREAD_STACK_SIZEOF(ctf_uart_stack),
+			ctf_uart_thread_fn, NULL, NULL, NULL,
+			K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+	return 0;
+}
+#endif /* CONFIG_UART_ASYNC_API */
+
+/* Events traced until the UART is up are kept in the ring buffer */
+static int ctf_uart_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	ctf_uart = device_get_binding(CONFIG_TRACING_CTF_BOTTOM_UART_DEV_NAME);
+	if (!ctf_uart) {
+		return -ENODEV;
+	}
+
+	return ctf_uart_start();
+}
+
+SYS_INIT(ctf_uart_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
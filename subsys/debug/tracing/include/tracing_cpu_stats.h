@@ -16,6 +16,17 @@ struct cpu_stats {
 	u64_t sched;
 };
 
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+struct cpu_stats_thread {
+	/* Time spent running the thread, out of interrupts, in ns */
+	u64_t runtime;
+	/* Number of times the thread was switched in */
+	u32_t switches;
+	/* Stack usage high-water mark sampled so far, in bytes */
+	u32_t stack_used;
+};
+#endif
+
 void sys_trace_thread_switched_in(void);
 void sys_trace_thread_switched_out(void);
 void sys_trace_isr_enter(void);
@@ -26,11 +37,20 @@ void cpu_stats_get_ns(struct cpu_stats *cpu_stats_ns);
 u32_t cpu_stats_non_idle_and_sched_get_percent(void);
 void cpu_stats_reset_counters(void);
 
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+void cpu_stats_thread_get(const struct k_thread *thread,
+			  struct cpu_stats_thread *stats);
+#endif
+
 #define sys_trace_isr_exit_to_scheduler()
 
 #define sys_trace_thread_priority_set(thread)
 #define sys_trace_thread_info(thread)
+#ifdef CONFIG_TRACING_CPU_STATS_THREADS
+void sys_trace_thread_create(struct k_thread *thread);
+#else
 #define sys_trace_thread_create(thread)
+#endif
 #define sys_trace_thread_abort(thread)
 #define sys_trace_thread_suspend(thread)
 #define sys_trace_thread_resume(thread)
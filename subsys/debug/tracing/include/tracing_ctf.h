@@ -32,6 +32,42 @@ void sys_trace_idle(void);
 void sys_trace_void(unsigned int id);
 void sys_trace_end_call(unsigned int id);
 
+#if defined(CONFIG_TRACING_CTF_RING) || defined(CONFIG_TRACING_CTF_BOTTOM_RTT)
+/**
+ * @brief Get the number of CTF events dropped.
+ *
+ * Events are dropped while the buffer of the bottom layer is full.
+ *
+ * @return Number of events dropped since boot.
+ */
+u32_t ctf_bottom_dropped(void);
+#endif
+
+#ifdef CONFIG_TRACING_CTF_RING
+/**
+ * @brief Get the number of bytes of the CTF stream in the ring buffer.
+ *
+ * @return Number of bytes not read yet.
+ */
+u32_t ctf_ring_used(void);
+#endif
+
+#ifdef CONFIG_TRACING_CTF_BOTTOM_RAM
+/**
+ * @brief Read the CTF stream from the ring buffer.
+ *
+ * Copies the oldest bytes of the stream and drops them from the ring
+ * buffer. Events may be split across reads. There must be a single reader
+ * at a time.
+ *
+ * @param buf Destination buffer.
+ * @param len Size of the destination buffer.
+ *
+ * @return Number of bytes read, 0 if the ring buffer is empty.
+ */
+u32_t ctf_ring_read(u8_t *buf, u32_t len);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_LEVEL CONFIG_FRAG_DECODER_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_REGISTER(frag_decoder);
+
+#include <errno.h>
+#include <string.h>
+#include <dfu/frag_decoder.h>
+
+/* Bytes of flash read at once when combining fragments */
+#define CHUNK_SIZE	32
+
+static bool bit_get(const u8_t *map, u32_t i)
+{
+	return (map[i >> 3] & BIT(i & 7)) != 0;
+}
+
+static void bit_set(u8_t *map, u32_t i)
+{
+	map[i >> 3] |= BIT(i & 7);
+}
+
+/* Pseudo-random generator of the parity matrix */
+static u32_t prbs23(u32_t x)
+{
+	u32_t b0 = x & 0x01;
+	u32_t b1 = (x & 0x20) >> 5;
+
+	return (x >> 1) + ((b0 ^ b1) << 22);
+}
+
+/* Row n, from 1, of the parity matrix of m fragments */
+static void parity_row(u8_t *row, u32_t n, u32_t m)
+{
+	u32_t mm = (m & (m - 1)) == 0 ? 1 : 0;
+	u32_t x = 1 + 1001 * n;
+	u32_t r;
+	u32_t i;
+
+	(void)memset(row, 0, ceiling_fraction(m, 8));
+
+	for (i = 0U; i < m / 2; i++) {
+		r = BIT(16);
+		while (r >= m) {
+			x = prbs23(x);
+			r = x % (m + mm);
+		}
+
+		bit_set(row, r);
+	}
+}
+
+/* XORs len bytes of a flash area into buf */
+static int xor_flash(const struct flash_area *fa, off_t off, u8_t *buf,
+		     size_t len)
+{
+	u8_t chunk[CHUNK_SIZE];
+	size_t n;
+	size_t i;
+	int rc;
+
+	while (len > 0) {
+		n = min(len, sizeof(chunk));
+		rc = flash_area_read(fa, off, chunk, n);
+		if (rc) {
+			LOG_ERR("flash read error %d", rc);
+			return rc;
+		}
+
+		for (i = 0; i < n; i++) {
+			buf[i] ^= chunk[i];
+		}
+
+		buf += n;
+		off += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static u32_t row_stride(const struct frag_decoder *dec)
+{
+	return dec->row_len + dec->frag_size;
+}
+
+/* Index of a lost fragment among the lost fragments */
+static u16_t lost_index(const struct frag_decoder *dec, u16_t frag)
+{
+	u16_t lost = 0U;
+	u16_t i;
+
+	for (i = 0U; i < frag; i++) {
+		if (!bit_get(dec->received, i)) {
+			lost++;
+		}
+	}
+
+	return lost;
+}
+
+static int frag_decoder_start_coding(struct frag_decoder *dec)
+{
+	u16_t lost = dec->nb_frags - dec->nb_uncoded;
+	u16_t row_len = ROUND_UP(ceiling_fraction(lost, 8), dec->align);
+
+	if (lost > CONFIG_FRAG_DECODER_MAX_MISSING ||
+	    (u32_t)lost * (row_len + dec->frag_size) > dec->matrix->fa_size) {
+		LOG_ERR("%u fragments lost, too many to recover", lost);
+		return -ENOSPC;
+	}
+
+	LOG_DBG("%u fragments lost", lost);
+
+	dec->nb_lost = lost;
+	dec->row_len = row_len;
+	dec->nb_rows = 0U;
+	dec->coding = true;
+
+	return 0;
+}
+
+/* Reduces the row in dec->row and dec->data against the matrix */
+static int frag_decoder_reduce(struct frag_decoder *dec)
+{
+	off_t off;
+	u16_t p;
+	int rc;
+
+	for (p = 0U; p < dec->nb_lost; p++) {
+		if (!bit_get(dec->row, p)) {
+			continue;
+		}
+
+		off = p * row_stride(dec);
+
+		if (!bit_get(dec->rows, p)) {
+			/* the matrix is upper triangular, row p starts at p */
+			rc = flash_area_write(dec->matrix, off, dec->row,
+					      dec->row_len);
+			off += dec->row_len;
+			if (rc == 0) {
+				rc = flash_area_write(dec->matrix, off,
+						      dec->data,
+						      dec->frag_size);
+			}
+
+			if (rc) {
+				LOG_ERR("flash write error %d", rc);
+				return rc;
+			}
+
+			bit_set(dec->rows, p);
+			dec->nb_rows++;
+
+			return 0;
+		}
+
+		rc = xor_flash(dec->matrix, off + p / 8, &dec->row[p / 8],
+			       dec->row_len - p / 8);
+		if (rc) {
+			return rc;
+		}
+
+		rc = xor_flash(dec->matrix, off + dec->row_len, dec->data,
+			       dec->frag_size);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	/* the fragment is a combination of those already received */
+	return 0;
+}
+
+/* Computes the lost fragments, from the last one to the first one */
+static int frag_decoder_solve(struct frag_decoder *dec)
+{
+	u16_t p = dec->nb_lost;
+	off_t off;
+	u16_t j;
+	s32_t f;
+	u16_t g;
+	int rc;
+
+	for (f = dec->nb_frags - 1; f >= 0; f--) {
+		if (bit_get(dec->received, f)) {
+			continue;
+		}
+
+		p--;
+		off = p * row_stride(dec);
+		rc = flash_area_read(dec->matrix, off, dec->row, dec->row_len);
+		if (rc == 0) {
+			rc = flash_area_read(dec->matrix, off + dec->row_len,
+					     dec->data, dec->frag_size);
+		}
+
+		if (rc) {
+			LOG_ERR("flash read error %d", rc);
+			return rc;
+		}
+
+		/* the lost fragments after this one are in the file by now */
+		j = p + 1;
+		for (g = f + 1; g < dec->nb_frags && j < dec->nb_lost; g++) {
+			if (bit_get(dec->received, g)) {
+				continue;
+			}
+
+			if (bit_get(dec->row, j)) {
+				rc = xor_flash(dec->file, g * dec->frag_size,
+					       dec->data, dec->frag_size);
+				if (rc) {
+					return rc;
+				}
+			}
+
+			j++;
+		}
+
+		rc = flash_area_write(dec->file, f * dec->frag_size, dec->data,
+				      dec->frag_size);
+		if (rc) {
+			LOG_ERR("flash write error %d", rc);
+			return rc;
+		}
+	}
+
+	dec->done = true;
+
+	return 0;
+}
+
+int frag_decoder_init(struct frag_decoder *dec,
+		      const struct flash_area *file,
+		      const struct flash_area *matrix,
+		      u16_t nb_frags, u16_t frag_size)
+{
+	u8_t align = max(max(flash_area_align(file), flash_area_align(matrix)),
+			 1);
+	int rc;
+
+	if (nb_frags == 0 || nb_frags > CONFIG_FRAG_DECODER_MAX_FRAGMENTS ||
+	    frag_size == 0 || frag_size > CONFIG_FRAG_DECODER_MAX_FRAG_SIZE ||
+	    align > FRAG_DECODER_ALIGN_MAX || frag_size % align != 0 ||
+	    (u32_t)nb_frags * frag_size > file->fa_size) {
+		return -EINVAL;
+	}
+
+	(void)memset(dec, 0, sizeof(*dec));
+	dec->file = file;
+	dec->matrix = matrix;
+	dec->nb_frags = nb_frags;
+	dec->frag_size = frag_size;
+	dec->align = align;
+
+	rc = flash_area_erase(file, 0, file->fa_size);
+	if (rc == 0) {
+		rc = flash_area_erase(matrix, 0, matrix->fa_size);
+	}
+
+	if (rc) {
+		LOG_ERR("flash erase error %d", rc);
+	}
+
+	return rc;
+}
+
+int frag_decoder_process(struct frag_decoder *dec, u16_t index,
+			 const u8_t *data)
+{
+	u16_t frag;
+	u16_t lost;
+	int rc;
+
+	if (dec->done) {
+		return 1;
+	}
+
+	if (index == 0) {
+		return -EINVAL;
+	}
+
+	if (index <= dec->nb_frags) {
+		frag = index - 1;
+		if (bit_get(dec->received, frag)) {
+			return 0;
+		}
+
+		if (!dec->coding) {
+			rc = flash_area_write(dec->file, frag * dec->frag_size,
+					      data, dec->frag_size);
+			if (rc) {
+				LOG_ERR("flash write error %d", rc);
+				return rc;
+			}
+
+			bit_set(dec->received, frag);
+			dec->nb_rx++;
+			dec->nb_uncoded++;
+			if (dec->nb_uncoded == dec->nb_frags) {
+				dec->done = true;
+				return 1;
+			}
+
+			return 0;
+		}
+
+		/* lost before the coded fragments, now a row of one fragment */
+		(void)memset(dec->row, 0, dec->row_len);
+		bit_set(dec->row, lost_index(dec, frag));
+		memcpy(dec->data, data, dec->frag_size);
+	} else {
+		if (!dec->coding) {
+			rc = frag_decoder_start_coding(dec);
+			if (rc) {
+				return rc;
+			}
+		}
+
+		/* drop the fragments received from the combination */
+		parity_row(dec->parity, index - dec->nb_frags, dec->nb_frags);
+		(void)memset(dec->row, 0, dec->row_len);
+		memcpy(dec->data, data, dec->frag_size);
+
+		for (frag = 0U, lost = 0U; frag < dec->nb_frags; frag++) {
+			if (!bit_get(dec->received, frag)) {
+				if (bit_get(dec->parity, frag)) {
+					bit_set(dec->row, lost);
+				}
+
+				lost++;
+			} else if (bit_get(dec->parity, frag)) {
+				rc = xor_flash(dec->file, frag * dec->frag_size,
+					       dec->data, dec->frag_size);
+				if (rc) {
+					return rc;
+				}
+			}
+		}
+	}
+
+	dec->nb_rx++;
+
+	rc = frag_decoder_reduce(dec);
+	if (rc) {
+		return rc;
+	}
+
+	if (dec->nb_rows < dec->nb_lost) {
+		return 0;
+	}
+
+	LOG_DBG("file rebuilt from %u fragments", dec->nb_rx);
+
+	rc = frag_decoder_solve(dec);
+	if (rc) {
+		return rc;
+	}
+
+	return 1;
+}
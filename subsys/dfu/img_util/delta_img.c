@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_MODULE_NAME delta_img
+#define LOG_LEVEL CONFIG_IMG_DELTA_LOG_LEVEL
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#include <errno.h>
+#include <string.h>
+#include <crc.h>
+#include <misc/util.h>
+#include <misc/byteorder.h>
+#include <dfu/delta_img.h>
+#ifdef CONFIG_MCUBOOT_IMG_MANAGER
+#include <flash_map.h>
+#include <dfu/flash_img.h>
+#endif
+
+#define OP_COPY		0
+#define OP_INSERT	1
+
+enum delta_img_state {
+	STATE_HEADER,
+	STATE_OP,
+	STATE_LEN,
+	STATE_OFF,
+	STATE_DATA,
+};
+
+bool delta_img_is_patch(const u8_t *data, size_t len)
+{
+	return len >= sizeof(u32_t) &&
+	       sys_get_le32(data) == DELTA_IMG_MAGIC;
+}
+
+int delta_img_init(struct delta_img_context *ctx, delta_img_read_t read,
+		   void *read_arg, delta_img_write_t write,
+		   void *write_arg)
+{
+	ctx->read = read;
+	ctx->read_arg = read_arg;
+	ctx->write = write;
+	ctx->write_arg = write_arg;
+	ctx->bytes_read = 0;
+	ctx->src_off = 0U;
+	ctx->dst_off = 0U;
+	ctx->state = STATE_HEADER;
+
+	return 0;
+}
+
+size_t delta_img_bytes_read(struct delta_img_context *ctx)
+{
+	return ctx->bytes_read;
+}
+
+static int delta_img_header(struct delta_img_context *ctx)
+{
+	u32_t crc = 0U;
+	u32_t off;
+	size_t size;
+	int rc;
+
+	if (sys_get_le32(ctx->hdr) != DELTA_IMG_MAGIC) {
+		LOG_ERR("bad magic");
+		return -EINVAL;
+	}
+
+	ctx->src_size = sys_get_le32(&ctx->hdr[4]);
+	ctx->dst_size = sys_get_le32(&ctx->hdr[12]);
+
+	/* the patch only applies to the image it was created from */
+	for (off = 0U; off < ctx->src_size; off += size) {
+		size = min(ctx->src_size - off, sizeof(ctx->buf));
+		rc = ctx->read(ctx->read_arg, off, ctx->buf, size);
+		if (rc) {
+			LOG_ERR("source read error %d offset=0x%08x", rc, off);
+			return rc;
+		}
+
+		crc = crc32_ieee_update(crc, ctx->buf, size);
+	}
+
+	if (crc != sys_get_le32(&ctx->hdr[8])) {
+		LOG_ERR("patch does not apply to the source image");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Returns 1 once the varint is complete, 0 if more bytes are needed */
+static int delta_img_varint(struct delta_img_context *ctx, u8_t byte)
+{
+	if (ctx->shift > 28 || (ctx->shift == 28 && (byte & 0x70))) {
+		LOG_ERR("varint overflow");
+		return -EINVAL;
+	}
+
+	ctx->val |= (u32_t)(byte & 0x7f) << ctx->shift;
+	ctx->shift += 7U;
+
+	return (byte & 0x80) ? 0 : 1;
+}
+
+static int delta_img_seek(struct delta_img_context *ctx)
+{
+	/* zigzag decoding */
+	s64_t off = (s64_t)ctx->src_off +
+		    (s32_t)((ctx->val >> 1) ^ -(ctx->val & 1));
+
+	if (off < 0 || off + ctx->len > ctx->src_size) {
+		LOG_ERR("source range out of bounds");
+		return -EINVAL;
+	}
+
+	ctx->src_off = off;
+
+	return 0;
+}
+
+/* Writes up to one buffer of the current record, data is the patch bytes */
+static int delta_img_emit(struct delta_img_context *ctx, const u8_t *data,
+			  size_t len)
+{
+	int rc;
+
+	if (ctx->op == OP_COPY) {
+		rc = ctx->read(ctx->read_arg, ctx->src_off, ctx->buf, len);
+		if (rc) {
+			LOG_ERR("source read error %d offset=0x%08x", rc,
+				ctx->src_off);
+			return rc;
+		}
+
+		ctx->src_off += len;
+	} else {
+		memcpy(ctx->buf, data, len);
+	}
+
+	rc = ctx->write(ctx->write_arg, ctx->buf, len, false);
+	if (rc) {
+		return rc;
+	}
+
+	ctx->dst_off += len;
+	ctx->len -= len;
+
+	return 0;
+}
+
+static int delta_img_copy(struct delta_img_context *ctx)
+{
+	int rc;
+
+	while (ctx->len > 0) {
+		rc = delta_img_emit(ctx, NULL, min(ctx->len,
+						   sizeof(ctx->buf)));
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+int delta_img_write(struct delta_img_context *ctx, const u8_t *data,
+		    size_t len, bool flush)
+{
+	size_t n;
+	int rc = 0;
+
+	while (len > 0) {
+		n = 1;
+
+		switch (ctx->state) {
+		case STATE_HEADER:
+			n = min(len, DELTA_IMG_HEADER_SIZE - ctx->bytes_read);
+			memcpy(&ctx->hdr[ctx->bytes_read], data, n);
+			if (ctx->bytes_read + n == DELTA_IMG_HEADER_SIZE) {
+				rc = delta_img_header(ctx);
+				ctx->state = STATE_OP;
+			}
+			break;
+		case STATE_OP:
+			ctx->op = *data;
+			if (ctx->op > OP_INSERT) {
+				LOG_ERR("bad op %u", ctx->op);
+				return -EINVAL;
+			}
+
+			ctx->val = 0U;
+			ctx->shift = 0U;
+			ctx->state = STATE_LEN;
+			break;
+		case STATE_LEN:
+			rc = delta_img_varint(ctx, *data);
+			if (rc <= 0) {
+				break;
+			}
+
+			ctx->len = ctx->val;
+			if (ctx->len > ctx->dst_size - ctx->dst_off) {
+				LOG_ERR("target overflow");
+				return -EINVAL;
+			}
+
+			ctx->val = 0U;
+			ctx->shift = 0U;
+			if (ctx->op == OP_COPY) {
+				ctx->state = STATE_OFF;
+			} else if (ctx->len > 0) {
+				ctx->state = STATE_DATA;
+			} else {
+				ctx->state = STATE_OP;
+			}
+			rc = 0;
+			break;
+		case STATE_OFF:
+			rc = delta_img_varint(ctx, *data);
+			if (rc <= 0) {
+				break;
+			}
+
+			rc = delta_img_seek(ctx);
+			if (rc == 0) {
+				rc = delta_img_copy(ctx);
+			}
+
+			ctx->state = STATE_OP;
+			break;
+		case STATE_DATA:
+			n = min(len, min(ctx->len, sizeof(ctx->buf)));
+			rc = delta_img_emit(ctx, data, n);
+			if (ctx->len == 0) {
+				ctx->state = STATE_OP;
+			}
+			break;
+		}
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		ctx->bytes_read += n;
+		data += n;
+		len -= n;
+	}
+
+	if (!flush) {
+		return 0;
+	}
+
+	if (ctx->state != STATE_OP || ctx->dst_off != ctx->dst_size) {
+		LOG_ERR("patch truncated");
+		return -EINVAL;
+	}
+
+	return ctx->write(ctx->write_arg, ctx->buf, 0, true);
+}
+
+#ifdef CONFIG_MCUBOOT_IMG_MANAGER
+/* Slot 0 is opened for each read, as a patch may be abandoned midway */
+static int delta_img_flash_read(void *arg, off_t off, void *dst, size_t len)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(DT_FLASH_AREA_IMAGE_0_ID, &fa);
+	if (rc) {
+		return rc;
+	}
+
+	rc = flash_area_read(fa, off, dst, len);
+	flash_area_close(fa);
+
+	return rc;
+}
+
+static int delta_img_flash_write(void *arg, u8_t *data, size_t len,
+				 bool flush)
+{
+	return flash_img_buffered_write(arg, data, len, flush);
+}
+
+int delta_img_flash_init(struct delta_img_context *ctx,
+			 struct flash_img_context *img)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	/* fail early if there is no source slot */
+	rc = flash_area_open(DT_FLASH_AREA_IMAGE_0_ID, &fa);
+	if (rc) {
+		return rc;
+	}
+
+	flash_area_close(fa);
+
+	return delta_img_init(ctx, delta_img_flash_read, NULL,
+			      delta_img_flash_write, img);
+}
+#endif
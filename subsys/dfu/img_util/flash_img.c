@@ -17,31 +17,71 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <errno.h>
 #include <dfu/flash_img.h>
 #include <inttypes.h>
+#include <init.h>
+#include <flash.h>
+#include <misc/util.h>
 
 BUILD_ASSERT_MSG((CONFIG_IMG_BLOCK_BUF_SIZE % DT_FLASH_WRITE_BLOCK_SIZE == 0),
 		 "CONFIG_IMG_BLOCK_BUF_SIZE is not a multiple of "
 		 "DT_FLASH_WRITE_BLOCK_SIZE");
 
+/* Size of the chunks read back to verify a block */
+#define VERIFY_CHUNK_SIZE 64
+
+#ifdef CONFIG_IMG_ERASE_PROGRESSIVELY
+/* Size of the mcuboot trailer written by boot_request_upgrade() */
+#define BOOT_TRAILER_SIZE (16 + 8 * 2)
+#endif
+
+#ifdef CONFIG_IMG_STREAM_HASH
+/* mcuboot image format, the header is followed by the image and the TLVs */
+#define IMAGE_MAGIC 0x96f3b83d
+#define IMAGE_TLV_INFO_MAGIC 0x6907
+#define IMAGE_TLV_SHA256 0x10
+
+struct image_header {
+	u32_t ih_magic;
+	u32_t ih_load_addr;
+	u16_t ih_hdr_size;
+	u16_t ih_pad1;
+	u32_t ih_img_size;
+} __packed;
+
+struct image_tlv_info {
+	u16_t it_magic;
+	u16_t it_tlv_tot;
+} __packed;
+
+struct image_tlv {
+	u8_t it_type;
+	u8_t it_pad;
+	u16_t it_len;
+} __packed;
+
+BUILD_ASSERT_MSG((CONFIG_IMG_BLOCK_BUF_SIZE >= sizeof(struct image_header)),
+		 "CONFIG_IMG_BLOCK_BUF_SIZE is smaller than the image header");
+#endif
+
+#ifndef CONFIG_IMG_STREAM_HASH
 static bool flash_verify(const struct flash_area *fa, off_t offset,
 			 u8_t *data, size_t len)
 {
 	size_t size;
-	u32_t temp;
+	u32_t temp[VERIFY_CHUNK_SIZE / sizeof(u32_t)];
 	int rc;
 
 	while (len) {
-		size = (len >= sizeof(temp)) ? sizeof(temp) : len;
-		rc = flash_area_read(fa, offset, &temp, size);
+		size = min(len, sizeof(temp));
+		rc = flash_area_read(fa, offset, temp, size);
 		if (rc) {
 			LOG_ERR("flash_read error %d offset=0x%08"PRIx32,
 				rc, (u32_t)offset);
 			break;
 		}
 
-		if (memcmp(data, &temp, size)) {
-			LOG_ERR("offset=0x%08"PRIx32" VERIFY FAIL. "
-				"expected: 0x%08x, actual: 0x%08x",
-				(u32_t)offset, temp, UNALIGNED_GET(data));
+		if (memcmp(data, temp, size)) {
+			LOG_ERR("offset=0x%08"PRIx32" VERIFY FAIL",
+				(u32_t)offset);
 			break;
 		}
 		len -= size;
@@ -51,28 +91,279 @@ static bool flash_verify(const struct flash_area *fa, off_t offset,
 
 	return (len == 0) ? true : false;
 }
+#endif
+
+#ifdef CONFIG_IMG_ERASE_PROGRESSIVELY
+/* Erase the pages of the slot up to the one holding end - 1 */
+static int flash_erase_to(struct flash_img_context *ctx, off_t end)
+{
+	const struct flash_area *fa = ctx->flash_area;
+	struct flash_pages_info page;
+	struct device *dev;
+	int rc;
+
+	dev = device_get_binding(fa->fa_dev_name);
+	if (!dev) {
+		return -ENODEV;
+	}
+
+	while (ctx->off_erased < end) {
+		rc = flash_get_page_info_by_offs(dev,
+						 fa->fa_off + ctx->off_erased,
+						 &page);
+		if (rc) {
+			return rc;
+		}
+
+		rc = flash_area_erase(fa, page.start_offset - fa->fa_off,
+				      page.size);
+		if (rc) {
+			LOG_ERR("flash_erase error %d offset=0x%08" PRIx32, rc,
+				(u32_t)page.start_offset);
+			return rc;
+		}
+
+		ctx->off_erased = page.start_offset - fa->fa_off + page.size;
+	}
+
+	return 0;
+}
+#endif
+
+static int flash_write_block(struct flash_img_context *ctx, off_t offset,
+			     u8_t *data)
+{
+	int rc;
+
+#ifdef CONFIG_IMG_ERASE_PROGRESSIVELY
+	rc = flash_erase_to(ctx, offset + CONFIG_IMG_BLOCK_BUF_SIZE);
+	if (rc) {
+		return rc;
+	}
+#endif
+
+	rc = flash_area_write(ctx->flash_area, offset, data,
+			      CONFIG_IMG_BLOCK_BUF_SIZE);
+	if (rc) {
+		LOG_ERR("flash_write error %d offset=0x%08" PRIx32, rc,
+			(u32_t)offset);
+		return rc;
+	}
+
+#ifndef CONFIG_IMG_STREAM_HASH
+	/* with a running hash, the whole image is read back once flushed */
+	if (!flash_verify(ctx->flash_area, offset, data,
+			  CONFIG_IMG_BLOCK_BUF_SIZE)) {
+		return -EIO;
+	}
+#endif
+
+	return 0;
+}
+
+#ifdef CONFIG_IMG_WRITE_PIPELINE
+static K_THREAD_STACK_DEFINE(flash_img_stack,
+			     CONFIG_IMG_WRITE_THREAD_STACK_SIZE);
+static struct k_work_q flash_img_workq;
+
+/* Given when the writer thread is done with a block */
+static K_SEM_DEFINE(flash_img_idle, 1, 1);
+
+static void flash_img_work(struct k_work *work)
+{
+	struct flash_img_context *ctx =
+		CONTAINER_OF(work, struct flash_img_context, work);
+
+	if (!ctx->wrc) {
+		ctx->wrc = flash_write_block(ctx, ctx->woff, ctx->wbuf);
+	}
+
+	k_sem_give(&flash_img_idle);
+}
+
+/* Wait for the block being written, the caller must give flash_img_idle */
+static int flash_img_wait(struct flash_img_context *ctx)
+{
+	k_sem_take(&flash_img_idle, K_FOREVER);
+
+	return ctx->wrc;
+}
+
+static int flash_img_workq_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_q_start(&flash_img_workq, flash_img_stack,
+		       K_THREAD_STACK_SIZEOF(flash_img_stack),
+		       K_PRIO_PREEMPT(CONFIG_IMG_WRITE_THREAD_PRIORITY));
+
+	return 0;
+}
+
+SYS_INIT(flash_img_workq_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif
+
+#ifdef CONFIG_IMG_STREAM_HASH
+static void flash_img_hash(struct flash_img_context *ctx, const u8_t *data,
+			   size_t len)
+{
+	size_t offset = ctx->bytes_written;
+	struct image_header hdr;
+
+	/* mcuboot hashes the header and the image, not the TLVs */
+	if (offset == 0 && len >= sizeof(hdr)) {
+		memcpy(&hdr, data, sizeof(hdr));
+		if (hdr.ih_magic == IMAGE_MAGIC) {
+			ctx->hash_len = hdr.ih_hdr_size + hdr.ih_img_size;
+			ctx->hash_len_known = true;
+		}
+	}
+
+	if (ctx->hash_len_known) {
+		if (offset >= ctx->hash_len) {
+			return;
+		}
+
+		len = min(len, ctx->hash_len - offset);
+	}
+
+	tc_sha256_update(&ctx->sha, data, len);
+}
+
+static int flash_img_check_tlv(struct flash_img_context *ctx,
+			       const u8_t *hash)
+{
+	const struct flash_area *fa = ctx->flash_area;
+	struct image_tlv_info info;
+	struct image_tlv tlv;
+	off_t offset = ctx->hash_len;
+	off_t end;
+	int rc;
+
+	rc = flash_area_read(fa, offset, &info, sizeof(info));
+	if (rc) {
+		return rc;
+	}
+
+	if (info.it_magic != IMAGE_TLV_INFO_MAGIC) {
+		LOG_ERR("no TLV after the image");
+		return -EBADMSG;
+	}
+
+	end = offset + info.it_tlv_tot;
+	offset += sizeof(info);
+
+	while (offset + sizeof(tlv) <= end) {
+		rc = flash_area_read(fa, offset, &tlv, sizeof(tlv));
+		if (rc) {
+			return rc;
+		}
+
+		offset += sizeof(tlv);
+
+		if (tlv.it_type == IMAGE_TLV_SHA256 &&
+		    tlv.it_len == TC_SHA256_DIGEST_SIZE) {
+			rc = flash_area_read(fa, offset, ctx->buf,
+					     TC_SHA256_DIGEST_SIZE);
+			if (rc) {
+				return rc;
+			}
+
+			if (memcmp(ctx->buf, hash, TC_SHA256_DIGEST_SIZE)) {
+				LOG_ERR("image hash mismatch");
+				return -EBADMSG;
+			}
+
+			return 0;
+		}
+
+		offset += tlv.it_len;
+	}
+
+	LOG_ERR("no SHA-256 TLV");
+	return -EBADMSG;
+}
+
+static int flash_img_check(struct flash_img_context *ctx)
+{
+	struct tc_sha256_state_struct sha;
+	u8_t hash[TC_SHA256_DIGEST_SIZE];
+	u8_t readback[TC_SHA256_DIGEST_SIZE];
+	size_t len = ctx->bytes_written;
+	size_t offset;
+	size_t size;
+	int rc;
+
+	if (ctx->hash_len_known) {
+		if (ctx->hash_len > ctx->bytes_written) {
+			LOG_ERR("image truncated");
+			return -EBADMSG;
+		}
+
+		len = ctx->hash_len;
+	}
+
+	tc_sha256_final(hash, &ctx->sha);
+
+	/* the block buffer is free once flushed, read back in blocks */
+	tc_sha256_init(&sha);
+	for (offset = 0; offset < len; offset += size) {
+		size = min(len - offset, CONFIG_IMG_BLOCK_BUF_SIZE);
+		rc = flash_area_read(ctx->flash_area, offset, ctx->buf, size);
+		if (rc) {
+			LOG_ERR("flash_read error %d offset=0x%08"PRIx32,
+				rc, (u32_t)offset);
+			return rc;
+		}
+
+		tc_sha256_update(&sha, ctx->buf, size);
+	}
+
+	tc_sha256_final(readback, &sha);
+	if (memcmp(hash, readback, sizeof(hash))) {
+		LOG_ERR("VERIFY FAIL");
+		return -EIO;
+	}
+
+	if (!ctx->hash_len_known) {
+		return 0;
+	}
+
+	return flash_img_check_tlv(ctx, hash);
+}
+#endif
 
 static int flash_sync(struct flash_img_context *ctx)
 {
 	int rc = 0;
 
+#ifdef CONFIG_IMG_STREAM_HASH
+	flash_img_hash(ctx, ctx->buf, ctx->buf_bytes);
+#endif
+
 	if (ctx->buf_bytes < CONFIG_IMG_BLOCK_BUF_SIZE) {
 		(void)memset(ctx->buf + ctx->buf_bytes, 0xFF,
 			     CONFIG_IMG_BLOCK_BUF_SIZE - ctx->buf_bytes);
 	}
 
-	rc = flash_area_write(ctx->flash_area, ctx->bytes_written, ctx->buf,
-			      CONFIG_IMG_BLOCK_BUF_SIZE);
+#ifdef CONFIG_IMG_WRITE_PIPELINE
+	rc = flash_img_wait(ctx);
 	if (rc) {
-		LOG_ERR("flash_write error %d offset=0x%08" PRIx32, rc,
-			(u32_t)ctx->bytes_written);
+		k_sem_give(&flash_img_idle);
 		return rc;
 	}
 
-	if (!flash_verify(ctx->flash_area, ctx->bytes_written, ctx->buf,
-			  CONFIG_IMG_BLOCK_BUF_SIZE)) {
-		return -EIO;
+	/* the next block is received while this one is written */
+	memcpy(ctx->wbuf, ctx->buf, CONFIG_IMG_BLOCK_BUF_SIZE);
+	ctx->woff = ctx->bytes_written;
+	k_work_submit_to_queue(&flash_img_workq, &ctx->work);
+#else
+	rc = flash_write_block(ctx, ctx->bytes_written, ctx->buf);
+	if (rc) {
+		return rc;
 	}
+#endif
 
 	ctx->bytes_written += ctx->buf_bytes;
 	ctx->buf_bytes = 0;
@@ -122,6 +413,32 @@ int flash_img_buffered_write(struct flash_img_context *ctx, u8_t *data,
 		}
 	}
 
+#ifdef CONFIG_IMG_WRITE_PIPELINE
+	rc = flash_img_wait(ctx);
+	k_sem_give(&flash_img_idle);
+	if (rc) {
+		return rc;
+	}
+#endif
+
+#ifdef CONFIG_IMG_ERASE_PROGRESSIVELY
+	/* the trailer is written once the image is downloaded */
+	if (ctx->off_erased < ctx->flash_area->fa_size - BOOT_TRAILER_SIZE) {
+		ctx->off_erased = ctx->flash_area->fa_size - BOOT_TRAILER_SIZE;
+		rc = flash_erase_to(ctx, ctx->flash_area->fa_size);
+		if (rc) {
+			return rc;
+		}
+	}
+#endif
+
+#ifdef CONFIG_IMG_STREAM_HASH
+	rc = flash_img_check(ctx);
+	if (rc) {
+		return rc;
+	}
+#endif
+
 	flash_area_close(ctx->flash_area);
 	ctx->flash_area = NULL;
 
@@ -135,6 +452,22 @@ size_t flash_img_bytes_written(struct flash_img_context *ctx)
 
 int flash_img_init(struct flash_img_context *ctx)
 {
+#ifdef CONFIG_IMG_WRITE_PIPELINE
+	/* a block of an aborted download may still be written */
+	k_sem_take(&flash_img_idle, K_FOREVER);
+	k_sem_give(&flash_img_idle);
+
+	ctx->wrc = 0;
+	k_work_init(&ctx->work, flash_img_work);
+#endif
+#ifdef CONFIG_IMG_ERASE_PROGRESSIVELY
+	ctx->off_erased = 0;
+#endif
+#ifdef CONFIG_IMG_STREAM_HASH
+	tc_sha256_init(&ctx->sha);
+	ctx->hash_len = 0;
+	ctx->hash_len_known = false;
+#endif
 	ctx->bytes_written = 0;
 	ctx->buf_bytes = 0;
 	return flash_area_open(DT_FLASH_AREA_IMAGE_1_ID,
@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <stddef.h>
 #include <string.h>
 #include <misc/byteorder.h>
+#include <init.h>
 
 #include <net/buf.h>
 
@@ -44,8 +45,9 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #define WARN_ALLOC_INTERVAL K_FOREVER
 #endif
 
-/* Linker-defined symbol bound to the static pool structs */
+/* Linker-defined symbols bound to the static pool structs */
 extern struct net_buf_pool _net_buf_pool_list[];
+extern struct net_buf_pool _net_buf_pool_list_end[];
 
 struct net_buf_pool *net_buf_pool_get(int id)
 {
@@ -64,6 +66,77 @@ int net_buf_id(struct net_buf *buf)
 	return buf - pool->__bufs;
 }
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+void net_buf_pool_foreach(net_buf_pool_cb_t cb, void *user_data)
+{
+	struct net_buf_pool *pool;
+
+	for (pool = _net_buf_pool_list; pool < _net_buf_pool_list_end;
+	     pool++) {
+		cb(pool, user_data);
+	}
+}
+
+static inline void pool_stats_alloc(struct net_buf_pool *pool,
+				    u32_t alloc_start)
+{
+	u16_t used = pool->buf_count - pool->avail_count;
+
+	pool->stats.alloc_count++;
+	pool->stats.wait_time += k_uptime_get_32() - alloc_start;
+
+	if (used > pool->stats.max_used) {
+		pool->stats.max_used = used;
+	}
+}
+
+static inline void pool_stats_fail(struct net_buf_pool *pool,
+				   u32_t alloc_start)
+{
+	pool->stats.alloc_failed++;
+	pool->stats.wait_time += k_uptime_get_32() - alloc_start;
+}
+#else
+#define pool_stats_alloc(pool, alloc_start)
+#define pool_stats_fail(pool, alloc_start)
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
+#if defined(CONFIG_NET_BUF_POOL_STATS)
+#if defined(CONFIG_STATS_NAMES)
+static const struct stats_name_map pool_stats_names[] = {
+	{ offsetof(struct net_buf_pool_stats, alloc_count), "alloc_count" },
+	{ offsetof(struct net_buf_pool_stats, alloc_failed), "alloc_failed" },
+	{ offsetof(struct net_buf_pool_stats, wait_time), "wait_time" },
+	{ offsetof(struct net_buf_pool_stats, max_used), "max_used" },
+};
+#define POOL_STATS_NAMES pool_stats_names, ARRAY_SIZE(pool_stats_names)
+#else
+#define POOL_STATS_NAMES NULL, 0
+#endif /* CONFIG_STATS_NAMES */
+
+static void pool_stats_register(struct net_buf_pool *pool, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	(void)stats_init_and_reg(&pool->stats.s_hdr, STATS_SIZE_32,
+				 (sizeof(pool->stats) -
+				  sizeof(struct stats_hdr)) / STATS_SIZE_32,
+				 POOL_STATS_NAMES, pool->name);
+}
+
+static int net_buf_pool_stats_init(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	net_buf_pool_foreach(pool_stats_register, NULL);
+
+	return 0;
+}
+
+SYS_INIT(net_buf_pool_stats_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_NET_BUF_POOL_STATS */
+
 static inline struct net_buf *pool_get_uninit(struct net_buf_pool *pool,
 					      u16_t uninit_count)
 {
@@ -306,6 +379,7 @@ struct net_buf *net_buf_alloc_len(struct net_buf_pool *pool, size_t size,
 #endif
 	if (!buf) {
 		NET_BUF_ERR("%s():%d: Failed to get free buffer", func, line);
+		pool_stats_fail(pool, alloc_start);
 		return NULL;
 	}
 
@@ -324,6 +398,7 @@ success:
 			NET_BUF_ERR("%s():%d: Failed to allocate data",
 				    func, line);
 			net_buf_destroy(buf);
+			pool_stats_fail(pool, alloc_start);
 			return NULL;
 		}
 	} else {
@@ -341,6 +416,8 @@ success:
 	NET_BUF_ASSERT(pool->avail_count >= 0);
 #endif
 
+	pool_stats_alloc(pool, alloc_start);
+
 	return buf;
 }
 
@@ -326,6 +326,73 @@ static inline void cache_remove(struct net_conn *conn)
 #define cache_remove(...)
 #endif /* CONFIG_NET_CONN_CACHE */
 
+#if defined(CONFIG_NET_CONN_HASH)
+
+/* UDP and TCP connections are hashed by protocol and local port. The
+ * connections that do not specify a local port, and the connections of
+ * other protocols, are kept in a separate wildcard list that is checked
+ * for every packet. All the lists are sorted by the position of the
+ * connection in the conns array so that a lookup visits the candidates
+ * in the same order as the linear scan, and so selects the same
+ * connection.
+ */
+static sys_slist_t conn_hash[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_wildcard;
+
+static inline sys_slist_t *conn_hash_bucket(u16_t proto, u16_t port)
+{
+	/* Note that we do not convert port value to host byte order */
+	return &conn_hash[(port ^ (port >> 8) ^ proto) %
+			  CONFIG_NET_CONN_HASH_BUCKETS];
+}
+
+static sys_slist_t *conn_hash_list(struct net_conn *conn)
+{
+	u16_t port = net_sin(&conn->local_addr)->sin_port;
+
+	if ((conn->proto == IPPROTO_UDP || conn->proto == IPPROTO_TCP) &&
+	    port) {
+		return conn_hash_bucket(conn->proto, port);
+	}
+
+	return &conn_wildcard;
+}
+
+static void conn_hash_add(struct net_conn *conn)
+{
+	sys_slist_t *list = conn_hash_list(conn);
+	sys_snode_t *prev = NULL;
+	struct net_conn *tmp;
+	unsigned int key;
+
+	key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, tmp, node) {
+		if (tmp > conn) {
+			break;
+		}
+
+		prev = &tmp->node;
+	}
+
+	sys_slist_insert(list, prev, &conn->node);
+
+	irq_unlock(key);
+}
+
+static void conn_hash_remove(struct net_conn *conn)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	sys_slist_find_and_remove(conn_hash_list(conn), &conn->node);
+	irq_unlock(key);
+}
+#else
+#define conn_hash_add(...)
+#define conn_hash_remove(...)
+#endif /* CONFIG_NET_CONN_HASH */
+
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
@@ -339,6 +406,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	}
 
 	cache_remove(conn);
+	conn_hash_remove(conn);
 
 	NET_DBG("[%zu] connection handler %p removed",
 		conn - conns, conn);
@@ -661,6 +729,7 @@ int net_conn_register(u16_t proto, u8_t family,
 
 		/* Cache needs to be cleared if new entries are added. */
 		cache_clear();
+		conn_hash_add(&conns[i]);
 
 		if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG) {
 			char dst[NET_IPV6_ADDR_LEN];
@@ -797,14 +866,153 @@ static bool is_invalid_packet(struct net_pkt *pkt,
 	return true;
 }
 
+/* Check if connection i matches the packet and if it is a better match
+ * than the current best one.
+ */
+static void conn_match(int i, struct net_pkt *pkt,
+		       union net_ip_header *ip_hdr,
+		       u8_t proto, u16_t src_port, u16_t dst_port,
+		       int *best_match, s16_t *best_rank)
+{
+	if (conns[i].proto != proto) {
+		return;
+	}
+
+	if (conns[i].family != AF_UNSPEC &&
+	    conns[i].family != net_pkt_family(pkt)) {
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_UDP) || IS_ENABLED(CONFIG_NET_TCP)) {
+		if (net_sin(&conns[i].remote_addr)->sin_port) {
+			if (net_sin(&conns[i].remote_addr)->sin_port !=
+			    src_port) {
+				return;
+			}
+		}
+
+		if (net_sin(&conns[i].local_addr)->sin_port) {
+			if (net_sin(&conns[i].local_addr)->sin_port !=
+			    dst_port) {
+				return;
+			}
+		}
+
+		if (conns[i].flags & NET_CONN_REMOTE_ADDR_SET) {
+			if (!check_addr(pkt, ip_hdr, &conns[i].remote_addr,
+					true)) {
+				return;
+			}
+		}
+
+		if (conns[i].flags & NET_CONN_LOCAL_ADDR_SET) {
+			if (!check_addr(pkt, ip_hdr, &conns[i].local_addr,
+					false)) {
+				return;
+			}
+		}
+
+		/* If we have an existing best_match, and that one
+		 * specifies a remote port, then we've matched to a
+		 * LISTENING connection that should not override.
+		 */
+		if (*best_match >= 0 &&
+		    net_sin(&conns[*best_match].remote_addr)->sin_port) {
+			return;
+		}
+
+		if (*best_rank < conns[i].rank) {
+			*best_rank = conns[i].rank;
+			*best_match = i;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET)) {
+		*best_rank = 0;
+		*best_match = i;
+	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN)) {
+		*best_rank = 0;
+		*best_match = i;
+	}
+}
+
+#if defined(CONFIG_NET_CONN_HASH)
+static int conn_find(struct net_pkt *pkt, union net_ip_header *ip_hdr,
+		     u8_t proto, u16_t src_port, u16_t dst_port)
+{
+	sys_snode_t *bucket = NULL;
+	sys_snode_t *wildcard;
+	struct net_conn *conn;
+	int best_match = -1;
+	s16_t best_rank = -1;
+	unsigned int key;
+
+	/* The lists are walked with the lock that protects their updates,
+	 * a handler (un)registered by another thread would otherwise break
+	 * the walk. A lookup only visits a few connections.
+	 */
+	key = irq_lock();
+
+	if (dst_port && (proto == IPPROTO_UDP || proto == IPPROTO_TCP)) {
+		bucket = sys_slist_peek_head(conn_hash_bucket(proto,
+							      dst_port));
+	}
+
+	wildcard = sys_slist_peek_head(&conn_wildcard);
+
+	/* Merge the two sorted lists so that the connections are checked
+	 * in the same order as in the full table.
+	 */
+	while (bucket || wildcard) {
+		if (!wildcard || (bucket && bucket < wildcard)) {
+			conn = CONTAINER_OF(bucket, struct net_conn, node);
+			bucket = sys_slist_peek_next(bucket);
+		} else {
+			conn = CONTAINER_OF(wildcard, struct net_conn, node);
+			wildcard = sys_slist_peek_next(wildcard);
+		}
+
+		conn_match(conn - conns, pkt, ip_hdr, proto,
+			   src_port, dst_port, &best_match, &best_rank);
+
+		/* Nothing can override a match that specifies a remote
+		 * port, so there is no need to check the rest.
+		 */
+		if (best_match >= 0 &&
+		    net_sin(&conns[best_match].remote_addr)->sin_port) {
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	return best_match;
+}
+#else
+static int conn_find(struct net_pkt *pkt, union net_ip_header *ip_hdr,
+		     u8_t proto, u16_t src_port, u16_t dst_port)
+{
+	int i, best_match = -1;
+	s16_t best_rank = -1;
+
+	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
+		if (!(conns[i].flags & NET_CONN_IN_USE)) {
+			continue;
+		}
+
+		conn_match(i, pkt, ip_hdr, proto, src_port, dst_port,
+			   &best_match, &best_rank);
+	}
+
+	return best_match;
+}
+#endif /* CONFIG_NET_CONN_HASH */
+
 enum net_verdict net_conn_input(struct net_pkt *pkt,
 				union net_ip_header *ip_hdr,
 				u8_t proto,
 				union net_proto_header *proto_hdr)
 {
 	struct net_if *pkt_iface = net_pkt_iface(pkt);
-	int i, best_match = -1;
-	s16_t best_rank = -1;
+	int best_match;
 	u16_t src_port;
 	u16_t dst_port;
 #if defined(CONFIG_NET_CONN_CACHE)
@@ -859,73 +1067,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		" family %d", net_proto2str(net_pkt_family(pkt), proto), pkt,
 		ntohs(src_port), ntohs(dst_port), net_pkt_family(pkt));
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (!(conns[i].flags & NET_CONN_IN_USE)) {
-			continue;
-		}
-
-		if (conns[i].proto != proto) {
-			continue;
-		}
-
-		if (conns[i].family != AF_UNSPEC &&
-		    conns[i].family != net_pkt_family(pkt)) {
-			continue;
-		}
-
-		if (IS_ENABLED(CONFIG_NET_UDP) ||
-		    IS_ENABLED(CONFIG_NET_TCP)) {
-			if (net_sin(&conns[i].remote_addr)->sin_port) {
-				if (net_sin(&conns[i].remote_addr)->sin_port !=
-				    src_port) {
-					continue;
-				}
-			}
-
-			if (net_sin(&conns[i].local_addr)->sin_port) {
-				if (net_sin(&conns[i].local_addr)->sin_port !=
-				    dst_port) {
-					continue;
-				}
-			}
-
-			if (conns[i].flags & NET_CONN_REMOTE_ADDR_SET) {
-				if (!check_addr(pkt, ip_hdr,
-						&conns[i].remote_addr,
-						true)) {
-					continue;
-				}
-			}
-
-			if (conns[i].flags & NET_CONN_LOCAL_ADDR_SET) {
-				if (!check_addr(pkt, ip_hdr,
-						&conns[i].local_addr,
-						false)) {
-					continue;
-				}
-			}
-
-			/* If we have an existing best_match, and that one
-			 * specifies a remote port, then we've matched to a
-			 * LISTENING connection that should not override.
-			 */
-			if (best_match >= 0 &&
-			    net_sin(&conns[best_match].remote_addr)->sin_port) {
-				continue;
-			}
-
-			if (best_rank < conns[i].rank) {
-				best_rank = conns[i].rank;
-				best_match = i;
-			}
-		} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET)) {
-			best_rank = 0;
-			best_match = i;
-		} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN)) {
-			best_rank = 0;
-			best_match = i;
-		}
-	}
+	best_match = conn_find(pkt, ip_hdr, proto, src_port, dst_port);
 
 	if (best_match >= 0) {
 #if defined(CONFIG_NET_CONN_CACHE)
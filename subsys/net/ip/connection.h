@@ -16,6 +16,7 @@
 #include <zephyr/types.h>
 
 #include <misc/util.h>
+#include <misc/slist.h>
 
 #include <net/net_core.h>
 #include <net/net_ip.h>
@@ -47,6 +48,11 @@ typedef enum net_verdict (*net_conn_cb_t)(struct net_conn *conn,
  *
  */
 struct net_conn {
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Internal slist node, links the connection into its hash bucket */
+	sys_snode_t node;
+#endif
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
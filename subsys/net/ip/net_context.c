@@ -287,6 +287,10 @@ int net_context_get(sa_family_t family,
 		k_sem_init(&contexts[i].recv_data_wait, 1, UINT_MAX);
 #endif /* CONFIG_NET_CONTEXT_SYNC_RECV */
 
+#if defined(CONFIG_NET_SOCKETS_POLLSET)
+		contexts[i].poll_entry = NULL;
+#endif /* CONFIG_NET_SOCKETS_POLLSET */
+
 		k_mutex_init(&contexts[i].lock);
 
 		contexts[i].flags |= NET_CONTEXT_IN_USE;
@@ -1458,10 +1462,39 @@ int net_context_sendto(struct net_pkt *pkt,
 	return ret;
 }
 
+/* Writes len bytes of data to pkt, from buf or from the buffers of
+ * msghdr when it is set.
+ */
+static int context_write_data(struct net_pkt *pkt, const void *buf,
+			      size_t len, const struct msghdr *msghdr)
+{
+	size_t i, chunk;
+	int ret;
+
+	if (!msghdr) {
+		return net_pkt_write_new(pkt, buf, len);
+	}
+
+	for (i = 0; i < msghdr->msg_iovlen && len > 0; i++) {
+		chunk = min(msghdr->msg_iov[i].iov_len, len);
+
+		ret = net_pkt_write_new(pkt, msghdr->msg_iov[i].iov_base,
+					chunk);
+		if (ret < 0) {
+			return ret;
+		}
+
+		len -= chunk;
+	}
+
+	return 0;
+}
+
 static int context_setup_udp_packet(struct net_context *context,
 				    struct net_pkt *pkt,
 				    const void *buf,
 				    size_t len,
+				    const struct msghdr *msghdr,
 				    const struct sockaddr *dst_addr,
 				    socklen_t addrlen)
 {
@@ -1503,7 +1536,7 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
-	ret = net_pkt_write_new(pkt, buf, len);
+	ret = context_write_data(pkt, buf, len, msghdr);
 	if (ret) {
 		return ret;
 	}
@@ -1532,6 +1565,7 @@ static void context_finalize_packet(struct net_context *context,
 static int context_sendto_new(struct net_context *context,
 			      const void *buf,
 			      size_t len,
+			      const struct msghdr *msghdr,
 			      const struct sockaddr *dst_addr,
 			      socklen_t addrlen,
 			      net_context_send_cb_t cb,
@@ -1649,7 +1683,7 @@ static int context_sendto_new(struct net_context *context,
 	if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
 		ret = context_setup_udp_packet(context, pkt, buf, len,
-					       dst_addr, addrlen);
+					       msghdr, dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1659,7 +1693,7 @@ static int context_sendto_new(struct net_context *context,
 		ret = net_send_data(pkt);
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
-		ret = net_pkt_write_new(pkt, buf, len);
+		ret = context_write_data(pkt, buf, len, msghdr);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1673,7 +1707,7 @@ static int context_sendto_new(struct net_context *context,
 		ret = net_tcp_send_data(context, cb, token, user_data);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = net_pkt_write_new(pkt, buf, len);
+		ret = context_write_data(pkt, buf, len, msghdr);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1684,7 +1718,7 @@ static int context_sendto_new(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN &&
 		   net_context_get_ip_proto(context) == CAN_RAW) {
-		ret = net_pkt_write_new(pkt, buf, len);
+		ret = context_write_data(pkt, buf, len, msghdr);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1709,43 +1743,53 @@ fail:
 	return ret;
 }
 
-int net_context_send_new(struct net_context *context,
-			 const void *buf,
-			 size_t len,
-			 net_context_send_cb_t cb,
-			 s32_t timeout,
-			 void *token,
-			 void *user_data)
+/* Returns the length of the remote address of a connected context */
+static int context_remote_addrlen(struct net_context *context,
+				  socklen_t *addrlen)
 {
-	socklen_t addrlen;
-	int ret = 0;
-
-	k_mutex_lock(&context->lock, K_FOREVER);
-
 	if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
 	    !net_sin(&context->remote)->sin_port) {
-		ret = -EDESTADDRREQ;
-		goto unlock;
+		return -EDESTADDRREQ;
 	}
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) &&
 	    net_context_get_family(context) == AF_INET) {
-		addrlen = sizeof(struct sockaddr_in);
+		*addrlen = sizeof(struct sockaddr_in);
 	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
 		   net_context_get_family(context) == AF_INET6) {
-		addrlen = sizeof(struct sockaddr_in6);
+		*addrlen = sizeof(struct sockaddr_in6);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = -EOPNOTSUPP;
-		goto unlock;
+		return -EOPNOTSUPP;
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN) {
-		addrlen = sizeof(struct sockaddr_can);
+		*addrlen = sizeof(struct sockaddr_can);
 	} else {
-		addrlen = 0;
+		*addrlen = 0;
 	}
 
-	ret = context_sendto_new(context, buf, len, &context->remote,
+	return 0;
+}
+
+int net_context_send_new(struct net_context *context,
+			 const void *buf,
+			 size_t len,
+			 net_context_send_cb_t cb,
+			 s32_t timeout,
+			 void *token,
+			 void *user_data)
+{
+	socklen_t addrlen;
+	int ret = 0;
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	ret = context_remote_addrlen(context, &addrlen);
+	if (ret < 0) {
+		goto unlock;
+	}
+
+	ret = context_sendto_new(context, buf, len, NULL, &context->remote,
 				 addrlen, cb, timeout, token, user_data);
 unlock:
 	k_mutex_unlock(&context->lock);
@@ -1753,7 +1797,6 @@ unlock:
 	return ret;
 }
 
-
 int net_context_sendto_new(struct net_context *context,
 			   const void *buf,
 			   size_t len,
@@ -1768,7 +1811,7 @@ int net_context_sendto_new(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto_new(context, buf, len, dst_addr, addrlen,
+	ret = context_sendto_new(context, buf, len, NULL, dst_addr, addrlen,
 				 cb, timeout, token, user_data);
 
 	k_mutex_unlock(&context->lock);
@@ -1776,6 +1819,48 @@ int net_context_sendto_new(struct net_context *context,
 	return ret;
 }
 
+int net_context_sendmsg(struct net_context *context,
+			const struct msghdr *msghdr,
+			int flags,
+			net_context_send_cb_t cb,
+			s32_t timeout,
+			void *token,
+			void *user_data)
+{
+	const struct sockaddr *dst_addr;
+	socklen_t addrlen;
+	size_t len = 0;
+	size_t i;
+	int ret;
+
+	ARG_UNUSED(flags);
+
+	for (i = 0; i < msghdr->msg_iovlen; i++) {
+		len += msghdr->msg_iov[i].iov_len;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (msghdr->msg_name) {
+		dst_addr = msghdr->msg_name;
+		addrlen = msghdr->msg_namelen;
+	} else {
+		ret = context_remote_addrlen(context, &addrlen);
+		if (ret < 0) {
+			goto unlock;
+		}
+
+		dst_addr = &context->remote;
+	}
+
+	ret = context_sendto_new(context, NULL, len, msghdr, dst_addr,
+				 addrlen, cb, timeout, token, user_data);
+unlock:
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
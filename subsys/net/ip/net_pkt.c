@@ -79,7 +79,8 @@ LOG_MODULE_REGISTER(net_pkt, CONFIG_NET_PKT_LOG_LEVEL);
 /* Make sure that IP + TCP/UDP/ICMP headers fit into one fragment. This
  * makes possible to cast a fragment pointer to protocol header struct.
  */
-#if CONFIG_NET_BUF_DATA_SIZE < (MAX_IP_PROTO_LEN + MAX_NEXT_PROTO_LEN)
+#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE) && \
+	CONFIG_NET_BUF_DATA_SIZE < (MAX_IP_PROTO_LEN + MAX_NEXT_PROTO_LEN)
 #if defined(STRING2)
 #undef STRING2
 #endif
@@ -121,10 +122,20 @@ NET_BUF_POOL_FIXED_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
 
 #else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
-NET_BUF_POOL_VAR_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
-			CONFIG_NET_BUF_DATA_POOL_SIZE, NULL);
-NET_BUF_POOL_VAR_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
-			CONFIG_NET_BUF_DATA_POOL_SIZE, NULL);
+NET_BUF_POOL_VAR_BOUNDED_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
+				CONFIG_NET_BUF_DATA_POOL_SIZE,
+				CONFIG_NET_BUF_DATA_MAX_FRAG_SIZE, NULL);
+NET_BUF_POOL_VAR_BOUNDED_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
+				CONFIG_NET_BUF_DATA_POOL_SIZE,
+				CONFIG_NET_BUF_DATA_MAX_FRAG_SIZE, NULL);
+
+/* Largest payload which fits in one data fragment */
+#define NET_BUF_MAX_FRAG_DATA \
+	(CONFIG_NET_BUF_DATA_MAX_FRAG_SIZE - NET_BUF_VAR_DATA_OVERHEAD)
+
+BUILD_ASSERT_MSG(NET_BUF_MAX_FRAG_DATA >=
+		 (MAX_IP_PROTO_LEN + MAX_NEXT_PROTO_LEN),
+		 "Too small net_buf fragment size");
 
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
@@ -1694,21 +1705,55 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 					size_t size, s32_t timeout)
 #endif
 {
-	struct net_buf *buf;
+	u32_t alloc_start = k_uptime_get_32();
+	struct net_buf *first = NULL;
+	struct net_buf *current = NULL;
+
+	/* Each fragment gets a block matching its size, up to the
+	 * bounded fragment size, bigger requests are chained.
+	 */
+	while (size) {
+		struct net_buf *new;
+
+		new = net_buf_alloc_len(pool, min(size, NET_BUF_MAX_FRAG_DATA),
+					timeout);
+		if (!new) {
+			goto error;
+		}
 
-	buf = net_buf_alloc_len(pool, size, timeout);
+		if (!first && !current) {
+			first = new;
+		} else {
+			current->frags = new;
+		}
+
+		current = new;
+		size -= current->size;
+
+		if (timeout != K_NO_WAIT && timeout != K_FOREVER) {
+			u32_t diff = k_uptime_get_32() - alloc_start;
+
+			timeout -= min(timeout, diff);
+		}
 
 #if CONFIG_NET_PKT_LOG_LEVEL >= LOG_LEVEL_DBG
-	NET_FRAG_CHECK_IF_NOT_IN_USE(buf, buf->ref + 1);
+		NET_FRAG_CHECK_IF_NOT_IN_USE(new, new->ref + 1);
 
-	net_pkt_alloc_add(buf, false, caller, line);
+		net_pkt_alloc_add(new, false, caller, line);
 
-	NET_DBG("%s (%s) [%d] frag %p ref %d (%s():%d)",
-		pool2str(pool), get_name(pool), get_frees(pool),
-		buf, buf->ref, caller, line);
+		NET_DBG("%s (%s) [%d] frag %p ref %d (%s():%d)",
+			pool2str(pool), get_name(pool), get_frees(pool),
+			new, new->ref, caller, line);
 #endif
+	}
+
+	return first;
+error:
+	if (first) {
+		net_buf_unref(first);
+	}
 
-	return buf;
+	return NULL;
 }
 
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
@@ -2449,6 +2449,18 @@ static void context_info(struct net_context *context, void *user_data)
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 }
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+static void pool_stats_cb(struct net_buf_pool *pool, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+
+	PR("%p\t%u\t%u\t%u\t%u\t%u\t%s\n", pool, pool->buf_count,
+	   pool->stats.max_used, pool->stats.alloc_count,
+	   pool->stats.alloc_failed, pool->stats.wait_time, pool->name);
+}
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 {
 	struct k_mem_slab *rx, *tx;
@@ -2459,7 +2471,12 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 
 	net_pkt_get_info(&rx, &tx, &rx_data, &tx_data);
 
+#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE)
 	PR("Fragment length %d bytes\n", CONFIG_NET_BUF_DATA_SIZE);
+#else
+	PR("Fragment length up to %d bytes from a %d bytes pool\n",
+	   CONFIG_NET_BUF_DATA_MAX_FRAG_SIZE, CONFIG_NET_BUF_DATA_POOL_SIZE);
+#endif
 
 	PR("Network buffer pools:\n");
 
@@ -2489,6 +2506,20 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 	PR("%p\t%d\tTX DATA\n", tx_data, tx_data->buf_count);
 #endif /* CONFIG_NET_BUF_POOL_USAGE */
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	{
+		struct net_shell_user_data user_data;
+
+		user_data.shell = shell;
+		user_data.user_data = NULL;
+
+		PR("\nBuffer pool statistics (wait time in ms):\n");
+		PR("Address\t\tTotal\tMax\tAllocs\tFails\tWait\tName\n");
+
+		net_buf_pool_foreach(pool_stats_cb, &user_data);
+	}
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 	if (IS_ENABLED(CONFIG_NET_CONTEXT_NET_PKT_POOL)) {
 		struct net_shell_user_data user_data;
 		struct ctx_info info;
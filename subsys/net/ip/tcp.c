@@ -52,6 +52,8 @@ static struct tcp_backlog_entry {
 	struct k_delayed_work ack_timer;
 	struct sockaddr remote;
 	u16_t send_mss;
+	u8_t send_wscale;
+	bool wscale_ok;
 } tcp_backlog[CONFIG_NET_TCP_BACKLOG_SIZE];
 
 #if defined(CONFIG_NET_TCP_ACK_TIMEOUT)
@@ -62,6 +64,9 @@ static struct tcp_backlog_entry {
 
 #define FIN_TIMEOUT K_SECONDS(1)
 
+/* RFC 6298 allows to limit the retransmission timeout to 60 seconds */
+#define MAX_RTO K_SECONDS(60)
+
 /* Declares a wrapper function for a net_conn callback that refs the
  * context around the invocation (to protect it from premature
  * deletion).  Long term would be nice to see this feature be part of
@@ -163,8 +168,71 @@ static void net_tcp_trace(struct net_pkt *pkt,
 
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((u32_t)1 << tcp->retry_timeout_shift) *
-				CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	return ((u32_t)1 << tcp->retry_timeout_shift) * tcp->rto;
+}
+
+/* Window scale shift needed to advertise the configured receive window */
+static inline u8_t recv_wscale(void)
+{
+	u8_t shift = 0U;
+
+	while (shift < NET_TCP_MAX_WSCALE &&
+	       (CONFIG_NET_TCP_RECV_WINDOW_SIZE >> shift) > UINT16_MAX) {
+		shift++;
+	}
+
+	return shift;
+}
+
+static void rtt_start(struct net_tcp *tcp)
+{
+	if (!IS_ENABLED(CONFIG_NET_TCP_RTT_ESTIMATION) || tcp->rtt_active) {
+		return;
+	}
+
+	tcp->rtt_active = 1U;
+	tcp->rtt_seq = tcp->send_seq;
+	tcp->rtt_start = k_uptime_get_32();
+}
+
+/* Update the retransmission timeout as described in RFC 6298, with the
+ * fixed point arithmetic of Jacobson's "Congestion Avoidance and Control".
+ */
+static void rtt_update(struct net_tcp *tcp, u32_t ack)
+{
+	s32_t rtt;
+	s32_t delta;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_RTT_ESTIMATION) || !tcp->rtt_active ||
+	    net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+		return;
+	}
+
+	tcp->rtt_active = 0U;
+
+	rtt = max(k_uptime_get_32() - tcp->rtt_start, 1);
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		delta = rtt - (tcp->srtt >> 3);
+		tcp->srtt += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		delta -= tcp->rttvar >> 2;
+		tcp->rttvar += delta;
+	}
+
+	tcp->rto = (tcp->srtt >> 3) + tcp->rttvar;
+	tcp->rto = max(tcp->rto, CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT);
+	tcp->rto = min(tcp->rto, MAX_RTO);
+
+	NET_DBG("[%p] rtt %d srtt %u rttvar %u rto %u", tcp, rtt,
+		tcp->srtt >> 3, tcp->rttvar >> 2, tcp->rto);
 }
 
 #define is_6lo_technology(pkt)						\
@@ -208,10 +276,43 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+/* Resend the first unack'd packet. */
+static void retransmit_first(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+
+	/* Karn's algorithm: a retransmitted segment cannot be used to
+	 * measure the round trip time.
+	 */
+	tcp->rtt_active = 0U;
+
+	if (net_pkt_sent(pkt)) {
+		do_ref_if_needed(tcp, pkt);
+		net_pkt_set_sent(pkt, false);
+	}
+
+	net_pkt_set_queued(pkt, true);
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		NET_DBG("retry %u: [%p] pkt %p send failed",
+			tcp->retry_timeout_shift, tcp, pkt);
+		net_pkt_unref(pkt);
+	} else {
+		NET_DBG("retry %u: [%p] sent pkt %p",
+			tcp->retry_timeout_shift, tcp, pkt);
+		if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+		    !is_6lo_technology(pkt)) {
+			net_stats_update_tcp_seg_rexmit(net_pkt_iface(pkt));
+		}
+	}
+}
+
 static void tcp_retry_expired(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, retry_timer);
-	struct net_pkt *pkt;
 
 	/* Double the retry period for exponential backoff and resend
 	 * the first (only the first!) unack'd packet.
@@ -226,29 +327,11 @@ static void tcp_retry_expired(struct k_work *work)
 
 		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
 
-		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_pkt, sent_list);
-
-		if (net_pkt_sent(pkt)) {
-			do_ref_if_needed(tcp, pkt);
-			net_pkt_set_sent(pkt, false);
-		}
+		/* The timeout ends any fast recovery in progress */
+		tcp->flags &= ~NET_TCP_RECOVERY;
+		tcp->dup_acks = 0U;
 
-		net_pkt_set_queued(pkt, true);
-
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
-			NET_DBG("retry %u: [%p] pkt %p send failed",
-				tcp->retry_timeout_shift, tcp, pkt);
-			net_pkt_unref(pkt);
-		} else {
-			NET_DBG("retry %u: [%p] sent pkt %p",
-				tcp->retry_timeout_shift, tcp, pkt);
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit(
-							net_pkt_iface(pkt));
-			}
-		}
+		retransmit_first(tcp);
 	} else if (CONFIG_NET_TCP_TIME_WAIT_DELAY != 0) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
 			NET_DBG("[%p] Closing connection (context %p)",
@@ -282,8 +365,9 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 	tcp_context[i].context = context;
 
 	tcp_context[i].send_seq = tcp_init_isn();
-	tcp_context[i].recv_wnd = min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
+	tcp_context[i].recv_wnd = CONFIG_NET_TCP_RECV_WINDOW_SIZE;
 	tcp_context[i].send_mss = NET_TCP_DEFAULT_MSS;
+	tcp_context[i].rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 
 	tcp_context[i].accept_cb = NULL;
 
@@ -313,6 +397,11 @@ static void timewait_timer_cancel(struct net_tcp *tcp)
 	k_delayed_work_cancel(&tcp->timewait_timer);
 }
 
+static void delack_timer_cancel(struct net_tcp *tcp)
+{
+	k_delayed_work_cancel(&tcp->delack_timer);
+}
+
 int net_tcp_release(struct net_tcp *tcp)
 {
 	struct net_pkt *pkt;
@@ -335,12 +424,14 @@ int net_tcp_release(struct net_tcp *tcp)
 	ack_timer_cancel(tcp);
 	fin_timer_cancel(tcp);
 	timewait_timer_cancel(tcp);
+	delack_timer_cancel(tcp);
 
 	net_tcp_change_state(tcp, NET_TCP_CLOSED);
 	tcp->context = NULL;
 
 	key = irq_lock();
-	tcp->flags &= ~(NET_TCP_IN_USE | NET_TCP_RECV_MSS_SET);
+	tcp->flags &= ~(NET_TCP_IN_USE | NET_TCP_RECV_MSS_SET |
+			NET_TCP_WSCALE | NET_TCP_RECOVERY);
 	irq_unlock(key);
 
 	NET_DBG("[%p] Disposed of TCP connection state", tcp);
@@ -510,6 +601,19 @@ u32_t net_tcp_get_recv_wnd(const struct net_tcp *tcp)
 	return tcp->recv_wnd;
 }
 
+/* Value of the window field of a segment */
+static u16_t get_adv_wnd(const struct net_tcp *tcp, u8_t flags)
+{
+	u32_t wnd = net_tcp_get_recv_wnd(tcp);
+
+	/* The window field of SYN segments is never scaled */
+	if ((tcp->flags & NET_TCP_WSCALE) && !(flags & NET_TCP_SYN)) {
+		wnd >>= recv_wscale();
+	}
+
+	return min(wnd, UINT16_MAX);
+}
+
 int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 			    void *options, size_t optlen,
 			    const struct sockaddr_ptr *local,
@@ -563,7 +667,7 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 		}
 	}
 
-	wnd = net_tcp_get_recv_wnd(tcp);
+	wnd = get_adv_wnd(tcp, flags);
 
 	segment.src_addr = (struct sockaddr_ptr *)local;
 	segment.dst_addr = remote;
@@ -677,6 +781,14 @@ static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 	*optionlen += NET_TCP_MSS_SIZE;
 }
 
+static void net_tcp_set_wscale_opt(u8_t *options, u8_t *optionlen)
+{
+	options[(*optionlen)++] = NET_TCP_NOP_OPT;
+	options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_OPT;
+	options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_SIZE;
+	options[(*optionlen)++] = recv_wscale();
+}
+
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 			struct net_pkt **pkt)
 {
@@ -832,6 +944,8 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 
 	context->tcp->send_seq += data_len;
 
+	rtt_start(context->tcp);
+
 	net_stats_update_tcp_sent(net_pkt_iface(pkt), data_len);
 
 	return net_tcp_queue_pkt(context, pkt);
@@ -920,6 +1034,7 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	}
 
 	ctx->tcp->sent_ack = ctx->tcp->send_ack;
+	ctx->tcp->unacked_segs = 0U;
 
 	/* We must have special handling for some network technologies that
 	 * tweak the IP protocol headers during packet sending. This happens
@@ -1133,12 +1248,80 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	 * sent times.
 	 */
 	if (valid_ack) {
+		rtt_update(ctx->tcp, ack);
 		restart_timer(ctx->tcp);
 	}
 
 	return true;
 }
 
+/* A duplicate ACK acknowledges nothing new while data is outstanding,
+ * and carries no data and no window update (RFC 5681, chapter 2).
+ */
+static bool is_dup_ack(struct net_tcp *tcp, struct net_pkt *pkt,
+		       struct net_tcp_hdr *tcp_hdr)
+{
+	u32_t wnd = (u32_t)sys_get_be16(tcp_hdr->wnd) << tcp->send_wscale;
+
+	return sys_get_be32(tcp_hdr->ack) == tcp->last_ack &&
+		wnd == tcp->send_wnd &&
+		!(NET_TCP_FLAGS(tcp_hdr) & (NET_TCP_SYN | NET_TCP_FIN)) &&
+		net_pkt_get_len(pkt) == net_pkt_ip_hdr_len(pkt) +
+					net_pkt_ipv6_ext_len(pkt) +
+					NET_TCP_HDR_LEN(tcp_hdr) &&
+		!sys_slist_is_empty(&tcp->sent_list);
+}
+
+/* Fast retransmit and recovery, as in RFC 6582 but without congestion
+ * window as we do not have one.
+ */
+static void fast_retransmit(struct net_tcp *tcp, u32_t ack, bool dup_ack)
+{
+	struct net_pkt *pkt;
+
+	if (dup_ack) {
+		if (tcp->dup_acks < UINT8_MAX) {
+			tcp->dup_acks++;
+		}
+
+		if (tcp->dup_acks != NET_TCP_DUP_ACK_THRESHOLD ||
+		    (tcp->flags & NET_TCP_RECOVERY)) {
+			return;
+		}
+
+		tcp->flags |= NET_TCP_RECOVERY;
+		tcp->recover = tcp->send_seq;
+	} else {
+		tcp->dup_acks = 0U;
+
+		if (!(tcp->flags & NET_TCP_RECOVERY) ||
+		    ack == tcp->last_ack) {
+			return;
+		}
+
+		/* All the data sent before the loss is acknowledged */
+		if (!net_tcp_seq_greater(tcp->recover, ack) ||
+		    sys_slist_is_empty(&tcp->sent_list)) {
+			tcp->flags &= ~NET_TCP_RECOVERY;
+			return;
+		}
+
+		/* Partial ACK, the next segment was lost too */
+	}
+
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+
+	/* The packet is still waiting in the TX queue */
+	if (!net_pkt_sent(pkt)) {
+		return;
+	}
+
+	NET_DBG("[%p] fast retransmit at %u", tcp, ack);
+
+	retransmit_first(tcp);
+}
+
 void net_tcp_init(void)
 {
 }
@@ -1335,6 +1518,19 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 				goto error;
 			}
 
+			break;
+		case NET_TCP_WINDOW_SCALE_OPT:
+			if (optlen != 1) {
+				goto error;
+			}
+
+			if (net_pkt_read_u8_new(pkt, &opts->wscale)) {
+				goto error;
+			}
+
+			opts->wscale = min(opts->wscale, NET_TCP_MAX_WSCALE);
+			opts->wscale_ok = true;
+
 			break;
 		default:
 			if (net_pkt_skip(pkt, optlen)) {
@@ -1432,7 +1628,7 @@ int net_tcp_update_recv_wnd(struct net_context *context, s32_t delta)
 	}
 
 	new_win = context->tcp->recv_wnd + delta;
-	if (new_win < 0 || new_win > UINT16_MAX) {
+	if (new_win < 0 || new_win > (UINT16_MAX << NET_TCP_MAX_WSCALE)) {
 		return -EINVAL;
 	}
 
@@ -1443,6 +1639,8 @@ int net_tcp_update_recv_wnd(struct net_context *context, s32_t delta)
 
 static int send_reset(struct net_context *context, struct sockaddr *local,
 		      struct sockaddr *remote);
+static int send_ack(struct net_context *context,
+		    struct sockaddr *remote, bool force);
 
 static void backlog_ack_timeout(struct k_work *work)
 {
@@ -1559,7 +1757,7 @@ static int tcp_backlog_syn(struct net_pkt *pkt,
 			   union net_ip_header *ip_hdr,
 			   struct net_tcp_hdr *tcp_hdr,
 			   struct net_context *context,
-			   u16_t send_mss)
+			   struct net_tcp_options *opts)
 {
 	int empty_slot = -1;
 
@@ -1578,7 +1776,9 @@ static int tcp_backlog_syn(struct net_pkt *pkt,
 
 	tcp_backlog[empty_slot].send_seq = context->tcp->send_seq;
 	tcp_backlog[empty_slot].send_ack = context->tcp->send_ack;
-	tcp_backlog[empty_slot].send_mss = send_mss;
+	tcp_backlog[empty_slot].send_mss = opts->mss;
+	tcp_backlog[empty_slot].send_wscale = opts->wscale;
+	tcp_backlog[empty_slot].wscale_ok = opts->wscale_ok;
 
 	k_delayed_work_init(&tcp_backlog[empty_slot].ack_timer,
 			    backlog_ack_timeout);
@@ -1610,6 +1810,16 @@ static int tcp_backlog_ack(struct net_pkt *pkt,
 	context->tcp->send_ack = tcp_backlog[r].send_ack;
 	context->tcp->send_mss = tcp_backlog[r].send_mss;
 
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALING) &&
+	    tcp_backlog[r].wscale_ok) {
+		context->tcp->flags |= NET_TCP_WSCALE;
+		context->tcp->send_wscale = tcp_backlog[r].send_wscale;
+	}
+
+	context->tcp->last_ack = sys_get_be32(tcp_hdr->ack);
+	context->tcp->send_wnd = (u32_t)sys_get_be16(tcp_hdr->wnd) <<
+				 context->tcp->send_wscale;
+
 	k_delayed_work_cancel(&tcp_backlog[r].ack_timer);
 	(void)memset(&tcp_backlog[r], 0, sizeof(struct tcp_backlog_entry));
 
@@ -1673,6 +1883,21 @@ static void handle_ack_timeout(struct k_work *work)
 	}
 }
 
+static void handle_delack_timeout(struct k_work *work)
+{
+	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp,
+					   delack_timer);
+	struct net_context *context = tcp->context;
+
+	if (!context) {
+		return;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+	send_ack(context, &context->remote, false);
+	k_mutex_unlock(&context->lock);
+}
+
 static void handle_timewait_timeout(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp,
@@ -1704,6 +1929,8 @@ int net_tcp_get(struct net_context *context)
 	k_delayed_work_init(&context->tcp->fin_timer, handle_fin_timeout);
 	k_delayed_work_init(&context->tcp->timewait_timer,
 			    handle_timewait_timeout);
+	k_delayed_work_init(&context->tcp->delack_timer,
+			    handle_delack_timeout);
 
 	return 0;
 }
@@ -1791,7 +2018,8 @@ static void print_send_info(struct net_pkt *pkt,
 static inline int send_syn_segment(struct net_context *context,
 				       const struct sockaddr_ptr *local,
 				       const struct sockaddr *remote,
-				       int flags, const char *msg)
+				       int flags, bool wscale,
+				       const char *msg)
 {
 	struct net_pkt *pkt = NULL;
 	int ret;
@@ -1802,6 +2030,10 @@ static inline int send_syn_segment(struct net_context *context,
 		net_tcp_set_syn_opt(context->tcp, options, &optionlen);
 	}
 
+	if (wscale) {
+		net_tcp_set_wscale_opt(options, &optionlen);
+	}
+
 	ret = net_tcp_prepare_segment(context->tcp, flags, options, optionlen,
 				      local, remote, &pkt);
 	if (ret) {
@@ -1826,15 +2058,20 @@ static inline int send_syn(struct net_context *context,
 {
 	net_tcp_change_state(context->tcp, NET_TCP_SYN_SENT);
 
-	return send_syn_segment(context, NULL, remote, NET_TCP_SYN, "SYN");
+	return send_syn_segment(context, NULL, remote, NET_TCP_SYN,
+				IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALING),
+				"SYN");
 }
 
 static inline int send_syn_ack(struct net_context *context,
 			       struct sockaddr_ptr *local,
-			       struct sockaddr *remote)
+			       struct sockaddr *remote,
+			       bool wscale)
 {
 	return send_syn_segment(context, local, remote,
 				    NET_TCP_SYN | NET_TCP_ACK,
+				    IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALING) &&
+				    wscale,
 				    "SYN_ACK");
 }
 
@@ -1888,6 +2125,27 @@ static int send_reset(struct net_context *context,
 	return ret;
 }
 
+/* Check if the ACK of a received segment can be delayed, and make sure
+ * it will be sent in time if so.
+ */
+static bool delay_ack(struct net_tcp *tcp, u16_t data_len)
+{
+	if (!CONFIG_NET_TCP_ACK_DELAY || !data_len) {
+		return false;
+	}
+
+	if (++tcp->unacked_segs >= CONFIG_NET_TCP_ACK_DELAY_SEGMENTS) {
+		return false;
+	}
+
+	if (k_delayed_work_remaining_get(&tcp->delack_timer) == 0) {
+		k_delayed_work_submit(&tcp->delack_timer,
+				      K_MSEC(CONFIG_NET_TCP_ACK_DELAY));
+	}
+
+	return true;
+}
+
 /* This is called when we receive data after the connection has been
  * established. The core TCP logic is located here.
  *
@@ -1940,8 +2198,13 @@ resend_ack:
 			    context->tcp->send_ack) > 0) {
 		/* Don't try to reorder packets.  If it doesn't
 		 * match the next segment exactly, drop and wait for
-		 * retransmit
+		 * retransmit. A duplicate ACK lets the peer fast
+		 * retransmit the missing segment.
 		 */
+		if (IS_ENABLED(CONFIG_NET_TCP_FAST_RETRANSMIT)) {
+			goto resend_ack;
+		}
+
 		ret = NET_DROP;
 		goto unlock;
 	}
@@ -1975,12 +2238,25 @@ resend_ack:
 
 	/* Handle TCP state transition */
 	if (tcp_flags & NET_TCP_ACK) {
-		if (!net_tcp_ack_received(context,
-					  sys_get_be32(tcp_hdr->ack))) {
+		u32_t ack = sys_get_be32(tcp_hdr->ack);
+		bool dup_ack = is_dup_ack(context->tcp, pkt, tcp_hdr);
+
+		if (!net_tcp_ack_received(context, ack)) {
 			ret = NET_DROP;
 			goto unlock;
 		}
 
+		if (IS_ENABLED(CONFIG_NET_TCP_FAST_RETRANSMIT)) {
+			fast_retransmit(context->tcp, ack, dup_ack);
+		}
+
+		if (!dup_ack) {
+			context->tcp->last_ack = ack;
+			context->tcp->send_wnd =
+				(u32_t)sys_get_be16(tcp_hdr->wnd) <<
+				context->tcp->send_wscale;
+		}
+
 		/* TCP state might be changed after maintaining the sent pkt
 		 * list, e.g., an ack of FIN is received.
 		 */
@@ -2066,7 +2342,9 @@ resend_ack:
 		context->tcp->send_ack += 1;
 	}
 
-	send_ack(context, &conn->remote_addr, false);
+	if ((tcp_flags & NET_TCP_FIN) || !delay_ack(context->tcp, data_len)) {
+		send_ack(context, &conn->remote_addr, false);
+	}
 
 clean_up:
 	if (net_tcp_get_state(context->tcp) == NET_TCP_TIME_WAIT) {
@@ -2149,8 +2427,30 @@ NET_CONN_CB(tcp_synack_received)
 		/* Remove the temporary connection handler and register
 		 * a proper now as we have an established connection.
 		 */
+		struct net_tcp_options tcp_opts = {
+			.mss = NET_TCP_DEFAULT_MSS,
+		};
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
+		int opt_totlen;
+
+		opt_totlen = NET_TCP_HDR_LEN(tcp_hdr)
+			     - sizeof(struct net_tcp_hdr);
+		if (net_tcp_parse_opts(pkt, opt_totlen, &tcp_opts) < 0) {
+			return NET_DROP;
+		}
+
+		context->tcp->send_mss = tcp_opts.mss;
+
+		if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALING) &&
+		    tcp_opts.wscale_ok) {
+			context->tcp->flags |= NET_TCP_WSCALE;
+			context->tcp->send_wscale = tcp_opts.wscale;
+		}
+
+		/* The window field of a SYN segment is not scaled */
+		context->tcp->last_ack = sys_get_be32(tcp_hdr->ack);
+		context->tcp->send_wnd = sys_get_be16(tcp_hdr->wnd);
 
 		tcp_copy_ip_addr_from_hdr(net_pkt_family(pkt), ip_hdr, tcp_hdr,
 					  &remote_addr, true);
@@ -2303,7 +2603,7 @@ NET_CONN_CB(tcp_syn_rcvd)
 		/* Get MSS from TCP options here*/
 
 		r = tcp_backlog_syn(pkt, ip_hdr, tcp_hdr,
-				    context, tcp_opts.mss);
+				    context, &tcp_opts);
 		if (r < 0) {
 			if (r == -EADDRINUSE) {
 				NET_DBG("TCP connection already exists");
@@ -2317,7 +2617,8 @@ NET_CONN_CB(tcp_syn_rcvd)
 		get_sockaddr_ptr(ip_hdr, tcp_hdr,
 				 net_context_get_family(context),
 				 &pkt_src_addr);
-		send_syn_ack(context, &pkt_src_addr, &remote_addr);
+		send_syn_ack(context, &pkt_src_addr, &remote_addr,
+			     tcp_opts.wscale_ok);
 		net_pkt_unref(pkt);
 		return NET_OK;
 	}
@@ -29,7 +29,11 @@ extern "C" {
 /** Is this TCP context/socket used or not */
 #define NET_TCP_IN_USE BIT(0)
 
-/* BIT(1), BIT(2) are unused and available */
+/** Window scaling has been negotiated with the peer */
+#define NET_TCP_WSCALE BIT(1)
+
+/** Fast retransmit done, recovering the rest of the lost segments */
+#define NET_TCP_RECOVERY BIT(2)
 
 /** Is the socket shutdown for read/write */
 #define NET_TCP_IS_SHUTDOWN BIT(3)
@@ -77,8 +81,11 @@ enum net_tcp_state {
  */
 #define NET_TCP_DEFAULT_MSS   536
 
-/* TCP max window size */
-#define NET_TCP_MAX_WIN   (4 * 1024)
+/* Maximum window scale shift, RFC 7323 */
+#define NET_TCP_MAX_WSCALE 14
+
+/* Number of duplicate ACKs that trigger a fast retransmit */
+#define NET_TCP_DUP_ACK_THRESHOLD 3
 
 /* Maximal value of the sequence number */
 #define NET_TCP_MAX_SEQ   0xffffffff
@@ -100,11 +107,11 @@ enum net_tcp_state {
 /** Parsed TCP option values for net_tcp_parse_opts()  */
 struct net_tcp_options {
 	u16_t mss;
+	/** Window scale shift, valid only if wscale_ok is set */
+	u8_t wscale;
+	bool wscale_ok;
 };
 
-/* Max received bytes to buffer internally */
-#define NET_TCP_BUF_MAX_LEN 1280
-
 /* Max segment lifetime, in seconds */
 #define NET_TCP_MAX_SEG_LIFETIME 60
 
@@ -154,13 +161,51 @@ struct net_tcp {
 	/**
 	 * Current TCP receive window for our side
 	 */
-	u16_t recv_wnd;
+	u32_t recv_wnd;
+
+	/**
+	 * Last receive window advertised by the peer, scaled
+	 */
+	u32_t send_wnd;
+
+	/** Last acknowledgment number received from the peer */
+	u32_t last_ack;
+
+	/** Highest sequence number sent when fast recovery started */
+	u32_t recover;
+
+	/** Retransmission timeout, in milliseconds */
+	u32_t rto;
+
+	/** Smoothed round trip time, in milliseconds scaled by 8 */
+	u32_t srtt;
+
+	/** Round trip time variation, in milliseconds scaled by 4 */
+	u32_t rttvar;
+
+	/** Time when the segment timed for the RTT measurement was sent */
+	u32_t rtt_start;
+
+	/** Acknowledgment number that ends the RTT measurement */
+	u32_t rtt_seq;
+
+	/** Delayed ACK timer */
+	struct k_delayed_work delack_timer;
 
 	/**
 	 * Send MSS for the peer
 	 */
 	u16_t send_mss;
 
+	/** Window scale shift of the peer receive window */
+	u8_t send_wscale;
+
+	/** Number of duplicate ACKs received in a row */
+	u8_t dup_acks;
+
+	/** Number of received segments not acknowledged yet */
+	u8_t unacked_segs;
+
 	/** Current retransmit period */
 	u32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
@@ -171,8 +216,10 @@ struct net_tcp {
 	u32_t fin_sent : 1;
 	/* An inbound FIN packet has been received */
 	u32_t fin_rcvd : 1;
+	/* A segment is timed for the RTT measurement */
+	u32_t rtt_active : 1;
 	/** Remaining bits in this u32_t */
-	u32_t _padding : 13;
+	u32_t _padding : 12;
 };
 
 typedef void (*net_tcp_cb_t)(struct net_tcp *tcp, void *user_data);
@@ -413,8 +460,8 @@ int net_tcp_finalize(struct net_pkt *pkt);
 /**
  * @brief Parse TCP options from network packet.
  *
- * Parse TCP options, returning MSS value (as that the only one we
- * handle so far).
+ * Parse TCP options, returning MSS and window scale values (as those
+ * are the only ones we handle so far).
  *
  * @param pkt Network packet
  * @param opt_totlen Total length of options to parse
@@ -266,10 +266,9 @@ int coap_packet_append_option(struct coap_packet *cpkt, u16_t code,
 	return 0;
 }
 
-int coap_append_option_int(struct coap_packet *cpkt, u16_t code,
-			   unsigned int val)
+static u8_t encode_option_int(unsigned int val, u8_t *data)
 {
-	u8_t data[4], len;
+	u8_t len;
 
 	if (val == 0) {
 		data[0] = 0U;
@@ -289,6 +288,16 @@ int coap_append_option_int(struct coap_packet *cpkt, u16_t code,
 		len = 4U;
 	}
 
+	return len;
+}
+
+int coap_append_option_int(struct coap_packet *cpkt, u16_t code,
+			   unsigned int val)
+{
+	u8_t data[4], len;
+
+	len = encode_option_int(val, data);
+
 	return coap_packet_append_option(cpkt, code, data, len);
 }
 
@@ -325,6 +334,127 @@ int coap_packet_append_payload(struct coap_packet *cpkt, u8_t *payload,
 	return append(cpkt, payload, payload_len) ? 0 : -EINVAL;
 }
 
+int coap_template_init(struct coap_template *tmpl, u8_t *data,
+		       u16_t max_len, u8_t type, u8_t code)
+{
+	if (!tmpl || !data || !max_len) {
+		return -EINVAL;
+	}
+
+	memset(tmpl, 0, sizeof(*tmpl));
+
+	/* Only the options are stored, the header and the token are
+	 * written by coap_template_build().
+	 */
+	tmpl->opts.data = data;
+	tmpl->opts.max_len = max_len;
+	tmpl->type = type;
+	tmpl->code = code;
+
+	return 0;
+}
+
+int coap_template_append_option(struct coap_template *tmpl, u16_t code,
+				const u8_t *value, u16_t len)
+{
+	if (!tmpl) {
+		return -EINVAL;
+	}
+
+	return coap_packet_append_option(&tmpl->opts, code, value, len);
+}
+
+int coap_template_append_option_int(struct coap_template *tmpl, u16_t code,
+				    unsigned int val)
+{
+	u8_t data[4], len;
+
+	if (!tmpl) {
+		return -EINVAL;
+	}
+
+	len = encode_option_int(val, data);
+
+	return coap_packet_append_option(&tmpl->opts, code, data, len);
+}
+
+int coap_template_append_observe(struct coap_template *tmpl)
+{
+	u8_t value[COAP_TEMPLATE_OBSERVE_LEN] = { 0 };
+	int r;
+
+	if (!tmpl || tmpl->observe_pos) {
+		return -EINVAL;
+	}
+
+	/* The sequence number always takes three bytes, leading zeros
+	 * are allowed in uint option values (RFC 7252, section 3.2).
+	 */
+	r = coap_packet_append_option(&tmpl->opts, COAP_OPTION_OBSERVE,
+				      value, sizeof(value));
+	if (r < 0) {
+		return r;
+	}
+
+	tmpl->observe_pos = tmpl->opts.offset - sizeof(value);
+
+	return 0;
+}
+
+int coap_template_build(const struct coap_template *tmpl,
+			struct coap_packet *cpkt, u8_t *data, u16_t max_len,
+			u16_t id, const u8_t *token, u8_t tkl,
+			u32_t observe, const u8_t *payload, u16_t payload_len)
+{
+	u8_t *opts;
+	u32_t len;
+
+	if (!tmpl || !cpkt || !data || tkl > 8 || (tkl && !token) ||
+	    (payload_len && !payload)) {
+		return -EINVAL;
+	}
+
+	len = BASIC_HEADER_SIZE + tkl + tmpl->opts.offset;
+	if (payload_len) {
+		len += 1 + payload_len;
+	}
+
+	if (len > max_len) {
+		return -EINVAL;
+	}
+
+	data[0] = (COAP_VERSION << 6) | ((tmpl->type & 0x3) << 4) | tkl;
+	data[1] = tmpl->code;
+	sys_put_be16(id, &data[2]);
+
+	if (tkl) {
+		memcpy(data + BASIC_HEADER_SIZE, token, tkl);
+	}
+
+	opts = data + BASIC_HEADER_SIZE + tkl;
+	memcpy(opts, tmpl->opts.data, tmpl->opts.offset);
+
+	if (tmpl->observe_pos) {
+		opts[tmpl->observe_pos] = observe >> 16;
+		sys_put_be16(observe, &opts[tmpl->observe_pos + 1]);
+	}
+
+	cpkt->data = data;
+	cpkt->max_len = max_len;
+	cpkt->hdr_len = BASIC_HEADER_SIZE + tkl;
+	cpkt->opt_len = tmpl->opts.opt_len;
+	cpkt->delta = tmpl->opts.delta;
+	cpkt->offset = cpkt->hdr_len + tmpl->opts.offset;
+
+	if (payload_len) {
+		cpkt->data[cpkt->offset++] = COAP_MARKER;
+		memcpy(cpkt->data + cpkt->offset, payload, payload_len);
+		cpkt->offset += payload_len;
+	}
+
+	return 0;
+}
+
 u8_t *coap_next_token(void)
 {
 	static u32_t rand[2];
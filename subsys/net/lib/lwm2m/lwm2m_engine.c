@@ -49,11 +49,15 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #ifdef CONFIG_LWM2M_RW_JSON_SUPPORT
 #include "lwm2m_rw_json.h"
 #endif
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+#include "lwm2m_rw_cbor.h"
+#endif
 #ifdef CONFIG_LWM2M_RD_CLIENT_SUPPORT
 #include "lwm2m_rd_client.h"
 #endif
 
-#define ENGINE_UPDATE_INTERVAL K_MSEC(500)
+/* Delay before polling the sockets again after an error */
+#define ENGINE_ERROR_BACKOFF K_MSEC(500)
 
 #define WELL_KNOWN_CORE_PATH	"</.well-known/core>"
 
@@ -91,15 +95,18 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 struct observe_node {
 	sys_snode_t node;
+	sys_snode_t index_node;
 	struct lwm2m_ctx *ctx;
 	struct lwm2m_obj_path path;
 	u8_t  token[MAX_TOKEN_LEN];
 	s64_t event_timestamp;
 	s64_t last_timestamp;
+	s64_t due_timestamp;
 	u32_t min_period_sec;
 	u32_t max_period_sec;
 	u32_t counter;
 	u16_t format;
+	u16_t heap_idx; /* position in observer_heap + 1, 0 if not queued */
 	u8_t  tkl;
 };
 
@@ -115,6 +122,13 @@ struct notification_attrs {
 
 static struct observe_node observe_node_data[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
 
+/* Observers hashed by observed path, and min-heap of the observers with a
+ * scheduled notification, ordered by due_timestamp.
+ */
+static sys_slist_t observer_index[CONFIG_LWM2M_ENGINE_OBSERVER_BUCKETS];
+static struct observe_node *observer_heap[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
+static u16_t observer_heap_count;
+
 #define MAX_PERIODIC_SERVICE	10
 
 struct service_node {
@@ -141,6 +155,10 @@ static struct lwm2m_ctx *sock_ctx[MAX_POLL_FD];
 static struct pollfd sock_fds[MAX_POLL_FD];
 static int sock_nfds;
 
+/* Raised when sock_fds changed, to restart the poll */
+static struct k_poll_signal sock_signal =
+	K_POLL_SIGNAL_INITIALIZER(sock_signal);
+
 #define NUM_BLOCK1_CONTEXT	CONFIG_LWM2M_NUM_BLOCK1_CONTEXT
 
 /* TODO: figure out what's correct value */
@@ -167,10 +185,12 @@ static const u8_t LWM2M_ATTR_LEN[] = { 4, 4, 2, 2, 2 };
 static struct lwm2m_attr write_attr_pool[CONFIG_LWM2M_NUM_ATTR];
 
 static struct k_delayed_work periodic_work;
+static bool periodic_work_ready;
 
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id);
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 							 int obj_inst_id);
+static void engine_schedule_service(void);
 
 /* Shared set of in-flight LwM2M messages */
 static struct lwm2m_message messages[CONFIG_LWM2M_ENGINE_MAX_MESSAGES];
@@ -378,25 +398,220 @@ static void clear_attrs(void *ref)
 	}
 }
 
-int lwm2m_notify_observer(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
+/* Returns the time of the next notification of the observer, or -1 if no
+ * notification is scheduled.
+ */
+static s64_t observer_due_timestamp(struct observe_node *obs)
 {
-	struct observe_node *obs;
-	int ret = 0;
+	/* manual notify: after min_period_sec since the last one */
+	if (obs->event_timestamp > obs->last_timestamp) {
+		return obs->last_timestamp + K_SECONDS(obs->min_period_sec);
+	}
 
-	/* look for observers which match our resource */
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
-		if (obs->path.obj_id == obj_id &&
-		    obs->path.obj_inst_id == obj_inst_id &&
-		    (obs->path.level < 3 ||
-		     obs->path.res_id == res_id)) {
-			/* update the event time for this observer */
-			obs->event_timestamp = k_uptime_get();
+	/* automatic time-based notify: after max_period_sec */
+	if (obs->max_period_sec) {
+		return obs->last_timestamp + K_SECONDS(obs->max_period_sec);
+	}
+
+	return -1;
+}
+
+static sys_slist_t *observer_index_bucket(u16_t obj_id, u16_t obj_inst_id,
+					 u16_t res_id, u8_t level)
+{
+	u32_t hash;
+
+	/* only the path components observed at this level are hashed */
+	if (level > 3) {
+		level = 3;
+	}
+
+	hash = obj_id * 31U + level;
+
+	if (level >= 2) {
+		hash = hash * 31U + obj_inst_id;
+	}
+
+	if (level >= 3) {
+		hash = hash * 31U + res_id;
+	}
+
+	return &observer_index[hash % CONFIG_LWM2M_ENGINE_OBSERVER_BUCKETS];
+}
+
+static sys_slist_t *observer_index_list(struct observe_node *obs)
+{
+	return observer_index_bucket(obs->path.obj_id, obs->path.obj_inst_id,
+				     obs->path.res_id, obs->path.level);
+}
+
+static void observer_heap_set(u16_t idx, struct observe_node *obs)
+{
+	observer_heap[idx] = obs;
+	obs->heap_idx = idx + 1;
+}
+
+static void observer_heap_sift_up(u16_t idx)
+{
+	struct observe_node *obs = observer_heap[idx];
+	u16_t parent;
+
+	while (idx > 0) {
+		parent = (idx - 1) / 2U;
+		if (observer_heap[parent]->due_timestamp <=
+		    obs->due_timestamp) {
+			break;
+		}
+
+		observer_heap_set(idx, observer_heap[parent]);
+		idx = parent;
+	}
+
+	observer_heap_set(idx, obs);
+}
+
+static void observer_heap_sift_down(u16_t idx)
+{
+	struct observe_node *obs = observer_heap[idx];
+	u16_t child;
+
+	while ((child = 2U * idx + 1) < observer_heap_count) {
+		if (child + 1 < observer_heap_count &&
+		    observer_heap[child + 1]->due_timestamp <
+		    observer_heap[child]->due_timestamp) {
+			child++;
+		}
+
+		if (obs->due_timestamp <= observer_heap[child]->due_timestamp) {
+			break;
+		}
+
+		observer_heap_set(idx, observer_heap[child]);
+		idx = child;
+	}
+
+	observer_heap_set(idx, obs);
+}
+
+static void observer_heap_remove(struct observe_node *obs)
+{
+	u16_t idx = obs->heap_idx - 1;
+
+	obs->heap_idx = 0U;
+	observer_heap_count--;
+
+	if (idx == observer_heap_count) {
+		return;
+	}
+
+	/* move the last node into the hole and restore the heap order */
+	observer_heap_set(idx, observer_heap[observer_heap_count]);
+	observer_heap_sift_up(idx);
+	observer_heap_sift_down(idx);
+}
+
+/* Moves the observer to its new place in the deadline heap after one of
+ * its timestamps or periods changed. Must be called with interrupts
+ * locked.
+ */
+static void observer_heap_update(struct observe_node *obs)
+{
+	obs->due_timestamp = observer_due_timestamp(obs);
+
+	if (obs->due_timestamp < 0) {
+		if (obs->heap_idx) {
+			observer_heap_remove(obs);
+		}
+
+		return;
+	}
+
+	if (!obs->heap_idx) {
+		observer_heap_set(observer_heap_count++, obs);
+	}
+
+	observer_heap_sift_up(obs->heap_idx - 1);
+	observer_heap_sift_down(obs->heap_idx - 1);
+}
+
+static void observer_link(struct observe_node *obs)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	sys_slist_append(observer_index_list(obs), &obs->index_node);
+	observer_heap_update(obs);
+	irq_unlock(key);
+}
+
+static void observer_unlink(struct observe_node *obs)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	sys_slist_find_and_remove(observer_index_list(obs), &obs->index_node);
+	if (obs->heap_idx) {
+		observer_heap_remove(obs);
+	}
 
-			LOG_DBG("NOTIFY EVENT %u/%u/%u",
-				obj_id, obj_inst_id, res_id);
+	irq_unlock(key);
+}
 
-			ret++;
+static int notify_observer_bucket(u16_t obj_id, u16_t obj_inst_id,
+				  u16_t res_id, u8_t level, s64_t timestamp)
+{
+	struct observe_node *obs;
+	int count = 0;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(observer_index_bucket(obj_id, obj_inst_id,
+							   res_id, level),
+				     obs, index_node) {
+		if (min(obs->path.level, 3) != level ||
+		    obs->path.obj_id != obj_id ||
+		    (level >= 2 && obs->path.obj_inst_id != obj_inst_id) ||
+		    (level >= 3 && obs->path.res_id != res_id)) {
+			continue;
 		}
+
+		/* update the event time for this observer */
+		obs->event_timestamp = timestamp;
+		observer_heap_update(obs);
+		count++;
+	}
+
+	return count;
+}
+
+/* Records a notify event for the observers of the resource, of its
+ * instance and of its object, without scheduling the engine service.
+ */
+static int notify_observer_event(u16_t obj_id, u16_t obj_inst_id,
+				 u16_t res_id, s64_t timestamp)
+{
+	unsigned int key;
+	int ret;
+
+	key = irq_lock();
+	ret = notify_observer_bucket(obj_id, obj_inst_id, res_id, 3,
+				     timestamp);
+	ret += notify_observer_bucket(obj_id, obj_inst_id, res_id, 2,
+				      timestamp);
+	ret += notify_observer_bucket(obj_id, obj_inst_id, res_id, 1,
+				      timestamp);
+	irq_unlock(key);
+
+	return ret;
+}
+
+int lwm2m_notify_observer(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
+{
+	int ret;
+
+	ret = notify_observer_event(obj_id, obj_inst_id, res_id,
+				    k_uptime_get());
+	if (ret > 0) {
+		LOG_DBG("NOTIFY EVENT %u/%u/%u", obj_id, obj_inst_id, res_id);
+		engine_schedule_service();
 	}
 
 	return ret;
@@ -546,6 +761,10 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	observe_node_data[i].counter = 1U;
 	sys_slist_append(&engine_observer_list,
 			 &observe_node_data[i].node);
+	observer_link(&observe_node_data[i]);
+
+	/* the first periodic notification is due after the new period */
+	engine_schedule_service();
 
 	LOG_DBG("OBSERVER ADDED %u/%u/%u(%u) token:'%s' addr:%s",
 		msg->path.obj_id, msg->path.obj_inst_id,
@@ -582,6 +801,7 @@ static int engine_remove_observer(const u8_t *token, u8_t tkl)
 	}
 
 	sys_slist_remove(&engine_observer_list, prev_node, &found_obj->node);
+	observer_unlink(found_obj);
 	(void)memset(found_obj, 0, sizeof(*found_obj));
 
 	LOG_DBG("observer '%s' removed", sprint_token(token, tkl));
@@ -604,6 +824,7 @@ static void engine_remove_observer_by_id(u16_t obj_id, s32_t obj_inst_id)
 		}
 
 		sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
+		observer_unlink(obs);
 		(void)memset(obs, 0, sizeof(*obs));
 	}
 }
@@ -1147,6 +1368,16 @@ static int select_writer(struct lwm2m_output_context *out, u16_t accept)
 		break;
 #endif
 
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_CBOR:
+		out->writer = &cbor_writer;
+		break;
+
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		out->writer = &senml_cbor_writer;
+		break;
+#endif
+
 	default:
 		LOG_WRN("Unknown content type %u", accept);
 		return -ENOMSG;
@@ -1178,6 +1409,16 @@ static int select_reader(struct lwm2m_input_context *in, u16_t format)
 		break;
 #endif
 
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_CBOR:
+		in->reader = &cbor_reader;
+		break;
+
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		in->reader = &senml_cbor_reader;
+		break;
+#endif
+
 	default:
 		LOG_WRN("Unknown content type %u", format);
 		return -ENOMSG;
@@ -1366,40 +1607,19 @@ int lwm2m_engine_set_res_data(char *pathstr, void *data_ptr, u16_t data_len,
 	return ret;
 }
 
-static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+/* Writes a value to a resolved resource, and tells whether the value
+ * changed. Observers are not notified.
+ */
+static int engine_set_res(struct lwm2m_engine_obj_inst *obj_inst,
+			  struct lwm2m_engine_obj_field *obj_field,
+			  struct lwm2m_engine_res_inst *res,
+			  const void *value, u16_t len, bool *changed)
 {
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res_inst *res = NULL;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 	int ret = 0;
-	bool changed = false;
 
-	LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res) {
-		LOG_ERR("res instance %d not found", path.res_id);
-		return -ENOENT;
-	}
+	*changed = false;
 
 	if (LWM2M_HAS_RES_FLAG(res, LWM2M_RES_DATA_FLAG_RO)) {
 		LOG_ERR("res data pointer is read-only");
@@ -1424,12 +1644,12 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	if (len > res->data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		LOG_ERR("length %u is too long for resource %d data",
-			len, path.res_id);
+			len, res->res_id);
 		return -ENOMEM;
 	}
 
 	if (memcmp(data_ptr, value, len) !=  0) {
-		changed = true;
+		*changed = true;
 	}
 
 	switch (obj_field->data_type) {
@@ -1505,6 +1725,44 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 					 false, 0);
 	}
 
+	return ret;
+}
+
+static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+{
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res_inst *res = NULL;
+	int ret = 0;
+	bool changed = false;
+
+	LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
+
+	/* look up resource obj */
+	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res) {
+		LOG_ERR("res instance %d not found", path.res_id);
+		return -ENOENT;
+	}
+
+	ret = engine_set_res(obj_inst, obj_field, res, value, len, &changed);
+
 	if (changed) {
 		NOTIFY_OBSERVER_PATH(&path);
 	}
@@ -1605,26 +1863,356 @@ int lwm2m_engine_get_res_data(char *pathstr, void **data_ptr, u16_t *data_len,
 		return ret;
 	}
 
-	*data_ptr = res->data_ptr;
-	*data_len = res->data_len;
-	*data_flags = res->data_flags;
+	*data_ptr = res->data_ptr;
+	*data_len = res->data_len;
+	*data_flags = res->data_flags;
+
+	return 0;
+}
+
+/* Points data_ptr and data_len to an instance of a multiple resource.
+ * The values of the instances are stored in an array, data_len being the
+ * size of the first one.
+ */
+static int res_inst_data(struct lwm2m_engine_res_inst *res, u8_t data_type,
+			 u16_t res_inst_id, void **data_ptr, size_t *data_len)
+{
+	size_t size;
+
+	switch (data_type) {
+
+	case LWM2M_RES_TYPE_U8:
+	case LWM2M_RES_TYPE_S8:
+	case LWM2M_RES_TYPE_BOOL:
+		size = 1;
+		break;
+
+	case LWM2M_RES_TYPE_U16:
+	case LWM2M_RES_TYPE_S16:
+		size = 2;
+		break;
+
+	case LWM2M_RES_TYPE_U32:
+	case LWM2M_RES_TYPE_S32:
+	case LWM2M_RES_TYPE_TIME:
+		size = 4;
+		break;
+
+	case LWM2M_RES_TYPE_U64:
+	case LWM2M_RES_TYPE_S64:
+		size = 8;
+		break;
+
+	case LWM2M_RES_TYPE_FLOAT32:
+		size = sizeof(float32_value_t);
+		break;
+
+	case LWM2M_RES_TYPE_FLOAT64:
+		size = sizeof(float64_value_t);
+		break;
+
+	default:
+		/* strings and opaque data have a single instance */
+		return -EINVAL;
+
+	}
+
+	if (!res->multi_count_var || res_inst_id >= *res->multi_count_var) {
+		return -ENOENT;
+	}
+
+	*data_ptr = (u8_t *)*data_ptr + res_inst_id * size;
+	*data_len = size;
+
+	return 0;
+}
+
+/* Reads the value of a resolved resource */
+static int engine_get_res(struct lwm2m_engine_obj_inst *obj_inst,
+			  struct lwm2m_engine_obj_field *obj_field,
+			  struct lwm2m_engine_res_inst *res,
+			  void *buf, u16_t buflen)
+{
+	void *data_ptr = NULL;
+	size_t data_len = 0;
+
+	/* setup initial data elements */
+	data_ptr = res->data_ptr;
+	data_len = res->data_len;
+
+	/* allow user to override data elements via callback */
+	if (res->read_cb) {
+		data_ptr = res->read_cb(obj_inst->obj_inst_id, &data_len);
+	}
+
+	/* TODO: handle data_len > buflen case */
+
+	if (data_ptr && data_len > 0) {
+		switch (obj_field->data_type) {
+
+		case LWM2M_RES_TYPE_OPAQUE:
+			if (data_len > buflen) {
+				return -ENOMEM;
+			}
+
+			memcpy(buf, data_ptr, data_len);
+			break;
+
+		case LWM2M_RES_TYPE_STRING:
+			strncpy((u8_t *)buf, (u8_t *)data_ptr, buflen);
+			break;
+
+		case LWM2M_RES_TYPE_U64:
+			*(u64_t *)buf = *(u64_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_U32:
+		case LWM2M_RES_TYPE_TIME:
+			*(u32_t *)buf = *(u32_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_U16:
+			*(u16_t *)buf = *(u16_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_U8:
+			*(u8_t *)buf = *(u8_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_S64:
+			*(s64_t *)buf = *(s64_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_S32:
+			*(s32_t *)buf = *(s32_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_S16:
+			*(s16_t *)buf = *(s16_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_S8:
+			*(s8_t *)buf = *(s8_t *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_BOOL:
+			*(bool *)buf = *(bool *)data_ptr;
+			break;
+
+		case LWM2M_RES_TYPE_FLOAT32:
+			((float32_value_t *)buf)->val1 =
+				((float32_value_t *)data_ptr)->val1;
+			((float32_value_t *)buf)->val2 =
+				((float32_value_t *)data_ptr)->val2;
+			break;
+
+		case LWM2M_RES_TYPE_FLOAT64:
+			((float64_value_t *)buf)->val1 =
+				((float64_value_t *)data_ptr)->val1;
+			((float64_value_t *)buf)->val2 =
+				((float64_value_t *)data_ptr)->val2;
+			break;
+
+		default:
+			LOG_ERR("unknown obj data_type %d",
+				obj_field->data_type);
+			return -EINVAL;
+
+		}
+	}
+
+	return 0;
+}
+
+static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
+{
+	int ret = 0;
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res_inst *res = NULL;
+
+	LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
+
+	/* look up resource obj */
+	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res) {
+		LOG_ERR("res instance %d not found", path.res_id);
+		return -ENOENT;
+	}
+
+	return engine_get_res(obj_inst, obj_field, res, buf, buflen);
+}
+
+int lwm2m_engine_get_opaque(char *pathstr, void *buf, u16_t buflen)
+{
+	return lwm2m_engine_get(pathstr, buf, buflen);
+}
+
+int lwm2m_engine_get_string(char *pathstr, void *buf, u16_t buflen)
+{
+	return lwm2m_engine_get(pathstr, buf, buflen);
+}
+
+int lwm2m_engine_get_u8(char *pathstr, u8_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 1);
+}
+
+int lwm2m_engine_get_u16(char *pathstr, u16_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 2);
+}
+
+int lwm2m_engine_get_u32(char *pathstr, u32_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 4);
+}
+
+int lwm2m_engine_get_u64(char *pathstr, u64_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 8);
+}
+
+int lwm2m_engine_get_s8(char *pathstr, s8_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 1);
+}
+
+int lwm2m_engine_get_s16(char *pathstr, s16_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 2);
+}
+
+int lwm2m_engine_get_s32(char *pathstr, s32_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 4);
+}
+
+int lwm2m_engine_get_s64(char *pathstr, s64_t *value)
+{
+	return lwm2m_engine_get(pathstr, value, 8);
+}
+
+int lwm2m_engine_get_bool(char *pathstr, bool *value)
+{
+	int ret = 0;
+	s8_t temp = 0;
+
+	ret = lwm2m_engine_get_s8(pathstr, &temp);
+	if (!ret) {
+		*value = temp != 0;
+	}
+
+	return ret;
+}
+
+int lwm2m_engine_get_float32(char *pathstr, float32_value_t *buf)
+{
+	return lwm2m_engine_get(pathstr, buf, sizeof(float32_value_t));
+}
+
+int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf)
+{
+	return lwm2m_engine_get(pathstr, buf, sizeof(float64_value_t));
+}
+
+int lwm2m_engine_push_sample(char *pathstr)
+{
+#if defined(CONFIG_LWM2M_RW_CBOR_SUPPORT) && \
+	CONFIG_LWM2M_RW_SENML_CBOR_SAMPLES > 0
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res_inst *res = NULL;
+	void *data_ptr = NULL;
+	size_t data_len = 0;
+	int ret;
+
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
+
+	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
+	if (ret < 0) {
+		return ret;
+	}
+
+	data_ptr = res->data_ptr;
+	data_len = res->data_len;
+
+	if (res->read_cb) {
+		data_ptr = res->read_cb(obj_inst->obj_inst_id, &data_len);
+	}
+
+	if (!data_ptr || data_len == 0) {
+		return -ENOENT;
+	}
+
+	if (path.level == 4) {
+		ret = res_inst_data(res, obj_field->data_type,
+				    path.res_inst_id, &data_ptr, &data_len);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return senml_cbor_push_sample(&path, obj_field->data_type, data_ptr);
+#else
+	return -ENOTSUP;
+#endif
+}
+
+int lwm2m_engine_get_resource(char *pathstr, struct lwm2m_engine_res_inst **res)
+{
+	int ret;
+	struct lwm2m_obj_path path;
+
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
 
-	return 0;
+	return path_to_objs(&path, NULL, NULL, res);
 }
 
-static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
+/* resource handle functions */
+
+int lwm2m_engine_get_res_handle(char *pathstr,
+				struct lwm2m_res_handle *handle)
 {
-	int ret = 0;
 	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res_inst *res = NULL;
-	void *data_ptr = NULL;
-	size_t data_len = 0;
+	int ret;
 
-	LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
+	/* a handle which failed is rejected by the setters */
+	(void)memset(handle, 0, sizeof(*handle));
 
-	/* translate path -> path_obj */
 	ret = string_to_path(pathstr, &path, '/');
 	if (ret < 0) {
 		return ret;
@@ -1635,161 +2223,239 @@ static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
 		return -EINVAL;
 	}
 
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
+	ret = path_to_objs(&path, &handle->obj_inst, &handle->obj_field,
+			   &handle->res);
 	if (ret < 0) {
-		return ret;
+		(void)memset(handle, 0, sizeof(*handle));
 	}
 
-	if (!res) {
-		LOG_ERR("res instance %d not found", path.res_id);
-		return -ENOENT;
+	return ret;
+}
+
+static int engine_set_handle(const struct lwm2m_res_handle *handle,
+			     const void *value, u16_t len, bool *changed)
+{
+	if (!handle || !handle->res) {
+		return -EINVAL;
 	}
 
-	/* setup initial data elements */
-	data_ptr = res->data_ptr;
-	data_len = res->data_len;
+	return engine_set_res(handle->obj_inst, handle->obj_field,
+			      handle->res, value, len, changed);
+}
 
-	/* allow user to override data elements via callback */
-	if (res->read_cb) {
-		data_ptr = res->read_cb(obj_inst->obj_inst_id, &data_len);
+static int notify_handle_event(const struct lwm2m_res_handle *handle,
+			       s64_t timestamp)
+{
+	return notify_observer_event(handle->obj_inst->obj->obj_id,
+				     handle->obj_inst->obj_inst_id,
+				     handle->res->res_id, timestamp);
+}
+
+static int lwm2m_engine_res_set(const struct lwm2m_res_handle *handle,
+				const void *value, u16_t len)
+{
+	bool changed = false;
+	int ret;
+
+	ret = engine_set_handle(handle, value, len, &changed);
+
+	if (changed && notify_handle_event(handle, k_uptime_get()) > 0) {
+		engine_schedule_service();
 	}
 
-	/* TODO: handle data_len > buflen case */
+	return ret;
+}
 
-	if (data_ptr && data_len > 0) {
-		switch (obj_field->data_type) {
+int lwm2m_engine_res_set_batch(const struct lwm2m_res_update *updates,
+			       int count)
+{
+	s64_t timestamp = k_uptime_get();
+	bool changed;
+	int notified = 0;
+	int ret = 0;
+	int i;
 
-		case LWM2M_RES_TYPE_OPAQUE:
-			if (data_len > buflen) {
-				return -ENOMEM;
-			}
+	for (i = 0; i < count; i++) {
+		changed = false;
+		ret = engine_set_handle(updates[i].handle, updates[i].value,
+					updates[i].len, &changed);
 
-			memcpy(buf, data_ptr, data_len);
-			break;
+		if (ret == 0 && changed) {
+			notified += notify_handle_event(updates[i].handle,
+							timestamp);
+		}
 
-		case LWM2M_RES_TYPE_STRING:
-			strncpy((u8_t *)buf, (u8_t *)data_ptr, buflen);
+		if (ret < 0) {
 			break;
+		}
+	}
 
-		case LWM2M_RES_TYPE_U64:
-			*(u64_t *)buf = *(u64_t *)data_ptr;
-			break;
+	/* the engine service sends all the notifications in one run */
+	if (notified > 0) {
+		engine_schedule_service();
+	}
 
-		case LWM2M_RES_TYPE_U32:
-		case LWM2M_RES_TYPE_TIME:
-			*(u32_t *)buf = *(u32_t *)data_ptr;
-			break;
+	return ret;
+}
 
-		case LWM2M_RES_TYPE_U16:
-			*(u16_t *)buf = *(u16_t *)data_ptr;
-			break;
+int lwm2m_engine_res_set_opaque(const struct lwm2m_res_handle *handle,
+				const void *data_ptr, u16_t data_len)
+{
+	return lwm2m_engine_res_set(handle, data_ptr, data_len);
+}
 
-		case LWM2M_RES_TYPE_U8:
-			*(u8_t *)buf = *(u8_t *)data_ptr;
-			break;
+int lwm2m_engine_res_set_string(const struct lwm2m_res_handle *handle,
+				const char *data_ptr)
+{
+	return lwm2m_engine_res_set(handle, data_ptr, strlen(data_ptr));
+}
 
-		case LWM2M_RES_TYPE_S64:
-			*(s64_t *)buf = *(s64_t *)data_ptr;
-			break;
+int lwm2m_engine_res_set_u8(const struct lwm2m_res_handle *handle,
+			    u8_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 1);
+}
 
-		case LWM2M_RES_TYPE_S32:
-			*(s32_t *)buf = *(s32_t *)data_ptr;
-			break;
+int lwm2m_engine_res_set_u16(const struct lwm2m_res_handle *handle,
+			     u16_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 2);
+}
 
-		case LWM2M_RES_TYPE_S16:
-			*(s16_t *)buf = *(s16_t *)data_ptr;
-			break;
+int lwm2m_engine_res_set_u32(const struct lwm2m_res_handle *handle,
+			     u32_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 4);
+}
 
-		case LWM2M_RES_TYPE_S8:
-			*(s8_t *)buf = *(s8_t *)data_ptr;
-			break;
+int lwm2m_engine_res_set_u64(const struct lwm2m_res_handle *handle,
+			     u64_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 8);
+}
 
-		case LWM2M_RES_TYPE_BOOL:
-			*(bool *)buf = *(bool *)data_ptr;
-			break;
+int lwm2m_engine_res_set_s8(const struct lwm2m_res_handle *handle,
+			    s8_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 1);
+}
 
-		case LWM2M_RES_TYPE_FLOAT32:
-			((float32_value_t *)buf)->val1 =
-				((float32_value_t *)data_ptr)->val1;
-			((float32_value_t *)buf)->val2 =
-				((float32_value_t *)data_ptr)->val2;
-			break;
+int lwm2m_engine_res_set_s16(const struct lwm2m_res_handle *handle,
+			     s16_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 2);
+}
 
-		case LWM2M_RES_TYPE_FLOAT64:
-			((float64_value_t *)buf)->val1 =
-				((float64_value_t *)data_ptr)->val1;
-			((float64_value_t *)buf)->val2 =
-				((float64_value_t *)data_ptr)->val2;
-			break;
+int lwm2m_engine_res_set_s32(const struct lwm2m_res_handle *handle,
+			     s32_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 4);
+}
 
-		default:
-			LOG_ERR("unknown obj data_type %d",
-				obj_field->data_type);
-			return -EINVAL;
+int lwm2m_engine_res_set_s64(const struct lwm2m_res_handle *handle,
+			     s64_t value)
+{
+	return lwm2m_engine_res_set(handle, &value, 8);
+}
 
-		}
+int lwm2m_engine_res_set_bool(const struct lwm2m_res_handle *handle,
+			      bool value)
+{
+	u8_t temp = (value != 0 ? 1 : 0);
+
+	return lwm2m_engine_res_set(handle, &temp, 1);
+}
+
+int lwm2m_engine_res_set_float32(const struct lwm2m_res_handle *handle,
+				 const float32_value_t *value)
+{
+	return lwm2m_engine_res_set(handle, value, sizeof(float32_value_t));
+}
+
+int lwm2m_engine_res_set_float64(const struct lwm2m_res_handle *handle,
+				 const float64_value_t *value)
+{
+	return lwm2m_engine_res_set(handle, value, sizeof(float64_value_t));
+}
+
+static int lwm2m_engine_res_get(const struct lwm2m_res_handle *handle,
+				void *buf, u16_t buflen)
+{
+	if (!handle || !handle->res) {
+		return -EINVAL;
 	}
 
-	return 0;
+	return engine_get_res(handle->obj_inst, handle->obj_field,
+			      handle->res, buf, buflen);
 }
 
-int lwm2m_engine_get_opaque(char *pathstr, void *buf, u16_t buflen)
+int lwm2m_engine_res_get_opaque(const struct lwm2m_res_handle *handle,
+				void *buf, u16_t buflen)
 {
-	return lwm2m_engine_get(pathstr, buf, buflen);
+	return lwm2m_engine_res_get(handle, buf, buflen);
 }
 
-int lwm2m_engine_get_string(char *pathstr, void *buf, u16_t buflen)
+int lwm2m_engine_res_get_string(const struct lwm2m_res_handle *handle,
+				void *buf, u16_t buflen)
 {
-	return lwm2m_engine_get(pathstr, buf, buflen);
+	return lwm2m_engine_res_get(handle, buf, buflen);
 }
 
-int lwm2m_engine_get_u8(char *pathstr, u8_t *value)
+int lwm2m_engine_res_get_u8(const struct lwm2m_res_handle *handle,
+			    u8_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 1);
+	return lwm2m_engine_res_get(handle, value, 1);
 }
 
-int lwm2m_engine_get_u16(char *pathstr, u16_t *value)
+int lwm2m_engine_res_get_u16(const struct lwm2m_res_handle *handle,
+			     u16_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 2);
+	return lwm2m_engine_res_get(handle, value, 2);
 }
 
-int lwm2m_engine_get_u32(char *pathstr, u32_t *value)
+int lwm2m_engine_res_get_u32(const struct lwm2m_res_handle *handle,
+			     u32_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 4);
+	return lwm2m_engine_res_get(handle, value, 4);
 }
 
-int lwm2m_engine_get_u64(char *pathstr, u64_t *value)
+int lwm2m_engine_res_get_u64(const struct lwm2m_res_handle *handle,
+			     u64_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 8);
+	return lwm2m_engine_res_get(handle, value, 8);
 }
 
-int lwm2m_engine_get_s8(char *pathstr, s8_t *value)
+int lwm2m_engine_res_get_s8(const struct lwm2m_res_handle *handle,
+			    s8_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 1);
+	return lwm2m_engine_res_get(handle, value, 1);
 }
 
-int lwm2m_engine_get_s16(char *pathstr, s16_t *value)
+int lwm2m_engine_res_get_s16(const struct lwm2m_res_handle *handle,
+			     s16_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 2);
+	return lwm2m_engine_res_get(handle, value, 2);
 }
 
-int lwm2m_engine_get_s32(char *pathstr, s32_t *value)
+int lwm2m_engine_res_get_s32(const struct lwm2m_res_handle *handle,
+			     s32_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 4);
+	return lwm2m_engine_res_get(handle, value, 4);
 }
 
-int lwm2m_engine_get_s64(char *pathstr, s64_t *value)
+int lwm2m_engine_res_get_s64(const struct lwm2m_res_handle *handle,
+			     s64_t *value)
 {
-	return lwm2m_engine_get(pathstr, value, 8);
+	return lwm2m_engine_res_get(handle, value, 8);
 }
 
-int lwm2m_engine_get_bool(char *pathstr, bool *value)
+int lwm2m_engine_res_get_bool(const struct lwm2m_res_handle *handle,
+			      bool *value)
 {
 	int ret = 0;
 	s8_t temp = 0;
 
-	ret = lwm2m_engine_get_s8(pathstr, &temp);
+	ret = lwm2m_engine_res_get_s8(handle, &temp);
 	if (!ret) {
 		*value = temp != 0;
 	}
@@ -1797,32 +2463,16 @@ int lwm2m_engine_get_bool(char *pathstr, bool *value)
 	return ret;
 }
 
-int lwm2m_engine_get_float32(char *pathstr, float32_value_t *buf)
-{
-	return lwm2m_engine_get(pathstr, buf, sizeof(float32_value_t));
-}
-
-int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf)
+int lwm2m_engine_res_get_float32(const struct lwm2m_res_handle *handle,
+				 float32_value_t *buf)
 {
-	return lwm2m_engine_get(pathstr, buf, sizeof(float64_value_t));
+	return lwm2m_engine_res_get(handle, buf, sizeof(float32_value_t));
 }
 
-int lwm2m_engine_get_resource(char *pathstr, struct lwm2m_engine_res_inst **res)
+int lwm2m_engine_res_get_float64(const struct lwm2m_res_handle *handle,
+				 float64_value_t *buf)
 {
-	int ret;
-	struct lwm2m_obj_path path;
-
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have 3 parts");
-		return -EINVAL;
-	}
-
-	return path_to_objs(&path, NULL, NULL, res);
+	return lwm2m_engine_res_get(handle, buf, sizeof(float64_value_t));
 }
 
 int lwm2m_engine_register_read_callback(char *pathstr,
@@ -2147,6 +2797,16 @@ int lwm2m_write_handler(struct lwm2m_engine_obj_inst *obj_inst,
 		data_ptr = res->pre_write_cb(obj_inst->obj_inst_id, &data_len);
 	}
 
+	/* write a single instance of a multiple resource */
+	if (msg->path.level == 4 && res->multi_count_var && data_ptr) {
+		ret = res_inst_data(res, obj_field->data_type,
+				    msg->path.res_inst_id,
+				    &data_ptr, &data_len);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
 	if (res->post_write_cb) {
 		/* Get block1 option for checking MORE block flag */
 		ret = get_option_int(msg->in.in_cpkt, COAP_OPTION_BLOCK1);
@@ -2283,6 +2943,7 @@ static int lwm2m_write_attr_handler(struct lwm2m_engine_obj *obj,
 	struct lwm2m_attr *attr;
 	struct notification_attrs nattrs = { 0 };
 	struct observe_node *obs;
+	unsigned int key;
 	u8_t type = 0U;
 	void *nattr_ptrs[NR_LWM2M_ATTR] = {
 		&nattrs.pmin, &nattrs.pmax, &nattrs.gt, &nattrs.lt, &nattrs.st
@@ -2596,11 +3257,16 @@ static int lwm2m_write_attr_handler(struct lwm2m_engine_obj *obj,
 			obs->path.res_id, obs->path.level,
 			obs->min_period_sec, obs->max_period_sec,
 			nattrs.pmin, max(nattrs.pmin, nattrs.pmax));
+		key = irq_lock();
 		obs->min_period_sec = (u32_t)nattrs.pmin;
 		obs->max_period_sec = (u32_t)max(nattrs.pmin, nattrs.pmax);
+		observer_heap_update(obs);
+		irq_unlock(key);
 		(void)memset(&nattrs, 0, sizeof(nattrs));
 	}
 
+	engine_schedule_service();
+
 	return 0;
 }
 
@@ -2667,6 +3333,14 @@ static int do_read_op(struct lwm2m_engine_obj *obj,
 		return do_read_op_json(obj, msg, content_format);
 #endif
 
+#if defined(CONFIG_LWM2M_RW_CBOR_SUPPORT)
+	case LWM2M_FORMAT_APP_CBOR:
+		return do_read_op_cbor(obj, msg, content_format);
+
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return do_read_op_senml_cbor(obj, msg, content_format);
+#endif
+
 	default:
 		LOG_ERR("Unsupported content-format: %u", content_format);
 		return -ENOMSG;
@@ -3072,6 +3746,14 @@ static int do_write_op(struct lwm2m_engine_obj *obj,
 		return do_write_op_json(obj, msg);
 #endif
 
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_CBOR:
+		return do_write_op_cbor(obj, msg);
+
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return do_write_op_senml_cbor(obj, msg);
+#endif
+
 	default:
 		LOG_ERR("Unsupported format: %u", format);
 		return -ENOMSG;
@@ -3719,29 +4401,53 @@ cleanup:
 	return ret;
 }
 
-s32_t engine_next_service_timeout_ms(u32_t max_timeout)
+static s64_t service_due_timestamp(struct service_node *srv)
+{
+	return srv->last_timestamp + K_MSEC(srv->min_call_period);
+}
+
+/* Returns the delay until the next observer or service is due, or
+ * K_FOREVER if nothing is scheduled.
+ */
+static s32_t engine_next_timeout(s64_t timestamp)
 {
 	struct service_node *srv;
-	u64_t time_left_ms, timestamp = k_uptime_get();
-	u32_t timeout = max_timeout;
+	s64_t due, next = -1;
+	unsigned int key;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_service_list, srv, node) {
-		time_left_ms = srv->last_timestamp +
-				  K_MSEC(srv->min_call_period);
+	key = irq_lock();
+	if (observer_heap_count) {
+		next = observer_heap[0]->due_timestamp;
+	}
 
-		/* service is due */
-		if (time_left_ms < timestamp) {
-			return 0;
-		}
+	irq_unlock(key);
 
-		/* service timeout is less than the current timeout */
-		time_left_ms -= timestamp;
-		if (time_left_ms < timeout) {
-			timeout = time_left_ms;
+	SYS_SLIST_FOR_EACH_CONTAINER(&engine_service_list, srv, node) {
+		due = service_due_timestamp(srv);
+		if (next < 0 || due < next) {
+			next = due;
 		}
 	}
 
-	return timeout;
+	if (next < 0) {
+		return K_FOREVER;
+	}
+
+	if (next <= timestamp) {
+		return K_NO_WAIT;
+	}
+
+	return (s32_t)min(next - timestamp, (s64_t)INT32_MAX);
+}
+
+/* Runs lwm2m_engine_service() as soon as possible, so that it can
+ * compute its next wakeup again.
+ */
+static void engine_schedule_service(void)
+{
+	if (periodic_work_ready) {
+		k_delayed_work_submit(&periodic_work, K_NO_WAIT);
+	}
 }
 
 int lwm2m_engine_add_service(k_work_handler_t service, u32_t period_ms)
@@ -3766,61 +4472,79 @@ int lwm2m_engine_add_service(k_work_handler_t service, u32_t period_ms)
 	sys_slist_append(&engine_service_list,
 			 &service_node_data[i].node);
 
+	engine_schedule_service();
+
 	return 0;
 }
 
+int lwm2m_engine_update_service_period(k_work_handler_t service,
+				       u32_t period_ms)
+{
+	int i;
+
+	for (i = 0; i < MAX_PERIODIC_SERVICE; i++) {
+		if (service_node_data[i].service_work.handler == service) {
+			service_node_data[i].min_call_period = period_ms;
+			engine_schedule_service();
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
 static void lwm2m_engine_service(struct k_work *work)
 {
 	struct observe_node *obs;
 	struct service_node *srv;
-	s64_t timestamp, service_due_timestamp;
+	s64_t timestamp;
 	s32_t sleep_ms;
+	bool manual_trigger;
+	unsigned int key;
 	int ret;
 
 	/*
-	 * 1. scan the observer list
-	 * 2. For each notify event found, scan the observer list
-	 * 3. For each observer match, generate a NOTIFY message,
-	 *    attaching the notify response handler
+	 * 1. pop the due observers from the top of the deadline heap
+	 * 2. move each of them to its next deadline
+	 * 3. generate a NOTIFY message for it, attaching the notify
+	 *    response handler
 	 */
 	timestamp = k_uptime_get();
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
-		/*
-		 * manual notify requirements:
-		 * - event_timestamp > last_timestamp
-		 * - current timestamp > last_timestamp + min_period_sec
-		 */
-		if (obs->event_timestamp > obs->last_timestamp &&
-		    timestamp > obs->last_timestamp +
-				K_SECONDS(obs->min_period_sec)) {
-			obs->last_timestamp = k_uptime_get();
-			generate_notify_message(obs, true);
-
-		/*
-		 * automatic time-based notify requirements:
-		 * - current timestamp > last_timestamp + max_period_sec
-		 */
-		} else if (timestamp > obs->last_timestamp +
-				K_SECONDS(obs->min_period_sec)) {
-			obs->last_timestamp = k_uptime_get();
-			generate_notify_message(obs, false);
+	while (true) {
+		key = irq_lock();
+		obs = observer_heap_count ? observer_heap[0] : NULL;
+		if (!obs || obs->due_timestamp > timestamp) {
+			irq_unlock(key);
+			break;
 		}
 
+		manual_trigger = obs->event_timestamp > obs->last_timestamp;
+		obs->last_timestamp = k_uptime_get();
+		observer_heap_update(obs);
+		irq_unlock(key);
+
+		generate_notify_message(obs, manual_trigger);
 	}
 
 	timestamp = k_uptime_get();
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_service_list, srv, node) {
-		service_due_timestamp = srv->last_timestamp +
-					K_MSEC(srv->min_call_period);
 		/* service is due */
-		if (timestamp > service_due_timestamp) {
+		if (timestamp >= service_due_timestamp(srv)) {
 			srv->last_timestamp = k_uptime_get();
 			k_work_submit(&srv->service_work);
 		}
 	}
 
-	/* calculate how long to sleep till the next service */
-	sleep_ms = engine_next_service_timeout_ms(ENGINE_UPDATE_INTERVAL);
+	/*
+	 * Sleep until the next observer or service is due. Anything that
+	 * changes the schedule before that calls engine_schedule_service(),
+	 * and retransmissions have their own per context delayed work.
+	 */
+	sleep_ms = engine_next_timeout(k_uptime_get());
+	if (sleep_ms == K_FOREVER) {
+		return;
+	}
+
 	ret = k_delayed_work_submit(&periodic_work, sleep_ms);
 	if (ret < 0) {
 		LOG_ERR("Work submit error:%d", ret);
@@ -3868,6 +4592,10 @@ found:
 	sock_ctx[i] = ctx;
 	sock_fds[i].fd = ctx->sock_fd;
 	sock_fds[i].events = POLLIN;
+
+	/* restart the poll with the new socket */
+	k_poll_signal_raise(&sock_signal, 0);
+
 	return 0;
 }
 
@@ -3878,6 +4606,7 @@ void lwm2m_socket_del(struct lwm2m_ctx *ctx)
 			sock_ctx[i] = NULL;
 			sock_fds[i].fd = -1;
 			sock_nfds--;
+			k_poll_signal_raise(&sock_signal, 0);
 			break;
 		}
 	}
@@ -3895,27 +4624,27 @@ static void socket_receive_loop(void)
 
 	from_addr_len = sizeof(from_addr);
 	while (1) {
-		/* wait for sockets */
-		if (sock_nfds < 1) {
-			k_sleep(ENGINE_UPDATE_INTERVAL);
-			continue;
-		}
-
 		/*
-		 * FIXME: Currently we timeout and restart poll in case fds
-		 *        were modified.
+		 * Wait for sockets without a timeout, lwm2m_socket_add() and
+		 * lwm2m_socket_del() raise sock_signal to restart the poll
+		 * when the sockets change.
 		 */
-		if (poll(sock_fds, sock_nfds, ENGINE_UPDATE_INTERVAL) < 0) {
+		if (zsock_poll_signal(sock_fds, sock_nfds, &sock_signal,
+				      K_FOREVER) < 0) {
 			LOG_ERR("Error in poll:%d", errno);
 			errno = 0;
-			k_sleep(ENGINE_UPDATE_INTERVAL);
+			k_sleep(ENGINE_ERROR_BACKOFF);
 			continue;
 		}
 
+		if (sock_signal.signaled) {
+			k_poll_signal_reset(&sock_signal);
+		}
+
 		for (i = 0; i < sock_nfds; i++) {
 			if (sock_fds[i].revents & POLLERR) {
 				LOG_ERR("Error in poll.. waiting a moment.");
-				k_sleep(ENGINE_UPDATE_INTERVAL);
+				k_sleep(ENGINE_ERROR_BACKOFF);
 				continue;
 			}
 
@@ -4200,6 +4929,7 @@ static int lwm2m_engine_init(struct device *dev)
 	LOG_DBG("LWM2M engine socket receive thread started");
 
 	k_delayed_work_init(&periodic_work, lwm2m_engine_service);
+	periodic_work_ready = true;
 	k_delayed_work_submit(&periodic_work, K_MSEC(2000));
 	LOG_DBG("LWM2M engine periodic work started");
 
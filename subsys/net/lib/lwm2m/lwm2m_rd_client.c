@@ -63,6 +63,8 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 #define SECONDS_TO_UPDATE_EARLY	6
 #define STATE_MACHINE_UPDATE_INTERVAL K_MSEC(500)
+/* Service period while waiting for a reply, a timeout or a restart */
+#define STATE_MACHINE_IDLE_INTERVAL K_SECONDS(3600)
 
 /* Leave room for 32 hexadeciaml digits (UUID) + NULL */
 #define CLIENT_EP_LEN		33
@@ -110,6 +112,9 @@ struct lwm2m_rd_client_info {
 static char query_buffer[64]; /* allocate some data for queries and updates */
 static u8_t client_data[256]; /* allocate some data for the RD */
 
+static void sm_update_service_period(void);
+static void lwm2m_rd_client_service(struct k_work *work);
+
 static void set_sm_state(u8_t sm_state)
 {
 	enum lwm2m_rd_client_event event = LWM2M_RD_CLIENT_EVENT_NONE;
@@ -136,6 +141,7 @@ static void set_sm_state(u8_t sm_state)
 
 	/* TODO: add locking? */
 	client.engine_state = sm_state;
+	sm_update_service_period();
 
 	if (event > LWM2M_RD_CLIENT_EVENT_NONE && client.event_cb) {
 		client.event_cb(client.ctx, event);
@@ -186,6 +192,7 @@ void engine_trigger_update(void)
 {
 	/* TODO: add locking? */
 	client.trigger_update = 1U;
+	sm_update_service_period();
 }
 
 /* state machine reply callbacks */
@@ -790,6 +797,54 @@ cleanup:
 	return ret;
 }
 
+/*
+ * Only run the state machine when it has something to do: right away in
+ * the states that send a message, at the registration update time once
+ * registered. The reply and timeout callbacks change the state, so the
+ * states waiting for them don't need to be polled.
+ */
+static void sm_update_service_period(void)
+{
+	u32_t period_ms = STATE_MACHINE_UPDATE_INTERVAL;
+	s64_t due;
+
+	if (!client.ctx) {
+		period_ms = STATE_MACHINE_IDLE_INTERVAL;
+	} else {
+		switch (get_sm_state()) {
+		case ENGINE_REGISTRATION_DONE:
+			if (client.trigger_update ||
+			    client.lifetime <= SECONDS_TO_UPDATE_EARLY) {
+				break;
+			}
+
+			due = client.last_update +
+			      K_SECONDS(client.lifetime -
+					SECONDS_TO_UPDATE_EARLY);
+			due -= k_uptime_get();
+			period_ms = due > 0 ? (u32_t)due : 0;
+			break;
+
+#if defined(CONFIG_LWM2M_RD_CLIENT_SUPPORT_BOOTSTRAP)
+		case ENGINE_BOOTSTRAP_REG_SENT:
+#endif
+		case ENGINE_REGISTRATION_SENT:
+		case ENGINE_UPDATE_SENT:
+		case ENGINE_DEREGISTER_SENT:
+		case ENGINE_DEREGISTER_FAILED:
+		case ENGINE_DEREGISTERED:
+			period_ms = STATE_MACHINE_IDLE_INTERVAL;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	lwm2m_engine_update_service_period(lwm2m_rd_client_service,
+					   period_ms);
+}
+
 static void lwm2m_rd_client_service(struct k_work *work)
 {
 	if (client.ctx) {
@@ -853,6 +908,8 @@ static void lwm2m_rd_client_service(struct k_work *work)
 
 		}
 	}
+
+	sm_update_service_period();
 }
 
 void lwm2m_rd_client_start(struct lwm2m_ctx *client_ctx, const char *ep_name,
@@ -868,8 +925,9 @@ void lwm2m_rd_client_start(struct lwm2m_ctx *client_ctx, const char *ep_name,
 
 static int lwm2m_rd_client_init(struct device *dev)
 {
+	/* idle until lwm2m_rd_client_start() */
 	return lwm2m_engine_add_service(lwm2m_rd_client_service,
-					STATE_MACHINE_UPDATE_INTERVAL);
+					STATE_MACHINE_IDLE_INTERVAL);
 }
 
 SYS_INIT(lwm2m_rd_client_init, APPLICATION,
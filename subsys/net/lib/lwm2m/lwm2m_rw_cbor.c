@@ -0,0 +1,1169 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * CBOR (RFC 7049) and SenML CBOR (RFC 8428) content formats.
+ *
+ * A CBOR payload holds the value of a single resource. A SenML CBOR
+ * payload is an array of records, one per resource (instance), each
+ * record being a map with the resource name relative to the base name
+ * of the first record, and the value.
+ *
+ * Samples recorded with lwm2m_engine_push_sample() are added to the
+ * SenML CBOR pack of the next read or notification of their path, with
+ * their time relative to the time of the pack, so that a time series can
+ * be sent in a single message.
+ *
+ * Floating point values are converted with the IEEE 754 helpers of
+ * lwm2m_util.c, so that no floating point arithmetic is needed.
+ */
+
+#define LOG_MODULE_NAME net_lwm2m_cbor
+#define LOG_LEVEL CONFIG_LWM2M_LOG_LEVEL
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <misc/byteorder.h>
+
+#include <cbor.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_rw_cbor.h"
+#include "lwm2m_engine.h"
+#include "lwm2m_util.h"
+
+/* SenML labels (RFC 8428, section 6) */
+#define SENML_LABEL_BASE_NAME		-2
+#define SENML_LABEL_NAME		0
+#define SENML_LABEL_VALUE		2
+#define SENML_LABEL_STRING_VALUE	3
+#define SENML_LABEL_BOOL_VALUE		4
+#define SENML_LABEL_TIME		6
+#define SENML_LABEL_DATA_VALUE		8
+
+struct cbor_out_formatter_data {
+	/* encoder output, appended to the outgoing packet */
+	struct cbor_encoder_writer writer;
+	struct coap_packet *cpkt;
+
+	CborEncoder encoder;
+	CborEncoder array;
+	CborError error;
+
+	/* SenML base name, written in the first record */
+	char base_name[MAX_RESOURCE_LEN];
+
+	/* flags */
+	u8_t writer_flags;
+
+	/* path storage */
+	struct lwm2m_obj_path path;
+	u8_t path_level;
+
+	bool senml;
+	bool base_name_written;
+
+	/* age of the sample being written, in ms, 0 for current values */
+	s64_t sample_age;
+};
+
+struct cbor_in_formatter_data {
+	/* value of the resource being written */
+	CborValue value;
+};
+
+#if CONFIG_LWM2M_RW_SENML_CBOR_SAMPLES > 0
+/* Resource value recorded by lwm2m_engine_push_sample() */
+struct senml_sample {
+	struct lwm2m_obj_path path;
+
+	/* uptime of the sample, in ms */
+	s64_t timestamp;
+
+	union {
+		s64_t s64;
+		float32_value_t f32;
+		float64_value_t f64;
+		bool b;
+	} value;
+
+	u8_t data_type;
+};
+
+/* samples in the order they were pushed */
+static struct senml_sample samples[CONFIG_LWM2M_RW_SENML_CBOR_SAMPLES];
+static int sample_count;
+static K_MUTEX_DEFINE(samples_lock);
+
+static void put_samples(struct lwm2m_output_context *out);
+#endif
+
+static int cpkt_write(struct cbor_encoder_writer *writer, const char *data,
+		      int len)
+{
+	struct cbor_out_formatter_data *fd =
+		CONTAINER_OF(writer, struct cbor_out_formatter_data, writer);
+
+	if (buf_append(CPKT_BUF_WRITE(fd->cpkt), (u8_t *)data, len) < 0) {
+		return CborErrorOutOfMemory;
+	}
+
+	writer->bytes_written += len;
+	return CborNoError;
+}
+
+static void out_formatter_init(struct cbor_out_formatter_data *fd,
+			       struct lwm2m_message *msg, bool senml)
+{
+	(void)memset(fd, 0, sizeof(*fd));
+	fd->writer.write = cpkt_write;
+	fd->cpkt = msg->out.out_cpkt;
+	memcpy(&fd->path, &msg->path, sizeof(fd->path));
+	fd->path_level = msg->path.level;
+	fd->senml = senml;
+	cbor_encoder_cust_writer_init(&fd->encoder, &fd->writer, 0);
+}
+
+static size_t put_begin(struct lwm2m_output_context *out,
+			struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	if (path->level >= 2) {
+		snprintk(fd->base_name, sizeof(fd->base_name), "/%u/%u/",
+			 path->obj_id, path->obj_inst_id);
+	} else {
+		snprintk(fd->base_name, sizeof(fd->base_name), "/%u/",
+			 path->obj_id);
+	}
+
+	/* the number of records is not known yet */
+	start = fd->writer.bytes_written;
+	fd->error |= cbor_encoder_create_array(&fd->encoder, &fd->array,
+					       CborIndefiniteLength);
+
+	return fd->writer.bytes_written - start;
+}
+
+static size_t put_end(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	start = fd->writer.bytes_written;
+
+#if CONFIG_LWM2M_RW_SENML_CBOR_SAMPLES > 0
+	put_samples(out);
+#endif
+
+	fd->error |= cbor_encoder_close_container(&fd->encoder, &fd->array);
+
+	return fd->writer.bytes_written - start;
+}
+
+static size_t put_begin_ri(struct lwm2m_output_context *out,
+			   struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags |= WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+static size_t put_end_ri(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags &= ~WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+/* Writes the time of a sample: it is in the past, so the time relative
+ * to the pack is negative, in seconds.
+ */
+static void put_time(struct cbor_out_formatter_data *fd, CborEncoder *map)
+{
+	float64_value_t age = {
+		.val1 = fd->sample_age / MSEC_PER_SEC,
+		.val2 = (fd->sample_age % MSEC_PER_SEC) *
+			(LWM2M_FLOAT64_DEC_MAX / MSEC_PER_SEC),
+	};
+	u8_t b64[8];
+	u64_t bits;
+
+	if (lwm2m_f64_to_b64(&age, b64, sizeof(b64)) < 0) {
+		fd->error |= CborErrorIO;
+		return;
+	}
+
+	/* the sign is taken from val1 only, which may be 0 */
+	b64[0] |= 0x80;
+	bits = ((u64_t)sys_get_be32(b64) << 32) | sys_get_be32(&b64[4]);
+
+	fd->error |= cbor_encode_int(map, SENML_LABEL_TIME);
+	fd->error |= cbor_encode_floating_point(map, CborDoubleType, &bits);
+}
+
+/*
+ * Starts the output of a value, and returns the encoder of the value:
+ * the top level encoder for CBOR, or the map of a new record for SenML
+ * CBOR, where the name, the time of a sample and the value label are
+ * already written.
+ */
+static CborEncoder *value_begin(struct cbor_out_formatter_data *fd,
+				struct lwm2m_obj_path *path, int label,
+				CborEncoder *map)
+{
+	char name[MAX_RESOURCE_LEN];
+	size_t count = 2;
+
+	if (!fd->senml) {
+		return &fd->encoder;
+	}
+
+	if (fd->path_level >= 2) {
+		if (fd->writer_flags & WRITER_RESOURCE_INSTANCE) {
+			snprintk(name, sizeof(name), "%u/%u",
+				 path->res_id, path->res_inst_id);
+		} else {
+			snprintk(name, sizeof(name), "%u", path->res_id);
+		}
+	} else {
+		if (fd->writer_flags & WRITER_RESOURCE_INSTANCE) {
+			snprintk(name, sizeof(name), "%u/%u/%u",
+				 path->obj_inst_id, path->res_id,
+				 path->res_inst_id);
+		} else {
+			snprintk(name, sizeof(name), "%u/%u",
+				 path->obj_inst_id, path->res_id);
+		}
+	}
+
+	if (!fd->base_name_written) {
+		count++;
+	}
+
+	if (fd->sample_age > 0) {
+		count++;
+	}
+
+	fd->error |= cbor_encoder_create_map(&fd->array, map, count);
+
+	if (!fd->base_name_written) {
+		fd->error |= cbor_encode_int(map, SENML_LABEL_BASE_NAME);
+		fd->error |= cbor_encode_text_stringz(map, fd->base_name);
+		fd->base_name_written = true;
+	}
+
+	fd->error |= cbor_encode_int(map, SENML_LABEL_NAME);
+	fd->error |= cbor_encode_text_stringz(map, name);
+
+	if (fd->sample_age > 0) {
+		put_time(fd, map);
+	}
+
+	fd->error |= cbor_encode_int(map, label);
+
+	return map;
+}
+
+static size_t value_end(struct cbor_out_formatter_data *fd,
+			CborEncoder *map, int start)
+{
+	if (fd->senml) {
+		fd->error |= cbor_encoder_close_container(&fd->array, map);
+	}
+
+	return fd->writer.bytes_written - start;
+}
+
+static size_t put_s64(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, s64_t value)
+{
+	struct cbor_out_formatter_data *fd;
+	CborEncoder map, *enc;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	start = fd->writer.bytes_written;
+	enc = value_begin(fd, path, SENML_LABEL_VALUE, &map);
+	fd->error |= cbor_encode_int(enc, value);
+
+	return value_end(fd, &map, start);
+}
+
+static size_t put_s32(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, s32_t value)
+{
+	return put_s64(out, path, (s64_t)value);
+}
+
+static size_t put_s16(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, s16_t value)
+{
+	return put_s64(out, path, (s64_t)value);
+}
+
+static size_t put_s8(struct lwm2m_output_context *out,
+		     struct lwm2m_obj_path *path, s8_t value)
+{
+	return put_s64(out, path, (s64_t)value);
+}
+
+static size_t put_string(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 char *buf, size_t buflen)
+{
+	struct cbor_out_formatter_data *fd;
+	CborEncoder map, *enc;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	start = fd->writer.bytes_written;
+	enc = value_begin(fd, path, SENML_LABEL_STRING_VALUE, &map);
+	fd->error |= cbor_encode_text_string(enc, buf, buflen);
+
+	return value_end(fd, &map, start);
+}
+
+static size_t put_opaque(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 char *buf, size_t buflen)
+{
+	struct cbor_out_formatter_data *fd;
+	CborEncoder map, *enc;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	start = fd->writer.bytes_written;
+	enc = value_begin(fd, path, SENML_LABEL_DATA_VALUE, &map);
+	fd->error |= cbor_encode_byte_string(enc, (u8_t *)buf, buflen);
+
+	return value_end(fd, &map, start);
+}
+
+static size_t put_float32fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float32_value_t *value)
+{
+	struct cbor_out_formatter_data *fd;
+	CborEncoder map, *enc;
+	u8_t b32[4];
+	u32_t bits;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	if (lwm2m_f32_to_b32(value, b32, sizeof(b32)) < 0) {
+		LOG_ERR("float32 conversion error");
+		return 0;
+	}
+
+	/* tinycbor takes the value in host byte order */
+	bits = sys_get_be32(b32);
+
+	start = fd->writer.bytes_written;
+	enc = value_begin(fd, path, SENML_LABEL_VALUE, &map);
+	fd->error |= cbor_encode_floating_point(enc, CborFloatType, &bits);
+
+	return value_end(fd, &map, start);
+}
+
+static size_t put_float64fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float64_value_t *value)
+{
+	struct cbor_out_formatter_data *fd;
+	CborEncoder map, *enc;
+	u8_t b64[8];
+	u64_t bits;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	if (lwm2m_f64_to_b64(value, b64, sizeof(b64)) < 0) {
+		LOG_ERR("float64 conversion error");
+		return 0;
+	}
+
+	bits = ((u64_t)sys_get_be32(b64) << 32) | sys_get_be32(&b64[4]);
+
+	start = fd->writer.bytes_written;
+	enc = value_begin(fd, path, SENML_LABEL_VALUE, &map);
+	fd->error |= cbor_encode_floating_point(enc, CborDoubleType, &bits);
+
+	return value_end(fd, &map, start);
+}
+
+static size_t put_bool(struct lwm2m_output_context *out,
+		       struct lwm2m_obj_path *path,
+		       bool value)
+{
+	struct cbor_out_formatter_data *fd;
+	CborEncoder map, *enc;
+	int start;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	start = fd->writer.bytes_written;
+	enc = value_begin(fd, path, SENML_LABEL_BOOL_VALUE, &map);
+	fd->error |= cbor_encode_boolean(enc, value);
+
+	return value_end(fd, &map, start);
+}
+
+static size_t get_s64(struct lwm2m_input_context *in, s64_t *value)
+{
+	struct cbor_in_formatter_data *fd;
+	int64_t tmp;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || !cbor_value_is_integer(&fd->value)) {
+		return 0;
+	}
+
+	if (cbor_value_get_int64_checked(&fd->value, &tmp) != CborNoError) {
+		return 0;
+	}
+
+	*value = tmp;
+	return sizeof(*value);
+}
+
+static size_t get_s32(struct lwm2m_input_context *in, s32_t *value)
+{
+	s64_t tmp = 0;
+
+	if (!get_s64(in, &tmp) || tmp < INT32_MIN || tmp > INT32_MAX) {
+		return 0;
+	}
+
+	*value = (s32_t)tmp;
+	return sizeof(*value);
+}
+
+static size_t get_string(struct lwm2m_input_context *in,
+			 u8_t *buf, size_t buflen)
+{
+	struct cbor_in_formatter_data *fd;
+	size_t len = buflen;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || !cbor_value_is_text_string(&fd->value)) {
+		return 0;
+	}
+
+	/* the string is NUL terminated if it fits */
+	if (cbor_value_copy_text_string(&fd->value, (char *)buf, &len,
+					NULL) != CborNoError) {
+		return 0;
+	}
+
+	return len;
+}
+
+/* Returns the IEEE 754 representation of a floating point value, in
+ * network byte order, or the length of the representation that the
+ * value needs.
+ */
+static size_t get_float_bits(struct lwm2m_input_context *in, u8_t *buf)
+{
+	struct cbor_in_formatter_data *fd;
+	float f;
+	double d;
+	u32_t bits32;
+	u64_t bits64;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd) {
+		return 0;
+	}
+
+	if (cbor_value_is_float(&fd->value)) {
+		cbor_value_get_float(&fd->value, &f);
+		memcpy(&bits32, &f, sizeof(bits32));
+		sys_put_be32(bits32, buf);
+		return sizeof(bits32);
+	}
+
+	if (cbor_value_is_double(&fd->value)) {
+		cbor_value_get_double(&fd->value, &d);
+		memcpy(&bits64, &d, sizeof(bits64));
+		sys_put_be32(bits64 >> 32, buf);
+		sys_put_be32(bits64, &buf[4]);
+		return sizeof(bits64);
+	}
+
+	return 0;
+}
+
+static size_t get_float32fix(struct lwm2m_input_context *in,
+			     float32_value_t *value)
+{
+	float64_value_t f64;
+	u8_t buf[8];
+	s64_t tmp;
+
+	/* SenML may encode integral values as integers */
+	if (get_s64(in, &tmp)) {
+		value->val1 = (s32_t)tmp;
+		value->val2 = 0;
+		return sizeof(*value);
+	}
+
+	switch (get_float_bits(in, buf)) {
+	case 4:
+		if (lwm2m_b32_to_f32(buf, 4, value) < 0) {
+			return 0;
+		}
+
+		break;
+
+	case 8:
+		if (lwm2m_b64_to_f64(buf, 8, &f64) < 0) {
+			return 0;
+		}
+
+		value->val1 = (s32_t)f64.val1;
+		value->val2 = (s32_t)(f64.val2 /
+				      (LWM2M_FLOAT64_DEC_MAX /
+				       LWM2M_FLOAT32_DEC_MAX));
+		break;
+
+	default:
+		return 0;
+	}
+
+	return sizeof(*value);
+}
+
+static size_t get_float64fix(struct lwm2m_input_context *in,
+			     float64_value_t *value)
+{
+	float32_value_t f32;
+	u8_t buf[8];
+	s64_t tmp;
+
+	if (get_s64(in, &tmp)) {
+		value->val1 = tmp;
+		value->val2 = 0;
+		return sizeof(*value);
+	}
+
+	switch (get_float_bits(in, buf)) {
+	case 4:
+		if (lwm2m_b32_to_f32(buf, 4, &f32) < 0) {
+			return 0;
+		}
+
+		value->val1 = f32.val1;
+		value->val2 = (s64_t)f32.val2 *
+			      (LWM2M_FLOAT64_DEC_MAX / LWM2M_FLOAT32_DEC_MAX);
+		break;
+
+	case 8:
+		if (lwm2m_b64_to_f64(buf, 8, value) < 0) {
+			return 0;
+		}
+
+		break;
+
+	default:
+		return 0;
+	}
+
+	return sizeof(*value);
+}
+
+static size_t get_bool(struct lwm2m_input_context *in, bool *value)
+{
+	struct cbor_in_formatter_data *fd;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || !cbor_value_is_boolean(&fd->value)) {
+		return 0;
+	}
+
+	cbor_value_get_boolean(&fd->value, value);
+	return 1;
+}
+
+static size_t get_opaque(struct lwm2m_input_context *in,
+			 u8_t *value, size_t buflen, bool *last_block)
+{
+	struct cbor_in_formatter_data *fd;
+	size_t len = buflen;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || !cbor_value_is_byte_string(&fd->value)) {
+		return 0;
+	}
+
+	if (cbor_value_copy_byte_string(&fd->value, value, &len,
+					NULL) != CborNoError) {
+		return 0;
+	}
+
+	*last_block = true;
+	return len;
+}
+
+#if CONFIG_LWM2M_RW_SENML_CBOR_SAMPLES > 0
+int senml_cbor_push_sample(const struct lwm2m_obj_path *path, u8_t data_type,
+			   const void *data_ptr)
+{
+	struct senml_sample sample = {
+		.timestamp = k_uptime_get(),
+		.data_type = data_type,
+	};
+
+	switch (data_type) {
+
+	case LWM2M_RES_TYPE_U64:
+		sample.value.s64 = (s64_t)*(u64_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_U32:
+	case LWM2M_RES_TYPE_TIME:
+		sample.value.s64 = *(u32_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_U16:
+		sample.value.s64 = *(u16_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_U8:
+		sample.value.s64 = *(u8_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_S64:
+		sample.value.s64 = *(s64_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_S32:
+		sample.value.s64 = *(s32_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_S16:
+		sample.value.s64 = *(s16_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_S8:
+		sample.value.s64 = *(s8_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_BOOL:
+		sample.value.b = *(bool *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_FLOAT32:
+		sample.value.f32 = *(float32_value_t *)data_ptr;
+		break;
+
+	case LWM2M_RES_TYPE_FLOAT64:
+		sample.value.f64 = *(float64_value_t *)data_ptr;
+		break;
+
+	default:
+		return -EINVAL;
+
+	}
+
+	memcpy(&sample.path, path, sizeof(sample.path));
+
+	k_mutex_lock(&samples_lock, K_FOREVER);
+
+	if (sample_count == ARRAY_SIZE(samples)) {
+		LOG_DBG("dropping sample of /%u/%u/%u", samples[0].path.obj_id,
+			samples[0].path.obj_inst_id, samples[0].path.res_id);
+		memmove(&samples[0], &samples[1],
+			(sample_count - 1) * sizeof(samples[0]));
+		sample_count--;
+	}
+
+	samples[sample_count++] = sample;
+
+	k_mutex_unlock(&samples_lock);
+
+	return 0;
+}
+
+static bool sample_in_path(const struct lwm2m_obj_path *sample,
+			   const struct lwm2m_obj_path *path)
+{
+	if (sample->obj_id != path->obj_id) {
+		return false;
+	}
+
+	if (path->level >= 2 && sample->obj_inst_id != path->obj_inst_id) {
+		return false;
+	}
+
+	if (path->level >= 3 && sample->res_id != path->res_id) {
+		return false;
+	}
+
+	if (path->level >= 4 && (sample->level < 4 ||
+				 sample->res_inst_id != path->res_inst_id)) {
+		return false;
+	}
+
+	return true;
+}
+
+/* Adds the samples of the path of the pack to it, oldest first. The
+ * samples are sent only once.
+ */
+static void put_samples(struct lwm2m_output_context *out)
+{
+	struct cbor_out_formatter_data *fd = engine_get_out_user_data(out);
+	u8_t writer_flags = fd->writer_flags;
+	s64_t now = k_uptime_get();
+	struct senml_sample *sample;
+	int i, kept = 0;
+
+	k_mutex_lock(&samples_lock, K_FOREVER);
+
+	for (i = 0; i < sample_count; i++) {
+		sample = &samples[i];
+
+		if (!sample_in_path(&sample->path, &fd->path)) {
+			samples[kept++] = *sample;
+			continue;
+		}
+
+		fd->sample_age = now - sample->timestamp;
+
+		if (sample->path.level == 4) {
+			fd->writer_flags |= WRITER_RESOURCE_INSTANCE;
+		} else {
+			fd->writer_flags &= ~WRITER_RESOURCE_INSTANCE;
+		}
+
+		switch (sample->data_type) {
+
+		case LWM2M_RES_TYPE_BOOL:
+			put_bool(out, &sample->path, sample->value.b);
+			break;
+
+		case LWM2M_RES_TYPE_FLOAT32:
+			put_float32fix(out, &sample->path, &sample->value.f32);
+			break;
+
+		case LWM2M_RES_TYPE_FLOAT64:
+			put_float64fix(out, &sample->path, &sample->value.f64);
+			break;
+
+		default:
+			put_s64(out, &sample->path, sample->value.s64);
+			break;
+
+		}
+	}
+
+	sample_count = kept;
+
+	k_mutex_unlock(&samples_lock);
+
+	fd->sample_age = 0;
+	fd->writer_flags = writer_flags;
+}
+#endif
+
+const struct lwm2m_writer cbor_writer = {
+	.put_s8 = put_s8,
+	.put_s16 = put_s16,
+	.put_s32 = put_s32,
+	.put_s64 = put_s64,
+	.put_string = put_string,
+	.put_float32fix = put_float32fix,
+	.put_float64fix = put_float64fix,
+	.put_bool = put_bool,
+	.put_opaque = put_opaque,
+};
+
+const struct lwm2m_writer senml_cbor_writer = {
+	.put_begin = put_begin,
+	.put_end = put_end,
+	.put_begin_ri = put_begin_ri,
+	.put_end_ri = put_end_ri,
+	.put_s8 = put_s8,
+	.put_s16 = put_s16,
+	.put_s32 = put_s32,
+	.put_s64 = put_s64,
+	.put_string = put_string,
+	.put_float32fix = put_float32fix,
+	.put_float64fix = put_float64fix,
+	.put_bool = put_bool,
+	.put_opaque = put_opaque,
+};
+
+/* both formats read a single value, SenML records are parsed by
+ * do_write_op_senml_cbor()
+ */
+const struct lwm2m_reader cbor_reader = {
+	.get_s32 = get_s32,
+	.get_s64 = get_s64,
+	.get_string = get_string,
+	.get_float32fix = get_float32fix,
+	.get_float64fix = get_float64fix,
+	.get_bool = get_bool,
+	.get_opaque = get_opaque,
+};
+
+const struct lwm2m_reader senml_cbor_reader = {
+	.get_s32 = get_s32,
+	.get_s64 = get_s64,
+	.get_string = get_string,
+	.get_float32fix = get_float32fix,
+	.get_float64fix = get_float64fix,
+	.get_bool = get_bool,
+	.get_opaque = get_opaque,
+};
+
+static int read_op(struct lwm2m_engine_obj *obj, struct lwm2m_message *msg,
+		   int content_format, bool senml)
+{
+	struct cbor_out_formatter_data fd;
+	int ret;
+
+	out_formatter_init(&fd, msg, senml);
+	engine_set_out_user_data(&msg->out, &fd);
+	ret = lwm2m_perform_read_op(obj, msg, content_format);
+	engine_clear_out_user_data(&msg->out);
+
+	if (ret == 0 && fd.error != CborNoError) {
+		LOG_ERR("CBOR encoding error: %s", cbor_error_string(fd.error));
+		ret = (fd.error & CborErrorOutOfMemory) ? -ENOMEM : -EINVAL;
+	}
+
+	return ret;
+}
+
+int do_read_op_cbor(struct lwm2m_engine_obj *obj, struct lwm2m_message *msg,
+		    int content_format)
+{
+	/* CBOR can only return single resource */
+	if (msg->path.level != 3) {
+		return -EPERM; /* NOT_ALLOWED */
+	}
+
+	return read_op(obj, msg, content_format, false);
+}
+
+int do_read_op_senml_cbor(struct lwm2m_engine_obj *obj,
+			  struct lwm2m_message *msg, int content_format)
+{
+	return read_op(obj, msg, content_format, true);
+}
+
+static int payload_parser_init(struct lwm2m_message *msg, CborParser *parser,
+			       CborValue *it)
+{
+	struct coap_packet *cpkt = msg->in.in_cpkt;
+
+	if (cbor_parser_init(cpkt->data + msg->in.offset,
+			     cpkt->offset - msg->in.offset, 0,
+			     parser, it) != CborNoError) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Looks up the resource of msg->path, creating the object instance if
+ * needed, and writes the value of the input formatter to it.
+ */
+static int write_resource(struct lwm2m_engine_obj *obj,
+			  struct lwm2m_message *msg)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res_inst *res = NULL;
+	int ret, i;
+	u8_t created = 0U;
+
+	ret = lwm2m_get_or_create_engine_obj(msg, &obj_inst, &created);
+	if (ret < 0) {
+		return ret;
+	}
+
+	obj_field = lwm2m_get_engine_obj_field(obj, msg->path.res_id);
+	if (!obj_field) {
+		return -ENOENT;
+	}
+
+	if (!LWM2M_HAS_PERM(obj_field, LWM2M_PERM_W)) {
+		return -EPERM;
+	}
+
+	if (!obj_inst->resources || obj_inst->resource_count == 0) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < obj_inst->resource_count; i++) {
+		if (obj_inst->resources[i].res_id == msg->path.res_id) {
+			res = &obj_inst->resources[i];
+			break;
+		}
+	}
+
+	if (!res) {
+		return -ENOENT;
+	}
+
+	return lwm2m_write_handler(obj_inst, res, obj_field, msg);
+}
+
+int do_write_op_cbor(struct lwm2m_engine_obj *obj, struct lwm2m_message *msg)
+{
+	struct cbor_in_formatter_data fd;
+	CborParser parser;
+	int ret;
+
+	ret = payload_parser_init(msg, &parser, &fd.value);
+	if (ret < 0) {
+		return ret;
+	}
+
+	engine_set_in_user_data(&msg->in, &fd);
+
+	/* a resource, or an instance of a multiple resource */
+	if (msg->path.level != 4) {
+		msg->path.level = 3;
+	}
+
+	ret = write_resource(obj, msg);
+	engine_clear_in_user_data(&msg->in);
+
+	return ret;
+}
+
+/* Parses a SenML name, such as "/3303/0/5700" or "/3/0/7/1", into a
+ * path. Returns the number of path components, or a negative error code.
+ */
+static int parse_path(const char *name, struct lwm2m_obj_path *path)
+{
+	u16_t *ids[] = { &path->obj_id, &path->obj_inst_id, &path->res_id,
+			 &path->res_inst_id };
+	u32_t val;
+	int level = 0;
+
+	(void)memset(path, 0, sizeof(*path));
+
+	if (*name == '/') {
+		name++;
+	}
+
+	while (*name) {
+		if (level == ARRAY_SIZE(ids) || *name < '0' || *name > '9') {
+			return -EINVAL;
+		}
+
+		val = 0U;
+		while (*name >= '0' && *name <= '9') {
+			val = val * 10U + (*name++ - '0');
+			if (val > UINT16_MAX) {
+				return -EINVAL;
+			}
+		}
+
+		*ids[level++] = val;
+
+		if (*name == '/') {
+			name++;
+		} else if (*name) {
+			return -EINVAL;
+		}
+	}
+
+	return level;
+}
+
+/* Reads a text string of a SenML record into buf */
+static int copy_text(CborValue *value, char *buf, size_t buflen)
+{
+	size_t len = buflen;
+
+	if (!cbor_value_is_text_string(value) ||
+	    cbor_value_copy_text_string(value, buf, &len, NULL) !=
+	    CborNoError) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int do_write_op_senml_cbor(struct lwm2m_engine_obj *obj,
+			   struct lwm2m_message *msg)
+{
+	struct cbor_in_formatter_data fd;
+	struct lwm2m_obj_path orig_path;
+	CborParser parser;
+	CborValue array, record, label;
+	char base_name[MAX_RESOURCE_LEN] = "";
+	char name[MAX_RESOURCE_LEN];
+	char full_name[2 * MAX_RESOURCE_LEN];
+	bool has_value;
+	int key;
+	int ret;
+
+	ret = payload_parser_init(msg, &parser, &array);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!cbor_value_is_array(&array) ||
+	    cbor_value_enter_container(&array, &record) != CborNoError) {
+		LOG_ERR("SenML pack is not an array");
+		return -EINVAL;
+	}
+
+	/* store a copy of the original path */
+	memcpy(&orig_path, &msg->path, sizeof(msg->path));
+	engine_set_in_user_data(&msg->in, &fd);
+
+	while (!cbor_value_at_end(&record)) {
+		if (!cbor_value_is_map(&record) ||
+		    cbor_value_enter_container(&record, &label) !=
+		    CborNoError) {
+			ret = -EINVAL;
+			break;
+		}
+
+		name[0] = '\0';
+		has_value = false;
+
+		/* labels can come in any order */
+		while (!cbor_value_at_end(&label)) {
+			ret = 0;
+
+			if (!cbor_value_is_integer(&label) ||
+			    cbor_value_get_int(&label, &key) != CborNoError ||
+			    cbor_value_advance_fixed(&label) != CborNoError) {
+				ret = -EINVAL;
+				break;
+			}
+
+			switch (key) {
+			case SENML_LABEL_BASE_NAME:
+				ret = copy_text(&label, base_name,
+						sizeof(base_name));
+				break;
+
+			case SENML_LABEL_NAME:
+				ret = copy_text(&label, name, sizeof(name));
+				break;
+
+			case SENML_LABEL_VALUE:
+			case SENML_LABEL_STRING_VALUE:
+			case SENML_LABEL_BOOL_VALUE:
+			case SENML_LABEL_DATA_VALUE:
+				fd.value = label;
+				has_value = true;
+				break;
+
+			default:
+				/* other labels (time, unit...) are ignored,
+				 * resources only hold their last value
+				 */
+				break;
+			}
+
+			if (ret < 0 ||
+			    cbor_value_advance(&label) != CborNoError) {
+				ret = -EINVAL;
+				break;
+			}
+		}
+
+		if (ret < 0 ||
+		    cbor_value_leave_container(&record, &label) !=
+		    CborNoError) {
+			ret = -EINVAL;
+			break;
+		}
+
+		if (!has_value) {
+			continue;
+		}
+
+		/* combine base_name + name */
+		snprintk(full_name, sizeof(full_name), "%s%s",
+			 base_name, name);
+
+		ret = parse_path(full_name, &msg->path);
+		if (ret < 3) {
+			LOG_ERR("Invalid SenML name %s", full_name);
+			ret = -EINVAL;
+			break;
+		}
+
+		msg->path.level = ret;
+
+		ret = write_resource(obj, msg);
+		if (orig_path.level == 3 && ret < 0) {
+			/* return errors on a single write */
+			break;
+		}
+
+		/* when writing multiple resources ignore return code */
+		ret = 0;
+	}
+
+	engine_clear_in_user_data(&msg->in);
+	memcpy(&msg->path, &orig_path, sizeof(orig_path));
+
+	return ret;
+}
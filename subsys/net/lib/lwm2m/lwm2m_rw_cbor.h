@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LWM2M_RW_CBOR_H_
+#define LWM2M_RW_CBOR_H_
+
+#include "lwm2m_object.h"
+
+extern const struct lwm2m_writer cbor_writer;
+extern const struct lwm2m_reader cbor_reader;
+
+extern const struct lwm2m_writer senml_cbor_writer;
+extern const struct lwm2m_reader senml_cbor_reader;
+
+int do_read_op_cbor(struct lwm2m_engine_obj *obj, struct lwm2m_message *msg,
+		    int content_format);
+int do_write_op_cbor(struct lwm2m_engine_obj *obj, struct lwm2m_message *msg);
+
+int do_read_op_senml_cbor(struct lwm2m_engine_obj *obj,
+			  struct lwm2m_message *msg, int content_format);
+int do_write_op_senml_cbor(struct lwm2m_engine_obj *obj,
+			   struct lwm2m_message *msg);
+
+int senml_cbor_push_sample(const struct lwm2m_obj_path *path, u8_t data_type,
+			   const void *data_ptr);
+
+#endif /* LWM2M_RW_CBOR_H_ */
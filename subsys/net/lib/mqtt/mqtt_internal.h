@@ -153,6 +153,31 @@ enum mqtt_state {
  */
 void event_notify(struct mqtt_client *client, const struct mqtt_evt *evt);
 
+#if defined(CONFIG_MQTT_OUTBOX)
+/**@brief Sends the messages of the outbox again, once connected.
+ *
+ * @param[in] client Identifies the client for which the procedure is requested.
+ */
+void mqtt_outbox_connected(struct mqtt_client *client);
+
+/**@brief Removes an acknowledged message from the outbox, and sends the
+ *        following ones.
+ *
+ * @param[in] client Identifies the client for which the procedure is requested.
+ * @param[in] message_id Message id of the PUBACK received.
+ */
+void mqtt_outbox_acked(struct mqtt_client *client, u16_t message_id);
+#else
+static inline void mqtt_outbox_connected(struct mqtt_client *client)
+{
+}
+
+static inline void mqtt_outbox_acked(struct mqtt_client *client,
+				     u16_t message_id)
+{
+}
+#endif /* CONFIG_MQTT_OUTBOX */
+
 /**@brief Handles MQTT messages received from the peer.
  *
  * @param[in] client Identifies the client for which the data was received.
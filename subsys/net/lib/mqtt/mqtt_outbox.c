@@ -0,0 +1,688 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file mqtt_outbox.c
+ *
+ * @brief Queue of outgoing QoS 1 messages.
+ *
+ * The messages are stored back to back in a ring buffer, each one as a
+ * record header followed by the topic and the payload. The records from
+ * the head are sent in order, as long as the number of messages waiting
+ * for an acknowledgment is below the window, and removed from the head
+ * once acknowledged.
+ *
+ * When a flash circular buffer is attached, every message is appended to
+ * it, followed later by an acknowledgment record, so that the queue can
+ * be rebuilt after a reset by walking the flash circular buffer.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_mqtt_outbox, CONFIG_MQTT_LOG_LEVEL);
+
+#include <string.h>
+#include <net/mqtt.h>
+
+#include "mqtt_internal.h"
+#include "mqtt_os.h"
+
+/** Message ids used by the queue. */
+#define OUTBOX_MESSAGE_ID_MIN 0x8000
+
+/** Records are stored on 4 bytes boundaries. */
+#define OUTBOX_ALIGN(len) (((len) + 3) & ~3)
+
+/** Largest flash write alignment supported. */
+#define OUTBOX_FCB_ALIGN_MAX 16
+
+enum outbox_record_type {
+	/** A message, followed by its topic and its payload. */
+	OUTBOX_RECORD_MESSAGE = 0x4d,
+
+	/** An acknowledgment, stored in flash only. */
+	OUTBOX_RECORD_ACK = 0x41,
+
+	/** The next record is at the beginning of the buffer. */
+	OUTBOX_RECORD_WRAP = 0x57,
+};
+
+/* The retain flag is kept in flash, the other flags are RAM only. */
+#define OUTBOX_FLAG_RETAIN   BIT(0)
+#define OUTBOX_FLAG_SENT     BIT(1)
+#define OUTBOX_FLAG_INFLIGHT BIT(2)
+#define OUTBOX_FLAG_ACKED    BIT(3)
+
+struct outbox_record {
+	u8_t type;
+	u8_t flags;
+	u16_t message_id;
+	u16_t topic_len;
+	u16_t reserved;
+	u32_t payload_len;
+};
+
+static inline u32_t record_len(const struct outbox_record *rec)
+{
+	return sizeof(*rec) + rec->topic_len + rec->payload_len;
+}
+
+/* The storage may not be aligned, records are always copied. */
+static inline void record_get(const struct mqtt_outbox *outbox, u32_t off,
+			      struct outbox_record *rec)
+{
+	memcpy(rec, outbox->buf + off, sizeof(*rec));
+}
+
+static inline void record_set_flags(struct mqtt_outbox *outbox, u32_t off,
+				    u8_t flags)
+{
+	outbox->buf[off + offsetof(struct outbox_record, flags)] = flags;
+}
+
+/** Returns the offset of the record following the one at off. It shall
+ *  only be called when there is a following record.
+ */
+static u32_t record_next(const struct mqtt_outbox *outbox, u32_t off)
+{
+	struct outbox_record rec;
+
+	record_get(outbox, off, &rec);
+	off += OUTBOX_ALIGN(record_len(&rec));
+
+	if (outbox->buf_size - off < sizeof(rec)) {
+		return 0;
+	}
+
+	record_get(outbox, off, &rec);
+	if (rec.type == OUTBOX_RECORD_WRAP) {
+		return 0;
+	}
+
+	return off;
+}
+
+static int record_find(const struct mqtt_outbox *outbox, u16_t message_id,
+		       u32_t *off)
+{
+	struct outbox_record rec;
+	u32_t i;
+
+	*off = outbox->head;
+
+	for (i = 0; i < outbox->count; i++) {
+		if (i > 0) {
+			*off = record_next(outbox, *off);
+		}
+
+		record_get(outbox, *off, &rec);
+		if (rec.message_id == message_id) {
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/** Reserves size bytes at the tail of the ring buffer. */
+static int queue_alloc(struct mqtt_outbox *outbox, u32_t size, u32_t *off)
+{
+	struct outbox_record wrap = {
+		.type = OUTBOX_RECORD_WRAP,
+	};
+
+	if (outbox->count == 0) {
+		outbox->head = 0;
+		outbox->tail = 0;
+	}
+
+	if (outbox->count == 0 || outbox->tail > outbox->head) {
+		if (outbox->buf_size - outbox->tail >= size) {
+			*off = outbox->tail;
+		} else if (outbox->head >= size) {
+			if (outbox->buf_size - outbox->tail >= sizeof(wrap)) {
+				memcpy(outbox->buf + outbox->tail, &wrap,
+				       sizeof(wrap));
+			}
+
+			*off = 0;
+		} else {
+			return -ENOMEM;
+		}
+	} else if (outbox->head - outbox->tail >= size) {
+		*off = outbox->tail;
+	} else {
+		return -ENOMEM;
+	}
+
+	outbox->tail = *off + size;
+
+	return 0;
+}
+
+/** Removes the record at the head of the ring buffer. */
+static void queue_pop(struct mqtt_outbox *outbox)
+{
+	u32_t head = outbox->head;
+
+	outbox->count--;
+
+	if (outbox->count > 0) {
+		outbox->head = record_next(outbox, head);
+	}
+
+	if (outbox->sent > 0) {
+		outbox->sent--;
+	} else {
+		outbox->next = outbox->head;
+	}
+}
+
+/** Removes the acknowledged records at the head of the ring buffer. */
+static void queue_trim(struct mqtt_outbox *outbox)
+{
+	struct outbox_record rec;
+
+	while (outbox->count > 0) {
+		record_get(outbox, outbox->head, &rec);
+		if (!(rec.flags & OUTBOX_FLAG_ACKED)) {
+			break;
+		}
+
+		queue_pop(outbox);
+	}
+}
+
+static u16_t next_message_id(struct mqtt_outbox *outbox)
+{
+	outbox->message_id++;
+	if (outbox->message_id < OUTBOX_MESSAGE_ID_MIN) {
+		outbox->message_id = OUTBOX_MESSAGE_ID_MIN;
+	}
+
+	return outbox->message_id;
+}
+
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+static int outbox_fcb_append(struct fcb *fcb, const u8_t *data, u16_t len)
+{
+	u8_t tail[OUTBOX_FCB_ALIGN_MAX];
+	struct fcb_entry loc;
+	u16_t aligned;
+	int rc;
+
+	rc = fcb_append(fcb, len, &loc);
+	if (rc) {
+		return rc;
+	}
+
+	/* The end of the data is padded to the write alignment. */
+	aligned = len & ~(fcb->f_align - 1);
+
+	if (aligned > 0) {
+		rc = fcb_flash_write(fcb, loc.fe_sector, loc.fe_data_off, data,
+				     aligned);
+		if (rc) {
+			return FCB_ERR_FLASH;
+		}
+	}
+
+	if (len > aligned) {
+		memset(tail, 0xff, sizeof(tail));
+		memcpy(tail, data + aligned, len - aligned);
+
+		rc = fcb_flash_write(fcb, loc.fe_sector,
+				     loc.fe_data_off + aligned, tail,
+				     fcb->f_align);
+		if (rc) {
+			return FCB_ERR_FLASH;
+		}
+	}
+
+	return fcb_append_finish(fcb, &loc);
+}
+
+/** Erases the oldest sector, after copying the messages it holds that
+ *  are still queued to the scratch sector.
+ */
+static void outbox_fcb_compress(struct mqtt_outbox *outbox)
+{
+	struct fcb *fcb = outbox->fcb;
+	struct fcb_entry loc = { 0 };
+	struct outbox_record rec;
+	u32_t off;
+	int rc;
+
+	rc = fcb_append_to_scratch(fcb);
+	if (rc) {
+		return;
+	}
+
+	while (fcb_getnext(fcb, &loc) == 0) {
+		if (loc.fe_sector != fcb->f_oldest) {
+			break;
+		}
+
+		rc = fcb_flash_read(fcb, loc.fe_sector, loc.fe_data_off, &rec,
+				    sizeof(rec));
+		if (rc || rec.type != OUTBOX_RECORD_MESSAGE) {
+			continue;
+		}
+
+		if (record_find(outbox, rec.message_id, &off)) {
+			continue;
+		}
+
+		record_get(outbox, off, &rec);
+		if (rec.flags & OUTBOX_FLAG_ACKED) {
+			continue;
+		}
+
+		rc = outbox_fcb_append(fcb, outbox->buf + off,
+				       record_len(&rec));
+		if (rc) {
+			MQTT_ERR("Cannot copy message %u (%d)",
+				 rec.message_id, rc);
+		}
+	}
+
+	fcb_rotate(fcb);
+}
+
+static int outbox_fcb_save(struct mqtt_outbox *outbox, const u8_t *data,
+			   u16_t len)
+{
+	int rc = FCB_ERR_NOSPACE;
+	int i;
+
+	if (outbox->fcb == NULL) {
+		return 0;
+	}
+
+	for (i = 0; i < outbox->fcb->f_sector_cnt - 1; i++) {
+		rc = outbox_fcb_append(outbox->fcb, data, len);
+		if (rc != FCB_ERR_NOSPACE) {
+			break;
+		}
+
+		outbox_fcb_compress(outbox);
+	}
+
+	return rc ? -EIO : 0;
+}
+
+static int outbox_fcb_restore_cb(struct fcb_entry_ctx *loc_ctx, void *arg)
+{
+	struct mqtt_outbox *outbox = arg;
+	struct fcb_entry *loc = &loc_ctx->loc;
+	struct outbox_record rec;
+	u32_t off;
+	int rc;
+
+	rc = fcb_flash_read(outbox->fcb, loc->fe_sector, loc->fe_data_off,
+			    &rec, sizeof(rec));
+	if (rc || loc->fe_data_len < sizeof(rec)) {
+		return 0;
+	}
+
+	if (rec.type == OUTBOX_RECORD_ACK) {
+		if (record_find(outbox, rec.message_id, &off) == 0) {
+			record_set_flags(outbox, off, OUTBOX_FLAG_ACKED);
+			queue_trim(outbox);
+		}
+
+		return 0;
+	}
+
+	if (rec.type != OUTBOX_RECORD_MESSAGE ||
+	    loc->fe_data_len != record_len(&rec)) {
+		return 0;
+	}
+
+	if (queue_alloc(outbox, OUTBOX_ALIGN(record_len(&rec)), &off)) {
+		MQTT_ERR("No room to restore message %u", rec.message_id);
+		return 1;
+	}
+
+	rc = fcb_flash_read(outbox->fcb, loc->fe_sector, loc->fe_data_off,
+			    outbox->buf + off, loc->fe_data_len);
+	if (rc) {
+		return 1;
+	}
+
+	/* The message may have been received by the broker already. */
+	record_set_flags(outbox, off, (rec.flags & OUTBOX_FLAG_RETAIN) |
+			 OUTBOX_FLAG_SENT);
+
+	outbox->count++;
+
+	/* Compressed sectors may have moved older messages after newer ones. */
+	if (outbox->message_id == 0U ||
+	    (s16_t)(rec.message_id - outbox->message_id) > 0) {
+		outbox->message_id = rec.message_id;
+	}
+
+	return 0;
+}
+
+static int outbox_fcb_restore(struct mqtt_outbox *outbox)
+{
+	struct fcb *fcb = outbox->fcb;
+	int rc;
+
+	if (fcb->f_align > OUTBOX_FCB_ALIGN_MAX) {
+		return -EINVAL;
+	}
+
+	/* A reset in the middle of the erase of a sector is recognized by
+	 * the scratch sector missing.
+	 */
+	while (fcb_free_sector_cnt(fcb) < 1) {
+		rc = flash_area_erase(fcb->fap,
+				      fcb->f_active.fe_sector->fs_off,
+				      fcb->f_active.fe_sector->fs_size);
+		if (rc) {
+			return -EIO;
+		}
+
+		rc = fcb_init(fcb->fap->fa_id, fcb);
+		if (rc) {
+			return -EINVAL;
+		}
+	}
+
+	rc = fcb_walk(fcb, NULL, outbox_fcb_restore_cb, outbox);
+	if (rc < 0) {
+		return -EIO;
+	}
+
+	outbox->next = outbox->head;
+
+	return 0;
+}
+#else
+static inline int outbox_fcb_save(struct mqtt_outbox *outbox,
+				  const u8_t *data, u16_t len)
+{
+	return 0;
+}
+#endif /* CONFIG_MQTT_OUTBOX_FCB */
+
+/** Sends the messages not sent yet on the current connection, as long as
+ *  the window allows.
+ */
+static void outbox_flush(struct mqtt_client *client)
+{
+	struct mqtt_outbox *outbox = client->outbox;
+	struct mqtt_publish_param param;
+	struct outbox_record rec;
+	u16_t window;
+	int err_code;
+
+	window = outbox->window ? outbox->window : CONFIG_MQTT_OUTBOX_WINDOW;
+
+	if (!MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED)) {
+		return;
+	}
+
+	while (outbox->sent < outbox->count && outbox->inflight < window) {
+		record_get(outbox, outbox->next, &rec);
+
+		if (!(rec.flags & OUTBOX_FLAG_ACKED)) {
+			param.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE;
+			param.message.topic.topic.utf8 =
+				outbox->buf + outbox->next + sizeof(rec);
+			param.message.topic.topic.size = rec.topic_len;
+			param.message.payload.data =
+				param.message.topic.topic.utf8 + rec.topic_len;
+			param.message.payload.len = rec.payload_len;
+			param.message_id = rec.message_id;
+			param.dup_flag = !!(rec.flags & OUTBOX_FLAG_SENT);
+			param.retain_flag = !!(rec.flags & OUTBOX_FLAG_RETAIN);
+
+			err_code = mqtt_publish(client, &param);
+			if (err_code < 0) {
+				MQTT_TRC("[CID %p]: Cannot send message %u "
+					 "(%d)", client, rec.message_id,
+					 err_code);
+				return;
+			}
+
+			record_set_flags(outbox, outbox->next,
+					 rec.flags | OUTBOX_FLAG_SENT |
+					 OUTBOX_FLAG_INFLIGHT);
+			outbox->inflight++;
+		}
+
+		outbox->sent++;
+		if (outbox->sent < outbox->count) {
+			outbox->next = record_next(outbox, outbox->next);
+		}
+	}
+}
+
+void mqtt_outbox_connected(struct mqtt_client *client)
+{
+	struct mqtt_outbox *outbox = client->outbox;
+	struct outbox_record rec;
+	u32_t off;
+	u32_t i;
+
+	if (outbox == NULL) {
+		return;
+	}
+
+	/* Everything not acknowledged yet is sent again. */
+	off = outbox->head;
+
+	for (i = 0; i < outbox->count; i++) {
+		if (i > 0) {
+			off = record_next(outbox, off);
+		}
+
+		record_get(outbox, off, &rec);
+		record_set_flags(outbox, off,
+				 rec.flags & ~OUTBOX_FLAG_INFLIGHT);
+	}
+
+	outbox->next = outbox->head;
+	outbox->sent = 0;
+	outbox->inflight = 0;
+
+	outbox_flush(client);
+}
+
+void mqtt_outbox_acked(struct mqtt_client *client, u16_t message_id)
+{
+	struct mqtt_outbox *outbox = client->outbox;
+	struct outbox_record rec;
+	u32_t off;
+	int err_code;
+
+	if (outbox == NULL || message_id < OUTBOX_MESSAGE_ID_MIN) {
+		return;
+	}
+
+	if (record_find(outbox, message_id, &off)) {
+		return;
+	}
+
+	record_get(outbox, off, &rec);
+	if (rec.flags & OUTBOX_FLAG_ACKED) {
+		return;
+	}
+
+	if (rec.flags & OUTBOX_FLAG_INFLIGHT) {
+		outbox->inflight--;
+	}
+
+	record_set_flags(outbox, off, (rec.flags & ~OUTBOX_FLAG_INFLIGHT) |
+			 OUTBOX_FLAG_ACKED);
+
+	memset(&rec, 0, sizeof(rec));
+	rec.type = OUTBOX_RECORD_ACK;
+	rec.message_id = message_id;
+
+	err_code = outbox_fcb_save(outbox, (u8_t *)&rec, sizeof(rec));
+	if (err_code < 0) {
+		MQTT_ERR("Cannot save acknowledgment of %u (%d)", message_id,
+			 err_code);
+	}
+
+	queue_trim(outbox);
+	outbox_flush(client);
+}
+
+int mqtt_outbox_init(struct mqtt_client *client, struct mqtt_outbox *outbox)
+{
+	int err_code = 0;
+
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(outbox);
+	NULL_PARAM_CHECK(outbox->buf);
+
+	mqtt_mutex_lock(client);
+
+	outbox->head = 0U;
+	outbox->tail = 0U;
+	outbox->next = 0U;
+	outbox->count = 0U;
+	outbox->sent = 0U;
+	outbox->inflight = 0U;
+	outbox->message_id = 0U;
+
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+	if (outbox->fcb != NULL) {
+		err_code = outbox_fcb_restore(outbox);
+		if (err_code < 0) {
+			goto exit;
+		}
+
+		MQTT_TRC("[CID %p]: %u messages restored", client,
+			 outbox->count);
+	}
+#endif
+
+	client->outbox = outbox;
+
+	outbox_flush(client);
+
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+exit:
+#endif
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+
+int mqtt_outbox_publish(struct mqtt_client *client,
+			const struct mqtt_publish_param *param)
+{
+	struct mqtt_outbox *outbox;
+	struct outbox_record rec;
+	u32_t tail, count;
+	u32_t off;
+	int err_code;
+
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(param);
+	NULL_PARAM_CHECK(client->outbox);
+
+	if (param->message.topic.qos != MQTT_QOS_1_AT_LEAST_ONCE ||
+	    param->message.topic.topic.size > 0xFFFF) {
+		return -EINVAL;
+	}
+
+	mqtt_mutex_lock(client);
+
+	outbox = client->outbox;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.type = OUTBOX_RECORD_MESSAGE;
+	rec.flags = param->retain_flag ? OUTBOX_FLAG_RETAIN : 0;
+	rec.topic_len = param->message.topic.topic.size;
+	rec.payload_len = param->message.payload.len;
+
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+	if (outbox->fcb != NULL && record_len(&rec) > FCB_MAX_LEN) {
+		err_code = -EMSGSIZE;
+		goto exit;
+	}
+#endif
+
+	/* Kept to drop the message if it cannot be saved. */
+	tail = outbox->tail;
+	count = outbox->count;
+
+	err_code = queue_alloc(outbox, OUTBOX_ALIGN(record_len(&rec)), &off);
+	if (err_code < 0) {
+		goto exit;
+	}
+
+	rec.message_id = next_message_id(outbox);
+
+	memcpy(outbox->buf + off, &rec, sizeof(rec));
+	memcpy(outbox->buf + off + sizeof(rec),
+	       param->message.topic.topic.utf8, rec.topic_len);
+	memcpy(outbox->buf + off + sizeof(rec) + rec.topic_len,
+	       param->message.payload.data, rec.payload_len);
+
+	err_code = outbox_fcb_save(outbox, outbox->buf + off,
+				   record_len(&rec));
+	if (err_code < 0) {
+		outbox->tail = tail;
+		goto exit;
+	}
+
+	outbox->count++;
+
+	/* Everything else has been sent, this message is the next one. */
+	if (outbox->sent == count) {
+		outbox->next = off;
+	}
+
+	MQTT_TRC("[CID %p]: Message %u queued, %u in the queue", client,
+		 rec.message_id, outbox->count);
+
+	outbox_flush(client);
+
+exit:
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+
+u32_t mqtt_outbox_count(struct mqtt_client *client)
+{
+	struct mqtt_outbox *outbox;
+	struct outbox_record rec;
+	u32_t count = 0U;
+	u32_t off;
+	u32_t i;
+
+	if (client == NULL || client->outbox == NULL) {
+		return 0;
+	}
+
+	mqtt_mutex_lock(client);
+
+	outbox = client->outbox;
+	off = outbox->head;
+
+	/* Messages acknowledged out of order wait for the older ones. */
+	for (i = 0; i < outbox->count; i++) {
+		if (i > 0) {
+			off = record_next(outbox, off);
+		}
+
+		record_get(outbox, off, &rec);
+		if (!(rec.flags & OUTBOX_FLAG_ACKED)) {
+			count++;
+		}
+	}
+
+	mqtt_mutex_unlock(client);
+
+	return count;
+}
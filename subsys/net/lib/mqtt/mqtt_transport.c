@@ -15,6 +15,8 @@
 extern int mqtt_client_tcp_connect(struct mqtt_client *client);
 extern int mqtt_client_tcp_write(struct mqtt_client *client, const u8_t *data,
 				 u32_t datalen);
+extern int mqtt_client_tcp_write_msg(struct mqtt_client *client,
+				     const struct msghdr *message);
 extern int mqtt_client_tcp_read(struct mqtt_client *client, u8_t *data,
 				u32_t buflen);
 extern int mqtt_client_tcp_disconnect(struct mqtt_client *client);
@@ -24,6 +26,8 @@ extern int mqtt_client_tcp_disconnect(struct mqtt_client *client);
 extern int mqtt_client_tls_connect(struct mqtt_client *client);
 extern int mqtt_client_tls_write(struct mqtt_client *client, const u8_t *data,
 				 u32_t datalen);
+extern int mqtt_client_tls_write_msg(struct mqtt_client *client,
+				     const struct msghdr *message);
 extern int mqtt_client_tls_read(struct mqtt_client *client, u8_t *data,
 				u32_t buflen);
 extern int mqtt_client_tls_disconnect(struct mqtt_client *client);
@@ -39,6 +43,7 @@ const struct transport_procedure transport_fn[MQTT_TRANSPORT_NUM] = {
 	{
 		mqtt_client_tcp_connect,
 		mqtt_client_tcp_write,
+		mqtt_client_tcp_write_msg,
 		mqtt_client_tcp_read,
 		mqtt_client_tcp_disconnect,
 	},
@@ -46,6 +51,7 @@ const struct transport_procedure transport_fn[MQTT_TRANSPORT_NUM] = {
 	{
 		mqtt_client_tls_connect,
 		mqtt_client_tls_write,
+		mqtt_client_tls_write_msg,
 		mqtt_client_tls_read,
 		mqtt_client_tls_disconnect,
 	},
@@ -54,6 +60,7 @@ const struct transport_procedure transport_fn[MQTT_TRANSPORT_NUM] = {
 	{
 		mqtt_client_socks5_connect,
 		mqtt_client_tcp_write,
+		mqtt_client_tcp_write_msg,
 		mqtt_client_tcp_read,
 		mqtt_client_tcp_disconnect,
 	},
@@ -72,6 +79,45 @@ int mqtt_transport_write(struct mqtt_client *client, const u8_t *data,
 							  datalen);
 }
 
+int mqtt_transport_write_msg(struct mqtt_client *client,
+			     struct msghdr *message)
+{
+	size_t total_len = 0;
+	size_t offset = 0;
+	size_t i;
+	int ret;
+
+	for (i = 0; i < message->msg_iovlen; i++) {
+		total_len += message->msg_iov[i].iov_len;
+	}
+
+	while (offset < total_len) {
+		ret = transport_fn[client->transport.type].write_msg(client,
+								     message);
+		if (ret < 0) {
+			return ret;
+		}
+
+		offset += ret;
+
+		/* Skip the buffers already sent. */
+		for (i = 0; i < message->msg_iovlen; i++) {
+			if (ret < message->msg_iov[i].iov_len) {
+				message->msg_iov[i].iov_len -= ret;
+				message->msg_iov[i].iov_base =
+					(u8_t *)message->msg_iov[i].iov_base +
+					ret;
+				break;
+			}
+
+			ret -= message->msg_iov[i].iov_len;
+			message->msg_iov[i].iov_len = 0;
+		}
+	}
+
+	return 0;
+}
+
 int mqtt_transport_read(struct mqtt_client *client, u8_t *data, u32_t buflen)
 {
 	return transport_fn[client->transport.type].read(client, data, buflen);
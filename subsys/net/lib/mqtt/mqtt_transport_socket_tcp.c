@@ -81,6 +81,27 @@ int mqtt_client_tcp_write(struct mqtt_client *client, const u8_t *data,
 	return 0;
 }
 
+/**@brief Handles write message requests on TCP socket transport.
+ *
+ * @param[in] client Identifies the client on which the procedure is requested.
+ * @param[in] message Message to be written on the transport.
+ *
+ * @retval Number of bytes written or an error code indicating reason for
+ *         failure.
+ */
+int mqtt_client_tcp_write_msg(struct mqtt_client *client,
+			      const struct msghdr *message)
+{
+	int ret;
+
+	ret = sendmsg(client->transport.tcp.sock, message, 0);
+	if (ret < 0) {
+		return -errno;
+	}
+
+	return ret;
+}
+
 /**@brief Handles read requests on TCP socket transport.
  *
  * @param[in] client Identifies the client on which the procedure is requested.
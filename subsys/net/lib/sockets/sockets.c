@@ -20,6 +20,9 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include "sockets_internal.h"
 
+/* Maximum number of buffers of a message sent from user mode */
+#define SENDMSG_MAX_IOV 8
+
 #define SET_ERRNO(x) \
 	{ int _err = x; if (_err < 0) { errno = -_err; return -1; } }
 
@@ -153,6 +156,8 @@ int zsock_close_ctx(struct net_context *ctx)
 #ifdef CONFIG_USERSPACE
 	_k_object_uninit(ctx);
 #endif
+	zsock_pollset_detach(ctx);
+
 	/* Reset callbacks to avoid any race conditions while
 	 * flushing queues. No need to check return values here,
 	 * as these are fail-free operations and we're closing
@@ -227,6 +232,7 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		k_fifo_init(&new_ctx->recv_q);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		zsock_pollset_notify(parent);
 	}
 }
 
@@ -256,6 +262,8 @@ static void zsock_received_cb(struct net_context *ctx,
 			net_pkt_set_eof(last_pkt, true);
 			NET_DBG("Set EOF flag on pkt %p", ctx);
 		}
+
+		zsock_pollset_notify(ctx);
 		return;
 	}
 
@@ -267,6 +275,7 @@ static void zsock_received_cb(struct net_context *ctx,
 	}
 
 	k_fifo_put(&ctx->recv_q, pkt);
+	zsock_pollset_notify(ctx);
 }
 
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -485,6 +494,85 @@ Z_SYSCALL_HANDLER(zsock_sendto, sock, buf, len, flags, dest_addr, addrlen)
 }
 #endif /* CONFIG_USERSPACE */
 
+ssize_t zsock_sendmsg_ctx(struct net_context *ctx, const struct msghdr *msg,
+			  int flags)
+{
+	s32_t timeout = K_FOREVER;
+	int status;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	status = net_context_sendmsg(ctx, msg, flags, NULL, timeout,
+				     NULL, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	return status;
+}
+
+ssize_t _impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	void *ctx = get_sock_vtable(sock, &vtable);
+
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (!vtable->sendmsg) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	return vtable->sendmsg(ctx, msg, flags);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_sendmsg, sock, msg, flags)
+{
+	struct iovec iov_copy[SENDMSG_MAX_IOV];
+	struct sockaddr_storage dest_addr_copy;
+	struct msghdr msg_copy;
+	size_t i;
+
+	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+	Z_OOPS(Z_SYSCALL_VERIFY(msg_copy.msg_iovlen <= SENDMSG_MAX_IOV));
+	Z_OOPS(z_user_from_copy(iov_copy, msg_copy.msg_iov,
+				msg_copy.msg_iovlen * sizeof(iov_copy[0])));
+
+	for (i = 0; i < msg_copy.msg_iovlen; i++) {
+		Z_OOPS(Z_SYSCALL_MEMORY_READ(iov_copy[i].iov_base,
+					     iov_copy[i].iov_len));
+	}
+
+	if (msg_copy.msg_name) {
+		Z_OOPS(Z_SYSCALL_VERIFY(msg_copy.msg_namelen <=
+					sizeof(dest_addr_copy)));
+		Z_OOPS(z_user_from_copy(&dest_addr_copy, msg_copy.msg_name,
+					msg_copy.msg_namelen));
+		msg_copy.msg_name = &dest_addr_copy;
+	}
+
+	msg_copy.msg_iov = iov_copy;
+
+	return _impl_zsock_sendmsg(sock, &msg_copy, flags);
+}
+#endif /* CONFIG_USERSPACE */
+
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
 				 enum net_ip_protocol proto,
 				 struct sockaddr *addr,
@@ -883,15 +971,17 @@ static inline int time_left(u32_t start, u32_t timeout)
 	return timeout - elapsed;
 }
 
-int _impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+static int poll_internal(struct zsock_pollfd *fds, int nfds,
+			 struct k_poll_signal *signal, int timeout)
 {
 	bool retry;
 	int ret = 0;
 	int i, remaining_time;
 	struct zsock_pollfd *pfd;
-	struct k_poll_event poll_events[CONFIG_NET_SOCKETS_POLL_MAX];
+	struct k_poll_event poll_events[CONFIG_NET_SOCKETS_POLL_MAX + 1];
 	struct k_poll_event *pev;
-	struct k_poll_event *pev_end = poll_events + ARRAY_SIZE(poll_events);
+	/* Last event is reserved for the signal */
+	struct k_poll_event *pev_end = poll_events + CONFIG_NET_SOCKETS_POLL_MAX;
 	const struct fd_op_vtable *vtable;
 	u32_t entry_time = k_uptime_get_32();
 
@@ -932,6 +1022,11 @@ int _impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
 		}
 	}
 
+	if (signal) {
+		k_poll_event_init(pev++, K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, signal);
+	}
+
 	remaining_time = timeout;
 
 	do {
@@ -978,7 +1073,7 @@ int _impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
 		}
 
 		if (retry) {
-			if (ret > 0) {
+			if (ret > 0 || (signal && signal->signaled)) {
 				break;
 			}
 
@@ -999,6 +1094,17 @@ int _impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
 	return ret;
 }
 
+int _impl_zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+	return poll_internal(fds, nfds, NULL, timeout);
+}
+
+int zsock_poll_signal(struct zsock_pollfd *fds, int nfds,
+		      struct k_poll_signal *signal, int timeout)
+{
+	return poll_internal(fds, nfds, signal, timeout);
+}
+
 #ifdef CONFIG_USERSPACE
 Z_SYSCALL_HANDLER(zsock_poll, fds, nfds, timeout)
 {
@@ -1189,6 +1295,12 @@ static ssize_t sock_sendto_vmeth(void *obj, const void *buf, size_t len,
 	return zsock_sendto_ctx(obj, buf, len, flags, dest_addr, addrlen);
 }
 
+static ssize_t sock_sendmsg_vmeth(void *obj, const struct msghdr *msg,
+				  int flags)
+{
+	return zsock_sendmsg_ctx(obj, msg, flags);
+}
+
 static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				   int flags, struct sockaddr *src_addr,
 				   socklen_t *addrlen)
@@ -1221,6 +1333,7 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.listen = sock_listen_vmeth,
 	.accept = sock_accept_vmeth,
 	.sendto = sock_sendto_vmeth,
+	.sendmsg = sock_sendmsg_vmeth,
 	.recvfrom = sock_recvfrom_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
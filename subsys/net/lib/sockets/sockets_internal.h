@@ -39,6 +39,7 @@ struct socket_op_vtable {
 	int (*accept)(void *obj, struct sockaddr *addr, socklen_t *addrlen);
 	ssize_t (*sendto)(void *obj, const void *buf, size_t len, int flags,
 			  const struct sockaddr *dest_addr, socklen_t addrlen);
+	ssize_t (*sendmsg)(void *obj, const struct msghdr *msg, int flags);
 	ssize_t (*recvfrom)(void *obj, void *buf, size_t max_len, int flags,
 			    struct sockaddr *src_addr, socklen_t *addrlen);
 	int (*getsockopt)(void *obj, int level, int optname,
@@ -47,6 +48,23 @@ struct socket_op_vtable {
 			  const void *optval, socklen_t optlen);
 };
 
+extern const struct socket_op_vtable sock_fd_op_vtable;
+
+#if defined(CONFIG_NET_SOCKETS_POLLSET)
+void zsock_pollset_notify(struct net_context *ctx);
+void zsock_pollset_detach(struct net_context *ctx);
+#else
+static inline void zsock_pollset_notify(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+
+static inline void zsock_pollset_detach(struct net_context *ctx)
+{
+	ARG_UNUSED(ctx);
+}
+#endif /* CONFIG_NET_SOCKETS_POLLSET */
+
 int ztls_socket(int family, int type, int proto);
 
 int zpacket_socket(int family, int type, int proto);
@@ -0,0 +1,529 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Persistent poll sets. Unlike poll(), which has to prepare a k_poll_event
+ * for every socket on each call, sockets registered in a poll set flag
+ * themselves as ready from the receive path and raise a single k_poll
+ * signal. Waiting then only visits the flagged entries.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_sock_pollset, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <atomic.h>
+#include <net/net_context.h>
+#include <net/socket.h>
+#include <syscall_handler.h>
+#include <misc/fdtable.h>
+
+#include "sockets_internal.h"
+
+#define POLLSET_WORD_BITS (sizeof(atomic_val_t) * 8)
+#define POLLSET_WORDS \
+	((CONFIG_NET_SOCKETS_POLLSET_MAX + POLLSET_WORD_BITS - 1) / \
+	 POLLSET_WORD_BITS)
+
+struct zsock_pollset;
+
+struct zsock_pollset_entry {
+	struct zsock_pollset *set;
+	struct net_context *ctx;
+	int fd;
+	short events;
+};
+
+struct zsock_pollset {
+	/** Raised whenever a registered socket becomes ready */
+	struct k_poll_signal signal;
+
+	/** Protects the entries against concurrent ctl/wait/close */
+	struct k_mutex lock;
+
+	/** Entries that may be ready, one bit per entry */
+	ATOMIC_DEFINE(ready, CONFIG_NET_SOCKETS_POLLSET_MAX);
+
+	struct zsock_pollset_entry entries[CONFIG_NET_SOCKETS_POLLSET_MAX];
+
+	bool in_use;
+};
+
+static struct zsock_pollset pollsets[CONFIG_NET_SOCKETS_POLLSET_COUNT];
+
+static K_MUTEX_DEFINE(pollsets_lock);
+
+static const struct fd_op_vtable pollset_fd_op_vtable;
+
+static inline int pollset_entry_index(struct zsock_pollset_entry *entry)
+{
+	return entry - entry->set->entries;
+}
+
+static short pollset_revents(struct zsock_pollset_entry *entry)
+{
+	struct net_context *ctx = entry->ctx;
+	short revents = 0;
+
+	if (entry->events & ZSOCK_POLLIN) {
+		if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+			revents |= ZSOCK_POLLIN;
+		}
+	}
+
+	/* Same as poll(), assume that socket is always writable */
+	if (entry->events & ZSOCK_POLLOUT) {
+		revents |= ZSOCK_POLLOUT;
+	}
+
+	return revents;
+}
+
+static void pollset_mark_ready(struct zsock_pollset_entry *entry)
+{
+	atomic_set_bit(entry->set->ready, pollset_entry_index(entry));
+	k_poll_signal_raise(&entry->set->signal, 0);
+}
+
+void zsock_pollset_notify(struct net_context *ctx)
+{
+	struct zsock_pollset_entry *entry;
+	unsigned int key;
+
+	key = irq_lock();
+
+	entry = ctx->poll_entry;
+	if (entry) {
+		pollset_mark_ready(entry);
+	}
+
+	irq_unlock(key);
+}
+
+static void pollset_entry_release(struct zsock_pollset_entry *entry)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	entry->ctx->poll_entry = NULL;
+	irq_unlock(key);
+
+	atomic_clear_bit(entry->set->ready, pollset_entry_index(entry));
+
+	entry->ctx = NULL;
+	entry->fd = -1;
+	entry->events = 0;
+}
+
+void zsock_pollset_detach(struct net_context *ctx)
+{
+	struct zsock_pollset_entry *entry;
+	struct zsock_pollset *set;
+	unsigned int key;
+
+	key = irq_lock();
+	entry = ctx->poll_entry;
+	irq_unlock(key);
+
+	if (!entry) {
+		return;
+	}
+
+	set = entry->set;
+
+	k_mutex_lock(&set->lock, K_FOREVER);
+
+	/* The entry could have been released by the poll set owner while
+	 * we were waiting for the lock.
+	 */
+	if (entry->ctx == ctx) {
+		pollset_entry_release(entry);
+	}
+
+	k_mutex_unlock(&set->lock);
+}
+
+int _impl_zsock_pollset_create(void)
+{
+	struct zsock_pollset *set = NULL;
+	int fd, i;
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	k_mutex_lock(&pollsets_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(pollsets); i++) {
+		if (!pollsets[i].in_use) {
+			set = &pollsets[i];
+			set->in_use = true;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&pollsets_lock);
+
+	if (!set) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	k_poll_signal_init(&set->signal);
+	k_mutex_init(&set->lock);
+	(void)memset(set->ready, 0, sizeof(set->ready));
+
+	for (i = 0; i < ARRAY_SIZE(set->entries); i++) {
+		set->entries[i].set = set;
+		set->entries[i].ctx = NULL;
+		set->entries[i].fd = -1;
+		set->entries[i].events = 0;
+	}
+
+	z_finalize_fd(fd, set, &pollset_fd_op_vtable);
+
+	NET_DBG("pollset %p created as fd %d", set, fd);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER0_SIMPLE(zsock_pollset_create);
+#endif /* CONFIG_USERSPACE */
+
+static int pollset_add(struct zsock_pollset *set, struct net_context *ctx,
+		       int sock, int events)
+{
+	struct zsock_pollset_entry *entry = NULL;
+	unsigned int key;
+	int i;
+
+	if (ctx->poll_entry) {
+		return -EEXIST;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(set->entries); i++) {
+		if (!set->entries[i].ctx) {
+			entry = &set->entries[i];
+			break;
+		}
+	}
+
+	if (!entry) {
+		return -ENOMEM;
+	}
+
+	entry->ctx = ctx;
+	entry->fd = sock;
+	entry->events = events;
+
+	key = irq_lock();
+	ctx->poll_entry = entry;
+	irq_unlock(key);
+
+	/* Data might have been queued before registration */
+	if (pollset_revents(entry)) {
+		pollset_mark_ready(entry);
+	}
+
+	return 0;
+}
+
+static int pollset_mod(struct zsock_pollset *set, struct net_context *ctx,
+		       int events)
+{
+	struct zsock_pollset_entry *entry = ctx->poll_entry;
+
+	if (!entry || entry->set != set) {
+		return -ENOENT;
+	}
+
+	entry->events = events;
+
+	if (pollset_revents(entry)) {
+		pollset_mark_ready(entry);
+	}
+
+	return 0;
+}
+
+static int pollset_del(struct zsock_pollset *set, struct net_context *ctx)
+{
+	struct zsock_pollset_entry *entry = ctx->poll_entry;
+
+	if (!entry || entry->set != set) {
+		return -ENOENT;
+	}
+
+	pollset_entry_release(entry);
+
+	return 0;
+}
+
+int _impl_zsock_pollset_ctl(int pset, int op, int sock, int events)
+{
+	struct zsock_pollset *set;
+	struct net_context *ctx;
+	int ret;
+
+	set = z_get_fd_obj(pset, &pollset_fd_op_vtable, EINVAL);
+	if (set == NULL) {
+		return -1;
+	}
+
+	/* Only native sockets are able to signal a poll set */
+	ctx = z_get_fd_obj(sock, (const struct fd_op_vtable *)
+			   &sock_fd_op_vtable, EOPNOTSUPP);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	/* The events are stored as short, like in struct zsock_pollfd */
+	if (op != ZSOCK_POLLSET_DEL &&
+	    (events & ~(ZSOCK_POLLIN | ZSOCK_POLLOUT)) != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	k_mutex_lock(&set->lock, K_FOREVER);
+
+	switch (op) {
+	case ZSOCK_POLLSET_ADD:
+		ret = pollset_add(set, ctx, sock, events);
+		break;
+	case ZSOCK_POLLSET_MOD:
+		ret = pollset_mod(set, ctx, events);
+		break;
+	case ZSOCK_POLLSET_DEL:
+		ret = pollset_del(set, ctx);
+		break;
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&set->lock);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_pollset_ctl, pset, op, sock, events)
+{
+	return _impl_zsock_pollset_ctl(pset, op, sock, events);
+}
+#endif /* CONFIG_USERSPACE */
+
+/* Walk only the entries flagged as ready. An entry which turns out to have
+ * no pending events is unflagged. Readiness is checked again after clearing
+ * the flag, so that a notification racing with this walk is not lost.
+ */
+static int pollset_collect(struct zsock_pollset *set,
+			   struct zsock_pollfd *ready, int max_ready)
+{
+	int count = 0;
+	int word;
+
+	for (word = 0; word < POLLSET_WORDS; word++) {
+		atomic_val_t pending = atomic_get(&set->ready[word]);
+
+		while (pending && count < max_ready) {
+			struct zsock_pollset_entry *entry;
+			int bit = find_lsb_set(pending) - 1;
+			int idx = word * POLLSET_WORD_BITS + bit;
+			short revents;
+
+			pending &= ~BIT(bit);
+			entry = &set->entries[idx];
+
+			if (!entry->ctx) {
+				atomic_clear_bit(set->ready, idx);
+				continue;
+			}
+
+			revents = pollset_revents(entry);
+			if (!revents) {
+				atomic_clear_bit(set->ready, idx);
+
+				revents = pollset_revents(entry);
+				if (!revents) {
+					continue;
+				}
+
+				atomic_set_bit(set->ready, idx);
+			}
+
+			ready[count].fd = entry->fd;
+			ready[count].events = entry->events;
+			ready[count].revents = revents;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static inline int time_left(u32_t start, u32_t timeout)
+{
+	u32_t elapsed = k_uptime_get_32() - start;
+
+	return timeout - elapsed;
+}
+
+int _impl_zsock_pollset_wait(int pset, struct zsock_pollfd *ready,
+			     int max_ready, int timeout)
+{
+	struct zsock_pollset *set;
+	struct k_poll_event event;
+	u32_t entry_time = k_uptime_get_32();
+	int remaining_time;
+	int count;
+	int ret;
+
+	set = z_get_fd_obj(pset, &pollset_fd_op_vtable, EINVAL);
+	if (set == NULL) {
+		return -1;
+	}
+
+	if (max_ready <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		timeout = K_FOREVER;
+	}
+
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY,
+			  &set->signal);
+
+	remaining_time = timeout;
+
+	while (true) {
+		/* Reset the signal before looking at the flags, any socket
+		 * becoming ready from now on will raise it again.
+		 */
+		k_poll_signal_reset(&set->signal);
+
+		k_mutex_lock(&set->lock, K_FOREVER);
+		count = pollset_collect(set, ready, max_ready);
+		k_mutex_unlock(&set->lock);
+
+		if (count > 0 || timeout == K_NO_WAIT) {
+			return count;
+		}
+
+		if (timeout != K_FOREVER) {
+			remaining_time = time_left(entry_time, timeout);
+			if (remaining_time <= 0) {
+				return 0;
+			}
+		}
+
+		event.state = K_POLL_STATE_NOT_READY;
+
+		ret = k_poll(&event, 1, remaining_time);
+		if (ret == -EAGAIN) {
+			return 0;
+		}
+
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(zsock_pollset_wait, pset, ready, max_ready, timeout)
+{
+	struct zsock_pollfd *ready_copy;
+	unsigned int ready_size;
+	int ret;
+
+	if (__builtin_umul_overflow(max_ready, sizeof(struct zsock_pollfd),
+				    &ready_size)) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(ready, ready_size));
+
+	ready_copy = z_user_alloc_from_copy((void *)ready, ready_size);
+	if (!ready_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	ret = _impl_zsock_pollset_wait(pset, ready_copy, max_ready, timeout);
+
+	if (ret > 0) {
+		z_user_to_copy((void *)ready, ready_copy,
+			       ret * sizeof(struct zsock_pollfd));
+	}
+	k_free(ready_copy);
+
+	return ret;
+}
+#endif /* CONFIG_USERSPACE */
+
+static int pollset_close(struct zsock_pollset *set)
+{
+	int i;
+
+	k_mutex_lock(&set->lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(set->entries); i++) {
+		if (set->entries[i].ctx) {
+			pollset_entry_release(&set->entries[i]);
+		}
+	}
+
+	k_mutex_unlock(&set->lock);
+
+	k_mutex_lock(&pollsets_lock, K_FOREVER);
+	set->in_use = false;
+	k_mutex_unlock(&pollsets_lock);
+
+	return 0;
+}
+
+static ssize_t pollset_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t pollset_write_vmeth(void *obj, const void *buffer,
+				   size_t count)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static int pollset_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_CLOSE:
+		return pollset_close(obj);
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static const struct fd_op_vtable pollset_fd_op_vtable = {
+	.read = pollset_read_vmeth,
+	.write = pollset_write_vmeth,
+	.ioctl = pollset_ioctl_vmeth,
+};
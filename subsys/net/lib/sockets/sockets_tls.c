@@ -137,6 +137,9 @@ struct tls_context {
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
 #endif /* CONFIG_MBEDTLS */
+
+	/** Buffer gathering the short buffers of a sendmsg() in a record. */
+	u8_t sendmsg_buf[CONFIG_NET_SOCKETS_TLS_SENDMSG_BUF_SIZE];
 };
 
 static mbedtls_ctr_drbg_context tls_ctr_drbg;
@@ -1447,6 +1450,103 @@ ssize_t ztls_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 }
 
+/* Largest record payload gathered, bounded by the negotiated fragment size */
+static size_t sendmsg_record_len(struct net_context *ctx)
+{
+	size_t len = sizeof(ctx->tls->sendmsg_buf);
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+	len = min(len, mbedtls_ssl_get_max_frag_len(&ctx->tls->ssl));
+#endif
+
+	return len;
+}
+
+/* Copies up to len bytes of the message, from buffer i at offset on */
+static size_t sendmsg_gather(const struct msghdr *msg, size_t i,
+			     size_t offset, u8_t *buf, size_t len)
+{
+	size_t pos = 0;
+	size_t size;
+
+	for (; i < msg->msg_iovlen && pos < len; i++, offset = 0) {
+		size = min(msg->msg_iov[i].iov_len - offset, len - pos);
+		memcpy(&buf[pos], (u8_t *)msg->msg_iov[i].iov_base + offset,
+		       size);
+		pos += size;
+	}
+
+	return pos;
+}
+
+ssize_t ztls_sendmsg_ctx(struct net_context *ctx, const struct msghdr *msg,
+			 int flags)
+{
+	ssize_t len = 0;
+	ssize_t ret;
+	size_t record;
+	size_t offset = 0;
+	size_t size;
+	size_t i = 0;
+
+	if (ctx->tls == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/* Larger messages are sent in several records, which would split a
+	 * DTLS datagram.
+	 */
+	if (net_context_get_type(ctx) != SOCK_STREAM) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	ctx->tls->flags = flags;
+	record = sendmsg_record_len(ctx);
+
+	while (i < msg->msg_iovlen) {
+		size = msg->msg_iov[i].iov_len - offset;
+		if (size == 0) {
+			i++;
+			offset = 0;
+			continue;
+		}
+
+		if (size >= record) {
+			/* Whole records are encrypted from the caller buffer */
+			ret = send_tls(ctx,
+				       (u8_t *)msg->msg_iov[i].iov_base + offset,
+				       size, flags);
+		} else {
+			/* Shorter data shares a record with the next buffers */
+			size = sendmsg_gather(msg, i, offset,
+					      ctx->tls->sendmsg_buf, record);
+			ret = send_tls(ctx, ctx->tls->sendmsg_buf, size, flags);
+		}
+
+		if (ret < 0) {
+			/* Report the data already written */
+			return len > 0 ? len : ret;
+		}
+
+		len += ret;
+
+		/* Skip the data written, which may end within a buffer */
+		while (ret > 0) {
+			size = min(msg->msg_iov[i].iov_len - offset, ret);
+			offset += size;
+			ret -= size;
+			if (offset == msg->msg_iov[i].iov_len) {
+				i++;
+				offset = 0;
+			}
+		}
+	}
+
+	return len;
+}
+
 static ssize_t recv_tls(struct net_context *ctx, void *buf,
 			size_t max_len, int flags)
 {
@@ -1921,6 +2021,12 @@ static ssize_t tls_sock_sendto_vmeth(void *obj, const void *buf, size_t len,
 	return ztls_sendto_ctx(obj, buf, len, flags, dest_addr, addrlen);
 }
 
+static ssize_t tls_sock_sendmsg_vmeth(void *obj, const struct msghdr *msg,
+				      int flags)
+{
+	return ztls_sendmsg_ctx(obj, msg, flags);
+}
+
 static ssize_t tls_sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				       int flags, struct sockaddr *src_addr,
 				       socklen_t *addrlen)
@@ -1953,6 +2059,7 @@ static const struct socket_op_vtable tls_sock_fd_op_vtable = {
 	.listen = tls_sock_listen_vmeth,
 	.accept = tls_sock_accept_vmeth,
 	.sendto = tls_sock_sendto_vmeth,
+	.sendmsg = tls_sock_sendmsg_vmeth,
 	.recvfrom = tls_sock_recvfrom_vmeth,
 	.getsockopt = tls_sock_getsockopt_vmeth,
 	.setsockopt = tls_sock_setsockopt_vmeth,
@@ -31,6 +31,14 @@ static const char core_devices[NUM_CORE_DEVICES][MAX_DEV_NAME_LEN] = {
 	"sys_clock",
 	"UART_0",
 };
+#elif defined(CONFIG_SOC_FAMILY_STM32)
+#define MAX_PM_DEVICES	15
+#define NUM_CORE_DEVICES	2
+#define MAX_DEV_NAME_LEN	16
+static const char core_devices[NUM_CORE_DEVICES][MAX_DEV_NAME_LEN] = {
+	"stm32-cc",
+	"sys_clock",
+};
 #else
 #error "Add SoC's core devices list for PM"
 #endif
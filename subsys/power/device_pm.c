@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <kernel.h>
+#include <device.h>
+#include <init.h>
+#include <atomic.h>
+
+/* Whether the system workqueue runs the deferred transitions */
+static bool device_pm_started;
+
+/*
+ * Transitions run in the caller thread for the synchronous calls, and in
+ * the system workqueue otherwise. An ISR does not wait for the transition
+ * in progress, if any.
+ */
+static int device_pm_lock(struct device_pm *pm)
+{
+	return k_sem_take(&pm->lock, k_is_in_isr() ? K_NO_WAIT : K_FOREVER);
+}
+
+static void device_pm_unlock(struct device_pm *pm)
+{
+	k_sem_give(&pm->lock);
+}
+
+/* Brings the device to the state required by its usage, with the lock held */
+static int device_pm_update(struct device_pm *pm)
+{
+	u32_t state = (atomic_get(&pm->usage) > 0) ? DEVICE_PM_ACTIVE_STATE :
+			DEVICE_PM_SUSPEND_STATE;
+	int ret;
+
+	if (!pm->enable || state == pm->state) {
+		return 0;
+	}
+
+	ret = device_set_power_state(pm->dev, state);
+	if (ret == 0) {
+		pm->state = state;
+	}
+
+	return ret;
+}
+
+static int device_pm_update_sync(struct device_pm *pm)
+{
+	int ret;
+
+	ret = device_pm_lock(pm);
+	if (ret) {
+		return -EBUSY;
+	}
+
+	ret = device_pm_update(pm);
+	device_pm_unlock(pm);
+
+	return ret;
+}
+
+static void device_pm_work_handler(struct k_work *work)
+{
+	struct device_pm *pm = CONTAINER_OF(work, struct device_pm, work.work);
+	int ret;
+
+	ret = device_pm_update_sync(pm);
+	(void)k_poll_signal_raise(&pm->signal, ret);
+}
+
+void device_pm_enable(struct device *dev)
+{
+	struct device_pm *pm = dev->config->pm;
+
+	pm->dev = dev;
+	pm->autosuspend_delay = CONFIG_DEVICE_IDLE_PM_AUTOSUSPEND_DELAY;
+	pm->state = DEVICE_PM_ACTIVE_STATE;
+	atomic_set(&pm->usage, 0);
+	k_sem_init(&pm->lock, 1, 1);
+	k_poll_signal_init(&pm->signal);
+	k_delayed_work_init(&pm->work, device_pm_work_handler);
+
+	pm->enable = true;
+
+	/* Suspended at startup otherwise */
+	if (device_pm_started) {
+		(void)k_delayed_work_submit(&pm->work, pm->autosuspend_delay);
+	}
+}
+
+void device_pm_disable(struct device *dev)
+{
+	struct device_pm *pm = dev->config->pm;
+
+	if (!pm->enable) {
+		return;
+	}
+
+	(void)k_delayed_work_cancel(&pm->work);
+
+	/* Hold the device active for good */
+	atomic_inc(&pm->usage);
+	(void)device_pm_update_sync(pm);
+	pm->enable = false;
+}
+
+void device_pm_autosuspend_delay_set(struct device *dev, s32_t delay)
+{
+	dev->config->pm->autosuspend_delay = delay;
+}
+
+int device_pm_get(struct device *dev)
+{
+	struct device_pm *pm = dev->config->pm;
+
+	if (!pm->enable) {
+		return 0;
+	}
+
+	atomic_inc(&pm->usage);
+
+	/* This also cancels the suspend pending, if any */
+	return k_delayed_work_submit(&pm->work, K_NO_WAIT);
+}
+
+int device_pm_get_sync(struct device *dev)
+{
+	struct device_pm *pm = dev->config->pm;
+	int ret;
+
+	if (!pm->enable) {
+		return 0;
+	}
+
+	atomic_inc(&pm->usage);
+
+	ret = device_pm_update_sync(pm);
+	if (ret) {
+		atomic_dec(&pm->usage);
+	}
+
+	return ret;
+}
+
+int device_pm_put(struct device *dev)
+{
+	struct device_pm *pm = dev->config->pm;
+
+	if (!pm->enable) {
+		return 0;
+	}
+
+	__ASSERT(atomic_get(&pm->usage) > 0, "Device usage count underflowed!");
+
+	if (atomic_dec(&pm->usage) > 1 || pm->autosuspend_delay == K_FOREVER ||
+	    !device_pm_started) {
+		return 0;
+	}
+
+	return k_delayed_work_submit(&pm->work, pm->autosuspend_delay);
+}
+
+int device_pm_put_sync(struct device *dev)
+{
+	struct device_pm *pm = dev->config->pm;
+
+	if (!pm->enable) {
+		return 0;
+	}
+
+	__ASSERT(atomic_get(&pm->usage) > 0, "Device usage count underflowed!");
+
+	if (atomic_dec(&pm->usage) > 1) {
+		return 0;
+	}
+
+	return device_pm_update_sync(pm);
+}
+
+/*
+ * Devices enabled during the early init levels are used before the system
+ * workqueue and the system timer are up: suspend those which are unused
+ * from then on.
+ */
+static int device_pm_start(struct device *unused)
+{
+	struct device *devices;
+	struct device_pm *pm;
+	int count;
+	int i;
+
+	ARG_UNUSED(unused);
+
+	device_list_get(&devices, &count);
+
+	for (i = 0; i < count; i++) {
+		pm = devices[i].config->pm;
+		if (pm->enable && atomic_get(&pm->usage) == 0 &&
+		    pm->autosuspend_delay != K_FOREVER) {
+			(void)k_delayed_work_submit(&pm->work,
+						    pm->autosuspend_delay);
+		}
+	}
+
+	device_pm_started = true;
+
+	return 0;
+}
+
+SYS_INIT(device_pm_start, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE);
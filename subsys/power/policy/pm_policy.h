@@ -39,6 +39,11 @@ extern void sys_pm_resume_devices(void);
  */
 extern enum power_states sys_pm_policy_next_state(s32_t ticks);
 
+/**
+ * @brief Function to notify the PM policy of the exit from a PM state
+ */
+extern void sys_pm_policy_state_exit(enum power_states state);
+
 /**
  * @brief Application defined function for Lower Power entry
  *
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <kernel.h>
+#include <init.h>
+#include <soc.h>
+#include <stats.h>
+#include "pm_policy.h"
+
+#define LOG_LEVEL CONFIG_PM_LOG_LEVEL /* From power module Kconfig */
+#include <logging/log.h>
+LOG_MODULE_DECLARE(power);
+
+/* Weight of a new latency sample, as a power of two */
+#define LATENCY_WEIGHT_SHIFT	3
+
+#define TICKS_TO_US(t) \
+	((u64_t)(t) * USEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+
+#define TICK_US		((u32_t)TICKS_TO_US(1))
+
+struct pm_state_info {
+	const char *name;
+	/* Power drawn in the state, in uW */
+	u32_t power;
+};
+
+static const struct pm_state_info pm_states[SYS_POWER_STATE_MAX] = {
+#ifdef CONFIG_SYS_POWER_LOW_POWER_STATES
+# ifdef CONFIG_SYS_POWER_STATE_CPU_LPS_SUPPORTED
+	[SYS_POWER_STATE_CPU_LPS] = { "pm_lps", CONFIG_PM_LPS_POWER },
+# endif
+# ifdef CONFIG_SYS_POWER_STATE_CPU_LPS_1_SUPPORTED
+	[SYS_POWER_STATE_CPU_LPS_1] = { "pm_lps_1", CONFIG_PM_LPS_1_POWER },
+# endif
+# ifdef CONFIG_SYS_POWER_STATE_CPU_LPS_2_SUPPORTED
+	[SYS_POWER_STATE_CPU_LPS_2] = { "pm_lps_2", CONFIG_PM_LPS_2_POWER },
+# endif
+#endif /* CONFIG_SYS_POWER_LOW_POWER_STATES */
+
+#ifdef CONFIG_SYS_POWER_DEEP_SLEEP_STATES
+# ifdef CONFIG_SYS_POWER_STATE_DEEP_SLEEP_SUPPORTED
+	[SYS_POWER_STATE_DEEP_SLEEP] = {
+		"pm_deep_sleep", CONFIG_PM_DEEP_SLEEP_POWER
+	},
+# endif
+# ifdef CONFIG_SYS_POWER_STATE_DEEP_SLEEP_1_SUPPORTED
+	[SYS_POWER_STATE_DEEP_SLEEP_1] = {
+		"pm_deep_sleep_1", CONFIG_PM_DEEP_SLEEP_1_POWER
+	},
+# endif
+# ifdef CONFIG_SYS_POWER_STATE_DEEP_SLEEP_2_SUPPORTED
+	[SYS_POWER_STATE_DEEP_SLEEP_2] = {
+		"pm_deep_sleep_2", CONFIG_PM_DEEP_SLEEP_2_POWER
+	},
+# endif
+#endif /* CONFIG_SYS_POWER_DEEP_SLEEP_STATES */
+};
+
+struct pm_state_data {
+	/* Wakeup latency learned, in us */
+	u32_t latency;
+	/* Shortest time worth spending in the state, in us */
+	u32_t break_even;
+	/* Time spent in the state, in us */
+	u64_t residency;
+	u32_t count;
+	u32_t early;
+};
+
+static struct pm_state_data pm_data[SYS_POWER_STATE_MAX];
+
+/* State entered, its entry time in cycles and timeout in us */
+static enum power_states entered = SYS_POWER_STATE_ACTIVE;
+static u32_t entry_cycles;
+static u32_t entry_timeout;
+
+#ifdef CONFIG_STATS
+STATS_SECT_START(pm_state)
+STATS_SECT_ENTRY(count)
+STATS_SECT_ENTRY(early)
+STATS_SECT_ENTRY(latency)
+STATS_SECT_ENTRY(break_even)
+STATS_SECT_ENTRY(residency)
+STATS_SECT_END;
+
+STATS_NAME_START(pm_state)
+STATS_NAME(pm_state, count)
+STATS_NAME(pm_state, early)
+STATS_NAME(pm_state, latency)
+STATS_NAME(pm_state, break_even)
+STATS_NAME(pm_state, residency)
+STATS_NAME_END(pm_state);
+
+static STATS_SECT_DECL(pm_state) pm_stats[SYS_POWER_STATE_MAX];
+
+static void pm_stats_update(enum power_states state)
+{
+	struct pm_state_data *data = &pm_data[state];
+
+	pm_stats[state].count = data->count;
+	pm_stats[state].early = data->early;
+	pm_stats[state].latency = data->latency;
+	pm_stats[state].break_even = data->break_even;
+	pm_stats[state].residency = data->residency / USEC_PER_MSEC;
+}
+
+static void pm_stats_register(enum power_states state)
+{
+	(void)stats_init_and_reg(&pm_stats[state].s_hdr,
+				 STATS_SIZE_INIT_PARMS(pm_stats[state],
+						       STATS_SIZE_32),
+				 STATS_NAME_INIT_PARMS(pm_state),
+				 pm_states[state].name);
+}
+#else
+static inline void pm_stats_update(enum power_states state) { }
+static inline void pm_stats_register(enum power_states state) { }
+#endif /* CONFIG_STATS */
+
+/*
+ * Leaving the state costs the latency at the active power, while staying
+ * in the shallower state instead would have cost its power all along:
+ * the state is worth entering for t such that
+ * latency * active + (t - latency) * power <= t * shallower power.
+ */
+static void pm_break_even_update(enum power_states state)
+{
+	u32_t shallower = (state == 0) ? CONFIG_PM_IDLE_POWER :
+			  pm_states[state - 1].power;
+	u32_t power = pm_states[state].power;
+	u64_t t;
+
+	if (shallower <= power) {
+		pm_data[state].break_even = UINT32_MAX;
+		return;
+	}
+
+	t = (u64_t)pm_data[state].latency * (CONFIG_PM_ACTIVE_POWER - power) /
+	    (shallower - power);
+	pm_data[state].break_even = max(t, pm_data[state].latency);
+}
+
+enum power_states sys_pm_policy_next_state(s32_t ticks)
+{
+	u32_t timeout = (ticks == K_FOREVER) ? UINT32_MAX :
+			(u32_t)min(TICKS_TO_US(ticks), UINT32_MAX - 1);
+	int i;
+
+	entered = SYS_POWER_STATE_ACTIVE;
+
+	for (i = SYS_POWER_STATE_MAX - 1; i >= 0; i--) {
+#ifdef CONFIG_PM_CONTROL_STATE_LOCK
+		if (!sys_pm_ctrl_is_state_enabled((enum power_states)(i))) {
+			continue;
+		}
+#endif
+		/*
+		 * Deep sleep states lose the system context: on STM32L0/L4,
+		 * the exit from Standby is a reset. They are only entered
+		 * automatically when the application opts in.
+		 */
+		if (!IS_ENABLED(CONFIG_PM_POLICY_ADAPTIVE_DEEP_SLEEP) &&
+		    sys_pm_is_deep_sleep_state((enum power_states)(i))) {
+			continue;
+		}
+
+		if ((ticks == K_FOREVER) ||
+		    (timeout >= pm_data[i].break_even)) {
+			LOG_DBG("Selected power state %d "
+				"(ticks: %d, break-even: %u us)",
+				i, ticks, pm_data[i].break_even);
+
+			entered = (enum power_states)(i);
+			entry_cycles = k_cycle_get_32();
+			entry_timeout = timeout;
+
+			return entered;
+		}
+	}
+
+	LOG_DBG("No suitable power state found!");
+	return SYS_POWER_STATE_ACTIVE;
+}
+
+void sys_pm_policy_state_exit(enum power_states state)
+{
+	struct pm_state_data *data = &pm_data[state];
+	u32_t slept;
+	s32_t sample;
+
+	/* Forced states are not accounted */
+	if (state != entered) {
+		return;
+	}
+
+	entered = SYS_POWER_STATE_ACTIVE;
+	slept = SYS_CLOCK_HW_CYCLES_TO_NS64(k_cycle_get_32() - entry_cycles) /
+		NSEC_PER_USEC;
+
+	data->count++;
+	data->residency += slept;
+
+	/*
+	 * The timeout counts from the last tick announced, before the state
+	 * was chosen: waking up on time is up to one tick earlier than the
+	 * timeout, half a tick on average. Waking up earlier still, or
+	 * without timeout, is due to another event, which tells nothing
+	 * about the latency.
+	 */
+	if ((u64_t)slept + TICK_US < entry_timeout) {
+		data->early++;
+	} else if (entry_timeout != UINT32_MAX) {
+		sample = max((s32_t)(slept + TICK_US / 2 - entry_timeout), 0);
+		data->latency += (sample - (s32_t)data->latency) >>
+				 LATENCY_WEIGHT_SHIFT;
+		pm_break_even_update(state);
+	}
+
+	pm_stats_update(state);
+}
+
+static int pm_policy_adaptive_init(struct device *dev)
+{
+	int i;
+
+	ARG_UNUSED(dev);
+
+	for (i = 0; i < SYS_POWER_STATE_MAX; i++) {
+		pm_data[i].latency = CONFIG_PM_POLICY_ADAPTIVE_LATENCY;
+		pm_break_even_update((enum power_states)(i));
+		pm_stats_update((enum power_states)(i));
+		pm_stats_register((enum power_states)(i));
+	}
+
+	return 0;
+}
+
+SYS_INIT(pm_policy_adaptive_init, APPLICATION,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -64,6 +64,15 @@ static void sys_pm_log_debug_info(enum power_states state) { }
 void sys_pm_dump_debug_info(void) { }
 #endif
 
+#ifdef CONFIG_PM_POLICY_ADAPTIVE
+static inline void sys_pm_policy_exit(enum power_states state)
+{
+	sys_pm_policy_state_exit(state);
+}
+#else
+static inline void sys_pm_policy_exit(enum power_states state) { }
+#endif
+
 __weak void sys_pm_notify_lps_entry(enum power_states state)
 {
 	/* This function can be overridden by the application. */
@@ -132,6 +141,7 @@ enum power_states sys_suspend(s32_t ticks)
 		post_ops_done = 1;
 		sys_pm_notify_lps_exit(pm_state);
 		sys_power_state_post_ops(pm_state);
+		sys_pm_policy_exit(pm_state);
 	}
 
 	return pm_state;
@@ -158,6 +168,7 @@ void sys_resume(void)
 		post_ops_done = 1;
 		sys_pm_notify_lps_exit(pm_state);
 		sys_power_state_post_ops(pm_state);
+		sys_pm_policy_exit(pm_state);
 	}
 }
 
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_LEVEL CONFIG_SENSING_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_REGISTER(sensing);
+
+#include <kernel.h>
+#include <init.h>
+#include <errno.h>
+#include <string.h>
+#include <spinlock.h>
+#include <misc/util.h>
+#include <sensing/sensing.h>
+
+#define RING_MASK	(CONFIG_SENSING_RING_SIZE - 1)
+
+BUILD_ASSERT_MSG((CONFIG_SENSING_RING_SIZE & RING_MASK) == 0,
+		 "CONFIG_SENSING_RING_SIZE must be a power of two");
+
+/* The lists are only changed and walked with the lock held */
+static sys_slist_t sensors;
+static sys_slist_t subscribers;
+static K_MUTEX_DEFINE(lock);
+
+/* Samples, the subscribers read them behind the head */
+static struct sensing_sample ring[CONFIG_SENSING_RING_SIZE];
+static u32_t ring_head;
+static struct k_spinlock ring_lock;
+
+static K_SEM_DEFINE(wakeup, 0, 1);
+static K_THREAD_STACK_DEFINE(sensing_stack, CONFIG_SENSING_THREAD_STACK_SIZE);
+static struct k_thread sensing_thread_data;
+
+static void sensing_timer_expiry(struct k_timer *timer)
+{
+	k_sem_give(&wakeup);
+}
+
+static K_TIMER_DEFINE(sensing_timer, sensing_timer_expiry, NULL);
+
+static bool sensing_wanted(const struct sensing_subscriber *sub,
+			   const struct sensing_sample *sample)
+{
+	if (sub->sensor && sub->sensor != sample->sensor) {
+		return false;
+	}
+
+	return (sample->seq % sub->divider) == 0;
+}
+
+static void sensing_put(const struct sensing_sample *sample)
+{
+	struct sensing_subscriber *sub;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ring_lock);
+	ring[ring_head & RING_MASK] = *sample;
+	ring_head++;
+	k_spin_unlock(&ring_lock, key);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&subscribers, sub, node) {
+		if (sensing_wanted(sub, sample)) {
+			k_sem_give(&sub->sem);
+		}
+	}
+}
+
+static void sensing_fetch(struct sensing_sensor *sensor)
+{
+	struct sensing_sample sample;
+	u8_t i;
+
+	if (sensor_sample_fetch(sensor->dev) < 0) {
+		LOG_DBG("Failed to fetch %s", sensor->dev->config->name);
+		sensor->errors++;
+		return;
+	}
+
+	(void)memset(&sample, 0, sizeof(sample));
+	sample.timestamp = (u32_t)(k_uptime_get() * USEC_PER_MSEC);
+	sample.seq = sensor->seq++;
+	sample.sensor = sensor;
+
+	for (i = 0U; i < sensor->num_chans; i++) {
+		sample.chan = sensor->chans[i];
+		if (sensor_channel_get(sensor->dev, sample.chan,
+				       sample.val) < 0) {
+			LOG_DBG("Failed to read channel %d of %s", sample.chan,
+				sensor->dev->config->name);
+			sensor->errors++;
+			continue;
+		}
+
+		sensing_put(&sample);
+	}
+}
+
+/* Fetch the sensors due, returns the time until the next one is due */
+static s32_t sensing_run(void)
+{
+	struct sensing_sensor *sensor;
+	u32_t now = k_uptime_get_32();
+	u32_t next = 0U;
+	bool idle = true;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	/* the sensors on a bus are next to each other in the list */
+	SYS_SLIST_FOR_EACH_CONTAINER(&sensors, sensor, node) {
+		if ((s32_t)(sensor->next - now) <= CONFIG_SENSING_COALESCE_MS) {
+			sensing_fetch(sensor);
+
+			/* skip the periods missed rather than catch up */
+			sensor->next += sensor->period;
+			if ((s32_t)(sensor->next - now) <= 0) {
+				sensor->next = now + sensor->period;
+			}
+		}
+
+		if (idle || (s32_t)(sensor->next - next) < 0) {
+			next = sensor->next;
+			idle = false;
+		}
+	}
+
+	k_mutex_unlock(&lock);
+
+	if (idle) {
+		return K_FOREVER;
+	}
+
+	return max((s32_t)(next - k_uptime_get_32()), 0);
+}
+
+static void sensing_thread(void)
+{
+	s32_t wait;
+
+	while (true) {
+		k_sem_take(&wakeup, K_FOREVER);
+
+		wait = sensing_run();
+		if (wait == K_FOREVER) {
+			k_timer_stop(&sensing_timer);
+		} else if (wait == 0) {
+			k_sem_give(&wakeup);
+		} else {
+			k_timer_start(&sensing_timer, wait, 0);
+		}
+	}
+}
+
+int sensing_sensor_add(struct sensing_sensor *sensor)
+{
+	struct sensing_sensor *other;
+	struct sensing_sensor *prev = NULL;
+	u32_t next = k_uptime_get_32();
+	bool first = true;
+
+	if (!sensor->dev || !sensor->chans || !sensor->num_chans ||
+	    !sensor->period) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&sensors, other, node) {
+		if (sensor->bus && other->bus == sensor->bus) {
+			prev = other;
+		}
+
+		if (first || (s32_t)(other->next - next) < 0) {
+			next = other->next;
+			first = false;
+		}
+	}
+
+	sensor->next = next;
+	sensor->seq = 0U;
+	sensor->errors = 0U;
+
+	if (prev) {
+		sys_slist_insert(&sensors, &prev->node, &sensor->node);
+	} else {
+		sys_slist_append(&sensors, &sensor->node);
+	}
+
+	k_mutex_unlock(&lock);
+
+	k_sem_give(&wakeup);
+
+	return 0;
+}
+
+int sensing_sensor_remove(struct sensing_sensor *sensor)
+{
+	struct sensing_subscriber *sub;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	/* a subscriber would wait for its samples forever */
+	SYS_SLIST_FOR_EACH_CONTAINER(&subscribers, sub, node) {
+		if (sub->sensor == sensor) {
+			k_mutex_unlock(&lock);
+			return -EBUSY;
+		}
+	}
+
+	sys_slist_find_and_remove(&sensors, &sensor->node);
+
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int sensing_subscribe(struct sensing_subscriber *sub)
+{
+	k_spinlock_key_t key;
+
+	sub->divider = 1U;
+	if (sub->sensor && sub->period) {
+		if (sub->period < sub->sensor->period) {
+			return -EINVAL;
+		}
+
+		sub->divider = (sub->period + sub->sensor->period / 2U) /
+			       sub->sensor->period;
+	}
+
+	sub->lost = 0U;
+	k_sem_init(&sub->sem, 0, 1);
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	key = k_spin_lock(&ring_lock);
+	sub->tail = ring_head;
+	k_spin_unlock(&ring_lock, key);
+
+	sys_slist_append(&subscribers, &sub->node);
+
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+void sensing_unsubscribe(struct sensing_subscriber *sub)
+{
+	k_mutex_lock(&lock, K_FOREVER);
+	sys_slist_find_and_remove(&subscribers, &sub->node);
+	k_mutex_unlock(&lock);
+}
+
+int sensing_read(struct sensing_subscriber *sub,
+		 struct sensing_sample *sample, s32_t timeout)
+{
+	const struct sensing_sample *slot;
+	k_spinlock_key_t key;
+
+	while (true) {
+		key = k_spin_lock(&ring_lock);
+
+		if (ring_head - sub->tail > CONFIG_SENSING_RING_SIZE) {
+			sub->lost += ring_head - sub->tail -
+				     CONFIG_SENSING_RING_SIZE;
+			sub->tail = ring_head - CONFIG_SENSING_RING_SIZE;
+		}
+
+		while (sub->tail != ring_head) {
+			slot = &ring[sub->tail & RING_MASK];
+			sub->tail++;
+
+			if (sensing_wanted(sub, slot)) {
+				*sample = *slot;
+				k_spin_unlock(&ring_lock, key);
+				return 0;
+			}
+		}
+
+		k_spin_unlock(&ring_lock, key);
+
+		if (k_sem_take(&sub->sem, timeout) < 0) {
+			return -EAGAIN;
+		}
+	}
+}
+
+static int sensing_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_thread_create(&sensing_thread_data, sensing_stack,
+			K_THREAD_STACK_SIZEOF(sensing_stack),
+			(k_thread_entry_t)sensing_thread, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(CONFIG_SENSING_THREAD_PRIORITY), 0, 0);
+	k_thread_name_set(&sensing_thread_data, "sensing");
+
+	return 0;
+}
+
+SYS_INIT(sensing_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
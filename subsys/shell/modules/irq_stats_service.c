@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <shell/shell.h>
+#include <stdlib.h>
+#include <debug/irq_stats.h>
+
+static void irq_stats_histogram_dump(const struct shell *shell,
+				     const char *name, const u32_t *histogram)
+{
+	int i;
+
+	shell_fprintf(shell, SHELL_NORMAL, "  %-9s", name);
+	for (i = 0; i < CONFIG_IRQ_STATS_BUCKETS; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " %8u", histogram[i]);
+	}
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+}
+
+static void irq_stats_dump(const struct shell *shell, unsigned int irq,
+			   const struct irq_stats *stats)
+{
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "IRQ %u: %u runs, latency max %u, duration max %u\n",
+		      irq, stats->count, stats->latency_max,
+		      stats->duration_max);
+	irq_stats_histogram_dump(shell, "latency", stats->latency);
+	irq_stats_histogram_dump(shell, "duration", stats->duration);
+}
+
+static int cmd_irq_stats_show(const struct shell *shell,
+			      size_t argc, char **argv)
+{
+	struct irq_stats stats;
+	unsigned int first = 0;
+	unsigned int last = CONFIG_NUM_IRQS - 1;
+	unsigned int irq;
+	int i;
+
+	if (argc > 1) {
+		first = strtoul(argv[1], NULL, 0);
+		last = first;
+		if (irq_stats_get(first, &stats) != 0) {
+			shell_error(shell, "Invalid IRQ %s", argv[1]);
+			return -EINVAL;
+		}
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Cycles at %u Hz, buckets below:\n",
+		      irq_stats_cycles_per_sec());
+	shell_fprintf(shell, SHELL_NORMAL, "  %-9s", "");
+	for (i = 0; i < CONFIG_IRQ_STATS_BUCKETS - 1; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " %8u",
+			      irq_stats_bucket_limit(i));
+	}
+	shell_fprintf(shell, SHELL_NORMAL, " %8s\n", "-");
+
+	/* Lines which never ran are only shown on request */
+	for (irq = first; irq <= last; irq++) {
+		(void)irq_stats_get(irq, &stats);
+		if (stats.count != 0 || argc > 1) {
+			irq_stats_dump(shell, irq, &stats);
+		}
+	}
+
+	return 0;
+}
+
+static int cmd_irq_stats_reset(const struct shell *shell,
+			       size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	irq_stats_reset();
+	shell_print(shell, "IRQ statistics reset");
+
+	return 0;
+}
+
+SHELL_CREATE_STATIC_SUBCMD_SET(sub_irq_stats)
+{
+	/* Alphabetically sorted. */
+	SHELL_CMD(reset, NULL, "Reset the statistics of all the IRQs.",
+		  cmd_irq_stats_reset),
+	SHELL_CMD_ARG(show, NULL,
+		      "Show the latency and duration histograms, in cycles.\n"
+		      "Usage: show [<irq>]",
+		      cmd_irq_stats_show, 1, 1),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+};
+
+SHELL_CMD_REGISTER(irq_stats, &sub_irq_stats, "IRQ statistics commands",
+		   NULL);
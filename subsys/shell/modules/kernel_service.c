@@ -13,6 +13,9 @@
 #include <misc/stack.h>
 #include <string.h>
 #include <device.h>
+#if defined(CONFIG_TRACING_CPU_STATS_THREADS)
+#include <tracing_cpu_stats.h>
+#endif
 
 static int cmd_kernel_version(const struct shell *shell,
 			      size_t argc, char **argv)
@@ -76,6 +79,15 @@ static void shell_tdata_dump(const struct k_thread *thread, void *user_data)
 		      "\toptions: 0x%x, priority: %d\n",
 		      thread->base.user_options,
 		      thread->base.prio);
+#if defined(CONFIG_TRACING_CPU_STATS_THREADS)
+	struct cpu_stats_thread stats;
+
+	cpu_stats_thread_get(thread, &stats);
+	shell_fprintf((const struct shell *)user_data, SHELL_NORMAL,
+		      "\truntime: %u ms, switches: %u\n",
+		      (u32_t)(stats.runtime / (NSEC_PER_USEC * USEC_PER_MSEC)),
+		      stats.switches);
+#endif
 	shell_fprintf((const struct shell *)user_data, SHELL_NORMAL,
 		"\tstack size %u, unused %u, usage %u / %u (%u %%)\n\n",
 		      size, unused, size - unused, size, pcnt);
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <zephyr/types.h>
+#include <kernel.h>
 #include <stats.h>
 
 #define STATS_GEN_NAME_MAX_LEN  (sizeof("s255"))
@@ -283,3 +284,136 @@ stats_reset(struct stats_hdr *hdr)
 {
 	(void)memset(hdr + 1, 0, hdr->s_size * hdr->s_cnt);
 }
+
+/* Longest LEB128 varint of a value of the given size, in bytes. */
+#define STATS_VARINT_MAX_LEN(size) (((size) * 8 + 6) / 7)
+
+#if CONFIG_STATS_SNAPSHOT_DELTA_ENTRIES > 0
+/* Values of the previous snapshot, the reference of the differences. */
+static u64_t stats_snapshot_prev[CONFIG_STATS_SNAPSHOT_DELTA_ENTRIES];
+#endif
+
+static u32_t stats_snapshot_seq;
+
+/* Serializes the snapshots, taken by the shell and by mcumgr. */
+static K_MUTEX_DEFINE(stats_snapshot_lock);
+
+static u64_t
+stats_get_value(const struct stats_hdr *hdr, int idx)
+{
+	const u8_t *val = (const u8_t *)hdr + stats_get_off(hdr, idx);
+
+	switch (hdr->s_size) {
+	case sizeof(u16_t):
+		return *(const u16_t *)val;
+	case sizeof(u32_t):
+		return *(const u32_t *)val;
+	default:
+		return *(const u64_t *)val;
+	}
+}
+
+static u8_t *
+stats_varint_put(u8_t *dst, u64_t value)
+{
+	while (value >= 0x80) {
+		*dst++ = (u8_t)value | 0x80;
+		value >>= 7;
+	}
+	*dst++ = (u8_t)value;
+
+	return dst;
+}
+
+/**
+ * Encodes the values of a group, the first of which is the entry of index
+ * entry among all the groups.
+ */
+static u8_t *
+stats_snapshot_group(struct stats_snapshot *snap, const struct stats_hdr *hdr,
+		     int entry, u8_t *dst)
+{
+	u64_t value;
+	int i;
+
+	for (i = 0; i < hdr->s_cnt; i++, entry++) {
+		value = stats_get_value(hdr, i);
+
+#if CONFIG_STATS_SNAPSHOT_DELTA_ENTRIES > 0
+		if (entry < CONFIG_STATS_SNAPSHOT_DELTA_ENTRIES) {
+			u64_t mask = UINT64_MAX >> (64 - 8 * hdr->s_size);
+			u64_t prev = stats_snapshot_prev[entry];
+
+			stats_snapshot_prev[entry] = value;
+			if (snap->delta) {
+				value = (value - prev) & mask;
+				snap->delta_cnt++;
+			}
+		}
+#endif
+
+		dst = stats_varint_put(dst, value);
+	}
+
+	return dst;
+}
+
+/**
+ * Encodes a snapshot of the values of the groups, from snap->start on.
+ * This function _DOES NOT_ lock the statistics list, and assumes that it is
+ * not being changed by another task.  The snapshots themselves are
+ * serialized, as each one becomes the reference of the next.
+ */
+int
+stats_snapshot_encode(struct stats_snapshot *snap, u8_t *buf, size_t *len)
+{
+	const struct stats_hdr *hdr;
+	u8_t *dst = buf;
+	u8_t *end = buf + *len;
+	int entry = 0;
+	int rc = 0;
+	int i = 0;
+
+	k_mutex_lock(&stats_snapshot_lock, K_FOREVER);
+
+	snap->next = -1;
+	snap->delta_cnt = 0;
+
+	for (hdr = stats_list; hdr != NULL; hdr = hdr->s_next, i++) {
+		if (i < snap->start || snap->next >= 0) {
+			entry += hdr->s_cnt;
+			continue;
+		}
+
+		/* Whole groups only, with their values at their longest. */
+		if (end - dst < hdr->s_cnt * STATS_VARINT_MAX_LEN(hdr->s_size)) {
+			if (i == snap->start) {
+				rc = -ENOMEM;
+				goto out;
+			}
+
+			snap->next = i;
+			continue;
+		}
+
+		dst = stats_snapshot_group(snap, hdr, entry, dst);
+		entry += hdr->s_cnt;
+	}
+
+	if (snap->start >= i) {
+		rc = -ENOENT;
+		goto out;
+	}
+
+	snap->groups = i;
+	if (snap->next < 0) {
+		snap->next = i;
+	}
+	snap->seq = ++stats_snapshot_seq;
+	*len = dst - buf;
+
+out:
+	k_mutex_unlock(&stats_snapshot_lock);
+
+	return rc;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <shell/shell.h>
+#include <string.h>
+#include <stats.h>
+
+/* Snapshot bytes per command output line */
+#define STATS_SHELL_LINE_LEN	32
+
+/* Snapshot bytes per page, a group at least */
+#define STATS_SHELL_PAGE_LEN	256
+
+static int stats_shell_field(struct stats_hdr *hdr, void *arg,
+			     const char *name, uint16_t off)
+{
+	ARG_UNUSED(hdr);
+	ARG_UNUSED(off);
+
+	shell_fprintf((const struct shell *)arg, SHELL_NORMAL, " %s", name);
+
+	return 0;
+}
+
+static int stats_shell_group(struct stats_hdr *hdr, void *arg)
+{
+	const struct shell *shell = arg;
+
+	shell_fprintf(shell, SHELL_NORMAL, "%s %u:", hdr->s_name, hdr->s_size);
+	(void)stats_walk(hdr, stats_shell_field, arg);
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+
+	return 0;
+}
+
+static int cmd_stats_schema(const struct shell *shell, size_t argc,
+			    char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	/* One line per group: name, entry size and field names */
+	(void)stats_group_walk(stats_shell_group, (void *)shell);
+
+	return 0;
+}
+
+static void stats_shell_hex(const struct shell *shell, const u8_t *data,
+			    size_t len)
+{
+	static const char hex[] = "0123456789abcdef";
+	char line[2 * STATS_SHELL_LINE_LEN + 1];
+	size_t i;
+	size_t j;
+
+	for (i = 0; i < len; i += j) {
+		for (j = 0; j < STATS_SHELL_LINE_LEN && i + j < len; j++) {
+			line[2 * j] = hex[data[i + j] >> 4];
+			line[2 * j + 1] = hex[data[i + j] & 0xf];
+		}
+		line[2 * j] = '\0';
+
+		shell_print(shell, "%s", line);
+	}
+}
+
+static int cmd_stats_snapshot(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	static u8_t page[STATS_SHELL_PAGE_LEN];
+	struct stats_snapshot snap = {
+		.delta = argc > 1 && strcmp(argv[1], "delta") == 0,
+	};
+	size_t len;
+	int err;
+
+	if (argc > 1 && !snap.delta) {
+		shell_error(shell, "Unknown encoding %s", argv[1]);
+		return -EINVAL;
+	}
+
+	do {
+		len = sizeof(page);
+		err = stats_snapshot_encode(&snap, page, &len);
+		if (err == -ENOENT) {
+			/* No groups */
+			return 0;
+		} else if (err != 0) {
+			shell_error(shell, "Group %d does not fit", snap.start);
+			return err;
+		}
+
+		/* Page header, then the LEB128 values in hexadecimal */
+		shell_print(shell, "seq %u groups %d-%d/%d delta %d",
+			    snap.seq, snap.start, snap.next - 1, snap.groups,
+			    snap.delta_cnt);
+		stats_shell_hex(shell, page, len);
+
+		snap.start = snap.next;
+	} while (snap.next < snap.groups);
+
+	return 0;
+}
+
+SHELL_CREATE_STATIC_SUBCMD_SET(sub_stats)
+{
+	/* Alphabetically sorted. */
+	SHELL_CMD(schema, NULL, "List the groups, entry sizes and fields",
+		  cmd_stats_schema),
+	SHELL_CMD_ARG(snapshot, NULL,
+		      "Dump the values in LEB128 varints, as hexadecimal\n"
+		      "Usage: snapshot [delta]",
+		      cmd_stats_snapshot, 1, 1),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+};
+
+SHELL_CMD_REGISTER(stats, &sub_stats, "Statistics commands", NULL);
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+#include <string.h>
+
+#include <net/coap.h>
+
+#define N_RUNS 10000
+
+#define BUF_SIZE 128
+
+/* LwM2M TLV content format */
+#define FORMAT_LWM2M_TLV 11542
+
+static const u8_t token[8] = { 0xde, 0xad, 0xbe, 0xef, 0x01, 0x02, 0x03, 0x04 };
+
+/* A single resource instance in TLV format */
+static const u8_t payload[] = {
+	0xe4, 0x16, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2a,
+};
+
+static u8_t tmpl_data[16];
+static u8_t data[BUF_SIZE];
+
+static struct coap_template tmpl;
+
+static int build_packet(struct coap_packet *cpkt, u16_t id, u32_t observe)
+{
+	int r;
+
+	r = coap_packet_init(cpkt, data, sizeof(data), 1, COAP_TYPE_CON,
+			     sizeof(token), (u8_t *)token,
+			     COAP_RESPONSE_CODE_CONTENT, id);
+	if (r < 0) {
+		return r;
+	}
+
+	r = coap_append_option_int(cpkt, COAP_OPTION_OBSERVE, observe);
+	if (r < 0) {
+		return r;
+	}
+
+	r = coap_append_option_int(cpkt, COAP_OPTION_CONTENT_FORMAT,
+				   FORMAT_LWM2M_TLV);
+	if (r < 0) {
+		return r;
+	}
+
+	r = coap_packet_append_payload_marker(cpkt);
+	if (r < 0) {
+		return r;
+	}
+
+	return coap_packet_append_payload(cpkt, (u8_t *)payload,
+					  sizeof(payload));
+}
+
+static int build_template(struct coap_packet *cpkt, u16_t id, u32_t observe)
+{
+	return coap_template_build(&tmpl, cpkt, data, sizeof(data), id,
+				   token, sizeof(token), observe,
+				   payload, sizeof(payload));
+}
+
+static void measure(const char *name,
+		    int (*build)(struct coap_packet *, u16_t, u32_t))
+{
+	struct coap_packet cpkt;
+	u32_t start, cycles;
+	u64_t ns;
+	int i;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_RUNS; i++) {
+		if (build(&cpkt, i, i) < 0) {
+			printk("Cannot build notification\n");
+			return;
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+	ns = SYS_CLOCK_HW_CYCLES_TO_NS64(cycles);
+
+	printk("%-8s  %6u  %15u\n", name, cycles / N_RUNS,
+	       (u32_t)(ns ? (u64_t)N_RUNS * NSEC_PER_SEC / ns : 0));
+}
+
+void main(void)
+{
+	int r;
+
+	r = coap_template_init(&tmpl, tmpl_data, sizeof(tmpl_data),
+			       COAP_TYPE_CON, COAP_RESPONSE_CODE_CONTENT);
+	if (r == 0) {
+		r = coap_template_append_observe(&tmpl);
+	}
+
+	if (r == 0) {
+		r = coap_template_append_option_int(&tmpl,
+						    COAP_OPTION_CONTENT_FORMAT,
+						    FORMAT_LWM2M_TLV);
+	}
+
+	if (r < 0) {
+		printk("Cannot create template (%d)\n", r);
+		return;
+	}
+
+	printk("method    cycles  notifications/s\n");
+
+	measure("packet", build_packet);
+	measure("template", build_template);
+
+	printk("fin\n");
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+#include <tracing.h>
+
+#define N_BATCHES 100
+
+/* Calls per batch, whose events fit in the buffer of the bottom layer */
+#define BATCH_LEN 16
+
+static K_SEM_DEFINE(sem, 0, 1);
+
+static void call_none(void)
+{
+}
+
+/* 5 bytes event */
+static void call_isr_enter(void)
+{
+	sys_trace_isr_enter();
+}
+
+/* 9 bytes event */
+static void call_void(void)
+{
+	sys_trace_void(SYS_TRACE_ID_SEMA_GIVE);
+}
+
+/* 29 bytes event, and 17 more with CONFIG_THREAD_STACK_INFO */
+static void call_thread_create(void)
+{
+	sys_trace_thread_create(k_current_get());
+}
+
+/* Traced kernel calls, 4 events of 9 bytes */
+static void call_sem_give_take(void)
+{
+	k_sem_give(&sem);
+	k_sem_take(&sem, K_NO_WAIT);
+}
+
+/* Empties the buffer of the bottom layer, outside of the measurements */
+static void drain(void)
+{
+#if defined(CONFIG_TRACING_CTF_BOTTOM_RAM)
+	u8_t buf[64];
+
+	while (ctf_ring_read(buf, sizeof(buf)) > 0) {
+	}
+#elif defined(CONFIG_TRACING_CTF_BOTTOM_UART)
+	/* Waiting traces events as well: wait for room for a batch only */
+	while (ctf_ring_used() > CONFIG_TRACING_CTF_RING_SIZE / 2) {
+		k_sleep(CONFIG_TRACING_CTF_BOTTOM_UART_INTERVAL);
+	}
+#endif
+}
+
+static u32_t measure(void (*call)(void))
+{
+	unsigned int key;
+	u32_t start;
+	u32_t cycles = 0U;
+	int i, j;
+
+	for (i = 0; i < N_BATCHES; i++) {
+		drain();
+
+		key = irq_lock();
+		start = k_cycle_get_32();
+
+		for (j = 0; j < BATCH_LEN; j++) {
+			call();
+		}
+
+		cycles += k_cycle_get_32() - start;
+		irq_unlock(key);
+	}
+
+	return cycles;
+}
+
+static void report(const char *name, void (*call)(void), u32_t base)
+{
+	u32_t cycles = measure(call) - base;
+
+	printk("%-16s  %6u  %6u\n", name, cycles / (N_BATCHES * BATCH_LEN),
+	       (u32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) /
+		       (N_BATCHES * BATCH_LEN)));
+}
+
+void main(void)
+{
+	/* Cost of the measurement itself, subtracted from the others */
+	u32_t base = measure(call_none);
+
+	printk("call              cycles      ns\n");
+
+	report("isr_enter", call_isr_enter, base);
+	report("void", call_void, base);
+	report("thread_create", call_thread_create, base);
+	report("sem_give_take", call_sem_give_take, base);
+
+#if defined(CONFIG_TRACING_CTF_RING) || defined(CONFIG_TRACING_CTF_BOTTOM_RTT)
+	printk("dropped events: %u\n", ctf_bottom_dropped());
+#endif
+
+	printk("fin\n");
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Measure time from a pended interrupt to its ISR
+ *
+ * This file contains a test that measures the time from pending an interrupt
+ * line in the NVIC to the execution of its handler. Unlike irq_offload(),
+ * the interrupt goes through the interrupt wrapper, and so measures the
+ * instrumentation the wrapper runs, such as CONFIG_IRQ_STATS.
+ *
+ * The file is only built on Cortex-M.
+ */
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+#include <irq.h>
+#ifdef CONFIG_IRQ_STATS
+#include <debug/irq_stats.h>
+#endif
+
+/*
+ * A driver connecting the same line statically fails the build, in
+ * gen_isr_tables.py, and one enabling it dynamically skips the test.
+ */
+#if CONFIG_LATENCY_MEASURE_IRQ_LINE < 0
+#define TEST_IRQ_LINE (CONFIG_NUM_IRQS - 1)
+#else
+#define TEST_IRQ_LINE CONFIG_LATENCY_MEASURE_IRQ_LINE
+#endif
+
+BUILD_ASSERT_MSG(TEST_IRQ_LINE < CONFIG_NUM_IRQS,
+		 "CONFIG_LATENCY_MEASURE_IRQ_LINE is not an NVIC line");
+
+static volatile int flag_var;
+
+static u32_t timestamp;
+
+/**
+ *
+ * @brief Test ISR used to measure the interrupt latency
+ *
+ * The interrupt handler gets the second timestamp.
+ *
+ * @return N/A
+ */
+static void latency_test_isr(void *unused)
+{
+	ARG_UNUSED(unused);
+
+	timestamp = TIME_STAMP_DELTA_GET(timestamp);
+	flag_var = 1;
+}
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int int_to_isr(void)
+{
+	PRINT_FORMAT(" 7 - Measure time from a pended interrupt to its ISR");
+
+	if (NVIC_GetEnableIRQ(TEST_IRQ_LINE)) {
+		PRINT_FORMAT(" IRQ line %d is in use. SKIPPED", TEST_IRQ_LINE);
+		return 0;
+	}
+
+	IRQ_CONNECT(TEST_IRQ_LINE, IRQ_PRIORITY, latency_test_isr, NULL, 0);
+	irq_enable(TEST_IRQ_LINE);
+
+	TICK_SYNCH();
+	flag_var = 0;
+	timestamp = TIME_STAMP_DELTA_GET(0);
+	NVIC_SetPendingIRQ(TEST_IRQ_LINE);
+	__DSB();
+	__ISB();
+
+	irq_disable(TEST_IRQ_LINE);
+
+	if (flag_var != 1) {
+		PRINT_FORMAT(" Flag variable has not changed. FAILED");
+		error_count++;
+		return 0;
+	}
+
+	PRINT_FORMAT(" interrupt latency is %u tcs = %u nsec",
+		     timestamp, SYS_CLOCK_HW_CYCLES_TO_NS(timestamp));
+
+#ifdef CONFIG_IRQ_STATS
+	struct irq_stats stats;
+
+	(void)irq_stats_get(TEST_IRQ_LINE, &stats);
+	PRINT_FORMAT(" wrapper to ISR latency is %u cycles, ISR %u cycles",
+		     stats.latency_max, stats.duration_max);
+#endif
+	return 0;
+}
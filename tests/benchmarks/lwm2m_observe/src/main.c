@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+
+#include <net/socket.h>
+#include <net/coap.h>
+#include <net/lwm2m.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+/* This is an observe notification microbenchmark. A synthetic object
+ * with INST_COUNT instances of RES_COUNT integer resources is
+ * registered in the engine, and a local "server" socket registers a
+ * growing number of observers on its resources with CoAP GET requests.
+ * The cost of lwm2m_engine_set_s32() is measured on an observed and on
+ * an unobserved resource, and the cost of lwm2m_engine_res_set_s32() on
+ * a handle of the unobserved resource.
+ */
+
+#define N_RUNS 1000
+
+#define BENCH_OBJ_ID 32769
+#define RES_COUNT 8
+#define INST_COUNT 25
+
+/* The last instance is never observed */
+#define OBSERVED_INST_COUNT (INST_COUNT - 1)
+#define MAX_OBSERVERS (OBSERVED_INST_COUNT * RES_COUNT)
+
+#define CLIENT_PORT 5683
+#define SERVER_PORT 5684
+
+#define RECV_TIMEOUT 1000
+
+#define BUF_SIZE 256
+
+static const int observer_counts[] = { 1, 16, 64, MAX_OBSERVERS };
+
+static s32_t values[INST_COUNT][RES_COUNT];
+
+static struct lwm2m_engine_obj bench_obj;
+static struct lwm2m_engine_obj_field fields[] = {
+	OBJ_FIELD_DATA(0, RW, S32),
+	OBJ_FIELD_DATA(1, RW, S32),
+	OBJ_FIELD_DATA(2, RW, S32),
+	OBJ_FIELD_DATA(3, RW, S32),
+	OBJ_FIELD_DATA(4, RW, S32),
+	OBJ_FIELD_DATA(5, RW, S32),
+	OBJ_FIELD_DATA(6, RW, S32),
+	OBJ_FIELD_DATA(7, RW, S32),
+};
+
+static struct lwm2m_engine_obj_inst inst[INST_COUNT];
+static struct lwm2m_engine_res_inst res[INST_COUNT][RES_COUNT];
+
+static struct lwm2m_ctx client_ctx;
+static int server_sock;
+
+static struct sockaddr_in client_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(CLIENT_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static struct sockaddr_in server_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(SERVER_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static struct lwm2m_engine_obj_inst *bench_create(u16_t obj_inst_id)
+{
+	int i = 0, j;
+
+	if (obj_inst_id >= INST_COUNT || inst[obj_inst_id].obj) {
+		return NULL;
+	}
+
+	for (j = 0; j < RES_COUNT; j++) {
+		INIT_OBJ_RES_DATA(res[obj_inst_id], i, j,
+				  &values[obj_inst_id][j], sizeof(s32_t));
+	}
+
+	inst[obj_inst_id].resources = res[obj_inst_id];
+	inst[obj_inst_id].resource_count = i;
+
+	return &inst[obj_inst_id];
+}
+
+static int create_objects(void)
+{
+	char path[16];
+	int ret;
+	int i;
+
+	bench_obj.obj_id = BENCH_OBJ_ID;
+	bench_obj.fields = fields;
+	bench_obj.field_count = ARRAY_SIZE(fields);
+	bench_obj.max_instance_count = INST_COUNT;
+	bench_obj.create_cb = bench_create;
+	lwm2m_register_obj(&bench_obj);
+
+	for (i = 0; i < INST_COUNT; i++) {
+		snprintk(path, sizeof(path), "%u/%d", BENCH_OBJ_ID, i);
+
+		ret = lwm2m_engine_create_obj_inst(path);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int create_sockets(void)
+{
+	int ret;
+
+	server_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (server_sock < 0) {
+		return -errno;
+	}
+
+	ret = bind(server_sock, (struct sockaddr *)&server_addr,
+		   sizeof(server_addr));
+	if (ret < 0) {
+		return -errno;
+	}
+
+	lwm2m_engine_context_init(&client_ctx);
+	memcpy(&client_ctx.remote_addr, &server_addr, sizeof(server_addr));
+
+	client_ctx.sock_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (client_ctx.sock_fd < 0) {
+		return -errno;
+	}
+
+	ret = bind(client_ctx.sock_fd, (struct sockaddr *)&client_addr,
+		   sizeof(client_addr));
+	if (ret < 0) {
+		return -errno;
+	}
+
+	ret = connect(client_ctx.sock_fd, (struct sockaddr *)&server_addr,
+		      sizeof(server_addr));
+	if (ret < 0) {
+		return -errno;
+	}
+
+	return lwm2m_socket_add(&client_ctx);
+}
+
+static int append_path_option(struct coap_packet *cpkt, int value)
+{
+	char buf[6];
+	int len;
+
+	len = snprintk(buf, sizeof(buf), "%d", value);
+
+	return coap_packet_append_option(cpkt, COAP_OPTION_URI_PATH,
+					 (u8_t *)buf, len);
+}
+
+/* Registers an observer on BENCH_OBJ_ID/obj_inst_id/res_id, and waits
+ * for the response of the engine.
+ */
+static int add_observer(int index, int obj_inst_id, int res_id)
+{
+	struct pollfd pfd = {
+		.fd = server_sock,
+		.events = POLLIN,
+	};
+	struct coap_packet cpkt;
+	u8_t buf[BUF_SIZE];
+	u8_t token[4];
+	ssize_t len;
+	int ret;
+
+	sys_put_be32(index, token);
+
+	ret = coap_packet_init(&cpkt, buf, sizeof(buf), 1, COAP_TYPE_CON,
+			       sizeof(token), token, COAP_METHOD_GET,
+			       coap_next_id());
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = coap_append_option_int(&cpkt, COAP_OPTION_OBSERVE, 0);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = append_path_option(&cpkt, BENCH_OBJ_ID);
+	if (ret == 0) {
+		ret = append_path_option(&cpkt, obj_inst_id);
+	}
+
+	if (ret == 0) {
+		ret = append_path_option(&cpkt, res_id);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	len = sendto(server_sock, cpkt.data, cpkt.offset, 0,
+		     (struct sockaddr *)&client_addr, sizeof(client_addr));
+	if (len < 0) {
+		return -errno;
+	}
+
+	if (poll(&pfd, 1, RECV_TIMEOUT) != 1) {
+		return -ETIMEDOUT;
+	}
+
+	len = recv(server_sock, buf, sizeof(buf), 0);
+	if (len < 0) {
+		return -errno;
+	}
+
+	ret = coap_packet_parse(&cpkt, buf, len, NULL, 0);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (coap_header_get_code(&cpkt) != COAP_RESPONSE_CODE_CONTENT) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static u32_t measure(char *path)
+{
+	u32_t start, cycles;
+	int i;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_RUNS; i++) {
+		/* A different value every time, so that the change is
+		 * notified.
+		 */
+		if (lwm2m_engine_set_s32(path, i) < 0) {
+			printk("Cannot set %s\n", path);
+			return 0;
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	return cycles / N_RUNS;
+}
+
+static u32_t measure_handle(struct lwm2m_res_handle *handle)
+{
+	u32_t start, cycles;
+	int i;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < N_RUNS; i++) {
+		if (lwm2m_engine_res_set_s32(handle, i) < 0) {
+			printk("Cannot set handle\n");
+			return 0;
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	return cycles / N_RUNS;
+}
+
+void main(void)
+{
+	struct lwm2m_res_handle handle;
+	char unobserved[16];
+	char observed[16];
+	int registered = 0;
+	int ret;
+	int i;
+
+	ret = create_objects();
+	if (ret < 0) {
+		printk("Cannot create objects (%d)\n", ret);
+		return;
+	}
+
+	ret = create_sockets();
+	if (ret < 0) {
+		printk("Cannot create sockets (%d)\n", ret);
+		return;
+	}
+
+	snprintk(unobserved, sizeof(unobserved), "%u/%d/0", BENCH_OBJ_ID,
+		 INST_COUNT - 1);
+
+	ret = lwm2m_engine_get_res_handle(unobserved, &handle);
+	if (ret < 0) {
+		printk("Cannot resolve %s (%d)\n", unobserved, ret);
+		return;
+	}
+
+	printk("observers  observed cycles  unobserved cycles  "
+	       "handle cycles\n");
+
+	for (i = 0; i < ARRAY_SIZE(observer_counts); i++) {
+		while (registered < observer_counts[i]) {
+			ret = add_observer(registered,
+					   registered / RES_COUNT,
+					   registered % RES_COUNT);
+			if (ret < 0) {
+				printk("Cannot add observer %d (%d)\n",
+				       registered, ret);
+				return;
+			}
+
+			registered++;
+		}
+
+		/* The most recently added observer is measured */
+		snprintk(observed, sizeof(observed), "%u/%d/%d", BENCH_OBJ_ID,
+			 (registered - 1) / RES_COUNT,
+			 (registered - 1) % RES_COUNT);
+
+		printk("%9d  %15u  %17u  %13u\n", registered,
+		       measure(observed), measure(unobserved),
+		       measure_handle(&handle));
+	}
+
+	lwm2m_engine_context_close(&client_ctx);
+	close(server_sock);
+
+	printk("fin\n");
+}
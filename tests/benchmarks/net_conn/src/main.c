@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+
+#include "connection.h"
+
+/* This is a connection demultiplexing microbenchmark. A UDP handler is
+ * registered with net_conn_register() after a growing number of other
+ * handlers, and packets are sent to it at the local address. The stack
+ * hands such packets straight back to its receive path, without going
+ * through a driver. The time from the send call to the handler callback
+ * is measured, first with a stable connection table and then while a
+ * handler is registered and unregistered before each packet.
+ */
+
+#define N_RUNS 200
+#define N_SETTLE 10
+
+#define SRC_PORT 9898
+#define TARGET_PORT 5683
+#define FILLER_PORT 20000
+#define CHURN_PORT 30000
+
+#define MAX_FILLERS (CONFIG_NET_MAX_CONN - 2)
+
+static const int filler_counts[] = { 0, 4, 16, 32, MAX_FILLERS };
+
+static struct net_conn_handle *fillers[MAX_FILLERS];
+static struct net_conn_handle *target;
+
+static struct k_sem recv_sem;
+static u32_t recv_stamp;
+
+static struct sockaddr_in peer_addr = {
+	.sin_family = AF_INET,
+	.sin_addr = { { { 198, 51, 100, 1 } } },
+};
+
+static struct sockaddr_in my_addr = {
+	.sin_family = AF_INET,
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+/* The interface only holds the local address: no packet reaches it */
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	static u8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int bench_send(struct device *dev, struct net_pkt *pkt)
+{
+	printk("Packet sent to the interface\n");
+
+	return -EIO;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(bench_if, "bench_if", bench_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&bench_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static enum net_verdict filler_cb(struct net_conn *conn,
+				  struct net_pkt *pkt,
+				  union net_ip_header *ip_hdr,
+				  union net_proto_header *proto_hdr,
+				  void *user_data)
+{
+	printk("Packet delivered to the wrong handler\n");
+
+	return NET_DROP;
+}
+
+static enum net_verdict target_cb(struct net_conn *conn,
+				  struct net_pkt *pkt,
+				  union net_ip_header *ip_hdr,
+				  union net_proto_header *proto_hdr,
+				  void *user_data)
+{
+	recv_stamp = k_cycle_get_32();
+
+	net_pkt_unref(pkt);
+	k_sem_give(&recv_sem);
+
+	return NET_OK;
+}
+
+static void register_filler(int i)
+{
+	int ret;
+
+	/* Every other handler is connected to a peer, the others are
+	 * plain listeners.
+	 */
+	if (i % 2) {
+		ret = net_conn_register(IPPROTO_UDP, AF_INET,
+					(struct sockaddr *)&peer_addr, NULL,
+					FILLER_PORT + i, FILLER_PORT + i,
+					filler_cb, NULL, &fillers[i]);
+	} else {
+		ret = net_conn_register(IPPROTO_UDP, AF_INET,
+					NULL, (struct sockaddr *)&my_addr,
+					0, FILLER_PORT + i,
+					filler_cb, NULL, &fillers[i]);
+	}
+
+	if (ret < 0) {
+		printk("Cannot register filler %d (%d)\n", i, ret);
+	}
+}
+
+static u32_t measure(struct net_context *ctx, bool churn)
+{
+	struct sockaddr_in dst = my_addr;
+	struct net_conn_handle *handle;
+	u64_t total = 0;
+	u32_t start;
+	int ret;
+	int i;
+
+	dst.sin_port = htons(TARGET_PORT);
+
+	for (i = 0; i < N_RUNS + N_SETTLE; i++) {
+		if (churn) {
+			ret = net_conn_register(IPPROTO_UDP, AF_INET,
+						NULL, NULL, 0, CHURN_PORT + i,
+						filler_cb, NULL, &handle);
+			if (ret < 0) {
+				printk("Cannot register churn handler (%d)\n",
+				       ret);
+				return 0;
+			}
+
+			net_conn_unregister(handle);
+		}
+
+		start = k_cycle_get_32();
+
+		ret = net_context_sendto_new(ctx, "bench", 5,
+					     (struct sockaddr *)&dst,
+					     sizeof(dst), NULL, K_NO_WAIT,
+					     NULL, NULL);
+		if (ret < 0) {
+			printk("Cannot send packet (%d)\n", ret);
+			return 0;
+		}
+
+		if (k_sem_take(&recv_sem, K_MSEC(100))) {
+			printk("Packet lost\n");
+			return 0;
+		}
+
+		if (i >= N_SETTLE) {
+			total += recv_stamp - start;
+		}
+	}
+
+	return total / N_RUNS;
+}
+
+void main(void)
+{
+	struct net_context *ctx;
+	struct sockaddr_in src = my_addr;
+	int registered = 0;
+	int ret;
+	int i;
+
+	k_sem_init(&recv_sem, 0, 1);
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	if (ret < 0) {
+		printk("Cannot get network context (%d)\n", ret);
+		return;
+	}
+
+	src.sin_port = htons(SRC_PORT);
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&src, sizeof(src));
+	if (ret < 0) {
+		printk("Cannot bind network context (%d)\n", ret);
+		return;
+	}
+
+	printk("handlers  steady cycles  churn cycles\n");
+
+	for (i = 0; i < ARRAY_SIZE(filler_counts); i++) {
+		/* Handlers take the first free slot of the table: the slot
+		 * of the measured handler goes to a filler, and the measured
+		 * handler is registered again after all of them.
+		 */
+		if (target) {
+			net_conn_unregister(target);
+		}
+
+		while (registered < filler_counts[i]) {
+			register_filler(registered++);
+		}
+
+		ret = net_conn_register(IPPROTO_UDP, AF_INET, NULL, NULL,
+					0, TARGET_PORT, target_cb, NULL,
+					&target);
+		if (ret < 0) {
+			printk("Cannot register target (%d)\n", ret);
+			return;
+		}
+
+		printk("%8d  %13u  %12u\n", registered + 1,
+		       measure(ctx, false), measure(ctx, true));
+	}
+
+	net_context_put(ctx);
+
+	printk("fin\n");
+}
@@ -120,6 +120,24 @@
 #define ADC_1ST_CHANNEL_ID	3
 #define ADC_2ND_CHANNEL_ID	4
 
+#elif defined(CONFIG_BOARD_NUCLEO_L073RZ)
+#define ADC_DEVICE_NAME		DT_ADC_1_NAME
+#define ADC_RESOLUTION		12
+#define ADC_GAIN		ADC_GAIN_1
+#define ADC_REFERENCE		ADC_REF_INTERNAL
+#define ADC_ACQUISITION_TIME	ADC_ACQ_TIME_DEFAULT
+#define ADC_1ST_CHANNEL_ID	17
+#define ADC_2ND_CHANNEL_ID	18
+
+#elif defined(CONFIG_BOARD_NUCLEO_L476RG)
+#define ADC_DEVICE_NAME		DT_ADC_1_NAME
+#define ADC_RESOLUTION		12
+#define ADC_GAIN		ADC_GAIN_1
+#define ADC_REFERENCE		ADC_REF_INTERNAL
+#define ADC_ACQUISITION_TIME	ADC_ACQ_TIME_DEFAULT
+#define ADC_1ST_CHANNEL_ID	0
+#define ADC_2ND_CHANNEL_ID	17
+
 #else
 #error "Unsupported board."
 #endif
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Sensors emulated on the virtual I2C bus */
+
+#define DT_ST_LIS2DH_0_LABEL			"LIS2DH"
+#define DT_ST_LIS2DH_0_BASE_ADDRESS		0x19
+#define DT_ST_LIS2DH_0_BUS_NAME			CONFIG_I2C_VIRTUAL_NAME
+#define DT_ST_LIS2DH_0_BUS_I2C			1
+
+#define DT_ST_LSM6DSL_0_LABEL			"LSM6DSL"
+#define DT_ST_LSM6DSL_0_BASE_ADDRESS		0x6a
+#define DT_ST_LSM6DSL_0_BUS_NAME		CONFIG_I2C_VIRTUAL_NAME
+#define DT_ST_LSM6DSL_BUS_I2C			1
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SENSOR_FIFO_EMUL_H__
+#define __SENSOR_FIFO_EMUL_H__
+
+#include <zephyr/types.h>
+
+/* Number of bus transactions addressed to each emulated sensor */
+extern int lis2dh_emul_transactions;
+extern int lsm6dsl_emul_transactions;
+
+void lis2dh_emul_fifo_reset(void);
+void lis2dh_emul_fifo_push(s16_t x, s16_t y, s16_t z);
+int lis2dh_emul_fifo_level(void);
+
+/* The FIFO of the LSM6DSL holds 16-bit words, the next one to be read is
+ * at position @a pattern in the data set.
+ */
+void lsm6dsl_emul_fifo_reset(u16_t pattern);
+void lsm6dsl_emul_fifo_push(const s16_t *words, int count);
+int lsm6dsl_emul_fifo_level(void);
+
+#endif /* __SENSOR_FIFO_EMUL_H__ */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * I2C slave emulating the registers and the FIFO of a LIS2DH
+ */
+
+#include <zephyr.h>
+#include <init.h>
+#include <i2c.h>
+#include <misc/util.h>
+
+#include "emul.h"
+
+#define REG_CTRL5		0x24
+#define REG_OUT_X_L		0x28
+#define REG_STATUS		0x27
+#define REG_OUT_Z_H		0x2D
+#define REG_FIFO_CTRL		0x2E
+#define REG_FIFO_SRC		0x2F
+
+#define CTRL5_FIFO_EN		BIT(6)
+#define STATUS_ZYXDA		BIT(3)
+#define FIFO_SRC_OVRN		BIT(6)
+#define FIFO_SRC_EMPTY		BIT(5)
+#define FIFO_SIZE		32
+#define AUTOINCREMENT		BIT(7)
+
+static u8_t regs[0x40];
+static u8_t addr;
+static bool autoinc;
+static bool first_write;
+
+static s16_t fifo[FIFO_SIZE][3];
+static int fifo_head;
+static int fifo_level;
+
+int lis2dh_emul_transactions;
+
+void lis2dh_emul_fifo_reset(void)
+{
+	fifo_head = 0;
+	fifo_level = 0;
+}
+
+void lis2dh_emul_fifo_push(s16_t x, s16_t y, s16_t z)
+{
+	int tail;
+
+	/* stream mode, the oldest sample is dropped when full */
+	if (fifo_level == FIFO_SIZE) {
+		fifo_head = (fifo_head + 1) % FIFO_SIZE;
+		fifo_level--;
+	}
+
+	tail = (fifo_head + fifo_level) % FIFO_SIZE;
+	fifo[tail][0] = x;
+	fifo[tail][1] = y;
+	fifo[tail][2] = z;
+	fifo_level++;
+}
+
+int lis2dh_emul_fifo_level(void)
+{
+	return fifo_level;
+}
+
+static bool fifo_enabled(void)
+{
+	return (regs[REG_CTRL5] & CTRL5_FIFO_EN) && regs[REG_FIFO_CTRL];
+}
+
+static u8_t reg_read(void)
+{
+	u8_t val;
+
+	if (addr >= REG_OUT_X_L && addr <= REG_OUT_Z_H && fifo_enabled()) {
+		u16_t axis = fifo_level ?
+			     fifo[fifo_head][(addr - REG_OUT_X_L) / 2] : 0;
+
+		val = (addr & 1) ? axis >> 8 : axis & 0xff;
+
+		/* the address rolls back once the sample is read */
+		if (addr == REG_OUT_Z_H) {
+			if (fifo_level) {
+				fifo_head = (fifo_head + 1) % FIFO_SIZE;
+				fifo_level--;
+			}
+			addr = REG_OUT_X_L;
+			return val;
+		}
+	} else if (addr == REG_STATUS) {
+		val = fifo_level ? STATUS_ZYXDA : 0;
+	} else if (addr == REG_FIFO_SRC) {
+		if (fifo_level == 0) {
+			val = FIFO_SRC_EMPTY;
+		} else if (fifo_level == FIFO_SIZE) {
+			val = FIFO_SRC_OVRN;
+		} else {
+			val = fifo_level;
+		}
+	} else {
+		val = regs[addr % sizeof(regs)];
+	}
+
+	if (autoinc) {
+		addr++;
+	}
+
+	return val;
+}
+
+static int lis2dh_emul_write_requested(struct i2c_slave_config *config)
+{
+	lis2dh_emul_transactions++;
+	first_write = true;
+
+	return 0;
+}
+
+static int lis2dh_emul_write_received(struct i2c_slave_config *config,
+				      u8_t val)
+{
+	if (first_write) {
+		addr = val & ~AUTOINCREMENT;
+		autoinc = val & AUTOINCREMENT;
+		first_write = false;
+		return 0;
+	}
+
+	regs[addr % sizeof(regs)] = val;
+	if (autoinc) {
+		addr++;
+	}
+
+	return 0;
+}
+
+static int lis2dh_emul_read(struct i2c_slave_config *config, u8_t *val)
+{
+	*val = reg_read();
+
+	return 0;
+}
+
+static int lis2dh_emul_stop(struct i2c_slave_config *config)
+{
+	return 0;
+}
+
+static const struct i2c_slave_callbacks lis2dh_emul_callbacks = {
+	.write_requested = lis2dh_emul_write_requested,
+	.read_requested = lis2dh_emul_read,
+	.write_received = lis2dh_emul_write_received,
+	.read_processed = lis2dh_emul_read,
+	.stop = lis2dh_emul_stop,
+};
+
+static struct i2c_slave_config lis2dh_emul_config = {
+	.address = DT_ST_LIS2DH_0_BASE_ADDRESS,
+	.callbacks = &lis2dh_emul_callbacks,
+};
+
+static int lis2dh_emul_init(struct device *dev)
+{
+	struct device *bus = device_get_binding(CONFIG_I2C_VIRTUAL_NAME);
+
+	ARG_UNUSED(dev);
+
+	if (!bus) {
+		return -ENODEV;
+	}
+
+	return i2c_slave_register(bus, &lis2dh_emul_config);
+}
+
+/* after the virtual bus, before the sensor drivers */
+SYS_INIT(lis2dh_emul_init, POST_KERNEL, 60);
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * I2C slave emulating the registers and the FIFO of a LSM6DSL
+ */
+
+#include <zephyr.h>
+#include <init.h>
+#include <i2c.h>
+#include <misc/util.h>
+
+#include "emul.h"
+
+#define REG_FIFO_CTRL3		0x08
+#define REG_FIFO_CTRL5		0x0A
+#define REG_WHO_AM_I		0x0F
+#define REG_FIFO_STATUS1	0x3A
+#define REG_FIFO_STATUS2	0x3B
+#define REG_FIFO_STATUS3	0x3C
+#define REG_FIFO_STATUS4	0x3D
+#define REG_FIFO_DATA_OUT_L	0x3E
+#define REG_FIFO_DATA_OUT_H	0x3F
+
+#define WHO_AM_I		0x6A
+#define FIFO_STATUS2_EMPTY	BIT(4)
+#define FIFO_MODE_MASK		BIT_MASK(3)
+#define FIFO_SIZE		2048
+
+static u8_t regs[0x80];
+static u8_t addr;
+static bool first_write;
+
+static s16_t fifo[FIFO_SIZE];
+static int fifo_head;
+static int fifo_level;
+static u16_t fifo_pattern;
+
+int lsm6dsl_emul_transactions;
+
+static int set_words(void)
+{
+	u8_t ctrl3 = regs[REG_FIFO_CTRL3];
+
+	return 3 * (((ctrl3 & BIT_MASK(3)) ? 1 : 0) +
+		    (((ctrl3 >> 3) & BIT_MASK(3)) ? 1 : 0));
+}
+
+void lsm6dsl_emul_fifo_reset(u16_t pattern)
+{
+	fifo_head = 0;
+	fifo_level = 0;
+	fifo_pattern = pattern;
+}
+
+void lsm6dsl_emul_fifo_push(const s16_t *words, int count)
+{
+	while (count-- && fifo_level < FIFO_SIZE) {
+		fifo[(fifo_head + fifo_level) % FIFO_SIZE] = *words++;
+		fifo_level++;
+	}
+}
+
+int lsm6dsl_emul_fifo_level(void)
+{
+	return fifo_level;
+}
+
+static u8_t reg_read(void)
+{
+	u8_t val;
+
+	switch (addr) {
+	case REG_WHO_AM_I:
+		val = WHO_AM_I;
+		break;
+	case REG_FIFO_STATUS1:
+		val = fifo_level & 0xff;
+		break;
+	case REG_FIFO_STATUS2:
+		val = (fifo_level >> 8) & BIT_MASK(3);
+		if (fifo_level == 0) {
+			val |= FIFO_STATUS2_EMPTY;
+		}
+		break;
+	case REG_FIFO_STATUS3:
+		val = fifo_pattern & 0xff;
+		break;
+	case REG_FIFO_STATUS4:
+		val = fifo_pattern >> 8;
+		break;
+	case REG_FIFO_DATA_OUT_L:
+		val = fifo_level ? fifo[fifo_head] & 0xff : 0;
+		break;
+	case REG_FIFO_DATA_OUT_H:
+		val = fifo_level ? (u16_t)fifo[fifo_head] >> 8 : 0;
+		if (fifo_level && set_words()) {
+			fifo_head = (fifo_head + 1) % FIFO_SIZE;
+			fifo_level--;
+			fifo_pattern = (fifo_pattern + 1) % set_words();
+		}
+		/* the address rolls back once the word is read */
+		addr = REG_FIFO_DATA_OUT_L;
+		return val;
+	default:
+		val = regs[addr % sizeof(regs)];
+		break;
+	}
+
+	addr++;
+
+	return val;
+}
+
+static int lsm6dsl_emul_write_requested(struct i2c_slave_config *config)
+{
+	lsm6dsl_emul_transactions++;
+	first_write = true;
+
+	return 0;
+}
+
+static int lsm6dsl_emul_write_received(struct i2c_slave_config *config,
+				       u8_t val)
+{
+	if (first_write) {
+		addr = val;
+		first_write = false;
+		return 0;
+	}
+
+	regs[addr % sizeof(regs)] = val;
+
+	/* the FIFO is emptied in bypass mode */
+	if (addr == REG_FIFO_CTRL5 && (val & FIFO_MODE_MASK) == 0) {
+		lsm6dsl_emul_fifo_reset(0);
+	}
+
+	addr++;
+
+	return 0;
+}
+
+static int lsm6dsl_emul_read(struct i2c_slave_config *config, u8_t *val)
+{
+	*val = reg_read();
+
+	return 0;
+}
+
+static int lsm6dsl_emul_stop(struct i2c_slave_config *config)
+{
+	return 0;
+}
+
+static const struct i2c_slave_callbacks lsm6dsl_emul_callbacks = {
+	.write_requested = lsm6dsl_emul_write_requested,
+	.read_requested = lsm6dsl_emul_read,
+	.write_received = lsm6dsl_emul_write_received,
+	.read_processed = lsm6dsl_emul_read,
+	.stop = lsm6dsl_emul_stop,
+};
+
+static struct i2c_slave_config lsm6dsl_emul_config = {
+	.address = DT_ST_LSM6DSL_0_BASE_ADDRESS,
+	.callbacks = &lsm6dsl_emul_callbacks,
+};
+
+static int lsm6dsl_emul_init(struct device *dev)
+{
+	struct device *bus = device_get_binding(CONFIG_I2C_VIRTUAL_NAME);
+
+	ARG_UNUSED(dev);
+
+	if (!bus) {
+		return -ENODEV;
+	}
+
+	return i2c_slave_register(bus, &lsm6dsl_emul_config);
+}
+
+/* after the virtual bus, before the sensor drivers */
+SYS_INIT(lsm6dsl_emul_init, POST_KERNEL, 60);
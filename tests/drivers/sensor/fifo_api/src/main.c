@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_LEVEL CONFIG_LOG_DEFAULT_LEVEL
+#include <logging/log.h>
+LOG_MODULE_REGISTER(main);
+
+#include <zephyr.h>
+#include <sensor.h>
+#include <ztest.h>
+
+#include "emul.h"
+
+/* default rate of the LIS2DH, 50Hz */
+#define LIS2DH_PERIOD_US	20000
+/* CONFIG_LSM6DSL_ACCEL_ODR and CONFIG_LSM6DSL_GYRO_ODR, 104Hz */
+#define LSM6DSL_PERIOD_US	(USEC_PER_SEC / 104)
+
+static struct sensor_frame_raw raw[40];
+static struct sensor_frame frames[8];
+
+static struct device *get_lis2dh(void)
+{
+	struct device *dev = device_get_binding(DT_ST_LIS2DH_0_LABEL);
+
+	zassert_not_null(dev, "LIS2DH not found");
+	lis2dh_emul_fifo_reset();
+
+	return dev;
+}
+
+static struct device *get_lsm6dsl(u16_t pattern)
+{
+	struct device *dev = device_get_binding(DT_ST_LSM6DSL_0_LABEL);
+
+	zassert_not_null(dev, "LSM6DSL not found");
+	lsm6dsl_emul_fifo_reset(pattern);
+
+	return dev;
+}
+
+static void test_lis2dh_empty(void)
+{
+	struct device *dev = get_lis2dh();
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw,
+				       ARRAY_SIZE(raw)), 0, NULL);
+}
+
+static void test_lis2dh_batch(void)
+{
+	struct device *dev = get_lis2dh();
+	int transactions;
+	int i;
+
+	for (i = 0; i < 10; i++) {
+		lis2dh_emul_fifo_push(i, -i, 1000 + i);
+	}
+
+	transactions = lis2dh_emul_transactions;
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw,
+				       ARRAY_SIZE(raw)), 10, NULL);
+
+	/* the FIFO level, then the samples in a single burst */
+	zassert_equal(lis2dh_emul_transactions - transactions, 2, NULL);
+	zassert_equal(lis2dh_emul_fifo_level(), 0, NULL);
+
+	for (i = 0; i < 10; i++) {
+		zassert_equal(raw[i].chan, SENSOR_CHAN_ACCEL_XYZ, NULL);
+		zassert_equal(raw[i].val[0], i, NULL);
+		zassert_equal(raw[i].val[1], -i, NULL);
+		zassert_equal(raw[i].val[2], 1000 + i, NULL);
+		if (i) {
+			zassert_equal(raw[i].timestamp - raw[i - 1].timestamp,
+				      LIS2DH_PERIOD_US, NULL);
+		}
+	}
+}
+
+static void test_lis2dh_full(void)
+{
+	struct device *dev = get_lis2dh();
+	int i;
+
+	/* the oldest samples are overwritten in stream mode */
+	for (i = 0; i < 40; i++) {
+		lis2dh_emul_fifo_push(i, 0, 0);
+	}
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw,
+				       ARRAY_SIZE(raw)), 32, NULL);
+	zassert_equal(raw[0].val[0], 8, NULL);
+	zassert_equal(raw[31].val[0], 39, NULL);
+}
+
+static void test_lis2dh_partial(void)
+{
+	struct device *dev = get_lis2dh();
+	int i;
+
+	for (i = 0; i < 20; i++) {
+		lis2dh_emul_fifo_push(i, 0, 0);
+	}
+
+	/* the samples which don't fit are left in the FIFO */
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw, 8), 8,
+		      NULL);
+	zassert_equal(raw[7].val[0], 7, NULL);
+	zassert_equal(lis2dh_emul_fifo_level(), 12, NULL);
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw,
+				       ARRAY_SIZE(raw)), 12, NULL);
+	zassert_equal(raw[0].val[0], 8, NULL);
+}
+
+static void test_lis2dh_value(void)
+{
+	struct device *dev = get_lis2dh();
+
+	/* 1g in the default +/-2g range */
+	lis2dh_emul_fifo_push(16384, 0, -16384);
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_VALUE, frames,
+				       ARRAY_SIZE(frames)), 1, NULL);
+	zassert_equal(frames[0].chan, SENSOR_CHAN_ACCEL_XYZ, NULL);
+	zassert_equal(frames[0].val[0].val1, 9, NULL);
+	zassert_equal(frames[0].val[1].val1, 0, NULL);
+	zassert_equal(frames[0].val[1].val2, 0, NULL);
+	zassert_equal(frames[0].val[2].val1, -10, NULL);
+}
+
+static void test_lis2dh_raw(void)
+{
+	struct device *dev = get_lis2dh();
+	struct sensor_scale scale;
+	struct sensor_value val[3];
+	s32_t xyz[3];
+	int axis;
+
+	lis2dh_emul_fifo_push(1000, -2000, 16384);
+
+	zassert_equal(sensor_sample_fetch(dev), 0, NULL);
+	zassert_equal(sensor_channel_get_raw(dev, SENSOR_CHAN_ACCEL_XYZ, xyz,
+					     &scale), 0, NULL);
+	zassert_equal(sensor_channel_get(dev, SENSOR_CHAN_ACCEL_XYZ, val), 0,
+		      NULL);
+	zassert_equal(xyz[0], 1000, NULL);
+	zassert_equal(xyz[1], -2000, NULL);
+	zassert_equal(xyz[2], 16384, NULL);
+
+	/* the scale gives the same values as sensor_channel_get() */
+	for (axis = 0; axis < 3; axis++) {
+		zassert_equal(sensor_raw_to_micro(xyz[axis], &scale),
+			      val[axis].val1 * 1000000LL + val[axis].val2,
+			      NULL);
+	}
+
+	zassert_equal(sensor_channel_get_raw(dev, SENSOR_CHAN_ACCEL_Y, xyz,
+					     NULL), 0, NULL);
+	zassert_equal(xyz[0], -2000, NULL);
+	zassert_equal(sensor_channel_get_raw(dev, SENSOR_CHAN_GYRO_XYZ, xyz,
+					     NULL), -ENOTSUP, NULL);
+}
+
+static void push_lsm6dsl_sets(int first, int count)
+{
+	s16_t set[6];
+	int i;
+
+	for (i = first; i < first + count; i++) {
+		/* gyroscope, then accelerometer */
+		set[0] = i;
+		set[1] = 100 + i;
+		set[2] = 200 + i;
+		set[3] = -i;
+		set[4] = -100 - i;
+		set[5] = -200 - i;
+		lsm6dsl_emul_fifo_push(set, ARRAY_SIZE(set));
+	}
+}
+
+static void test_lsm6dsl_batch(void)
+{
+	struct device *dev = get_lsm6dsl(0);
+	int transactions;
+	int i;
+
+	push_lsm6dsl_sets(0, 5);
+
+	transactions = lsm6dsl_emul_transactions;
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw,
+				       ARRAY_SIZE(raw)), 10, NULL);
+	zassert_equal(lsm6dsl_emul_transactions - transactions, 2, NULL);
+	zassert_equal(lsm6dsl_emul_fifo_level(), 0, NULL);
+
+	for (i = 0; i < 5; i++) {
+		struct sensor_frame_raw *gyro = &raw[2 * i];
+		struct sensor_frame_raw *accel = &raw[2 * i + 1];
+
+		zassert_equal(gyro->chan, SENSOR_CHAN_GYRO_XYZ, NULL);
+		zassert_equal(gyro->val[0], i, NULL);
+		zassert_equal(gyro->val[2], 200 + i, NULL);
+		zassert_equal(accel->chan, SENSOR_CHAN_ACCEL_XYZ, NULL);
+		zassert_equal(accel->val[0], -i, NULL);
+		zassert_equal(accel->val[2], -200 - i, NULL);
+
+		/* both samples of a data set are taken together */
+		zassert_equal(gyro->timestamp, accel->timestamp, NULL);
+		if (i) {
+			zassert_equal(gyro->timestamp - raw[2 * i - 2].timestamp,
+				      LSM6DSL_PERIOD_US, NULL);
+		}
+	}
+}
+
+static void test_lsm6dsl_large_batch(void)
+{
+	static struct sensor_frame_raw big[200];
+	struct device *dev = get_lsm6dsl(0);
+	int i;
+
+	/* more than one burst of data sets */
+	push_lsm6dsl_sets(0, 100);
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, big,
+				       ARRAY_SIZE(big)), 200, NULL);
+	for (i = 0; i < 100; i++) {
+		zassert_equal(big[2 * i].val[0], i, NULL);
+		zassert_equal(big[2 * i + 1].val[0], -i, NULL);
+	}
+}
+
+static void test_lsm6dsl_partial(void)
+{
+	struct device *dev = get_lsm6dsl(0);
+
+	push_lsm6dsl_sets(0, 5);
+
+	/* only whole data sets are read */
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw, 3), 2,
+		      NULL);
+	zassert_equal(lsm6dsl_emul_fifo_level(), 24, NULL);
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw,
+				       ARRAY_SIZE(raw)), 8, NULL);
+	zassert_equal(raw[0].val[0], 1, NULL);
+}
+
+static void test_lsm6dsl_misaligned(void)
+{
+	static const s16_t accel[3] = { -1000, -1000, -1000 };
+	struct device *dev = get_lsm6dsl(3);
+
+	/* the FIFO starts in the middle of a data set */
+	lsm6dsl_emul_fifo_push(accel, ARRAY_SIZE(accel));
+	push_lsm6dsl_sets(0, 2);
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw,
+				       ARRAY_SIZE(raw)), 4, NULL);
+	zassert_equal(raw[0].chan, SENSOR_CHAN_GYRO_XYZ, NULL);
+	zassert_equal(raw[0].val[0], 0, NULL);
+	zassert_equal(raw[3].val[0], -1, NULL);
+}
+
+static void test_lsm6dsl_value(void)
+{
+	static const s16_t set[6] = { 0, 0, 0, 16384, 0, 0 };
+	struct device *dev = get_lsm6dsl(0);
+
+	lsm6dsl_emul_fifo_push(set, ARRAY_SIZE(set));
+
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_VALUE, frames,
+				       ARRAY_SIZE(frames)), 2, NULL);
+	zassert_equal(frames[0].chan, SENSOR_CHAN_GYRO_XYZ, NULL);
+	zassert_equal(frames[0].val[0].val1, 0, NULL);
+	zassert_equal(frames[1].chan, SENSOR_CHAN_ACCEL_XYZ, NULL);
+	/* 16384 * 0.061mg */
+	zassert_equal(frames[1].val[0].val1, 9, NULL);
+}
+
+static void test_lsm6dsl_raw(void)
+{
+	static const s16_t set[6] = { 1000, 0, -2000, 16384, -8192, 0 };
+	struct device *dev = get_lsm6dsl(0);
+	struct sensor_scale scale[2];
+	s64_t delta;
+	int i;
+	int axis;
+
+	zassert_equal(sensor_channel_get_raw(dev, SENSOR_CHAN_GYRO_XYZ, NULL,
+					     &scale[0]), 0, NULL);
+	zassert_equal(sensor_channel_get_raw(dev, SENSOR_CHAN_ACCEL_XYZ, NULL,
+					     &scale[1]), 0, NULL);
+
+	lsm6dsl_emul_fifo_push(set, ARRAY_SIZE(set));
+	lsm6dsl_emul_fifo_push(set, ARRAY_SIZE(set));
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_RAW, raw, 2), 2,
+		      NULL);
+	zassert_equal(sensor_fifo_read(dev, SENSOR_FRAME_VALUE, frames, 2), 2,
+		      NULL);
+
+	/* the values of the frames are truncated to the milli unit */
+	for (i = 0; i < 2; i++) {
+		for (axis = 0; axis < 3; axis++) {
+			delta = sensor_raw_to_micro(raw[i].val[axis],
+						    &scale[i]) -
+				(frames[i].val[axis].val1 * 1000000LL +
+				 frames[i].val[axis].val2);
+			zassert_true(delta > -1000 && delta < 1000, NULL);
+		}
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sensor_fifo_api,
+			 ztest_unit_test(test_lis2dh_empty),
+			 ztest_unit_test(test_lis2dh_batch),
+			 ztest_unit_test(test_lis2dh_full),
+			 ztest_unit_test(test_lis2dh_partial),
+			 ztest_unit_test(test_lis2dh_value),
+			 ztest_unit_test(test_lis2dh_raw),
+			 ztest_unit_test(test_lsm6dsl_batch),
+			 ztest_unit_test(test_lsm6dsl_large_batch),
+			 ztest_unit_test(test_lsm6dsl_partial),
+			 ztest_unit_test(test_lsm6dsl_misaligned),
+			 ztest_unit_test(test_lsm6dsl_value),
+			 ztest_unit_test(test_lsm6dsl_raw));
+	ztest_run_test_suite(sensor_fifo_api);
+}
@@ -42,3 +42,39 @@ DEVICE_AND_API_INIT(dummy_driver, DUMMY_DRIVER_NAME, &dummy_init,
 /**
  * @endcond
  */
+
+#define DUMMY_PM_DRIVER_NAME	"dummy_pm_driver"
+
+#ifdef CONFIG_DEVICE_POWER_MANAGEMENT
+static u32_t dummy_pm_state = DEVICE_PM_ACTIVE_STATE;
+
+static int dummy_pm_control(struct device *dev, u32_t ctrl_command,
+			    void *context)
+{
+	if (ctrl_command == DEVICE_PM_SET_POWER_STATE) {
+		dummy_pm_state = *((u32_t *)context);
+	} else {
+		*((u32_t *)context) = dummy_pm_state;
+	}
+
+	return 0;
+}
+#endif
+
+int dummy_pm_init(struct device *dev)
+{
+	device_pm_enable(dev);
+
+	return 0;
+}
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+DEVICE_DEFINE(dummy_pm_driver, DUMMY_PM_DRIVER_NAME, &dummy_pm_init,
+	      dummy_pm_control, NULL, NULL, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &funcs);
+
+/**
+ * @endcond
+ */
@@ -12,6 +12,7 @@
 
 #define DUMMY_PORT_1    "dummy"
 #define DUMMY_PORT_2    "dummy_driver"
+#define DUMMY_PM_PORT   "dummy_pm_driver"
 
 /**
  * @brief Test cases to verify device objects
@@ -158,6 +159,128 @@ void test_dummy_device_pm(void)
 }
 #endif
 
+#ifdef CONFIG_DEVICE_IDLE_PM
+/* Longer than the autosuspend delay, ticks included */
+#define AUTOSUSPEND_WAIT	(CONFIG_DEVICE_IDLE_PM_AUTOSUSPEND_DELAY + 20)
+
+static u32_t dummy_pm_state(struct device *dev)
+{
+	u32_t state;
+
+	zassert_equal(device_get_power_state(dev, &state), 0, NULL);
+
+	return state;
+}
+
+/**
+ * @brief Test device runtime power management
+ *
+ * Validates that a device is resumed while it has users, and suspended
+ * once unused for its autosuspend delay, or at once when put synchronously.
+ *
+ * @see device_pm_get_sync(), device_pm_put(), device_pm_put_sync(),
+ * device_pm_autosuspend_delay_set()
+ */
+static void test_dummy_device_idle_pm(void)
+{
+	struct device *dev;
+
+	dev = device_get_binding(DUMMY_PM_PORT);
+	zassert_false((dev == NULL), NULL);
+
+	/* unused since its init */
+	k_sleep(AUTOSUSPEND_WAIT);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_SUSPEND_STATE, NULL);
+
+	zassert_equal(device_pm_get_sync(dev), 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+	zassert_equal(device_pm_get_sync(dev), 0, NULL);
+
+	zassert_equal(device_pm_put(dev), 0, NULL);
+	k_sleep(AUTOSUSPEND_WAIT);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+
+	zassert_equal(device_pm_put(dev), 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+	k_sleep(AUTOSUSPEND_WAIT);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_SUSPEND_STATE, NULL);
+
+	/* gotten again before the autosuspend delay */
+	zassert_equal(device_pm_get_sync(dev), 0, NULL);
+	zassert_equal(device_pm_put(dev), 0, NULL);
+	zassert_equal(device_pm_get_sync(dev), 0, NULL);
+	k_sleep(AUTOSUSPEND_WAIT);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+
+	zassert_equal(device_pm_put_sync(dev), 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_SUSPEND_STATE, NULL);
+
+	device_pm_autosuspend_delay_set(dev, K_FOREVER);
+	zassert_equal(device_pm_get_sync(dev), 0, NULL);
+	zassert_equal(device_pm_put(dev), 0, NULL);
+	k_sleep(AUTOSUSPEND_WAIT);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+
+	zassert_equal(device_pm_get_sync(dev), 0, NULL);
+	zassert_equal(device_pm_put_sync(dev), 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_SUSPEND_STATE, NULL);
+	device_pm_autosuspend_delay_set(dev,
+					CONFIG_DEVICE_IDLE_PM_AUTOSUSPEND_DELAY);
+}
+
+/**
+ * @brief Test asynchronous device resume
+ *
+ * Validates that the device runtime power management signal is raised once
+ * the device is resumed, and that a disabled device is kept active.
+ *
+ * @see device_pm_get(), device_pm_disable()
+ */
+static void test_dummy_device_idle_pm_async(void)
+{
+	struct device *dev;
+	struct k_poll_event event;
+	unsigned int signaled;
+	int result;
+
+	dev = device_get_binding(DUMMY_PM_PORT);
+	zassert_false((dev == NULL), NULL);
+
+	zassert_equal(device_pm_get_sync(dev), 0, NULL);
+	zassert_equal(device_pm_put_sync(dev), 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_SUSPEND_STATE, NULL);
+
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY,
+			  &dev->config->pm->signal);
+	k_poll_signal_reset(&dev->config->pm->signal);
+
+	zassert_equal(device_pm_get(dev), 0, NULL);
+	zassert_equal(k_poll(&event, 1, K_FOREVER), 0, NULL);
+	k_poll_signal_check(&dev->config->pm->signal, &signaled, &result);
+	zassert_true(signaled, NULL);
+	zassert_equal(result, 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+
+	zassert_equal(device_pm_put_sync(dev), 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_SUSPEND_STATE, NULL);
+
+	device_pm_disable(dev);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+	zassert_equal(device_pm_put_sync(dev), 0, NULL);
+	zassert_equal(dummy_pm_state(dev), DEVICE_PM_ACTIVE_STATE, NULL);
+}
+#else
+static void test_dummy_device_idle_pm(void)
+{
+	ztest_test_skip();
+}
+
+static void test_dummy_device_idle_pm_async(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 /**
  * @}
  */
@@ -167,6 +290,8 @@ void test_main(void)
 	ztest_test_suite(device,
 			 ztest_unit_test(test_dummy_device_pm),
 			 ztest_unit_test(build_suspend_device_list),
+			 ztest_unit_test(test_dummy_device_idle_pm),
+			 ztest_unit_test(test_dummy_device_idle_pm_async),
 			 ztest_unit_test(test_dummy_device),
 			 ztest_unit_test(test_bogus_dynamic_name),
 			 ztest_unit_test(test_dynamic_name));
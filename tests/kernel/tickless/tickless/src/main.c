@@ -35,7 +35,11 @@ static K_THREAD_STACK_DEFINE(thread_tickless_stack, STACKSIZE);
 s32_t _sys_idle_threshold_ticks;
 #endif
 
-#define TICKS_TO_MS  (MSEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+/*
+ * Tick rates of timers clocked at 32768 Hz do not divide a second in whole
+ * milliseconds: round down, the sleep is rounded up to whole ticks again.
+ */
+#define TICKS_TO_MS(t)  ((s32_t)max(__ticks_to_ms(t), 1))
 
 
 /* NOTE: Clock speed may change between platforms */
@@ -88,6 +92,8 @@ void ticklessTestThread(void)
 	s32_t start_time;
 	s32_t end_time;
 	s32_t diff_time;
+	u32_t start_tick;
+	u32_t end_tick;
 	s32_t diff_ticks;
 	_timer_res_t start_tsc;
 	_timer_res_t end_tsc;
@@ -120,13 +126,13 @@ void ticklessTestThread(void)
 		 * Do a single tick sleep to get us as close to a tick boundary
 		 * as we can.
 		 */
-		k_sleep(TICKS_TO_MS);
+		k_sleep(TICKS_TO_MS(1));
 		start_time = k_uptime_get_32();
 		start_tsc = _TIMESTAMP_READ();
 		/* FIXME: one tick less to account for
 		 * one  extra tick for _TICK_ALIGN in k_sleep
 		 */
-		k_sleep((SLEEP_TICKS - 1) * TICKS_TO_MS);
+		k_sleep(TICKS_TO_MS(SLEEP_TICKS - 1));
 		end_tsc = _TIMESTAMP_READ();
 		end_time = k_uptime_get_32();
 		cal_tsc += end_tsc - start_tsc;
@@ -155,14 +161,16 @@ void ticklessTestThread(void)
 		 * Do a single tick sleep to get us as close to a tick boundary
 		 * as we can.
 		 */
-		k_sleep(TICKS_TO_MS);
+		k_sleep(TICKS_TO_MS(1));
 		start_time = k_uptime_get_32();
+		start_tick = z_tick_get_32();
 		start_tsc = _TIMESTAMP_READ();
 		/* FIXME: one tick less to account for
 		 * one  extra tick for _TICK_ALIGN in k_sleep
 		 */
-		k_sleep((SLEEP_TICKS - 1) * TICKS_TO_MS);
+		k_sleep(TICKS_TO_MS(SLEEP_TICKS - 1));
 		end_tsc = _TIMESTAMP_READ();
+		end_tick = z_tick_get_32();
 		end_time = k_uptime_get_32();
 		diff_tsc += end_tsc - start_tsc;
 	}
@@ -170,8 +178,7 @@ void ticklessTestThread(void)
 	diff_tsc /= CAL_REPS;
 
 	diff_time = (end_time - start_time);
-	/* Convert ms to ticks*/
-	diff_ticks = (diff_time / TICKS_TO_MS);
+	diff_ticks = (s32_t)(end_tick - start_tick);
 
 	printk("start time     : %d\n", start_time);
 	printk("end   time     : %d\n", end_time);
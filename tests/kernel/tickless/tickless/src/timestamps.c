@@ -305,6 +305,24 @@ void _timestamp_close(void)
 	soc_pmc_peripheral_disable(ID_RTT);
 }
 
+#elif defined(CONFIG_STM32_LPTIM_TIMER)
+/* STM32 - use the system timer, whose LSE clock keeps running in STOP mode */
+
+#include <kernel.h>
+
+void _timestamp_open(void)
+{
+}
+
+u32_t _timestamp_read(void)
+{
+	return k_cycle_get_32();
+}
+
+void _timestamp_close(void)
+{
+}
+
 #else
 #error "Unknown platform"
 #endif /* CONFIG_SOC_xxx */
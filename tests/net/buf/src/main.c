@@ -66,6 +66,7 @@ static void var_destroy(struct net_buf *buf);
 NET_BUF_POOL_HEAP_DEFINE(bufs_pool, 10, buf_destroy);
 NET_BUF_POOL_FIXED_DEFINE(fixed_pool, 10, 128, fixed_destroy);
 NET_BUF_POOL_VAR_DEFINE(var_pool, 10, 1024, var_destroy);
+NET_BUF_POOL_VAR_BOUNDED_DEFINE(bounded_pool, 10, 1024, 256, NULL);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -457,6 +458,85 @@ static void net_buf_test_var_pool(void)
 	zassert_equal(destroy_called, 3, "Incorrect destroy callback count");
 }
 
+static void net_buf_test_bounded_var_pool(void)
+{
+	struct net_buf *bufs[10];
+	struct net_buf *buf;
+	int i;
+
+	/* A single payload can't take more than the fragment bound */
+	buf = net_buf_alloc_len(&bounded_pool, 1000, K_NO_WAIT);
+	zassert_is_null(buf, "Got oversized buffer");
+
+	for (i = 0; i < 4; i++) {
+		bufs[i] = net_buf_alloc_len(&bounded_pool,
+					    256 - NET_BUF_VAR_DATA_OVERHEAD,
+					    K_NO_WAIT);
+		zassert_not_null(bufs[i], "Failed to get buffer");
+	}
+
+	buf = net_buf_alloc_len(&bounded_pool, 20, K_NO_WAIT);
+	zassert_is_null(buf, "Got buffer from exhausted pool");
+
+	for (i = 0; i < 4; i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	/* Small payloads only take a small block each */
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_buf_alloc_len(&bounded_pool, 20, K_NO_WAIT);
+		zassert_not_null(bufs[i], "Failed to get buffer");
+	}
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(bufs[i]);
+	}
+}
+
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+static void net_buf_test_pool_stats(void)
+{
+	struct net_buf *bufs[10];
+	struct net_buf *buf;
+	u32_t alloc_count, alloc_failed;
+	int i;
+
+	alloc_count = fixed_pool.stats.alloc_count;
+	alloc_failed = fixed_pool.stats.alloc_failed;
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_buf_alloc_len(&fixed_pool, 20, K_NO_WAIT);
+		zassert_not_null(bufs[i], "Failed to get buffer");
+	}
+
+	buf = net_buf_alloc_len(&fixed_pool, 20, K_NO_WAIT);
+	zassert_is_null(buf, "Got buffer from exhausted pool");
+
+	/* Blocking allocation failure is accounted as wait time */
+	buf = net_buf_alloc_len(&fixed_pool, 20, K_MSEC(20));
+	zassert_is_null(buf, "Got buffer from exhausted pool");
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	zassert_equal(fixed_pool.stats.alloc_count,
+		      alloc_count + ARRAY_SIZE(bufs),
+		      "Incorrect allocation count");
+	zassert_equal(fixed_pool.stats.alloc_failed, alloc_failed + 2,
+		      "Incorrect failure count");
+	zassert_equal(fixed_pool.stats.max_used, ARRAY_SIZE(bufs),
+		      "Incorrect high-water mark");
+	zassert_true(fixed_pool.stats.wait_time >= 20,
+		     "Incorrect wait time");
+}
+#else
+static void net_buf_test_pool_stats(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 void test_main(void)
 {
 	ztest_test_suite(net_buf_test,
@@ -468,7 +548,9 @@ void test_main(void)
 			 ztest_unit_test(net_buf_test_multi_frags),
 			 ztest_unit_test(net_buf_test_clone),
 			 ztest_unit_test(net_buf_test_fixed_pool),
-			 ztest_unit_test(net_buf_test_var_pool)
+			 ztest_unit_test(net_buf_test_var_pool),
+			 ztest_unit_test(net_buf_test_bounded_var_pool),
+			 ztest_unit_test(net_buf_test_pool_stats)
 			 );
 
 	ztest_run_test_suite(net_buf_test);
@@ -28,6 +28,9 @@ LOG_MODULE_REGISTER(net_test, LOG_LEVEL_DBG);
 #define NUM_OBSERVERS 3
 #define NUM_REPLIES 3
 
+/* application/octet-stream content format */
+#define FORMAT_OCTET_STREAM 42
+
 static struct coap_pending pendings[NUM_PENDINGS];
 static struct coap_observer observers[NUM_OBSERVERS];
 static struct coap_reply replies[NUM_REPLIES];
@@ -155,6 +158,134 @@ done:
 	return result;
 }
 
+static int test_build_template_pdu(void)
+{
+	u8_t tmpl_data[16];
+	u8_t ref_data[COAP_BUF_SIZE];
+	u8_t data[COAP_BUF_SIZE];
+	const char token[] = "token";
+	const char payload[] = "payload";
+	struct coap_template tmpl;
+	struct coap_packet ref;
+	struct coap_packet cpkt;
+	struct coap_option option;
+	const u8_t *pl;
+	u16_t pl_len;
+	int result = TC_FAIL;
+	int r;
+
+	r = coap_template_init(&tmpl, tmpl_data, sizeof(tmpl_data),
+			       COAP_TYPE_CON, COAP_RESPONSE_CODE_CONTENT);
+	if (r < 0) {
+		TC_PRINT("Could not initialize template\n");
+		goto done;
+	}
+
+	r = coap_template_append_observe(&tmpl);
+	if (r < 0) {
+		TC_PRINT("Could not append observe option\n");
+		goto done;
+	}
+
+	r = coap_template_append_option_int(&tmpl, COAP_OPTION_CONTENT_FORMAT,
+					    FORMAT_OCTET_STREAM);
+	if (r < 0) {
+		TC_PRINT("Could not append option\n");
+		goto done;
+	}
+
+	/* Options can't go back in the numbering */
+	r = coap_template_append_observe(&tmpl);
+	if (r == 0) {
+		TC_PRINT("Observe option appended twice\n");
+		goto done;
+	}
+
+	/* A three bytes sequence number is encoded the same way by both */
+	r = coap_packet_init(&ref, ref_data, sizeof(ref_data), 1,
+			     COAP_TYPE_CON, strlen(token), (u8_t *)token,
+			     COAP_RESPONSE_CODE_CONTENT, 0x1234);
+	if (r < 0) {
+		TC_PRINT("Could not initialize packet\n");
+		goto done;
+	}
+
+	r = coap_append_option_int(&ref, COAP_OPTION_OBSERVE, 0x123456);
+	r |= coap_append_option_int(&ref, COAP_OPTION_CONTENT_FORMAT,
+				    FORMAT_OCTET_STREAM);
+	r |= coap_packet_append_payload_marker(&ref);
+	r |= coap_packet_append_payload(&ref, (u8_t *)payload,
+					strlen(payload));
+	if (r < 0) {
+		TC_PRINT("Could not build reference packet\n");
+		goto done;
+	}
+
+	r = coap_template_build(&tmpl, &cpkt, data, sizeof(data), 0x1234,
+				(const u8_t *)token, strlen(token), 0x123456,
+				(const u8_t *)payload, strlen(payload));
+	if (r < 0) {
+		TC_PRINT("Could not build packet from template\n");
+		goto done;
+	}
+
+	if (cpkt.offset != ref.offset ||
+	    memcmp(ref.data, cpkt.data, cpkt.offset)) {
+		TC_PRINT("Built packet doesn't match reference packet\n");
+		goto done;
+	}
+
+	/* Smaller sequence numbers keep their leading zeros */
+	r = coap_template_build(&tmpl, &cpkt, data, sizeof(data), 0x4321,
+				(const u8_t *)token, strlen(token), 5,
+				(const u8_t *)payload, strlen(payload));
+	if (r < 0) {
+		TC_PRINT("Could not build packet from template\n");
+		goto done;
+	}
+
+	r = coap_packet_parse(&cpkt, data, cpkt.offset, NULL, 0);
+	if (r < 0) {
+		TC_PRINT("Could not parse packet built from template\n");
+		goto done;
+	}
+
+	if (coap_header_get_id(&cpkt) != 0x4321) {
+		TC_PRINT("Invalid message id\n");
+		goto done;
+	}
+
+	r = coap_find_options(&cpkt, COAP_OPTION_OBSERVE, &option, 1);
+	if (r != 1 || option.len != COAP_TEMPLATE_OBSERVE_LEN ||
+	    coap_option_value_to_int(&option) != 5) {
+		TC_PRINT("Invalid observe option\n");
+		goto done;
+	}
+
+	pl = coap_packet_get_payload(&cpkt, &pl_len);
+	if (!pl || pl_len != strlen(payload) ||
+	    memcmp(pl, payload, pl_len)) {
+		TC_PRINT("Invalid payload\n");
+		goto done;
+	}
+
+	/* Too small output buffer */
+	r = coap_template_build(&tmpl, &cpkt, data, ref.offset - 1, 0x1234,
+				(const u8_t *)token, strlen(token), 0x123456,
+				(const u8_t *)payload, strlen(payload));
+	if (r == 0) {
+		TC_PRINT("Packet built in a too small buffer\n");
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 /* No options, No payload */
 static int test_parse_empty_pdu(void)
 {
@@ -1462,6 +1593,7 @@ static const struct {
 } tests[] = {
 	{ "Build empty PDU test", test_build_empty_pdu, },
 	{ "Build simple PDU test", test_build_simple_pdu, },
+	{ "Build template PDU test", test_build_template_pdu, },
 	{ "Parse emtpy PDU test", test_parse_empty_pdu, },
 	{ "Parse empty PDU test no marker", test_parse_empty_pdu_1, },
 	{ "Parse simple PDU test", test_parse_simple_pdu, },
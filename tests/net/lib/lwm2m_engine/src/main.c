@@ -0,0 +1,846 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#include <net/socket.h>
+#include <net/coap.h>
+#include <net/lwm2m.h>
+
+#if defined(CONFIG_LWM2M_RW_CBOR_SUPPORT)
+#include <cbor.h>
+#endif
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+#define LWM2M_PORT 5683
+#define LATE_PORT 5684
+#define CLIENT_PORT 9898
+#define CBOR_PORT 5685
+#define SERVER_PORT 9899
+
+/* The engine sends nothing while idle, the only wakeups expected in the
+ * window come from the device object service and from the test thread
+ * itself.
+ */
+#define IDLE_WINDOW K_SECONDS(5)
+#define MAX_IDLE_WAKEUPS 4
+
+/* Time for the engine to receive a packet on a new socket */
+#define RECV_DELAY K_MSEC(100)
+
+#define RECV_TIMEOUT 1000
+
+/* 22.5 as an IEEE 754 single precision value */
+#define TEMP_VALUE_BITS 0x41b40000
+
+static struct lwm2m_ctx ctx;
+static struct lwm2m_ctx late_ctx;
+static struct lwm2m_ctx cbor_ctx;
+
+static volatile u32_t idle_entries;
+
+/* Tracing hooks, called by the architecture code when no tracing backend
+ * is enabled. tracing.h turns the names into empty macros for C code, the
+ * parentheses keep them from being expanded here.
+ */
+void (z_sys_trace_idle)(void)
+{
+	idle_entries++;
+}
+
+void (z_sys_trace_isr_enter)(void)
+{
+}
+
+void (z_sys_trace_isr_exit)(void)
+{
+}
+
+void (z_sys_trace_isr_exit_to_scheduler)(void)
+{
+}
+
+void (z_sys_trace_thread_switched_in)(void)
+{
+}
+
+void (z_sys_trace_thread_switched_out)(void)
+{
+}
+
+static int bound_socket(u16_t port)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(port),
+	};
+	int sock;
+	int ret;
+
+	ret = inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&addr.sin_addr);
+	zassert_equal(ret, 1, "inet_pton failed");
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(sock >= 0, "socket failed");
+
+	ret = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "bind failed");
+
+	return sock;
+}
+
+static void add_context(struct lwm2m_ctx *client_ctx, u16_t port)
+{
+	int ret;
+
+	lwm2m_engine_context_init(client_ctx);
+	client_ctx->sock_fd = bound_socket(port);
+
+	ret = lwm2m_socket_add(client_ctx);
+	zassert_equal(ret, 0, "lwm2m_socket_add failed");
+}
+
+static void test_idle_wakeups(void)
+{
+	u32_t wakeups;
+
+	add_context(&ctx, LWM2M_PORT);
+
+	/* Let the engine start and go idle */
+	k_sleep(K_SECONDS(3));
+
+	wakeups = idle_entries;
+	k_sleep(IDLE_WINDOW);
+	wakeups = idle_entries - wakeups;
+
+	TC_PRINT("%u wakeups in %d ms\n", wakeups, IDLE_WINDOW);
+
+	zassert_true(wakeups <= MAX_IDLE_WAKEUPS, "engine is polling");
+}
+
+static void test_socket_added_while_idle(void)
+{
+	struct sockaddr_in dst = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LATE_PORT),
+	};
+	char buf[8];
+	ssize_t len;
+	int client;
+
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &dst.sin_addr);
+
+	/* The engine is waiting without timeout on the first socket only */
+	add_context(&late_ctx, LATE_PORT);
+
+	client = bound_socket(CLIENT_PORT);
+
+	len = sendto(client, "ping", 4, 0, (struct sockaddr *)&dst,
+		     sizeof(dst));
+	zassert_equal(len, 4, "sendto failed");
+
+	k_sleep(RECV_DELAY);
+
+	/* The engine already read the packet from the new socket */
+	len = recv(late_ctx.sock_fd, buf, sizeof(buf), MSG_DONTWAIT);
+	zassert_equal(len, -1, "packet not received by the engine");
+	zassert_equal(errno, EAGAIN, "");
+
+	lwm2m_engine_context_close(&late_ctx);
+	close(client);
+}
+
+static void test_res_handle(void)
+{
+	struct lwm2m_res_handle value_handle, min_handle, max_handle;
+	float32_value_t value = { .val1 = 21, .val2 = 500000 };
+	float32_value_t min = { .val1 = -40 };
+	float32_value_t max = { .val1 = 85 };
+	float32_value_t out;
+	struct lwm2m_res_update range[] = {
+		LWM2M_RES_UPDATE(&min_handle, &min),
+		LWM2M_RES_UPDATE(&max_handle, &max),
+	};
+	char units[8];
+	int ret;
+
+	ret = lwm2m_engine_create_obj_inst("3303/0");
+	zassert_equal(ret, 0, "cannot create temperature sensor");
+
+	/* Only existing resources can be resolved */
+	ret = lwm2m_engine_get_res_handle("3303/0", &value_handle);
+	zassert_equal(ret, -EINVAL, "object instance resolved");
+	ret = lwm2m_engine_get_res_handle("3303/1/5700", &value_handle);
+	zassert_equal(ret, -ENOENT, "missing instance resolved");
+
+	ret = lwm2m_engine_get_res_handle("3303/0/5700", &value_handle);
+	zassert_equal(ret, 0, "cannot resolve sensor value");
+
+	/* Handle and path accesses see the same resource */
+	ret = lwm2m_engine_res_set_float32(&value_handle, &value);
+	zassert_equal(ret, 0, "cannot set sensor value");
+	ret = lwm2m_engine_get_float32("3303/0/5700", &out);
+	zassert_equal(ret, 0, "cannot get sensor value");
+	zassert_true(out.val1 == value.val1 && out.val2 == value.val2,
+		     "wrong value read by path");
+
+	value.val1 = 22;
+	ret = lwm2m_engine_set_float32("3303/0/5700", &value);
+	zassert_equal(ret, 0, "cannot set sensor value");
+	ret = lwm2m_engine_res_get_float32(&value_handle, &out);
+	zassert_equal(ret, 0, "cannot get sensor value");
+	zassert_equal(out.val1, 22, "wrong value read by handle");
+
+	/* Strings keep the length check of the path setter */
+	ret = lwm2m_engine_get_res_handle("3303/0/5701", &value_handle);
+	zassert_equal(ret, 0, "cannot resolve units");
+	ret = lwm2m_engine_res_set_string(&value_handle, "Cel");
+	zassert_equal(ret, 0, "cannot set units");
+	ret = lwm2m_engine_res_get_string(&value_handle, units,
+					  sizeof(units));
+	zassert_equal(ret, 0, "cannot get units");
+	zassert_true(strcmp(units, "Cel") == 0, "wrong units");
+	ret = lwm2m_engine_res_set_string(&value_handle, "too long");
+	zassert_equal(ret, -ENOMEM, "long string accepted");
+
+	/* Batch update of the sensor range */
+	ret = lwm2m_engine_get_res_handle("3303/0/5603", &min_handle);
+	zassert_equal(ret, 0, "cannot resolve min range");
+	ret = lwm2m_engine_get_res_handle("3303/0/5604", &max_handle);
+	zassert_equal(ret, 0, "cannot resolve max range");
+
+	ret = lwm2m_engine_res_set_batch(range, ARRAY_SIZE(range));
+	zassert_equal(ret, 0, "batch update failed");
+
+	ret = lwm2m_engine_get_float32("3303/0/5603", &out);
+	zassert_equal(ret, 0, "cannot get min range");
+	zassert_equal(out.val1, -40, "wrong min range");
+	ret = lwm2m_engine_get_float32("3303/0/5604", &out);
+	zassert_equal(ret, 0, "cannot get max range");
+	zassert_equal(out.val1, 85, "wrong max range");
+
+	/* A handle which failed to resolve is rejected, and stops the batch
+	 * after the entries which changed.
+	 */
+	ret = lwm2m_engine_get_res_handle("3303/1/5604", &max_handle);
+	zassert_equal(ret, -ENOENT, "missing instance resolved");
+	ret = lwm2m_engine_res_set_float32(&max_handle, &max);
+	zassert_equal(ret, -EINVAL, "failed handle accepted");
+
+	min.val1 = -20;
+	ret = lwm2m_engine_res_set_batch(range, ARRAY_SIZE(range));
+	zassert_equal(ret, -EINVAL, "failed handle accepted in batch");
+	ret = lwm2m_engine_get_float32("3303/0/5603", &out);
+	zassert_equal(ret, 0, "cannot get min range");
+	zassert_equal(out.val1, -20, "wrong min range");
+}
+
+#if defined(CONFIG_LWM2M_RW_CBOR_SUPPORT)
+/* Test object, with a writable multiple resource */
+#define TEST_OBJ_ID 32769
+#define TEST_LEVELS_ID 0
+#define TEST_GAIN_ID 1
+#define TEST_LEVEL_COUNT 3
+
+#define MAX_RECORDS 8
+
+static s32_t test_levels[TEST_LEVEL_COUNT];
+static u8_t test_level_count = TEST_LEVEL_COUNT;
+static float32_value_t test_gain;
+
+static struct lwm2m_engine_obj test_obj;
+static struct lwm2m_engine_obj_field test_fields[] = {
+	OBJ_FIELD(TEST_LEVELS_ID, RW, S32, TEST_LEVEL_COUNT),
+	OBJ_FIELD_DATA(TEST_GAIN_ID, RW, FLOAT32),
+};
+
+static struct lwm2m_engine_obj_inst test_inst;
+static struct lwm2m_engine_res_inst test_res[ARRAY_SIZE(test_fields)];
+
+/* SenML record, as decoded by the tests */
+struct senml_record {
+	char name[16];
+	double value;
+	double time;
+	bool has_time;
+};
+
+static struct lwm2m_engine_obj_inst *test_obj_create(u16_t obj_inst_id)
+{
+	int i = 0;
+
+	INIT_OBJ_RES_MULTI_DATA(test_res, i, TEST_LEVELS_ID,
+				&test_level_count, test_levels,
+				sizeof(*test_levels));
+	INIT_OBJ_RES_DATA(test_res, i, TEST_GAIN_ID,
+			  &test_gain, sizeof(test_gain));
+
+	test_inst.resources = test_res;
+	test_inst.resource_count = i;
+
+	return &test_inst;
+}
+
+static void test_obj_init(void)
+{
+	test_obj.obj_id = TEST_OBJ_ID;
+	test_obj.fields = test_fields;
+	test_obj.field_count = ARRAY_SIZE(test_fields);
+	test_obj.max_instance_count = 1U;
+	test_obj.create_cb = test_obj_create;
+	lwm2m_register_obj(&test_obj);
+
+	zassert_equal(lwm2m_engine_create_obj_inst("32769/0"), 0,
+		      "cannot create test object");
+}
+
+/* Opens the server socket, and the context the engine answers on */
+static int cbor_server_open(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int server;
+	int ret;
+
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &addr.sin_addr);
+	server = bound_socket(SERVER_PORT);
+
+	add_context(&cbor_ctx, CBOR_PORT);
+	ret = connect(cbor_ctx.sock_fd, (struct sockaddr *)&addr,
+		      sizeof(addr));
+	zassert_equal(ret, 0, "connect failed");
+
+	return server;
+}
+
+static void cbor_server_close(int server)
+{
+	lwm2m_engine_context_close(&cbor_ctx);
+	close(server);
+}
+
+/* Starts a request on path, in buf */
+static void request_init(struct coap_packet *req, u8_t *buf, size_t buflen,
+			 u8_t method, const char * const *path, int path_len)
+{
+	int ret;
+	int i;
+
+	ret = coap_packet_init(req, buf, buflen, 1, COAP_TYPE_CON, 0, NULL,
+			       method, coap_next_id());
+	zassert_equal(ret, 0, "cannot init request");
+
+	for (i = 0; i < path_len; i++) {
+		ret = coap_packet_append_option(req, COAP_OPTION_URI_PATH,
+						(const u8_t *)path[i],
+						strlen(path[i]));
+		zassert_equal(ret, 0, "cannot append path");
+	}
+}
+
+/* Sends a request from the server socket to cbor_ctx, and receives the
+ * response in the buffer of the request.
+ */
+static u8_t exchange(int server, struct coap_packet *req,
+		     struct coap_packet *rsp, u8_t *buf, size_t buflen)
+{
+	struct sockaddr_in dst = {
+		.sin_family = AF_INET,
+		.sin_port = htons(CBOR_PORT),
+	};
+	struct pollfd pfd = {
+		.fd = server,
+		.events = POLLIN,
+	};
+	ssize_t len;
+	int ret;
+
+	inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR, &dst.sin_addr);
+
+	len = sendto(server, req->data, req->offset, 0,
+		     (struct sockaddr *)&dst, sizeof(dst));
+	zassert_equal(len, req->offset, "sendto failed");
+
+	zassert_equal(poll(&pfd, 1, RECV_TIMEOUT), 1, "no response");
+
+	len = recv(server, buf, buflen, 0);
+	zassert_true(len > 0, "recv failed");
+
+	ret = coap_packet_parse(rsp, buf, len, NULL, 0);
+	zassert_equal(ret, 0, "cannot parse response");
+
+	return coap_header_get_code(rsp);
+}
+
+/* Sends a GET request for path with the given Accept option, and returns
+ * the payload of the response.
+ */
+static void cbor_get(int server, const char * const *path, int path_len,
+		     int accept, struct coap_packet *rsp, u8_t *buf,
+		     size_t buflen, const u8_t **payload, u16_t *payload_len)
+{
+	struct coap_packet req;
+	int ret;
+
+	request_init(&req, buf, buflen, COAP_METHOD_GET, path, path_len);
+
+	ret = coap_append_option_int(&req, COAP_OPTION_ACCEPT, accept);
+	zassert_equal(ret, 0, "cannot append accept");
+
+	zassert_equal(exchange(server, &req, rsp, buf, buflen),
+		      COAP_RESPONSE_CODE_CONTENT, "request failed");
+
+	*payload = coap_packet_get_payload(rsp, payload_len);
+	zassert_not_null(*payload, "empty response");
+}
+
+/* Sends a PUT request for path with a payload in the given format, and
+ * returns the code of the response.
+ */
+static u8_t cbor_put(int server, const char * const *path, int path_len,
+		     int format, const u8_t *data, size_t len)
+{
+	struct coap_packet req, rsp;
+	u8_t buf[256];
+	int ret;
+
+	request_init(&req, buf, sizeof(buf), COAP_METHOD_PUT, path, path_len);
+
+	ret = coap_append_option_int(&req, COAP_OPTION_CONTENT_FORMAT, format);
+	zassert_equal(ret, 0, "cannot append content format");
+	ret = coap_packet_append_payload_marker(&req);
+	zassert_equal(ret, 0, "cannot append payload marker");
+	ret = coap_packet_append_payload(&req, (u8_t *)data, len);
+	zassert_equal(ret, 0, "cannot append payload");
+
+	return exchange(server, &req, &rsp, buf, sizeof(buf));
+}
+
+/* Reads a number of a SenML record */
+static double senml_number(CborValue *value)
+{
+	int64_t i;
+	float f;
+	double d;
+
+	if (cbor_value_is_integer(value)) {
+		cbor_value_get_int64(value, &i);
+		return i;
+	}
+
+	if (cbor_value_is_float(value)) {
+		cbor_value_get_float(value, &f);
+		return f;
+	}
+
+	zassert_true(cbor_value_is_double(value), "not a number");
+	cbor_value_get_double(value, &d);
+	return d;
+}
+
+/* Decodes the names, numeric values and times of a SenML CBOR pack, and
+ * returns the number of records.
+ */
+static int senml_decode(const u8_t *payload, u16_t payload_len,
+			struct senml_record *records)
+{
+	CborParser parser;
+	CborValue it, record, label;
+	size_t len;
+	int count = 0;
+	int key;
+
+	(void)memset(records, 0, MAX_RECORDS * sizeof(*records));
+
+	cbor_parser_init(payload, payload_len, 0, &parser, &it);
+	zassert_true(cbor_value_is_array(&it), "not a SenML pack");
+	cbor_value_enter_container(&it, &record);
+
+	while (!cbor_value_at_end(&record)) {
+		zassert_true(count < MAX_RECORDS, "too many records");
+		zassert_true(cbor_value_is_map(&record), "not a SenML record");
+		cbor_value_enter_container(&record, &label);
+
+		while (!cbor_value_at_end(&label)) {
+			cbor_value_get_int(&label, &key);
+			cbor_value_advance_fixed(&label);
+
+			if (key == 0) {
+				len = sizeof(records[count].name);
+				cbor_value_copy_text_string(&label,
+							    records[count].name,
+							    &len, NULL);
+			} else if (key == 2) {
+				records[count].value = senml_number(&label);
+			} else if (key == 6) {
+				records[count].time = senml_number(&label);
+				records[count].has_time = true;
+			}
+
+			cbor_value_advance(&label);
+		}
+
+		cbor_value_leave_container(&record, &label);
+		count++;
+	}
+
+	return count;
+}
+
+static void test_cbor_read(void)
+{
+	static const char * const value_path[] = { "3303", "0", "5700" };
+	static const char * const inst_path[] = { "3303", "0" };
+	struct coap_packet rsp;
+	const u8_t *payload;
+	u16_t payload_len;
+	CborParser parser;
+	CborValue it, record, label;
+	u8_t buf[256];
+	char name[16] = "";
+	char text[16];
+	size_t len;
+	bool units_found = false;
+	bool bn_found = false;
+	float value;
+	u32_t bits;
+	int key;
+	int server;
+
+	server = cbor_server_open();
+
+	/* CBOR: a single float, set by test_res_handle */
+	cbor_get(server, value_path, ARRAY_SIZE(value_path),
+		 LWM2M_FORMAT_APP_CBOR, &rsp, buf, sizeof(buf),
+		 &payload, &payload_len);
+
+	cbor_parser_init(payload, payload_len, 0, &parser, &it);
+	zassert_true(cbor_value_is_float(&it), "not a float");
+	cbor_value_get_float(&it, &value);
+	memcpy(&bits, &value, sizeof(bits));
+	zassert_equal(bits, TEMP_VALUE_BITS, "wrong value");
+
+	/* SenML CBOR: a record per resource, the first one with bn */
+	cbor_get(server, inst_path, ARRAY_SIZE(inst_path),
+		 LWM2M_FORMAT_APP_SENML_CBOR, &rsp, buf, sizeof(buf),
+		 &payload, &payload_len);
+
+	cbor_parser_init(payload, payload_len, 0, &parser, &it);
+	zassert_true(cbor_value_is_array(&it), "not a SenML pack");
+	cbor_value_enter_container(&it, &record);
+
+	while (!cbor_value_at_end(&record)) {
+		zassert_true(cbor_value_is_map(&record), "not a SenML record");
+		cbor_value_enter_container(&record, &label);
+
+		while (!cbor_value_at_end(&label)) {
+			cbor_value_get_int(&label, &key);
+			cbor_value_advance_fixed(&label);
+
+			if (key == -2) {
+				len = sizeof(text);
+				cbor_value_copy_text_string(&label, text,
+							    &len, NULL);
+				zassert_true(strcmp(text, "/3303/0/") == 0,
+					     "wrong base name");
+				bn_found = true;
+			} else if (key == 0) {
+				len = sizeof(name);
+				cbor_value_copy_text_string(&label, name,
+							    &len, NULL);
+			} else if (key == 3 && strcmp(name, "5701") == 0) {
+				len = sizeof(text);
+				cbor_value_copy_text_string(&label, text,
+							    &len, NULL);
+				zassert_true(strcmp(text, "Cel") == 0,
+					     "wrong units");
+				units_found = true;
+			}
+
+			cbor_value_advance(&label);
+		}
+
+		cbor_value_leave_container(&record, &label);
+	}
+
+	zassert_true(bn_found, "no base name");
+	zassert_true(units_found, "no units record");
+
+	cbor_server_close(server);
+}
+
+static void test_cbor_write(void)
+{
+	static const char * const gain_path[] = { "32769", "0", "1" };
+	static const char * const level_path[] = { "32769", "0", "0", "2" };
+	static const char * const missing_path[] = { "32769", "0", "0", "3" };
+	static const char * const temp_path[] = { "3303", "0", "5700" };
+	u8_t data[16];
+	CborEncoder enc;
+	float32_value_t gain;
+	int server;
+
+	test_obj_init();
+	server = cbor_server_open();
+
+	/* A single resource */
+	cbor_encoder_init(&enc, data, sizeof(data), 0);
+	cbor_encode_float(&enc, 1.5f);
+	zassert_equal(cbor_put(server, gain_path, ARRAY_SIZE(gain_path),
+			       LWM2M_FORMAT_APP_CBOR, data,
+			       cbor_encoder_get_buffer_size(&enc, data)),
+		      COAP_RESPONSE_CODE_CHANGED, "cannot write gain");
+
+	zassert_equal(lwm2m_engine_get_float32("32769/0/1", &gain), 0, NULL);
+	zassert_true(gain.val1 == 1 && gain.val2 == 500000, "wrong gain");
+
+	/* An instance of a multiple resource, the others are kept */
+	test_levels[0] = 1;
+	test_levels[1] = 2;
+	test_levels[2] = 3;
+
+	cbor_encoder_init(&enc, data, sizeof(data), 0);
+	cbor_encode_int(&enc, 42);
+	zassert_equal(cbor_put(server, level_path, ARRAY_SIZE(level_path),
+			       LWM2M_FORMAT_APP_CBOR, data,
+			       cbor_encoder_get_buffer_size(&enc, data)),
+		      COAP_RESPONSE_CODE_CHANGED, "cannot write level");
+
+	zassert_equal(test_levels[0], 1, "wrong instance written");
+	zassert_equal(test_levels[1], 2, "wrong instance written");
+	zassert_equal(test_levels[2], 42, "level not written");
+
+	/* Past the instances of the resource */
+	zassert_equal(cbor_put(server, missing_path, ARRAY_SIZE(missing_path),
+			       LWM2M_FORMAT_APP_CBOR, data,
+			       cbor_encoder_get_buffer_size(&enc, data)),
+		      COAP_RESPONSE_CODE_NOT_FOUND, "missing level written");
+
+	/* Read only resource */
+	zassert_equal(cbor_put(server, temp_path, ARRAY_SIZE(temp_path),
+			       LWM2M_FORMAT_APP_CBOR, data,
+			       cbor_encoder_get_buffer_size(&enc, data)),
+		      COAP_RESPONSE_CODE_NOT_ALLOWED, "sensor value written");
+
+	cbor_server_close(server);
+}
+
+static void test_senml_cbor_write(void)
+{
+	static const char * const inst_path[] = { "32769", "0" };
+	struct coap_packet rsp;
+	const u8_t *payload;
+	u16_t payload_len;
+	u8_t buf[256];
+	u8_t data[64];
+	size_t len;
+	CborEncoder enc, array, map;
+	float32_value_t gain;
+	int server;
+
+	server = cbor_server_open();
+
+	/* What was just read can be written back, multiple resources
+	 * included.
+	 */
+	test_levels[0] = 1;
+	test_levels[1] = 2;
+	test_levels[2] = 3;
+
+	cbor_get(server, inst_path, ARRAY_SIZE(inst_path),
+		 LWM2M_FORMAT_APP_SENML_CBOR, &rsp, buf, sizeof(buf),
+		 &payload, &payload_len);
+
+	zassert_true(payload_len <= sizeof(data), "pack too long");
+	memcpy(data, payload, payload_len);
+	len = payload_len;
+
+	test_levels[0] = 0;
+	test_levels[1] = 0;
+	test_levels[2] = 0;
+
+	zassert_equal(cbor_put(server, inst_path, ARRAY_SIZE(inst_path),
+			       LWM2M_FORMAT_APP_SENML_CBOR, data, len),
+		      COAP_RESPONSE_CODE_CHANGED, "cannot write pack back");
+
+	zassert_equal(test_levels[0], 1, "level 0 not written");
+	zassert_equal(test_levels[1], 2, "level 1 not written");
+	zassert_equal(test_levels[2], 3, "level 2 not written");
+
+	/* Names relative to the base name, integral float value and a
+	 * time, which is ignored.
+	 */
+	cbor_encoder_init(&enc, data, sizeof(data), 0);
+	cbor_encoder_create_array(&enc, &array, 2);
+
+	cbor_encoder_create_map(&array, &map, 3);
+	cbor_encode_int(&map, -2);
+	cbor_encode_text_stringz(&map, "/32769/0/");
+	cbor_encode_int(&map, 0);
+	cbor_encode_text_stringz(&map, "0/1");
+	cbor_encode_int(&map, 2);
+	cbor_encode_int(&map, -7);
+	cbor_encoder_close_container(&array, &map);
+
+	cbor_encoder_create_map(&array, &map, 3);
+	cbor_encode_int(&map, 0);
+	cbor_encode_text_stringz(&map, "1");
+	cbor_encode_int(&map, 6);
+	cbor_encode_int(&map, -10);
+	cbor_encode_int(&map, 2);
+	cbor_encode_int(&map, 2);
+	cbor_encoder_close_container(&array, &map);
+
+	cbor_encoder_close_container(&enc, &array);
+
+	zassert_equal(cbor_put(server, inst_path, ARRAY_SIZE(inst_path),
+			       LWM2M_FORMAT_APP_SENML_CBOR, data,
+			       cbor_encoder_get_buffer_size(&enc, data)),
+		      COAP_RESPONSE_CODE_CHANGED, "cannot write pack");
+
+	zassert_equal(test_levels[1], -7, "level 1 not written");
+	zassert_equal(lwm2m_engine_get_float32("32769/0/1", &gain), 0, NULL);
+	zassert_true(gain.val1 == 2 && gain.val2 == 0, "wrong gain");
+
+	/* Too deep a path */
+	cbor_encoder_init(&enc, data, sizeof(data), 0);
+	cbor_encoder_create_array(&enc, &array, 1);
+	cbor_encoder_create_map(&array, &map, 2);
+	cbor_encode_int(&map, 0);
+	cbor_encode_text_stringz(&map, "/32769/0/0/1/0");
+	cbor_encode_int(&map, 2);
+	cbor_encode_int(&map, 5);
+	cbor_encoder_close_container(&array, &map);
+	cbor_encoder_close_container(&enc, &array);
+
+	zassert_equal(cbor_put(server, inst_path, ARRAY_SIZE(inst_path),
+			       LWM2M_FORMAT_APP_SENML_CBOR, data,
+			       cbor_encoder_get_buffer_size(&enc, data)),
+		      COAP_RESPONSE_CODE_INTERNAL_ERROR, "bad name written");
+	zassert_equal(test_levels[1], -7, "level written");
+
+	cbor_server_close(server);
+}
+
+static void test_senml_cbor_samples(void)
+{
+	static const char * const gain_path[] = { "32769", "0", "1" };
+	static const char * const inst_path[] = { "32769", "0" };
+	float32_value_t gain = { .val1 = 1 };
+	struct senml_record records[MAX_RECORDS];
+	struct coap_packet rsp;
+	const u8_t *payload;
+	u16_t payload_len;
+	u8_t buf[256];
+	int count;
+	int server;
+
+	server = cbor_server_open();
+
+	/* Only numeric and boolean values have samples */
+	zassert_equal(lwm2m_engine_push_sample("3303/0/5701"), -EINVAL,
+		      "sample of a string pushed");
+
+	/* Two samples of the gain, 300 and 100 ms before the read, and
+	 * one of a level.
+	 */
+	lwm2m_engine_set_float32("32769/0/1", &gain);
+	zassert_equal(lwm2m_engine_push_sample("32769/0/1"), 0, NULL);
+	test_levels[1] = 5;
+	zassert_equal(lwm2m_engine_push_sample("32769/0/0/1"), 0, NULL);
+	k_sleep(K_MSEC(200));
+
+	gain.val1 = 2;
+	lwm2m_engine_set_float32("32769/0/1", &gain);
+	zassert_equal(lwm2m_engine_push_sample("32769/0/1"), 0, NULL);
+	k_sleep(K_MSEC(100));
+
+	gain.val1 = 3;
+	lwm2m_engine_set_float32("32769/0/1", &gain);
+
+	/* The current value, then the samples of the path, oldest first */
+	cbor_get(server, gain_path, ARRAY_SIZE(gain_path),
+		 LWM2M_FORMAT_APP_SENML_CBOR, &rsp, buf, sizeof(buf),
+		 &payload, &payload_len);
+	count = senml_decode(payload, payload_len, records);
+
+	zassert_equal(count, 3, "wrong number of records");
+	zassert_true(strcmp(records[0].name, "1") == 0, "wrong name");
+	zassert_true(records[0].value == 3.0 && !records[0].has_time,
+		     "wrong current value");
+	zassert_true(strcmp(records[1].name, "1") == 0, "wrong name");
+	zassert_true(records[1].value == 1.0 && records[1].has_time,
+		     "wrong first sample");
+	zassert_true(strcmp(records[2].name, "1") == 0, "wrong name");
+	zassert_true(records[2].value == 2.0 && records[2].has_time,
+		     "wrong second sample");
+	zassert_true(records[1].time < -0.29 && records[1].time > -2.0,
+		     "wrong time of the first sample");
+	zassert_true(records[2].time <= -0.1 &&
+		     records[2].time > records[1].time,
+		     "wrong time of the second sample");
+
+	/* Samples are sent once, the one of the level is still there */
+	cbor_get(server, gain_path, ARRAY_SIZE(gain_path),
+		 LWM2M_FORMAT_APP_SENML_CBOR, &rsp, buf, sizeof(buf),
+		 &payload, &payload_len);
+	zassert_equal(senml_decode(payload, payload_len, records), 1,
+		      "samples sent twice");
+
+	cbor_get(server, inst_path, ARRAY_SIZE(inst_path),
+		 LWM2M_FORMAT_APP_SENML_CBOR, &rsp, buf, sizeof(buf),
+		 &payload, &payload_len);
+	count = senml_decode(payload, payload_len, records);
+
+	/* 3 levels and the gain, then the sample */
+	zassert_equal(count, 5, "wrong number of records");
+	zassert_true(strcmp(records[4].name, "0/1") == 0,
+		     "wrong name of the level sample");
+	zassert_true(records[4].value == 5.0 && records[4].has_time,
+		     "wrong level sample");
+
+	cbor_server_close(server);
+}
+#else
+static void test_cbor_read(void)
+{
+	ztest_test_skip();
+}
+
+static void test_cbor_write(void)
+{
+	ztest_test_skip();
+}
+
+static void test_senml_cbor_write(void)
+{
+	ztest_test_skip();
+}
+
+static void test_senml_cbor_samples(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine,
+			 ztest_unit_test(test_idle_wakeups),
+			 ztest_unit_test(test_socket_added_while_idle),
+			 ztest_unit_test(test_res_handle),
+			 ztest_unit_test(test_cbor_read),
+			 ztest_unit_test(test_cbor_write),
+			 ztest_unit_test(test_senml_cbor_write),
+			 ztest_unit_test(test_senml_cbor_samples));
+
+	ztest_run_test_suite(lwm2m_engine);
+}
@@ -0,0 +1,541 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, LOG_LEVEL_WRN);
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/mqtt.h>
+
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+#include <flash_map.h>
+#endif
+
+/* The broker is played by the test itself, on the loopback interface.
+ * It accepts the connection of the client, and parses just enough of
+ * the MQTT packets to answer CONNECT with CONNACK and PUBLISH with
+ * PUBACK.
+ */
+
+#define BROKER_PORT 1883
+
+#define TOPIC "sensors/temperature"
+#define PAYLOAD "21.5"
+
+#define RECV_TIMEOUT 200
+#define INPUT_TIMEOUT 50
+
+/* Round trip time simulated by the broker for the throughput test. */
+#define ACK_DELAY K_MSEC(20)
+#define THROUGHPUT_MSG_COUNT 16
+#define THROUGHPUT_WINDOW 8
+
+#define MQTT_PKT_CONNECT 0x10
+#define MQTT_PKT_PUBLISH 0x30
+#define MQTT_PKT_DUP     0x08
+
+static struct sockaddr_in broker_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(BROKER_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static int listen_sock = -1;
+static int broker_sock = -1;
+static u8_t broker_buf[512];
+static size_t broker_len;
+
+static struct mqtt_client client;
+static struct mqtt_outbox outbox;
+static u8_t rx_buffer[128];
+static u8_t tx_buffer[128];
+static u8_t outbox_buffer[512];
+static int disconnected;
+
+struct publish_info {
+	u16_t message_id;
+	bool dup;
+};
+
+static void evt_handler(struct mqtt_client *const c,
+			const struct mqtt_evt *evt)
+{
+	if (evt->type == MQTT_EVT_DISCONNECT) {
+		disconnected++;
+	}
+}
+
+/* Reads the next packet sent by the client. Returns its first byte, or
+ * 0 if nothing is received before the timeout.
+ */
+static u8_t broker_recv(struct publish_info *info, int timeout)
+{
+	struct pollfd pfd = {
+		.fd = broker_sock,
+		.events = POLLIN,
+	};
+	size_t remaining = 0, hdr_len = 1, total = 0;
+	u16_t topic_len;
+	u8_t type;
+	ssize_t len;
+	int shift = 0;
+
+	while (true) {
+		/* Remaining length, on up to 4 bytes. */
+		if (broker_len >= 2) {
+			remaining = 0;
+			shift = 0;
+			hdr_len = 1;
+
+			while (hdr_len < broker_len) {
+				remaining |= (broker_buf[hdr_len] & 0x7f) <<
+					     shift;
+				shift += 7;
+				if (!(broker_buf[hdr_len++] & 0x80)) {
+					break;
+				}
+			}
+
+			total = hdr_len + remaining;
+			if (!(broker_buf[hdr_len - 1] & 0x80) &&
+			    total <= broker_len) {
+				break;
+			}
+		}
+
+		if (poll(&pfd, 1, timeout) != 1) {
+			return 0;
+		}
+
+		len = recv(broker_sock, broker_buf + broker_len,
+			   sizeof(broker_buf) - broker_len, 0);
+		zassert_true(len > 0, "recv failed");
+		broker_len += len;
+	}
+
+	type = broker_buf[0];
+
+	if ((type & 0xf0) == MQTT_PKT_PUBLISH && info != NULL) {
+		topic_len = sys_get_be16(&broker_buf[hdr_len]);
+		info->message_id =
+			sys_get_be16(&broker_buf[hdr_len + 2 + topic_len]);
+		info->dup = !!(type & MQTT_PKT_DUP);
+	}
+
+	broker_len -= total;
+	memmove(broker_buf, broker_buf + total, broker_len);
+
+	return type;
+}
+
+static void broker_send(const u8_t *data, size_t len)
+{
+	zassert_equal(send(broker_sock, data, len, 0), len, "send failed");
+}
+
+static void broker_puback(u16_t message_id)
+{
+	u8_t puback[] = { 0x40, 0x02, message_id >> 8, message_id & 0xff };
+
+	broker_send(puback, sizeof(puback));
+}
+
+/* Waits for the packets of the client to be processed by the stack. */
+static void client_input(void)
+{
+	struct pollfd pfd = {
+		.fd = client.transport.tcp.sock,
+		.events = POLLIN,
+	};
+
+	while (poll(&pfd, 1, INPUT_TIMEOUT) == 1) {
+		if (mqtt_input(&client) < 0) {
+			break;
+		}
+
+		if (disconnected) {
+			break;
+		}
+	}
+}
+
+static void client_setup(u16_t window)
+{
+	mqtt_client_init(&client);
+
+	client.broker = &broker_addr;
+	client.evt_cb = evt_handler;
+	client.client_id.utf8 = (u8_t *)"outbox";
+	client.client_id.size = strlen("outbox");
+	client.protocol_version = MQTT_VERSION_3_1_1;
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+
+	memset(&outbox, 0, sizeof(outbox));
+	outbox.buf = outbox_buffer;
+	outbox.buf_size = sizeof(outbox_buffer);
+	outbox.window = window;
+
+	disconnected = 0;
+
+	zassert_equal(mqtt_outbox_init(&client, &outbox), 0,
+		      "outbox init failed");
+}
+
+static void client_connect(void)
+{
+	static const u8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+
+	disconnected = 0;
+	broker_len = 0;
+
+	zassert_equal(mqtt_connect(&client), 0, "connect failed");
+
+	broker_sock = accept(listen_sock, NULL, NULL);
+	zassert_true(broker_sock >= 0, "accept failed");
+
+	zassert_equal(broker_recv(NULL, RECV_TIMEOUT) & 0xf0,
+		      MQTT_PKT_CONNECT, "CONNECT expected");
+
+	broker_send(connack, sizeof(connack));
+	client_input();
+}
+
+static void client_close(void)
+{
+	mqtt_disconnect(&client);
+
+	if (broker_sock >= 0) {
+		close(broker_sock);
+		broker_sock = -1;
+	}
+}
+
+static void queue(int count)
+{
+	struct mqtt_publish_param param;
+	int i;
+
+	memset(&param, 0, sizeof(param));
+	param.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE;
+	param.message.topic.topic.utf8 = (u8_t *)TOPIC;
+	param.message.topic.topic.size = strlen(TOPIC);
+	param.message.payload.data = (u8_t *)PAYLOAD;
+	param.message.payload.len = strlen(PAYLOAD);
+
+	for (i = 0; i < count; i++) {
+		zassert_equal(mqtt_outbox_publish(&client, &param), 0,
+			      "publish failed");
+	}
+}
+
+/* Receives the PUBLISH packets sent by the client until it stops. */
+static int broker_recv_all(struct publish_info *info, int max)
+{
+	int count = 0;
+
+	while (count < max &&
+	       broker_recv(&info[count], RECV_TIMEOUT) != 0) {
+		count++;
+	}
+
+	/* Nothing more is expected. */
+	zassert_equal(broker_recv(NULL, RECV_TIMEOUT), 0,
+		      "unexpected packet");
+
+	return count;
+}
+
+static void test_setup(void)
+{
+	int ret;
+
+	listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_sock >= 0, "socket failed");
+
+	ret = bind(listen_sock, (struct sockaddr *)&broker_addr,
+		   sizeof(broker_addr));
+	zassert_equal(ret, 0, "bind failed");
+
+	ret = listen(listen_sock, 1);
+	zassert_equal(ret, 0, "listen failed");
+}
+
+static void test_window(void)
+{
+	struct publish_info info[8];
+
+	client_setup(2);
+	queue(5);
+
+	zassert_equal(mqtt_outbox_count(&client), 5, "wrong count");
+
+	client_connect();
+
+	/* Only the window is sent before the first acknowledgment. */
+	zassert_equal(broker_recv_all(&info[0], 8), 2, "window not respected");
+
+	/* Each acknowledgment lets one more message out. */
+	broker_puback(info[0].message_id);
+	client_input();
+	zassert_equal(broker_recv_all(&info[2], 6), 1, "window not respected");
+
+	broker_puback(info[1].message_id);
+	broker_puback(info[2].message_id);
+	client_input();
+	zassert_equal(broker_recv_all(&info[3], 5), 2, "window not respected");
+
+	zassert_equal(mqtt_outbox_count(&client), 2, "wrong count");
+
+	broker_puback(info[3].message_id);
+	broker_puback(info[4].message_id);
+	client_input();
+
+	zassert_equal(mqtt_outbox_count(&client), 0, "messages left");
+
+	client_close();
+}
+
+static void test_full(void)
+{
+	struct mqtt_publish_param param;
+	int count = 0;
+
+	client_setup(0);
+
+	memset(&param, 0, sizeof(param));
+	param.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE;
+	param.message.topic.topic.utf8 = (u8_t *)TOPIC;
+	param.message.topic.topic.size = strlen(TOPIC);
+	param.message.payload.data = (u8_t *)PAYLOAD;
+	param.message.payload.len = strlen(PAYLOAD);
+
+	while (mqtt_outbox_publish(&client, &param) == 0) {
+		count++;
+		zassert_true(count < sizeof(outbox_buffer), "never full");
+	}
+
+	zassert_equal(mqtt_outbox_publish(&client, &param), -ENOMEM,
+		      "-ENOMEM expected");
+	zassert_equal(mqtt_outbox_count(&client), count, "wrong count");
+
+	param.message.topic.qos = MQTT_QOS_0_AT_MOST_ONCE;
+	zassert_equal(mqtt_outbox_publish(&client, &param), -EINVAL,
+		      "QoS 0 accepted");
+}
+
+static void test_reconnect(void)
+{
+	struct publish_info first[4];
+	struct publish_info again[4];
+	int i;
+
+	client_setup(4);
+	client_connect();
+
+	queue(3);
+	zassert_equal(broker_recv_all(first, ARRAY_SIZE(first)), 3,
+		      "3 messages expected");
+
+	for (i = 0; i < 3; i++) {
+		zassert_false(first[i].dup, "DUP set on first attempt");
+	}
+
+	/* The broker acknowledges the first one, then drops the
+	 * connection.
+	 */
+	broker_puback(first[0].message_id);
+	close(broker_sock);
+	broker_sock = -1;
+	client_input();
+
+	zassert_equal(disconnected, 1, "disconnection not noticed");
+	zassert_equal(mqtt_outbox_count(&client), 2, "wrong count");
+
+	client_connect();
+
+	zassert_equal(broker_recv_all(again, ARRAY_SIZE(again)), 2,
+		      "2 messages expected");
+
+	for (i = 0; i < 2; i++) {
+		zassert_equal(again[i].message_id, first[i + 1].message_id,
+			      "message id changed");
+		zassert_true(again[i].dup, "DUP not set");
+		broker_puback(again[i].message_id);
+	}
+
+	client_input();
+	zassert_equal(mqtt_outbox_count(&client), 0, "messages left");
+
+	client_close();
+}
+
+/* Sends THROUGHPUT_MSG_COUNT messages, with the acknowledgments delayed
+ * by ACK_DELAY, and returns the time it took.
+ */
+static s64_t deliver(u16_t window)
+{
+	struct publish_info info[THROUGHPUT_MSG_COUNT];
+	s64_t start;
+	int count;
+	int i;
+
+	client_setup(window);
+	client_connect();
+
+	start = k_uptime_get();
+
+	queue(THROUGHPUT_MSG_COUNT);
+
+	while (mqtt_outbox_count(&client) > 0) {
+		count = 0;
+		while (count < ARRAY_SIZE(info) &&
+		       broker_recv(&info[count], 10) != 0) {
+			count++;
+		}
+
+		zassert_true(count > 0 && count <= window,
+			     "window not respected");
+
+		k_sleep(ACK_DELAY);
+
+		for (i = 0; i < count; i++) {
+			broker_puback(info[i].message_id);
+		}
+
+		client_input();
+	}
+
+	start = k_uptime_delta(&start);
+
+	client_close();
+
+	return start;
+}
+
+static void test_throughput(void)
+{
+	s64_t serial, windowed;
+
+	serial = deliver(1);
+	windowed = deliver(THROUGHPUT_WINDOW);
+
+	TC_PRINT("%d messages: %d ms with window 1, %d ms with window %d\n",
+		 THROUGHPUT_MSG_COUNT, (int)serial, (int)windowed,
+		 THROUGHPUT_WINDOW);
+
+	zassert_true(windowed * 2 < serial, "window does not help");
+}
+
+#if defined(CONFIG_MQTT_OUTBOX_FCB)
+#define TEST_FCB_FLASH_AREA_ID DT_FLASH_AREA_IMAGE_1_ID
+
+static struct flash_sector test_fcb_sector[] = {
+	{ .fs_off = 0, .fs_size = 0x1000 },
+	{ .fs_off = 0x1000, .fs_size = 0x1000 },
+	{ .fs_off = 0x2000, .fs_size = 0x1000 },
+};
+
+static struct fcb test_fcb;
+
+static void fcb_setup(void)
+{
+	memset(&test_fcb, 0, sizeof(test_fcb));
+	test_fcb.f_sectors = test_fcb_sector;
+	test_fcb.f_sector_cnt = ARRAY_SIZE(test_fcb_sector);
+	test_fcb.f_scratch_cnt = 1;
+
+	zassert_equal(fcb_init(TEST_FCB_FLASH_AREA_ID, &test_fcb), 0,
+		      "fcb init failed");
+}
+
+static void test_fcb_restore(void)
+{
+	struct publish_info first[4];
+	struct publish_info again[4];
+	const struct flash_area *fap;
+	int i;
+
+	zassert_equal(flash_area_open(TEST_FCB_FLASH_AREA_ID, &fap), 0,
+		      "flash area open failed");
+
+	for (i = 0; i < ARRAY_SIZE(test_fcb_sector); i++) {
+		zassert_equal(flash_area_erase(fap, test_fcb_sector[i].fs_off,
+					       test_fcb_sector[i].fs_size),
+			      0, "erase failed");
+	}
+
+	fcb_setup();
+
+	client_setup(4);
+	outbox.fcb = &test_fcb;
+	zassert_equal(mqtt_outbox_init(&client, &outbox), 0,
+		      "outbox init failed");
+
+	client_connect();
+	queue(3);
+	zassert_equal(broker_recv_all(first, ARRAY_SIZE(first)), 3,
+		      "3 messages expected");
+
+	broker_puback(first[1].message_id);
+	client_input();
+	client_close();
+
+	/* Reset: the queue is rebuilt from flash. */
+	fcb_setup();
+
+	client_setup(4);
+	outbox.fcb = &test_fcb;
+	zassert_equal(mqtt_outbox_init(&client, &outbox), 0,
+		      "outbox init failed");
+	zassert_equal(mqtt_outbox_count(&client), 2, "wrong count");
+
+	client_connect();
+	zassert_equal(broker_recv_all(again, ARRAY_SIZE(again)), 2,
+		      "2 messages expected");
+
+	zassert_equal(again[0].message_id, first[0].message_id,
+		      "wrong message");
+	zassert_equal(again[1].message_id, first[2].message_id,
+		      "wrong message");
+
+	for (i = 0; i < 2; i++) {
+		zassert_true(again[i].dup, "DUP not set");
+		broker_puback(again[i].message_id);
+	}
+
+	client_input();
+	client_close();
+}
+#else
+static void test_fcb_restore(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_MQTT_OUTBOX_FCB */
+
+static void test_cleanup(void)
+{
+	close(listen_sock);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mqtt_outbox,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_window),
+			 ztest_unit_test(test_full),
+			 ztest_unit_test(test_reconnect),
+			 ztest_unit_test(test_throughput),
+			 ztest_unit_test(test_fcb_restore),
+			 ztest_unit_test(test_cleanup));
+
+	ztest_run_test_suite(mqtt_outbox);
+}
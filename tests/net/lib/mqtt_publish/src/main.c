@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, LOG_LEVEL_WRN);
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/mqtt.h>
+
+/* The broker is played by the test itself, on the loopback interface.
+ * It answers CONNECT with CONNACK, and checks that a PUBLISH packet
+ * arrives in one segment, whatever the size of its payload against
+ * the transmit buffer of the client.
+ */
+
+#define BROKER_PORT 1883
+
+#define TOPIC "sensors/raw"
+#define PAYLOAD_LEN 200
+
+#define RECV_TIMEOUT 200
+#define INPUT_TIMEOUT 50
+
+#define MQTT_PKT_CONNECT 0x10
+#define MQTT_PKT_PUBLISH 0x30
+
+static struct sockaddr_in broker_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(BROKER_PORT),
+	.sin_addr = { { { 192, 0, 2, 1 } } },
+};
+
+static int listen_sock = -1;
+static int broker_sock = -1;
+static u8_t broker_buf[512];
+
+static struct mqtt_client client;
+static u8_t rx_buffer[32];
+static u8_t tx_buffer[32];
+static u8_t payload[PAYLOAD_LEN];
+
+static void evt_handler(struct mqtt_client *const c,
+			const struct mqtt_evt *evt)
+{
+}
+
+/* Reads what the stack delivers at once: the data of one segment. */
+static ssize_t broker_recv(void)
+{
+	struct pollfd pfd = {
+		.fd = broker_sock,
+		.events = POLLIN,
+	};
+
+	if (poll(&pfd, 1, RECV_TIMEOUT) != 1) {
+		return 0;
+	}
+
+	return recv(broker_sock, broker_buf, sizeof(broker_buf), 0);
+}
+
+/* Waits for the packets of the broker to be processed by the client. */
+static void client_input(void)
+{
+	struct pollfd pfd = {
+		.fd = client.transport.tcp.sock,
+		.events = POLLIN,
+	};
+
+	while (poll(&pfd, 1, INPUT_TIMEOUT) == 1) {
+		if (mqtt_input(&client) < 0) {
+			break;
+		}
+	}
+}
+
+/* Publishes len bytes of the payload, and checks the packet received. */
+static void publish(size_t len)
+{
+	struct mqtt_publish_param param;
+	size_t remaining = 2 + strlen(TOPIC) + len;
+	size_t hdr_len = remaining < 128 ? 2 : 3;
+
+	memset(&param, 0, sizeof(param));
+	param.message.topic.qos = MQTT_QOS_0_AT_MOST_ONCE;
+	param.message.topic.topic.utf8 = (u8_t *)TOPIC;
+	param.message.topic.topic.size = strlen(TOPIC);
+	param.message.payload.data = payload;
+	param.message.payload.len = len;
+
+	zassert_equal(mqtt_publish(&client, &param), 0, "publish failed");
+
+	zassert_equal(broker_recv(), hdr_len + remaining,
+		      "not sent in one segment");
+
+	zassert_equal(broker_buf[0], MQTT_PKT_PUBLISH, "PUBLISH expected");
+	zassert_equal(broker_buf[1], (remaining & 0x7f) |
+		      (hdr_len > 2 ? 0x80 : 0), "wrong remaining length");
+	zassert_equal(sys_get_be16(&broker_buf[hdr_len]), strlen(TOPIC),
+		      "wrong topic length");
+	zassert_equal(memcmp(&broker_buf[hdr_len + 2], TOPIC, strlen(TOPIC)),
+		      0, "wrong topic");
+	zassert_equal(memcmp(&broker_buf[hdr_len + 2 + strlen(TOPIC)],
+			     payload, len),
+		      0, "wrong payload");
+}
+
+static void test_setup(void)
+{
+	static const u8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+	int ret;
+	int i;
+
+	for (i = 0; i < sizeof(payload); i++) {
+		payload[i] = i;
+	}
+
+	listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_sock >= 0, "socket failed");
+
+	ret = bind(listen_sock, (struct sockaddr *)&broker_addr,
+		   sizeof(broker_addr));
+	zassert_equal(ret, 0, "bind failed");
+
+	ret = listen(listen_sock, 1);
+	zassert_equal(ret, 0, "listen failed");
+
+	mqtt_client_init(&client);
+
+	client.broker = &broker_addr;
+	client.evt_cb = evt_handler;
+	client.client_id.utf8 = (u8_t *)"publish";
+	client.client_id.size = strlen("publish");
+	client.protocol_version = MQTT_VERSION_3_1_1;
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+
+	zassert_equal(mqtt_connect(&client), 0, "connect failed");
+
+	broker_sock = accept(listen_sock, NULL, NULL);
+	zassert_true(broker_sock >= 0, "accept failed");
+
+	zassert_true(broker_recv() > 0, "CONNECT expected");
+	zassert_equal(broker_buf[0] & 0xf0, MQTT_PKT_CONNECT,
+		      "CONNECT expected");
+
+	zassert_equal(send(broker_sock, connack, sizeof(connack), 0),
+		      sizeof(connack), "send failed");
+	client_input();
+}
+
+static void test_publish_short(void)
+{
+	publish(16);
+}
+
+static void test_publish_long(void)
+{
+	/* The payload does not fit in the transmit buffer. */
+	zassert_true(PAYLOAD_LEN > sizeof(tx_buffer), NULL);
+
+	publish(PAYLOAD_LEN);
+}
+
+static void test_publish_empty(void)
+{
+	publish(0);
+}
+
+static void test_cleanup(void)
+{
+	mqtt_disconnect(&client);
+
+	close(broker_sock);
+	close(listen_sock);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mqtt_publish,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_publish_short),
+			 ztest_unit_test(test_publish_long),
+			 ztest_unit_test(test_publish_empty),
+			 ztest_unit_test(test_cleanup));
+
+	ztest_run_test_suite(mqtt_publish);
+}
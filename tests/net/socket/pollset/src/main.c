@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+#define MAX_SOCKS CONFIG_NET_SOCKETS_POLLSET_MAX
+#define LATENCY_ROUNDS 20
+
+/* On QEMU, waits take +10ms from the requested time. */
+#define FUZZ 10
+
+#define SENDER_STACK_SIZE 1024
+
+K_THREAD_STACK_DEFINE(sender_stack, SENDER_STACK_SIZE);
+static struct k_thread sender_thread;
+static K_SEM_DEFINE(send_sem, 0, 1);
+static int sender_sock;
+static u32_t send_stamp;
+
+void test_pollset(void)
+{
+	int res;
+	int pset;
+	int c_sock;
+	int s_sock;
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct zsock_pollfd ready[2];
+	u32_t tstamp;
+	ssize_t len;
+	char buf[10];
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	pset = zsock_pollset_create();
+	zassert_true(pset >= 0, "pollset create failed");
+
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_ADD, c_sock, POLLIN);
+	zassert_equal(res, 0, "pollset add failed");
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_ADD, s_sock, POLLIN);
+	zassert_equal(res, 0, "pollset add failed");
+
+	/* A socket can be registered only once */
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_ADD, s_sock, POLLIN);
+	zassert_equal(res, -1, "duplicate add succeeded");
+	zassert_equal(errno, EEXIST, "");
+
+	/* Events are checked, not truncated */
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_MOD, s_sock,
+				POLLIN | 0x10000);
+	zassert_equal(res, -1, "unknown events accepted");
+	zassert_equal(errno, EINVAL, "");
+
+	/* A poll set can't be registered in a poll set */
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_ADD, pset, POLLIN);
+	zassert_equal(res, -1, "pollset add of pollset succeeded");
+	zassert_equal(errno, EOPNOTSUPP, "");
+
+	/* Wait on non-ready sockets with timeout of 0 */
+	tstamp = k_uptime_get_32();
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	/* Wait on non-ready sockets with timeout of 30 */
+	tstamp = k_uptime_get_32();
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30 && tstamp <= 30 + FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	/* Send two pkts for s_sock, only s_sock is reported */
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	tstamp = k_uptime_get_32();
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp <= FUZZ, "");
+	zassert_equal(res, 1, "");
+	zassert_equal(ready[0].fd, s_sock, "");
+	zassert_equal(ready[0].events, POLLIN, "");
+	zassert_equal(ready[0].revents, POLLIN, "");
+
+	/* Level-triggered: still reported while data is pending */
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ready[0].fd, s_sock, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 0);
+	zassert_equal(res, 0, "");
+
+	/* Removed sockets are not reported anymore */
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_DEL, s_sock, 0);
+	zassert_equal(res, 0, "pollset del failed");
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_DEL, s_sock, 0);
+	zassert_equal(res, -1, "duplicate del succeeded");
+	zassert_equal(errno, ENOENT, "");
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 30);
+	zassert_equal(res, 0, "");
+
+	/* Re-adding a socket with pending data reports it at once */
+	res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_ADD, s_sock, POLLIN);
+	zassert_equal(res, 0, "pollset add failed");
+
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ready[0].fd, s_sock, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	/* Closing a socket removes it from the poll set */
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready), 0);
+	zassert_equal(res, 0, "");
+
+	res = close(pset);
+	zassert_equal(res, 0, "close failed");
+}
+
+/* Sends a packet each time the test is about to block. */
+static void sender(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		k_sem_take(&send_sem, K_FOREVER);
+
+		send_stamp = k_cycle_get_32();
+		send(sender_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	}
+}
+
+static u32_t measure_wakeup(int s_sock, int pset, struct pollfd *pollfds,
+			    int nfds)
+{
+	u32_t total = 0;
+	struct zsock_pollfd ready[1];
+	ssize_t len;
+	char buf[10];
+	int res;
+	int i;
+
+	for (i = 0; i < LATENCY_ROUNDS; i++) {
+		/* The test thread is cooperative: the sender only runs once
+		 * it blocks, and the wakeup is measured from the send.
+		 */
+		k_sem_give(&send_sem);
+
+		if (pollfds) {
+			res = poll(pollfds, nfds, 100);
+		} else {
+			res = zsock_pollset_wait(pset, ready, ARRAY_SIZE(ready),
+						 100);
+		}
+
+		total += k_cycle_get_32() - send_stamp;
+
+		zassert_equal(res, 1, "no wakeup");
+
+		len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+		zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+	}
+
+	return total / LATENCY_ROUNDS;
+}
+
+void test_pollset_latency(void)
+{
+	int socks[MAX_SOCKS];
+	struct pollfd pollfds[MAX_SOCKS];
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	u32_t pollset_cycles;
+	u32_t poll_cycles;
+	int c_sock;
+	int pset;
+	int count;
+	int res;
+	int i;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+
+	sender_sock = c_sock;
+	k_thread_create(&sender_thread, sender_stack, SENDER_STACK_SIZE,
+			sender, NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0,
+			K_NO_WAIT);
+
+	pset = zsock_pollset_create();
+	zassert_true(pset >= 0, "pollset create failed");
+
+	for (i = 0; i < MAX_SOCKS; i++) {
+		prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR,
+				    SERVER_PORT + i, &socks[i], &s_addr);
+
+		res = bind(socks[i], (struct sockaddr *)&s_addr,
+			   sizeof(s_addr));
+		zassert_equal(res, 0, "bind failed");
+	}
+
+	TC_PRINT("sockets  poll() cycles  pollset cycles\n");
+
+	/* The ready socket is always the last one, the worst case for a
+	 * linear scan.
+	 */
+	for (count = 1; count <= MAX_SOCKS; count *= 2) {
+		for (i = 0; i < count; i++) {
+			pollfds[i].fd = socks[i];
+			pollfds[i].events = POLLIN;
+
+			res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_ADD,
+						socks[i], POLLIN);
+			zassert_equal(res, 0, "pollset add failed");
+		}
+
+		s_addr.sin6_port = htons(SERVER_PORT + count - 1);
+		res = connect(c_sock, (struct sockaddr *)&s_addr,
+			      sizeof(s_addr));
+		zassert_equal(res, 0, "connect failed");
+
+		poll_cycles = measure_wakeup(socks[count - 1], -1, pollfds,
+					     count);
+		pollset_cycles = measure_wakeup(socks[count - 1], pset, NULL,
+						0);
+
+		TC_PRINT("%7d  %13u  %14u\n", count, poll_cycles,
+			 pollset_cycles);
+
+		for (i = 0; i < count; i++) {
+			res = zsock_pollset_ctl(pset, ZSOCK_POLLSET_DEL,
+						socks[i], 0);
+			zassert_equal(res, 0, "pollset del failed");
+		}
+	}
+
+	for (i = 0; i < MAX_SOCKS; i++) {
+		res = close(socks[i]);
+		zassert_equal(res, 0, "close failed");
+	}
+
+	k_thread_abort(&sender_thread);
+
+	res = close(c_sock);
+	zassert_equal(res, 0, "close failed");
+	res = close(pset);
+	zassert_equal(res, 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_pollset,
+			 ztest_unit_test(test_pollset),
+			 ztest_unit_test(test_pollset_latency));
+
+	ztest_run_test_suite(socket_pollset);
+}
@@ -13,6 +13,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include "../../socket_helpers.h"
 
 #define TEST_STR_SMALL "test"
+#define TEST_STR_GATHER "gathered data"
 
 #define ANY_PORT 0
 #define SERVER_PORT 4242
@@ -326,6 +327,63 @@ void test_v6_sendto_recvfrom_null_dest(void)
 	k_sleep(TCP_TEARDOWN_TIMEOUT);
 }
 
+void test_v4_sendmsg(void)
+{
+	/* Test if sendmsg() sends its buffers in one segment. */
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	struct iovec io_vector[3];
+	struct msghdr msg;
+	char rx_buf[30] = {0};
+	size_t len = strlen(TEST_STR_SMALL) + strlen(TEST_STR_GATHER);
+	ssize_t recved;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+
+	io_vector[0].iov_base = TEST_STR_SMALL;
+	io_vector[0].iov_len = strlen(TEST_STR_SMALL);
+	io_vector[1].iov_base = NULL;
+	io_vector[1].iov_len = 0;
+	io_vector[2].iov_base = TEST_STR_GATHER;
+	io_vector[2].iov_len = strlen(TEST_STR_GATHER);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+
+	zassert_equal(sendmsg(c_sock, &msg, 0), len, "sendmsg failed");
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	/* A stream recv() returns the data of one segment at most */
+	recved = recv(new_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(recved, len, "not sent in one segment");
+	zassert_equal(strncmp(rx_buf, TEST_STR_SMALL, strlen(TEST_STR_SMALL)),
+		      0, "unexpected data");
+	zassert_equal(strncmp(rx_buf + strlen(TEST_STR_SMALL), TEST_STR_GATHER,
+			      strlen(TEST_STR_GATHER)),
+		      0, "unexpected data");
+
+	test_close(new_sock);
+	test_close(c_sock);
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(socket_tcp,
@@ -334,7 +392,8 @@ void test_main(void)
 			 ztest_user_unit_test(test_v4_sendto_recvfrom),
 			 ztest_user_unit_test(test_v6_sendto_recvfrom),
 			 ztest_user_unit_test(test_v4_sendto_recvfrom_null_dest),
-			 ztest_user_unit_test(test_v6_sendto_recvfrom_null_dest));
+			 ztest_user_unit_test(test_v6_sendto_recvfrom_null_dest),
+			 ztest_user_unit_test(test_v4_sendmsg));
 
 	ztest_run_test_suite(socket_tcp);
 }
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/tls_credentials.h>
+
+#define SERVER_PORT 4243
+#define PSK_TAG 1
+
+#define TEST_STR_HEADER "head:"
+#define PAYLOAD_LEN 3000
+
+#define RECORD_LEN CONFIG_NET_SOCKETS_TLS_SENDMSG_BUF_SIZE
+
+#define SERVER_STACK_SIZE 4096
+#define TCP_TEARDOWN_TIMEOUT K_SECONDS(1)
+
+static const u8_t psk[] = {
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+	0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+};
+static const char psk_id[] = "socket_tls";
+
+static const sec_tag_t sec_tags[] = { PSK_TAG };
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+static K_SEM_DEFINE(server_sem, 0, 1);
+
+static int s_sock = -1;
+static u8_t payload[PAYLOAD_LEN];
+static u8_t rx_buf[sizeof(TEST_STR_HEADER) - 1 + PAYLOAD_LEN];
+static ssize_t first_recved;
+static size_t recved;
+
+static void prepare_sock_tls_v4(const char *addr, u16_t port,
+				int *sock, struct sockaddr_in *sockaddr)
+{
+	int rv;
+
+	*sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(*sock >= 0, "socket open failed");
+
+	rv = setsockopt(*sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tags,
+			sizeof(sec_tags));
+	zassert_equal(rv, 0, "setsockopt failed");
+
+	sockaddr->sin_family = AF_INET;
+	sockaddr->sin_port = htons(port);
+	rv = inet_pton(AF_INET, addr, &sockaddr->sin_addr);
+	zassert_equal(rv, 1, "inet_pton failed");
+}
+
+/* Accepts the client, and receives its data: the handshakes block. */
+static void server_entry(void *p1, void *p2, void *p3)
+{
+	int new_sock;
+	ssize_t ret;
+
+	new_sock = accept(s_sock, NULL, NULL);
+	if (new_sock < 0) {
+		k_sem_give(&server_sem);
+		return;
+	}
+
+	/* A TLS recv() returns the data of one record at most */
+	first_recved = recv(new_sock, rx_buf, sizeof(rx_buf), 0);
+	recved = first_recved > 0 ? first_recved : 0;
+
+	while (first_recved > 0 && recved < sizeof(rx_buf)) {
+		ret = recv(new_sock, &rx_buf[recved], sizeof(rx_buf) - recved,
+			   0);
+		if (ret <= 0) {
+			break;
+		}
+
+		recved += ret;
+	}
+
+	close(new_sock);
+	k_sem_give(&server_sem);
+}
+
+static void test_credentials(void)
+{
+	zassert_equal(tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK,
+					 psk, sizeof(psk)),
+		      0, "PSK not added");
+	zassert_equal(tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK_ID,
+					 psk_id, strlen(psk_id)),
+		      0, "PSK identity not added");
+}
+
+static void test_v4_sendmsg(void)
+{
+	/* Test if sendmsg() gathers its short buffers in one record. */
+	int c_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct iovec io_vector[3];
+	struct msghdr msg;
+	size_t len = sizeof(rx_buf);
+	int i;
+
+	for (i = 0; i < sizeof(payload); i++) {
+		payload[i] = i;
+	}
+
+	prepare_sock_tls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, 0,
+			    &c_sock, &c_saddr);
+	prepare_sock_tls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	zassert_equal(bind(s_sock, (struct sockaddr *)&s_saddr,
+			   sizeof(s_saddr)),
+		      0, "bind failed");
+	zassert_equal(listen(s_sock, 1), 0, "listen failed");
+
+	k_thread_create(&server_thread, server_stack, SERVER_STACK_SIZE,
+			server_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	zassert_equal(connect(c_sock, (struct sockaddr *)&s_saddr,
+			      sizeof(s_saddr)),
+		      0, "connect failed");
+
+	io_vector[0].iov_base = TEST_STR_HEADER;
+	io_vector[0].iov_len = strlen(TEST_STR_HEADER);
+	io_vector[1].iov_base = NULL;
+	io_vector[1].iov_len = 0;
+	io_vector[2].iov_base = payload;
+	io_vector[2].iov_len = sizeof(payload);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+
+	zassert_equal(sendmsg(c_sock, &msg, 0), len, "sendmsg failed");
+
+	zassert_equal(k_sem_take(&server_sem, K_SECONDS(10)), 0,
+		      "server timed out");
+
+	/* The header shares the first record with the payload */
+	zassert_equal(first_recved, min(len, RECORD_LEN),
+		      "header not sent with the payload");
+	zassert_equal(recved, len, "data missing");
+	zassert_equal(memcmp(rx_buf, TEST_STR_HEADER, strlen(TEST_STR_HEADER)),
+		      0, "unexpected header");
+	zassert_equal(memcmp(&rx_buf[strlen(TEST_STR_HEADER)], payload,
+			     sizeof(payload)),
+		      0, "unexpected payload");
+
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_tls,
+			 ztest_unit_test(test_credentials),
+			 ztest_unit_test(test_v4_sendmsg));
+
+	ztest_run_test_suite(socket_tls);
+}
@@ -301,6 +301,60 @@ void test_send_recv_2_sock(void)
 	zassert_equal(rv, 0, "close failed");
 }
 
+void test_v4_sendmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct iovec io_vector[3];
+	struct msghdr msg;
+	static char rx_buf[400];
+	ssize_t sent;
+	ssize_t recved;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* The buffers are gathered in a single datagram */
+	io_vector[0].iov_base = TEST_STR_SMALL;
+	io_vector[0].iov_len = STRLEN(TEST_STR_SMALL);
+	io_vector[1].iov_base = NULL;
+	io_vector[1].iov_len = 0;
+	io_vector[2].iov_base = TEST_STR2;
+	io_vector[2].iov_len = STRLEN(TEST_STR2);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &server_addr;
+	msg.msg_namelen = sizeof(server_addr);
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+
+	sent = sendmsg(client_sock, &msg, 0);
+	zassert_equal(sent, STRLEN(TEST_STR_SMALL) + STRLEN(TEST_STR2),
+		      "sendmsg failed");
+
+	clear_buf(rx_buf);
+	recved = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(recved, sent, "unexpected received bytes");
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR_SMALL), "wrong data");
+	zassert_mem_equal(rx_buf + STRLEN(TEST_STR_SMALL),
+			  BUF_AND_SIZE(TEST_STR2), "wrong data");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(socket_udp,
@@ -308,7 +362,8 @@ void test_main(void)
 			 ztest_unit_test(test_v4_sendto_recvfrom),
 			 ztest_unit_test(test_v6_sendto_recvfrom),
 			 ztest_unit_test(test_v4_bind_sendto),
-			 ztest_unit_test(test_v6_bind_sendto));
+			 ztest_unit_test(test_v6_bind_sendto),
+			 ztest_unit_test(test_v4_sendmsg));
 
 	ztest_run_test_suite(socket_udp);
 }
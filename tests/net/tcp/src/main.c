@@ -1527,10 +1527,9 @@ static inline u32_t get_recv_wnd(struct net_tcp *tcp)
 	/* We don't queue received data inside the stack, we hand off
 	 * packets to synchronous callbacks (who can queue if they
 	 * want, but it's not our business).  So the available window
-	 * size is always the same.  There are two configurables to
-	 * check though.
+	 * size is always the configured one.
 	 */
-	return min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
+	return CONFIG_NET_TCP_RECV_WINDOW_SIZE;
 }
 
 static bool test_tcp_seq_validity(void)
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* TCP bulk transfer over a link with a long round trip time and some
+ * packet loss. The client connects to PEER_IPV4_ADDR, which is not a
+ * local address, so the packets of both directions go through the
+ * network interface of this test. It plays the peer: it swaps the
+ * addresses of the packets and loops them back after a fixed delay,
+ * and drops one data segment out of LOSS_INTERVAL, like
+ * "tc qdisc add dev <if> root netem delay 50ms loss 2%" would do on
+ * Linux.
+ *
+ * The same settings can be checked against a Linux peer by building
+ * samples/net/zperf for native_posix with this test's TCP options,
+ * and running iperf on the host with netem configured on the zeth
+ * interface.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+#include <ztest.h>
+
+#define SERVER_PORT 4242
+
+/* Address of the peer, on the subnet of the interface */
+#define PEER_IPV4_ADDR "192.0.2.2"
+
+#define TRANSFER_SIZE (64 * 1024)
+#define CHUNK_SIZE 512
+
+/* One way delay of the link */
+#define LINK_DELAY K_MSEC(50)
+
+/* Drop one data segment out of this many */
+#define LOSS_INTERVAL 50
+
+/* Segments with less data than this are never dropped, so that the
+ * connection setup is not delayed.
+ */
+#define LOSS_MIN_LEN 128
+
+#define TRANSFER_TIMEOUT K_SECONDS(120)
+
+#define DELAY_QUEUE_LEN (CONFIG_NET_PKT_RX_COUNT)
+#define DELAY_STACK_SIZE 1024
+
+struct delayed_pkt {
+	struct net_pkt *pkt;
+	u32_t due;
+};
+
+K_MSGQ_DEFINE(delay_queue, sizeof(struct delayed_pkt), DELAY_QUEUE_LEN, 4);
+
+static K_THREAD_STACK_DEFINE(delay_stack, DELAY_STACK_SIZE);
+static struct k_thread delay_thread;
+
+static K_THREAD_STACK_DEFINE(server_stack, 2048);
+static struct k_thread server_thread;
+
+static K_SEM_DEFINE(server_done, 0, 1);
+
+static u32_t data_segments;
+static u32_t dropped_segments;
+static u32_t delayed_segments;
+static size_t received;
+static bool data_ok;
+
+static void delay_fn(void *p1, void *p2, void *p3)
+{
+	struct delayed_pkt entry;
+	s32_t wait;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_msgq_get(&delay_queue, &entry, K_FOREVER);
+
+		wait = (s32_t)(entry.due - k_uptime_get_32());
+		if (wait > 0) {
+			k_sleep(wait);
+		}
+
+		if (net_recv_data(net_pkt_iface(entry.pkt), entry.pkt) < 0) {
+			net_pkt_unref(entry.pkt);
+		}
+	}
+}
+
+static int delay_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_thread_create(&delay_thread, delay_stack,
+			K_THREAD_STACK_SIZEOF(delay_stack),
+			delay_fn, NULL, NULL, NULL,
+			K_PRIO_COOP(7), 0, K_NO_WAIT);
+
+	return 0;
+}
+
+static void delay_iface_init(struct net_if *iface)
+{
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	static u8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int delay_send(struct device *dev, struct net_pkt *pkt)
+{
+	struct delayed_pkt entry;
+	struct in_addr addr;
+
+	ARG_UNUSED(dev);
+
+	if (net_pkt_get_len(pkt) >= LOSS_MIN_LEN &&
+	    (++data_segments % LOSS_INTERVAL) == 0) {
+		dropped_segments++;
+		return 0;
+	}
+
+	/* The sent packet is released by the caller, and can still be in
+	 * the TCP retransmission queue, so pass a copy to the receiver.
+	 */
+	entry.pkt = net_pkt_clone(pkt, K_MSEC(100));
+	if (!entry.pkt) {
+		return -ENOMEM;
+	}
+
+	/* Sent to the peer, the packet comes back from it. Swapping the
+	 * addresses keeps the IPv4 and TCP checksums valid.
+	 */
+	net_ipaddr_copy(&addr, &NET_IPV4_HDR(entry.pkt)->src);
+	net_ipaddr_copy(&NET_IPV4_HDR(entry.pkt)->src,
+			&NET_IPV4_HDR(entry.pkt)->dst);
+	net_ipaddr_copy(&NET_IPV4_HDR(entry.pkt)->dst, &addr);
+
+	entry.due = k_uptime_get_32() + LINK_DELAY;
+
+	if (k_msgq_put(&delay_queue, &entry, K_NO_WAIT)) {
+		/* Queue overflow, like a full router buffer */
+		net_pkt_unref(entry.pkt);
+		dropped_segments++;
+	} else {
+		delayed_segments++;
+	}
+
+	return 0;
+}
+
+static struct dummy_api delay_if_api = {
+	.iface_api.init = delay_iface_init,
+	.send = delay_send,
+};
+
+NET_DEVICE_INIT(delay_if, "delay_if",
+		delay_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&delay_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static void server_fn(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	u8_t buf[CHUNK_SIZE];
+	ssize_t len;
+	int client;
+	int i;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	data_ok = true;
+
+	client = accept(sock, NULL, NULL);
+	if (client < 0) {
+		data_ok = false;
+		k_sem_give(&server_done);
+		return;
+	}
+
+	while ((len = recv(client, buf, sizeof(buf), 0)) > 0) {
+		for (i = 0; i < len; i++) {
+			if (buf[i] != (u8_t)(received + i)) {
+				data_ok = false;
+			}
+		}
+
+		received += len;
+	}
+
+	close(client);
+	k_sem_give(&server_done);
+}
+
+static void test_tcp_throughput(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	struct sockaddr_in peer_addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	u8_t buf[CHUNK_SIZE];
+	size_t sent = 0;
+	u32_t elapsed;
+	ssize_t len;
+	int server;
+	int client;
+	int ret;
+	int i;
+
+	zassert_equal(inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+				&addr.sin_addr), 1, "inet_pton failed");
+	zassert_equal(inet_pton(AF_INET, PEER_IPV4_ADDR,
+				&peer_addr.sin_addr), 1, "inet_pton failed");
+
+	server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(server >= 0, "socket failed");
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(client >= 0, "socket failed");
+
+	ret = bind(server, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "bind failed");
+	ret = listen(server, 1);
+	zassert_equal(ret, 0, "listen failed");
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server_fn, INT_TO_POINTER(server), NULL, NULL,
+			K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+
+	/* The server accepts the connection from the peer address */
+	ret = connect(client, (struct sockaddr *)&peer_addr,
+		      sizeof(peer_addr));
+	zassert_equal(ret, 0, "connect failed");
+
+	elapsed = k_uptime_get_32();
+
+	while (sent < TRANSFER_SIZE) {
+		for (i = 0; i < sizeof(buf); i++) {
+			buf[i] = (u8_t)(sent + i);
+		}
+
+		len = send(client, buf, sizeof(buf), 0);
+		zassert_true(len > 0, "send failed");
+
+		/* Keep the pattern aligned on what was actually sent */
+		sent += len;
+	}
+
+	ret = close(client);
+	zassert_equal(ret, 0, "close failed");
+
+	zassert_equal(k_sem_take(&server_done, TRANSFER_TIMEOUT), 0,
+		      "transfer timed out");
+
+	elapsed = k_uptime_get_32() - elapsed;
+
+	TC_PRINT("%u bytes in %u ms (%u B/s), %u of %u segments dropped\n",
+		 received, elapsed, (u32_t)(received * 1000U / elapsed),
+		 dropped_segments, data_segments);
+
+	zassert_true(data_ok, "corrupted data");
+	zassert_equal(received, TRANSFER_SIZE, "data lost");
+
+	/* The transfer went through the link, and recovered from losses */
+	zassert_true(delayed_segments > 0, "no segment delayed");
+	zassert_true(dropped_segments > 0, "no segment dropped");
+	zassert_true(elapsed >= 2 * LINK_DELAY, "round trip not delayed");
+
+	close(server);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_tcp_throughput,
+			 ztest_unit_test(test_tcp_throughput));
+
+	ztest_run_test_suite(net_tcp_throughput);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <tracing_cpu_stats.h>
+
+#define STACK_SIZE 2048
+#define DEEP_SIZE 1024
+
+#define BUSY_US 5000
+#define BUSY_LOOPS 4
+
+/* Enough switches out for the sampling to scan the whole stack */
+#define SAMPLE_LOOPS \
+	(STACK_SIZE / (CONFIG_TRACING_CPU_STATS_THREADS_STACK_WORDS * 4) + 1)
+
+K_THREAD_STACK_DEFINE(worker_stack, STACK_SIZE);
+static struct k_thread worker;
+
+static K_SEM_DEFINE(worker_sem, 0, 1);
+static K_SEM_DEFINE(test_sem, 0, 1);
+
+static void busy_entry(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	/* Switched out and in again at each sleep */
+	for (i = 0; i < BUSY_LOOPS; i++) {
+		k_busy_wait(BUSY_US);
+		k_sleep(1);
+	}
+
+	k_sem_give(&test_sem);
+}
+
+static void __attribute__((noinline)) stack_deep_use(void)
+{
+	volatile u8_t buf[DEEP_SIZE];
+	int i;
+
+	for (i = 0; i < sizeof(buf); i++) {
+		buf[i] = 0U;
+	}
+}
+
+static void stack_sample(void)
+{
+	int i;
+
+	for (i = 0; i < SAMPLE_LOOPS; i++) {
+		k_sleep(1);
+	}
+}
+
+static void stack_entry(void *p1, void *p2, void *p3)
+{
+	stack_sample();
+	k_sem_give(&test_sem);
+	k_sem_take(&worker_sem, K_FOREVER);
+
+	stack_deep_use();
+	stack_sample();
+	k_sem_give(&test_sem);
+}
+
+/* The worker is preemptible, so it only runs once the test waits */
+static void worker_start(k_thread_entry_t entry)
+{
+	k_thread_create(&worker, worker_stack, STACK_SIZE, entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+}
+
+static void test_runtime(void)
+{
+	struct cpu_stats_thread stats;
+
+	worker_start(busy_entry);
+
+	cpu_stats_thread_get(&worker, &stats);
+	zassert_equal(stats.switches, 0, "thread not run yet");
+	zassert_equal(stats.runtime, 0, "thread not run yet");
+
+	k_sem_take(&test_sem, K_FOREVER);
+
+	/* The interrupts during the busy waits are not accounted */
+	cpu_stats_thread_get(&worker, &stats);
+	zassert_true(stats.switches >= BUSY_LOOPS, "switches %u",
+		     stats.switches);
+	zassert_true(stats.runtime >= (u64_t)BUSY_LOOPS * BUSY_US *
+		     NSEC_PER_USEC / 2, "runtime %llu ns", stats.runtime);
+
+	k_thread_abort(&worker);
+}
+
+static void test_stack_used(void)
+{
+	struct cpu_stats_thread before;
+	struct cpu_stats_thread after;
+
+	worker_start(stack_entry);
+
+	k_sem_take(&test_sem, K_FOREVER);
+	cpu_stats_thread_get(&worker, &before);
+	zassert_true(before.stack_used < DEEP_SIZE, "stack used %u",
+		     before.stack_used);
+
+	k_sem_give(&worker_sem);
+	k_sem_take(&test_sem, K_FOREVER);
+	cpu_stats_thread_get(&worker, &after);
+	zassert_true(after.stack_used >= DEEP_SIZE, "stack used %u",
+		     after.stack_used);
+	zassert_true(after.switches > before.switches, NULL);
+
+	k_thread_abort(&worker);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(cpu_stats,
+			 ztest_unit_test(test_runtime),
+			 ztest_unit_test(test_stack_used));
+
+	ztest_run_test_suite(cpu_stats);
+}
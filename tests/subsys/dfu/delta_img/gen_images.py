@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019 HES-SO Valais-Wallis
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# This writes two images looking like two builds of an application: the new
+# build has a function added in the middle of the text, the functions and
+# literals after it moved, the absolute addresses to them relocated, and a
+# string changed.
+
+import random
+import struct
+import sys
+
+BASE = 0x10000
+SIZE = 24 * 1024
+ADDED = 212
+
+
+def build(added):
+    rnd = random.Random(1)
+    out = bytearray()
+    shift = 0
+
+    while len(out) < SIZE:
+        if added and shift == 0 and len(out) >= SIZE // 3:
+            out += bytes(random.Random(2).getrandbits(8)
+                         for _ in range(ADDED))
+            shift = ADDED
+
+        # a function: code, then a literal pool of addresses
+        out += bytes(rnd.getrandbits(8) for _ in range(rnd.randrange(16, 96)))
+        for _ in range(rnd.randrange(1, 4)):
+            addr = BASE + rnd.randrange(SIZE)
+            if addr >= BASE + SIZE // 3:
+                addr += shift
+            out += struct.pack('<I', addr)
+
+    version = b'v1.0.1' if added else b'v1.0.0'
+    return bytes(out) + b'Zephyr app ' + version + b'\0'
+
+
+def main():
+    with open(sys.argv[1], 'wb') as f:
+        f.write(build(False))
+    with open(sys.argv[2], 'wb') as f:
+        f.write(build(True))
+
+
+if __name__ == "__main__":
+    main()
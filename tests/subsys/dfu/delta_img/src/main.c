@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <dfu/delta_img.h>
+
+static const u8_t old_img[] = {
+#include <old.bin.inc>
+};
+
+static const u8_t new_img[] = {
+#include <new.bin.inc>
+};
+
+static const u8_t patch[] = {
+#include <patch.bin.inc>
+};
+
+static u8_t src[sizeof(old_img)];
+static u8_t out[sizeof(new_img) + CONFIG_IMG_DELTA_BUF_SIZE];
+static size_t out_len;
+static bool flushed;
+
+static int src_read(void *arg, off_t off, void *dst, size_t len)
+{
+	if (off < 0 || off + len > sizeof(src)) {
+		return -EINVAL;
+	}
+
+	memcpy(dst, &src[off], len);
+
+	return 0;
+}
+
+static int out_write(void *arg, u8_t *data, size_t len, bool flush)
+{
+	zassert_false(flushed, "write after flush");
+
+	if (out_len + len > sizeof(out)) {
+		return -ENOSPC;
+	}
+
+	memcpy(&out[out_len], data, len);
+	out_len += len;
+	flushed = flush;
+
+	return 0;
+}
+
+static int apply(const u8_t *data, size_t len, size_t chunk)
+{
+	struct delta_img_context ctx;
+	size_t off;
+	size_t n;
+	int rc;
+
+	memcpy(src, old_img, sizeof(src));
+	out_len = 0;
+	flushed = false;
+
+	zassert_equal(delta_img_init(&ctx, src_read, NULL, out_write, NULL), 0,
+		      NULL);
+
+	for (off = 0; off < len; off += n) {
+		n = min(chunk, len - off);
+		rc = delta_img_write(&ctx, &data[off], n, off + n == len);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	zassert_equal(delta_img_bytes_read(&ctx), len, NULL);
+
+	return 0;
+}
+
+static void test_is_patch(void)
+{
+	zassert_true(delta_img_is_patch(patch, sizeof(patch)), NULL);
+	zassert_false(delta_img_is_patch(new_img, sizeof(new_img)), NULL);
+	zassert_false(delta_img_is_patch(patch, 3), NULL);
+}
+
+static void test_apply(void)
+{
+	static const size_t chunks[] = { 1, 7, 64, 512, sizeof(patch) };
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(chunks); i++) {
+		zassert_equal(apply(patch, sizeof(patch), chunks[i]), 0,
+			      "chunk %u", chunks[i]);
+		zassert_true(flushed, NULL);
+		zassert_equal(out_len, sizeof(new_img), NULL);
+		zassert_equal(memcmp(out, new_img, sizeof(new_img)), 0,
+			      "chunk %u", chunks[i]);
+	}
+}
+
+static void test_patch_size(void)
+{
+	TC_PRINT("%u bytes patch for a %u bytes image\n", sizeof(patch),
+		 sizeof(new_img));
+
+	zassert_true(sizeof(patch) < sizeof(new_img) / 4, NULL);
+}
+
+static void test_wrong_source(void)
+{
+	struct delta_img_context ctx;
+
+	memcpy(src, old_img, sizeof(src));
+	src[sizeof(src) / 2] ^= 0x01;
+
+	delta_img_init(&ctx, src_read, NULL, out_write, NULL);
+	zassert_equal(delta_img_write(&ctx, patch, sizeof(patch), true),
+		      -EINVAL, NULL);
+}
+
+static void test_truncated(void)
+{
+	zassert_equal(apply(patch, sizeof(patch) - 1, 64), -EINVAL, NULL);
+	zassert_false(flushed, NULL);
+}
+
+static void test_malformed(void)
+{
+	u8_t bad[DELTA_IMG_HEADER_SIZE + 8];
+
+	memcpy(bad, patch, DELTA_IMG_HEADER_SIZE);
+
+	/* copy from beyond the end of the source */
+	bad[DELTA_IMG_HEADER_SIZE] = 0;
+	bad[DELTA_IMG_HEADER_SIZE + 1] = 16;
+	bad[DELTA_IMG_HEADER_SIZE + 2] = 0xfe;
+	bad[DELTA_IMG_HEADER_SIZE + 3] = 0xff;
+	bad[DELTA_IMG_HEADER_SIZE + 4] = 0x07;
+	zassert_equal(apply(bad, DELTA_IMG_HEADER_SIZE + 5, 64), -EINVAL,
+		      NULL);
+
+	/* unknown op */
+	bad[DELTA_IMG_HEADER_SIZE] = 2;
+	zassert_equal(apply(bad, DELTA_IMG_HEADER_SIZE + 1, 64), -EINVAL,
+		      NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(delta_img,
+			 ztest_unit_test(test_is_patch),
+			 ztest_unit_test(test_apply),
+			 ztest_unit_test(test_patch_size),
+			 ztest_unit_test(test_wrong_source),
+			 ztest_unit_test(test_truncated),
+			 ztest_unit_test(test_malformed));
+	ztest_run_test_suite(delta_img);
+}
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <dfu/frag_decoder.h>
+
+#define FRAG_SIZE	16
+#define NB_FRAGS	100
+#define FLASH_ALIGN	4
+
+/* Flash areas emulated in RAM, which are only written once erased */
+static u8_t flash[2048 + 1024];
+
+static const struct flash_area file_area = {
+	.fa_off = 0,
+	.fa_size = 2048,
+};
+
+static const struct flash_area matrix_area = {
+	.fa_off = 2048,
+	.fa_size = 1024,
+};
+
+int flash_area_read(const struct flash_area *fa, off_t off, void *dst,
+		    size_t len)
+{
+	zassert_true(off >= 0 && off + len <= fa->fa_size, "read out of area");
+	memcpy(dst, &flash[fa->fa_off + off], len);
+
+	return 0;
+}
+
+int flash_area_write(const struct flash_area *fa, off_t off, const void *src,
+		     size_t len)
+{
+	size_t i;
+
+	zassert_true(off >= 0 && off + len <= fa->fa_size,
+		     "write out of area");
+	zassert_equal(off % FLASH_ALIGN, 0, "unaligned write");
+	zassert_equal(len % FLASH_ALIGN, 0, "unaligned write");
+
+	for (i = 0; i < len; i++) {
+		zassert_equal(flash[fa->fa_off + off + i], 0xff,
+			      "write to a byte not erased");
+	}
+
+	memcpy(&flash[fa->fa_off + off], src, len);
+
+	return 0;
+}
+
+int flash_area_erase(const struct flash_area *fa, off_t off, size_t len)
+{
+	memset(&flash[fa->fa_off + off], 0xff, len);
+
+	return 0;
+}
+
+u8_t flash_area_align(const struct flash_area *fa)
+{
+	return FLASH_ALIGN;
+}
+
+static struct frag_decoder dec;
+static u8_t file[NB_FRAGS][FRAG_SIZE];
+static u32_t seed;
+
+static u32_t next_rand(void)
+{
+	seed = seed * 1103515245U + 12345U;
+
+	return seed >> 16;
+}
+
+/*
+ * Sender side, straight from the LoRaWAN fragmented data block transport
+ * specification.
+ */
+static int spec_prbs23(int x)
+{
+	int b0 = x & 1;
+	int b1 = (x & 32) >> 5;
+
+	return (x >> 1) + ((b0 ^ b1) << 22);
+}
+
+static void spec_matrix_line(u8_t *line, int n, int m)
+{
+	int mm = 0;
+	int x;
+	int nb_coeff = 0;
+	int r;
+
+	if ((m & (m - 1)) == 0) {
+		mm = 1;
+	}
+
+	x = 1 + (1001 * n);
+	memset(line, 0, m);
+
+	while (nb_coeff < m / 2) {
+		r = 1 << 16;
+		while (r >= m) {
+			x = spec_prbs23(x);
+			r = x % (m + mm);
+		}
+
+		line[r] = 1;
+		nb_coeff += 1;
+	}
+}
+
+static void coded_fragment(u8_t *frag, int n)
+{
+	u8_t line[NB_FRAGS];
+	int i, j;
+
+	spec_matrix_line(line, n, NB_FRAGS);
+	memset(frag, 0, FRAG_SIZE);
+
+	for (i = 0; i < NB_FRAGS; i++) {
+		if (line[i]) {
+			for (j = 0; j < FRAG_SIZE; j++) {
+				frag[j] ^= file[i][j];
+			}
+		}
+	}
+}
+
+static void setup(u32_t s)
+{
+	int i, j;
+
+	seed = s;
+	for (i = 0; i < NB_FRAGS; i++) {
+		for (j = 0; j < FRAG_SIZE; j++) {
+			file[i][j] = next_rand();
+		}
+	}
+
+	zassert_equal(frag_decoder_init(&dec, &file_area, &matrix_area,
+					NB_FRAGS, FRAG_SIZE), 0, NULL);
+}
+
+/* Sends the uncoded fragments, dropping those in lost */
+static void send_uncoded(const bool *lost)
+{
+	int i;
+
+	for (i = 0; i < NB_FRAGS; i++) {
+		if (!lost[i]) {
+			zassert_equal(frag_decoder_process(&dec, i + 1,
+							   file[i]),
+				      i == NB_FRAGS - 1 ? 1 : 0, NULL);
+		}
+	}
+}
+
+/* Sends coded fragments until the file is rebuilt, returns their number */
+static int send_coded(int max)
+{
+	u8_t frag[FRAG_SIZE];
+	int n;
+	int rc;
+
+	for (n = 1; n <= max; n++) {
+		coded_fragment(frag, n);
+		rc = frag_decoder_process(&dec, NB_FRAGS + n, frag);
+		zassert_true(rc >= 0, "process failed %d", rc);
+		if (rc == 1) {
+			return n;
+		}
+	}
+
+	return -1;
+}
+
+static void check_file(void)
+{
+	zassert_true(frag_decoder_done(&dec), NULL);
+	zassert_equal(memcmp(flash, file, sizeof(file)), 0, NULL);
+}
+
+static void test_no_loss(void)
+{
+	bool lost[NB_FRAGS] = { 0 };
+
+	setup(1);
+	send_uncoded(lost);
+	check_file();
+
+	/* late fragments are ignored */
+	zassert_equal(frag_decoder_process(&dec, 1, file[0]), 1, NULL);
+}
+
+static void test_recover(void)
+{
+	bool lost[NB_FRAGS] = { 0 };
+	int nb_lost = 0;
+	int coded;
+	int i;
+
+	setup(2);
+	/* the last one is lost, so that the uncoded ones are not enough */
+	for (i = 0; i < NB_FRAGS; i++) {
+		lost[i] = (next_rand() % 100) < 20 || i == NB_FRAGS - 1;
+		nb_lost += lost[i];
+	}
+
+	zassert_true(nb_lost <= CONFIG_FRAG_DECODER_MAX_MISSING, NULL);
+
+	for (i = 0; i < NB_FRAGS - 1; i++) {
+		if (!lost[i]) {
+			zassert_equal(frag_decoder_process(&dec, i + 1,
+							   file[i]), 0, NULL);
+			/* duplicates */
+			zassert_equal(frag_decoder_process(&dec, i + 1,
+							   file[i]), 0, NULL);
+		}
+	}
+
+	coded = send_coded(2 * nb_lost);
+	TC_PRINT("%d fragments lost, recovered with %d coded fragments\n",
+		 nb_lost, coded);
+
+	zassert_true(coded >= nb_lost, NULL);
+	zassert_true(coded <= nb_lost + 10, NULL);
+	zassert_equal(dec.nb_lost, nb_lost, NULL);
+	check_file();
+}
+
+static void test_late_uncoded(void)
+{
+	u8_t frag[FRAG_SIZE];
+	bool lost[NB_FRAGS] = { 0 };
+	int i;
+
+	setup(3);
+	for (i = 0; i < 20; i++) {
+		lost[i * 5] = true;
+	}
+
+	for (i = 0; i < NB_FRAGS; i++) {
+		if (!lost[i]) {
+			zassert_equal(frag_decoder_process(&dec, i + 1,
+							   file[i]), 0, NULL);
+		}
+	}
+
+	for (i = 1; i <= 10; i++) {
+		coded_fragment(frag, i);
+		zassert_equal(frag_decoder_process(&dec, NB_FRAGS + i, frag),
+			      0, NULL);
+	}
+
+	/* the uncoded fragments lost are repeated */
+	for (i = 0; i < NB_FRAGS && !frag_decoder_done(&dec); i++) {
+		if (lost[i]) {
+			zassert_true(frag_decoder_process(&dec, i + 1,
+							  file[i]) >= 0, NULL);
+		}
+	}
+
+	check_file();
+}
+
+static void test_too_many_lost(void)
+{
+	u8_t frag[FRAG_SIZE];
+	int i;
+
+	setup(4);
+	for (i = CONFIG_FRAG_DECODER_MAX_MISSING + 1; i < NB_FRAGS; i++) {
+		zassert_equal(frag_decoder_process(&dec, i + 1, file[i]), 0,
+			      NULL);
+	}
+
+	coded_fragment(frag, 1);
+	zassert_equal(frag_decoder_process(&dec, NB_FRAGS + 1, frag),
+		      -ENOSPC, NULL);
+}
+
+static void test_invalid(void)
+{
+	zassert_equal(frag_decoder_init(&dec, &file_area, &matrix_area,
+					NB_FRAGS, FRAG_SIZE - 2), -EINVAL,
+		      NULL);
+	zassert_equal(frag_decoder_init(&dec, &file_area, &matrix_area,
+					CONFIG_FRAG_DECODER_MAX_FRAGMENTS + 1,
+					FRAG_SIZE), -EINVAL, NULL);
+	zassert_equal(frag_decoder_init(&dec, &file_area, &matrix_area,
+					NB_FRAGS, 2 * FRAG_SIZE), -EINVAL,
+		      NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(frag_decoder,
+			 ztest_unit_test(test_no_loss),
+			 ztest_unit_test(test_recover),
+			 ztest_unit_test(test_late_uncoded),
+			 ztest_unit_test(test_too_many_lost),
+			 ztest_unit_test(test_invalid));
+	ztest_run_test_suite(frag_decoder);
+}
@@ -8,6 +8,23 @@
 #include <flash_map.h>
 #include <dfu/flash_img.h>
 
+#ifdef CONFIG_IMG_STREAM_HASH
+#include <misc/byteorder.h>
+#include <tinycrypt/sha256.h>
+
+/* mcuboot image: header, body, then the TLVs with the SHA-256 of both */
+#define IMG_HDR_SIZE 32
+#define IMG_BODY_SIZE 1000
+#define IMG_TLV_OFF (IMG_HDR_SIZE + IMG_BODY_SIZE)
+#define IMG_TLV_SIZE (4 + 4 + TC_SHA256_DIGEST_SIZE)
+#define IMG_HASH_OFF (IMG_TLV_OFF + 8)
+
+/* Size of the data of a transport packet */
+#define IMG_CHUNK_SIZE 100
+
+static u8_t image[IMG_TLV_OFF + IMG_TLV_SIZE];
+#endif
+
 void test_collecting(void)
 {
 	const struct flash_area *fa;
@@ -51,9 +68,105 @@ void test_collecting(void)
 	}
 }
 
+#ifdef CONFIG_IMG_STREAM_HASH
+static void build_image(void)
+{
+	struct tc_sha256_state_struct sha;
+	u8_t *tlv = &image[IMG_TLV_OFF];
+	u32_t i;
+
+	(void)memset(image, 0, sizeof(image));
+
+	sys_put_le32(0x96f3b83d, &image[0]);
+	sys_put_le16(IMG_HDR_SIZE, &image[8]);
+	sys_put_le32(IMG_BODY_SIZE, &image[12]);
+
+	for (i = IMG_HDR_SIZE; i < IMG_TLV_OFF; i++) {
+		image[i] = i;
+	}
+
+	sys_put_le16(0x6907, &tlv[0]);
+	sys_put_le16(IMG_TLV_SIZE, &tlv[2]);
+	tlv[4] = 0x10;
+	sys_put_le16(TC_SHA256_DIGEST_SIZE, &tlv[6]);
+
+	tc_sha256_init(&sha);
+	tc_sha256_update(&sha, image, IMG_TLV_OFF);
+	tc_sha256_final(&image[IMG_HASH_OFF], &sha);
+}
+
+/* Writes the image as received from a transport, and returns the result
+ * of the last write, which checks the image.
+ */
+static int write_image(void)
+{
+	struct flash_img_context ctx;
+	size_t offset, len;
+	int ret;
+
+	ret = flash_img_init(&ctx);
+	zassert_true(ret == 0, "Flash img init");
+
+	ret = flash_area_erase(ctx.flash_area, 0, ctx.flash_area->fa_size);
+	zassert_true(ret == 0, "Flash erase");
+
+	for (offset = 0; offset < sizeof(image); offset += len) {
+		len = min(sizeof(image) - offset, IMG_CHUNK_SIZE);
+		ret = flash_img_buffered_write(&ctx, &image[offset], len,
+					       offset + len == sizeof(image));
+		if (ret) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+void test_mcuboot_image(void)
+{
+	build_image();
+
+	zassert_equal(write_image(), 0, "valid image rejected");
+}
+
+void test_mcuboot_hash_mismatch(void)
+{
+	build_image();
+	image[IMG_HASH_OFF] ^= 0xff;
+
+	zassert_equal(write_image(), -EBADMSG, "wrong hash accepted");
+}
+
+void test_mcuboot_no_tlv(void)
+{
+	build_image();
+	image[IMG_TLV_OFF] = 0U;
+
+	zassert_equal(write_image(), -EBADMSG, "image without TLV accepted");
+}
+#else
+void test_mcuboot_image(void)
+{
+	ztest_test_skip();
+}
+
+void test_mcuboot_hash_mismatch(void)
+{
+	ztest_test_skip();
+}
+
+void test_mcuboot_no_tlv(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(test_util,
-			ztest_unit_test(test_collecting));
+			ztest_unit_test(test_collecting),
+			ztest_unit_test(test_mcuboot_image),
+			ztest_unit_test(test_mcuboot_hash_mismatch),
+			ztest_unit_test(test_mcuboot_no_tlv));
 	ztest_run_test_suite(test_util);
 }
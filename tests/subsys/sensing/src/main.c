@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <init.h>
+#include <sensor.h>
+#include <sensing/sensing.h>
+#include <ztest.h>
+
+#define FETCH_LOG_SIZE	64
+
+struct fake_data {
+	u32_t fetches;
+};
+
+static struct fake_data fake_data[3];
+
+/* Sensors fetched, in order, and the uptime of each fetch */
+static struct device *fetch_log[FETCH_LOG_SIZE];
+static u32_t fetch_time[FETCH_LOG_SIZE];
+static int fetch_count;
+
+static const enum sensor_channel chans[] = { SENSOR_CHAN_DIE_TEMP };
+
+static struct sensing_sensor sensors[3];
+
+static int fake_sample_fetch(struct device *dev, enum sensor_channel chan)
+{
+	struct fake_data *data = dev->driver_data;
+
+	data->fetches++;
+	if (fetch_count < FETCH_LOG_SIZE) {
+		fetch_log[fetch_count] = dev;
+		fetch_time[fetch_count] = k_uptime_get_32();
+	}
+	fetch_count++;
+
+	return 0;
+}
+
+static int fake_channel_get(struct device *dev, enum sensor_channel chan,
+			    struct sensor_value *val)
+{
+	struct fake_data *data = dev->driver_data;
+
+	val->val1 = data->fetches;
+	val->val2 = chan;
+
+	return 0;
+}
+
+static const struct sensor_driver_api fake_api = {
+	.sample_fetch = fake_sample_fetch,
+	.channel_get = fake_channel_get,
+};
+
+static int fake_init(struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_AND_API_INIT(fake_0, "FAKE_0", fake_init, &fake_data[0], NULL,
+		    POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY, &fake_api);
+DEVICE_AND_API_INIT(fake_1, "FAKE_1", fake_init, &fake_data[1], NULL,
+		    POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY, &fake_api);
+DEVICE_AND_API_INIT(fake_2, "FAKE_2", fake_init, &fake_data[2], NULL,
+		    POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY, &fake_api);
+DEVICE_INIT(bus_a, "BUS_A", fake_init, NULL, NULL, POST_KERNEL,
+	    CONFIG_KERNEL_INIT_PRIORITY_DEVICE);
+DEVICE_INIT(bus_b, "BUS_B", fake_init, NULL, NULL, POST_KERNEL,
+	    CONFIG_KERNEL_INIT_PRIORITY_DEVICE);
+
+static void setup_sensor(int i, const char *bus, u32_t period)
+{
+	static const char * const names[] = { "FAKE_0", "FAKE_1", "FAKE_2" };
+	struct sensing_sensor *sensor = &sensors[i];
+
+	sensor->dev = device_get_binding(names[i]);
+	zassert_not_null(sensor->dev, NULL);
+	sensor->bus = device_get_binding(bus);
+	zassert_not_null(sensor->bus, NULL);
+	sensor->chans = chans;
+	sensor->num_chans = ARRAY_SIZE(chans);
+	sensor->period = period;
+
+	fake_data[i].fetches = 0U;
+}
+
+static void reset(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sensors); i++) {
+		zassert_equal(sensing_sensor_remove(&sensors[i]), 0, NULL);
+	}
+
+	/* let a pass in progress complete */
+	k_sleep(20);
+	fetch_count = 0;
+}
+
+static void test_bus_grouping(void)
+{
+	int i;
+
+	setup_sensor(0, "BUS_A", 100);
+	setup_sensor(1, "BUS_B", 100);
+	setup_sensor(2, "BUS_A", 100);
+	reset();
+
+	for (i = 0; i < ARRAY_SIZE(sensors); i++) {
+		zassert_equal(sensing_sensor_add(&sensors[i]), 0, NULL);
+	}
+
+	k_sleep(50);
+
+	/* all due in one pass, the sensors of bus A first */
+	zassert_equal(fetch_count, 3, NULL);
+	zassert_equal(fetch_log[0], sensors[0].dev, NULL);
+	zassert_equal(fetch_log[1], sensors[2].dev, NULL);
+	zassert_equal(fetch_log[2], sensors[1].dev, NULL);
+
+	reset();
+}
+
+/* Tolerance of the counts of periodic events */
+static bool near(u32_t count, u32_t expected)
+{
+	return count + 1 >= expected && count <= expected + 1;
+}
+
+static void test_rates(void)
+{
+	int wakeups = 1;
+	int i;
+
+	setup_sensor(0, "BUS_A", 10);
+	setup_sensor(1, "BUS_A", 20);
+	setup_sensor(2, "BUS_A", 40);
+	reset();
+
+	for (i = 0; i < ARRAY_SIZE(sensors); i++) {
+		zassert_equal(sensing_sensor_add(&sensors[i]), 0, NULL);
+	}
+
+	k_sleep(195);
+
+	for (i = 0; i < ARRAY_SIZE(sensors); i++) {
+		zassert_equal(sensing_sensor_remove(&sensors[i]), 0, NULL);
+	}
+
+	zassert_true(near(fake_data[0].fetches, 20), NULL);
+	zassert_true(near(fake_data[1].fetches, 10), NULL);
+	zassert_true(near(fake_data[2].fetches, 5), NULL);
+
+	/* the slower sensors are fetched with the faster one */
+	for (i = 1; i < min(fetch_count, FETCH_LOG_SIZE); i++) {
+		if (fetch_time[i] - fetch_time[i - 1] > 1) {
+			wakeups++;
+		}
+	}
+
+	zassert_true(near(wakeups, fake_data[0].fetches), NULL);
+
+	reset();
+}
+
+static void test_downsampling(void)
+{
+	struct sensing_subscriber full = { .sensor = &sensors[0] };
+	struct sensing_subscriber slow = {
+		.sensor = &sensors[0],
+		.period = 30,
+	};
+	struct sensing_subscriber fast = {
+		.sensor = &sensors[0],
+		.period = 5,
+	};
+	struct sensing_sample sample;
+	u32_t i;
+
+	setup_sensor(0, "BUS_A", 10);
+	reset();
+
+	zassert_equal(sensing_subscribe(&fast), -EINVAL, NULL);
+	zassert_equal(sensing_subscribe(&full), 0, NULL);
+	zassert_equal(sensing_subscribe(&slow), 0, NULL);
+	zassert_equal(sensing_sensor_add(&sensors[0]), 0, NULL);
+
+	for (i = 0U; i < 3; i++) {
+		zassert_equal(sensing_read(&slow, &sample, 100), 0, NULL);
+		zassert_equal(sample.seq, 3 * i, NULL);
+		zassert_equal(sample.sensor, &sensors[0], NULL);
+		zassert_equal(sample.chan, SENSOR_CHAN_DIE_TEMP, NULL);
+		zassert_equal(sample.val[0].val1, 3 * i + 1, NULL);
+	}
+
+	for (i = 0U; i < 7; i++) {
+		zassert_equal(sensing_read(&full, &sample, K_NO_WAIT), 0,
+			      NULL);
+		zassert_equal(sample.seq, i, NULL);
+	}
+
+	zassert_equal(full.lost, 0, NULL);
+	zassert_equal(slow.lost, 0, NULL);
+
+	sensing_unsubscribe(&full);
+	sensing_unsubscribe(&slow);
+	reset();
+}
+
+static void test_lost(void)
+{
+	struct sensing_subscriber sub = { 0 };
+	struct sensing_sample sample;
+	struct sensing_sample next;
+
+	setup_sensor(0, "BUS_A", 10);
+	reset();
+
+	zassert_equal(sensing_subscribe(&sub), 0, NULL);
+	zassert_equal(sensing_sensor_add(&sensors[0]), 0, NULL);
+
+	/* twice the size of the ring */
+	k_sleep(CONFIG_SENSING_RING_SIZE * 2 * 10);
+
+	zassert_equal(sensing_read(&sub, &sample, K_NO_WAIT), 0, NULL);
+	zassert_true(sub.lost >= CONFIG_SENSING_RING_SIZE / 2, NULL);
+	zassert_equal(sample.seq, sub.lost, NULL);
+
+	zassert_equal(sensing_read(&sub, &next, K_NO_WAIT), 0, NULL);
+	zassert_equal(next.seq, sample.seq + 1, NULL);
+
+	sensing_unsubscribe(&sub);
+	reset();
+}
+
+static void test_timeout(void)
+{
+	struct sensing_subscriber sub = { .sensor = &sensors[1] };
+	struct sensing_sample sample;
+
+	setup_sensor(0, "BUS_A", 10);
+	setup_sensor(1, "BUS_B", 10);
+	reset();
+
+	/* only the other sensor is sampled */
+	zassert_equal(sensing_subscribe(&sub), 0, NULL);
+	zassert_equal(sensing_sensor_add(&sensors[0]), 0, NULL);
+	zassert_equal(sensing_read(&sub, &sample, 50), -EAGAIN, NULL);
+
+	sensing_unsubscribe(&sub);
+	reset();
+}
+
+static void test_remove_busy(void)
+{
+	struct sensing_subscriber sub = { .sensor = &sensors[0] };
+	struct sensing_sample sample;
+
+	setup_sensor(0, "BUS_A", 10);
+	reset();
+
+	zassert_equal(sensing_subscribe(&sub), 0, NULL);
+	zassert_equal(sensing_sensor_add(&sensors[0]), 0, NULL);
+
+	/* the sensor is kept for its subscriber */
+	zassert_equal(sensing_sensor_remove(&sensors[0]), -EBUSY, NULL);
+	zassert_equal(sensing_read(&sub, &sample, 50), 0, NULL);
+	zassert_equal(sensing_read(&sub, &sample, 50), 0, NULL);
+
+	sensing_unsubscribe(&sub);
+	zassert_equal(sensing_sensor_remove(&sensors[0]), 0, NULL);
+
+	reset();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sensing,
+			 ztest_unit_test(test_bus_grouping),
+			 ztest_unit_test(test_rates),
+			 ztest_unit_test(test_downsampling),
+			 ztest_unit_test(test_lost),
+			 ztest_unit_test(test_timeout),
+			 ztest_unit_test(test_remove_busy));
+	ztest_run_test_suite(sensing);
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <stats.h>
+
+STATS_SECT_START(test16)
+	STATS_SECT_ENTRY16(a)
+	STATS_SECT_ENTRY16(b)
+STATS_SECT_END;
+
+STATS_SECT_START(test32)
+	STATS_SECT_ENTRY32(a)
+	STATS_SECT_ENTRY32(b)
+STATS_SECT_END;
+
+STATS_SECT_START(test64)
+	STATS_SECT_ENTRY64(a)
+	STATS_SECT_ENTRY64(b)
+STATS_SECT_END;
+
+static STATS_SECT_DECL(test16) test16;
+static STATS_SECT_DECL(test32) test32;
+static STATS_SECT_DECL(test64) test64;
+
+/* Entries of the three groups, in the order of the snapshots */
+#define ENTRY_CNT 6
+
+static u8_t buf[64];
+
+/* Takes a snapshot of all the groups, and decodes its values. */
+static void snapshot(struct stats_snapshot *snap, bool delta,
+		     u64_t values[ENTRY_CNT])
+{
+	size_t len = sizeof(buf);
+	u8_t *src = buf;
+	int shift;
+	int i;
+
+	memset(snap, 0, sizeof(*snap));
+	snap->delta = delta;
+
+	zassert_equal(stats_snapshot_encode(snap, buf, &len), 0,
+		      "snapshot failed");
+	zassert_equal(snap->groups, 3, "wrong group count");
+	zassert_equal(snap->next, 3, "groups left");
+
+	for (i = 0; i < ENTRY_CNT; i++) {
+		values[i] = 0;
+		shift = 0;
+
+		do {
+			zassert_true(src < buf + len, "truncated snapshot");
+			values[i] |= (u64_t)(*src & 0x7f) << shift;
+			shift += 7;
+		} while (*src++ & 0x80);
+	}
+
+	zassert_equal(src, buf + len, "trailing bytes");
+}
+
+static void test_register(void)
+{
+	zassert_equal(STATS_INIT_AND_REG(test16, STATS_SIZE_16, "test16"), 0,
+		      "register failed");
+	zassert_equal(STATS_INIT_AND_REG(test32, STATS_SIZE_32, "test32"), 0,
+		      "register failed");
+	zassert_equal(STATS_INIT_AND_REG(test64, STATS_SIZE_64, "test64"), 0,
+		      "register failed");
+}
+
+static void test_absolute(void)
+{
+	struct stats_snapshot snap;
+	u64_t values[ENTRY_CNT];
+	size_t len = sizeof(buf);
+
+	test16.a = 1;
+	test16.b = 0xffff;
+	test32.a = 0x80;
+	test32.b = 0;
+	test64.a = 0x123456789aULL;
+	test64.b = UINT64_MAX;
+
+	snapshot(&snap, false, values);
+
+	zassert_equal(snap.delta_cnt, 0, "unexpected differences");
+	zassert_equal(values[0], 1, NULL);
+	zassert_equal(values[1], 0xffff, NULL);
+	zassert_equal(values[2], 0x80, NULL);
+	zassert_equal(values[3], 0, NULL);
+	zassert_equal(values[4], 0x123456789aULL, NULL);
+	zassert_equal(values[5], UINT64_MAX, NULL);
+
+	/* Varints: 1, 3 bytes for 16 bits, 2 for 0x80 and 10 for 64 bits */
+	zassert_equal(memcmp(buf, "\x01\xff\xff\x03\x80\x01", 6), 0,
+		      "wrong varints");
+	zassert_equal(stats_snapshot_encode(&snap, buf, &len), 0, NULL);
+	zassert_equal(len, 1 + 3 + 2 + 1 + 6 + 10, "wrong length");
+}
+
+static void test_delta(void)
+{
+	struct stats_snapshot snap;
+	u64_t values[ENTRY_CNT];
+	u32_t seq;
+
+	test16.a = 10;
+	test16.b = 0xfffe;
+	test32.a = 0xffffffff;
+	test32.b = 7;
+	test64.a = 0x100000000ULL;
+	test64.b = 42;
+
+	/* The reference */
+	snapshot(&snap, false, values);
+	seq = snap.seq;
+
+	/* test16.b and test32.a wrap around */
+	STATS_INCN(test16, a, 3);
+	STATS_INCN(test16, b, 3);
+	STATS_INCN(test32, a, 5);
+	STATS_INCN(test64, a, 1000);
+	STATS_INCN(test64, b, 1);
+
+	snapshot(&snap, true, values);
+
+	zassert_equal(snap.seq, seq + 1, "wrong sequence number");
+	zassert_equal(snap.delta_cnt, 5, "wrong difference count");
+	zassert_equal(values[0], 3, NULL);
+	zassert_equal(values[1], 3, NULL);
+	zassert_equal(values[2], 5, NULL);
+	zassert_equal(values[3], 0, NULL);
+	zassert_equal(values[4], 1000, NULL);
+
+	/* Beyond the kept entries, values are whole */
+	zassert_equal(values[5], 43, NULL);
+
+	/* The delta snapshot is the reference of the next one */
+	snapshot(&snap, true, values);
+
+	zassert_equal(snap.seq, seq + 2, "wrong sequence number");
+	zassert_equal(values[0], 0, NULL);
+	zassert_equal(values[1], 0, NULL);
+	zassert_equal(values[2], 0, NULL);
+	zassert_equal(values[4], 0, NULL);
+	zassert_equal(values[5], 43, NULL);
+}
+
+static void test_paging(void)
+{
+	struct stats_snapshot snap;
+	size_t len;
+
+	stats_reset(&test16.s_hdr);
+	stats_reset(&test32.s_hdr);
+	stats_reset(&test64.s_hdr);
+
+	/*
+	 * A group fits when its values fit at their longest: 6 bytes for
+	 * the 16-bit group, 10 for the 32-bit one and 20 for the 64-bit one.
+	 */
+	memset(&snap, 0, sizeof(snap));
+	len = 16;
+	zassert_equal(stats_snapshot_encode(&snap, buf, &len), 0, NULL);
+	zassert_equal(snap.next, 2, "wrong next group");
+	zassert_equal(snap.groups, 3, "wrong group count");
+	zassert_equal(len, 4, "wrong length");
+
+	snap.start = snap.next;
+	len = 20;
+	zassert_equal(stats_snapshot_encode(&snap, buf, &len), 0, NULL);
+	zassert_equal(snap.next, 3, "wrong next group");
+	zassert_equal(len, 2, "wrong length");
+
+	/* The start group does not fit */
+	snap.start = 0;
+	len = 5;
+	zassert_equal(stats_snapshot_encode(&snap, buf, &len), -ENOMEM, NULL);
+
+	/* No group from the start one on */
+	snap.start = 3;
+	len = sizeof(buf);
+	zassert_equal(stats_snapshot_encode(&snap, buf, &len), -ENOENT, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(stats_snapshot,
+			 ztest_unit_test(test_register),
+			 ztest_unit_test(test_absolute),
+			 ztest_unit_test(test_delta),
+			 ztest_unit_test(test_paging));
+
+	ztest_run_test_suite(stats_snapshot);
+}
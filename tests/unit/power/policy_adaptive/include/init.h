@@ -0,0 +1,10 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* No init levels: the test initializes the policy itself */
+struct device;
+
+#define SYS_INIT(init_fn, level, prio)
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 HES-SO Valais-Wallis
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Power states of STM32L4: Stop 1, Stop 2 and Standby */
+#define CONFIG_SYS_POWER_MANAGEMENT 1
+#define CONFIG_SYS_POWER_LOW_POWER_STATES 1
+#define CONFIG_SYS_POWER_STATE_CPU_LPS_SUPPORTED 1
+#define CONFIG_SYS_POWER_STATE_CPU_LPS_1_SUPPORTED 1
+#define CONFIG_SYS_POWER_DEEP_SLEEP_STATES 1
+#define CONFIG_SYS_POWER_STATE_DEEP_SLEEP_SUPPORTED 1
+
+#define CONFIG_PM_LOG_LEVEL 0
+#define CONFIG_PM_POLICY_ADAPTIVE_LATENCY 1000
+#define CONFIG_PM_ACTIVE_POWER 3000
+#define CONFIG_PM_IDLE_POWER 1000
+#define CONFIG_PM_LPS_POWER 100
+#define CONFIG_PM_LPS_1_POWER 50
+#define CONFIG_PM_DEEP_SLEEP_POWER 10
+
+#include <ztest.h>
+
+/* No architecture in unit tests: the cycle counter is mocked below */
+u32_t _arch_k_cycle_get_32(void);
+
+#include <subsys/power/policy/policy_adaptive.c>
+
+/* Hardware cycles per microsecond, and microseconds per tick */
+#define CYCLES_PER_US	(CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC / USEC_PER_SEC)
+#define US_PER_TICK	(USEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+
+/* Standby resets the SoC: only entered on request */
+#ifdef CONFIG_PM_POLICY_ADAPTIVE_DEEP_SLEEP
+#define DEEPEST_STATE	SYS_POWER_STATE_DEEP_SLEEP
+#else
+#define DEEPEST_STATE	SYS_POWER_STATE_CPU_LPS_1
+#endif
+
+static u32_t cycles;
+
+u32_t _arch_k_cycle_get_32(void)
+{
+	return cycles;
+}
+
+static void setup(void)
+{
+	(void)memset(pm_data, 0, sizeof(pm_data));
+	entered = SYS_POWER_STATE_ACTIVE;
+	cycles = 0U;
+
+	pm_policy_adaptive_init(NULL);
+}
+
+/* Enters the state chosen for ticks, and leaves it after us */
+static enum power_states sleep_for(s32_t ticks, u32_t us)
+{
+	enum power_states state = sys_pm_policy_next_state(ticks);
+
+	if (state != SYS_POWER_STATE_ACTIVE) {
+		cycles += us * CYCLES_PER_US;
+		sys_pm_policy_state_exit(state);
+	}
+
+	return state;
+}
+
+static void test_break_even(void)
+{
+	setup();
+
+	/*
+	 * latency * (active - power) / (shallower - power):
+	 * 1000 * 2900 / 900, 1000 * 2950 / 50 and 1000 * 2990 / 40.
+	 */
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].break_even, 3222, NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS_1].break_even, 59000,
+		      NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_DEEP_SLEEP].break_even, 74750,
+		      NULL);
+
+	/* No state worth entering */
+	zassert_equal(sys_pm_policy_next_state(0), SYS_POWER_STATE_ACTIVE,
+		      NULL);
+
+	/* 10 ms, 60 ms */
+	zassert_equal(sys_pm_policy_next_state(1), SYS_POWER_STATE_CPU_LPS,
+		      NULL);
+	zassert_equal(sys_pm_policy_next_state(6), SYS_POWER_STATE_CPU_LPS_1,
+		      NULL);
+}
+
+static void test_deep_sleep(void)
+{
+	setup();
+
+	/* 80 ms */
+	zassert_equal(sys_pm_policy_next_state(8), DEEPEST_STATE, NULL);
+	zassert_equal(sys_pm_policy_next_state(K_FOREVER), DEEPEST_STATE,
+		      NULL);
+}
+
+static void test_latency_learning(void)
+{
+	u32_t latency;
+	int i;
+
+	setup();
+
+	/*
+	 * Woken up on time is up to a tick before the timeout, half a tick
+	 * on average: 200 us past that is the latency sample. It weighs an
+	 * eighth in the average.
+	 */
+	zassert_equal(sleep_for(1, US_PER_TICK / 2 + 200),
+		      SYS_POWER_STATE_CPU_LPS, NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].count, 1, NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].latency, 900, NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].break_even, 2900, NULL);
+
+	for (i = 0; i < 100; i++) {
+		(void)sleep_for(1, US_PER_TICK / 2 + 200);
+	}
+
+	/* Converged, within the rounding of the average */
+	latency = pm_data[SYS_POWER_STATE_CPU_LPS].latency;
+	zassert_true(latency >= 200 && latency < 200 + 8,
+		     "latency %u", latency);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].count, 101, NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].break_even,
+		      latency * 2900 / 900, NULL);
+
+	/* The other states keep theirs */
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS_1].latency, 1000, NULL);
+}
+
+static void test_latency_no_sample(void)
+{
+	setup();
+
+	/* Woken up by another event, more than a tick early */
+	zassert_equal(sleep_for(5, 2 * US_PER_TICK), SYS_POWER_STATE_CPU_LPS,
+		      NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].early, 1, NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].latency, 1000, NULL);
+
+	/* Without timeout, any wakeup is due to an event */
+	zassert_equal(sleep_for(K_FOREVER, 10 * US_PER_TICK), DEEPEST_STATE,
+		      NULL);
+	zassert_equal(pm_data[DEEPEST_STATE].count, 1, NULL);
+	zassert_equal(pm_data[DEEPEST_STATE].latency, 1000, NULL);
+
+	/* Another state than the one chosen was forced */
+	zassert_equal(sys_pm_policy_next_state(1), SYS_POWER_STATE_CPU_LPS,
+		      NULL);
+	cycles += US_PER_TICK * CYCLES_PER_US;
+	sys_pm_policy_state_exit(SYS_POWER_STATE_CPU_LPS_1);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS].count, 1, NULL);
+	zassert_equal(pm_data[SYS_POWER_STATE_CPU_LPS_1].count,
+		      (DEEPEST_STATE == SYS_POWER_STATE_CPU_LPS_1) ? 1 : 0,
+		      NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(policy_adaptive,
+			 ztest_unit_test(test_break_even),
+			 ztest_unit_test(test_deep_sleep),
+			 ztest_unit_test(test_latency_learning),
+			 ztest_unit_test(test_latency_no_sample));
+
+	ztest_run_test_suite(policy_adaptive);
+}